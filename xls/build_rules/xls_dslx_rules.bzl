@@ -104,6 +104,9 @@ def _get_dslx_test_cmdline(ctx, src, all_srcs, append_cmd_line_args = True):
         "enable_warnings",
         "max_ticks",
         "format_preference",
+        "test_threads",
+        "bytecode_cache_dir",
+        "bytecode_cache_read_only",
     )
 
     dslx_test_args = dict(_dslx_test_args)
@@ -122,6 +122,13 @@ SCHEDULING_FIELDS = {
     "minimize_clock_on_error": "If true, when `--clock_period_ps` is given " +
                                "but is infeasible for scheduling, search for " +
                                "& report the shortest feasible clock period.",
+    "scheduling_threads": "Number of threads to use when searching for the " +
+                          "minimum clock period and when proving mutual " +
+                          "exclusion. If zero, uses one thread per " +
+                          "available CPU.",
+    "sdc_partition_size": "If positive, functions with more nodes than this " +
+                          "are scheduled by solving SDC problems over " +
+                          "partitions of at most this many nodes.",
     "minimize_worst_case_throughput": "If true, when `--worst_case_throughput` " +
                                       "is not given, search for & report the best " +
                                       "possible worst-case throughput of the circuit " +
@@ -161,10 +168,15 @@ SCHEDULING_FIELDS = {
                                      "in each FDO iteration.",
     "fdo_refinement_stochastic_ratio": "Must be a positive float <= 1.0.",
     "fdo_path_evaluate_strategy": "Support window, cone, and path for now.",
-    "fdo_synthesizer_name": "Only support yosys for now.",
+    "fdo_synthesizer_name": "Support yosys and fake for now.",
     "fdo_yosys_path": "Absolute path of Yosys.",
     "fdo_sta_path": "Absolute path of OpenSTA.",
     "fdo_synthesis_libraries": "Synthesis and STA libraries.",
+    "fdo_synthesis_threads": "Maximum number of subgraphs synthesized " +
+                             "concurrently. If zero, uses one thread per " +
+                             "available CPU.",
+    "fdo_synthesis_cache_path": "File in which the delays of synthesized " +
+                                "subgraphs are cached across runs.",
     "multi_proc": "If true, schedule all procs and codegen them all.",
 }
 
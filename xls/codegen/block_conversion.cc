@@ -483,12 +483,12 @@ static absl::StatusOr<BubbleFlowControl> UpdatePipelineWithBubbleFlowControl(
                 /*loc=*/SourceInfo(), pipeline_reg.reg_write->data(),
                 /*load_enable=*/result.data_load_enable.at(stage),
                 /*reset=*/pipeline_reg.reg_write->reset(), pipeline_reg.reg));
-        XLS_RET_CHECK(node_to_stage_map.contains(pipeline_reg.reg_write));
-        Stage s = node_to_stage_map[pipeline_reg.reg_write];
-        node_to_stage_map.erase(pipeline_reg.reg_write);
+        auto stage_entry = node_to_stage_map.extract(pipeline_reg.reg_write);
+        XLS_RET_CHECK(!stage_entry.empty());
+        stage_entry.key() = new_reg_write;
+        node_to_stage_map.insert(std::move(stage_entry));
         XLS_RETURN_IF_ERROR(block->RemoveNode(pipeline_reg.reg_write));
         pipeline_reg.reg_write = new_reg_write;
-        node_to_stage_map[new_reg_write] = s;
       }
     }
   }
@@ -731,10 +731,11 @@ static absl::StatusOr<ValidPorts> AddValidSignal(
                 /*loc=*/SourceInfo(), pipeline_reg.reg_write->data(),
                 /*load_enable=*/load_enable,
                 /*reset=*/std::nullopt, pipeline_reg.reg));
-        if (node_to_stage_map.contains(pipeline_reg.reg_write)) {
-          Stage s = node_to_stage_map[pipeline_reg.reg_write];
-          node_to_stage_map.erase(pipeline_reg.reg_write);
-          node_to_stage_map[new_write] = s;
+        if (auto stage_entry =
+                node_to_stage_map.extract(pipeline_reg.reg_write);
+            !stage_entry.empty()) {
+          stage_entry.key() = new_write;
+          node_to_stage_map.insert(std::move(stage_entry));
         }
         XLS_RETURN_IF_ERROR(block->RemoveNode(pipeline_reg.reg_write));
         pipeline_reg.reg_write = new_write;
@@ -2199,21 +2200,20 @@ class CloneNodesIntoBlockHandler {
   }
 
   // Add pipeline registers. A register is needed for each node which is
-  // scheduled at or before this cycle and has a use after this cycle.
-  absl::Status AddNextPipelineStage(const PipelineSchedule& schedule,
+  // scheduled at or before this cycle and has a use after this cycle, i.e., for
+  // each of `live_out_nodes` (see PipelineSchedule::GetLiveOutNodesByCycle).
+  absl::Status AddNextPipelineStage(absl::Span<Node* const> live_out_nodes,
                                     int64_t stage) {
-    for (Node* function_base_node : function_base_->nodes()) {
-      if (schedule.IsLiveOutOfCycle(function_base_node, stage)) {
-        Node* node = node_map_.at(function_base_node);
+    for (Node* function_base_node : live_out_nodes) {
+      Node* node = node_map_.at(function_base_node);
 
-        XLS_ASSIGN_OR_RETURN(
-            Node * node_after_stage,
-            CreatePipelineRegistersForNode(
-                PipelineSignalName(node->GetName(), stage), node, stage,
-                result_.pipeline_registers.at(stage)));
+      XLS_ASSIGN_OR_RETURN(
+          Node * node_after_stage,
+          CreatePipelineRegistersForNode(
+              PipelineSignalName(node->GetName(), stage), node, stage,
+              result_.pipeline_registers.at(stage)));
 
-        node_map_[function_base_node] = node_after_stage;
-      }
+      node_map_[function_base_node] = node_after_stage;
     }
 
     return absl::OkStatus();
@@ -2846,9 +2846,15 @@ CloneNodesIntoPipelinedBlock(const PipelineSchedule& schedule,
 
   CloneNodesIntoBlockHandler cloner(function_base, schedule.length(), options,
                                     block);
+  // Bucket the nodes needing pipeline registers by stage up front rather than
+  // checking every node for liveness at every stage, which is quadratic for
+  // deep pipelines.
+  std::vector<std::vector<Node*>> live_out_nodes =
+      schedule.GetLiveOutNodesByCycle();
   for (int64_t stage = 0; stage < schedule.length(); ++stage) {
     XLS_RET_CHECK_OK(cloner.CloneNodes(schedule.nodes_in_cycle(stage), stage));
-    XLS_RET_CHECK_OK(cloner.AddNextPipelineStage(schedule, stage));
+    XLS_RET_CHECK_OK(
+        cloner.AddNextPipelineStage(live_out_nodes[stage], stage));
   }
 
   XLS_RET_CHECK_OK(cloner.AddOutputPortsIfFunction());
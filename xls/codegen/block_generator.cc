@@ -43,6 +43,7 @@
 #include "xls/codegen/node_representation.h"
 #include "xls/codegen/op_override.h"
 #include "xls/codegen/vast.h"
+#include "xls/codegen/vast_sink.h"
 #include "xls/codegen/verilog_line_map.pb.h"
 #include "xls/common/casts.h"
 #include "xls/common/logging/log_lines.h"
@@ -898,6 +899,22 @@ absl::StatusOr<std::vector<Block*>> GatherInstantiatedBlocks(Block* top) {
 absl::StatusOr<std::string> GenerateVerilog(Block* top,
                                             const CodegenOptions& options,
                                             VerilogLineMap* verilog_line_map) {
+  std::string text;
+  {
+    VastSink sink(&text);
+    XLS_RETURN_IF_ERROR(
+        GenerateVerilog(top, options, &sink, verilog_line_map));
+  }
+
+  XLS_VLOG(2) << "Verilog output:";
+  XLS_VLOG_LINES(2, text);
+
+  return text;
+}
+
+absl::Status GenerateVerilog(Block* top, const CodegenOptions& options,
+                             VastSink* sink,
+                             VerilogLineMap* verilog_line_map) {
   XLS_VLOG(2) << absl::StreamFormat(
       "Generating Verilog for packge with with top level block `%s`:",
       top->name());
@@ -916,7 +933,7 @@ absl::StatusOr<std::string> GenerateVerilog(Block* top,
   }
 
   LineInfo line_info;
-  std::string text = file.Emit(&line_info);
+  file.EmitTo(&line_info, sink, options.emit_threads());
   if (verilog_line_map != nullptr) {
     for (const auto& [vast_node, partial_spans] : line_info.Spans()) {
       std::optional<std::vector<LineSpan>> spans =
@@ -942,10 +959,7 @@ absl::StatusOr<std::string> GenerateVerilog(Block* top,
     }
   }
 
-  XLS_VLOG(2) << "Verilog output:";
-  XLS_VLOG_LINES(2, text);
-
-  return text;
+  return absl::OkStatus();
 }
 
 }  // namespace verilog
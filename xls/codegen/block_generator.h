@@ -17,8 +17,10 @@
 
 #include <string>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/codegen_options.h"
+#include "xls/codegen/vast_sink.h"
 #include "xls/codegen/verilog_line_map.pb.h"
 #include "xls/ir/block.h"
 
@@ -32,6 +34,12 @@ absl::StatusOr<std::string> GenerateVerilog(
     Block* top, const CodegenOptions& options,
     VerilogLineMap* verilog_line_map = nullptr);
 
+// As above, but writes the text to the given sink, which lets the caller
+// stream it to a file rather than holding it in memory.
+absl::Status GenerateVerilog(Block* top, const CodegenOptions& options,
+                             VastSink* sink,
+                             VerilogLineMap* verilog_line_map = nullptr);
+
 }  // namespace verilog
 }  // namespace xls
 
@@ -56,6 +56,7 @@ CodegenOptions::CodegenOptions(const CodegenOptions& options)
       streaming_channel_valid_suffix_(options.streaming_channel_valid_suffix_),
       array_index_bounds_checking_(options.array_index_bounds_checking_),
       gate_recvs_(options.gate_recvs_),
+      emit_threads_(options.emit_threads_),
       register_merge_strategy_(options.register_merge_strategy_) {
   for (auto& [op, op_override] : options.op_overrides_) {
     op_overrides_.insert_or_assign(op, op_override->Clone());
@@ -87,6 +88,7 @@ CodegenOptions& CodegenOptions::operator=(const CodegenOptions& options) {
   streaming_channel_valid_suffix_ = options.streaming_channel_valid_suffix_;
   array_index_bounds_checking_ = options.array_index_bounds_checking_;
   gate_recvs_ = options.gate_recvs_;
+  emit_threads_ = options.emit_threads_;
   register_merge_strategy_ = options.register_merge_strategy_;
   for (auto& [op, op_override] : options.op_overrides_) {
     op_overrides_.insert_or_assign(op, op_override->Clone());
@@ -269,4 +271,9 @@ CodegenOptions& CodegenOptions::register_merge_strategy(
   return *this;
 }
 
+CodegenOptions& CodegenOptions::emit_threads(int64_t value) {
+  emit_threads_ = value;
+  return *this;
+}
+
 }  // namespace xls::verilog
@@ -255,6 +255,12 @@ class CodegenOptions {
     return *this;
   }
 
+  // The number of threads used to emit the text of the modules in the
+  // generated file. Emitting with more than one thread holds the text of every
+  // module in memory at once.
+  CodegenOptions& emit_threads(int64_t value);
+  int64_t emit_threads() const { return emit_threads_; }
+
  private:
   std::optional<std::string> entry_;
   std::optional<std::string> module_name_;
@@ -279,6 +285,7 @@ class CodegenOptions {
   bool gate_recvs_ = true;
   std::vector<std::unique_ptr<RamConfiguration>> ram_configurations_;
   int64_t max_trace_verbosity_ = 0;
+  int64_t emit_threads_ = 1;
   RegisterMergeStrategy register_merge_strategy_ =
       RegisterMergeStrategy::kDefault;
 };
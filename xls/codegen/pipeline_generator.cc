@@ -21,6 +21,9 @@
 
 #include "absl/log/log.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xls/codegen/block_conversion.h"
 #include "xls/codegen/block_generator.h"
 #include "xls/codegen/codegen_options.h"
@@ -40,17 +43,36 @@
 
 namespace xls {
 namespace verilog {
+namespace {
+
+// Logs the time spent in each phase of generation and moves it into `timing`
+// if it is non-null.
+void ReportTiming(PipelineGeneratorTiming& phase_timing,
+                  PipelineGeneratorTiming* timing) {
+  XLS_VLOG(1) << absl::StreamFormat(
+      "Block conversion: %s, codegen passes: %s, Verilog generation: %s",
+      absl::FormatDuration(phase_timing.block_conversion),
+      absl::FormatDuration(phase_timing.pass_pipeline),
+      absl::FormatDuration(phase_timing.verilog_generation));
+  if (timing != nullptr) {
+    *timing = std::move(phase_timing);
+  }
+}
+
+}  // namespace
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
-    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+    const CodegenOptions& options, const DelayEstimator* delay_estimator,
+    PipelineGeneratorTiming* timing) {
   return ToPipelineModuleText(schedule, static_cast<FunctionBase*>(func),
-                              options, delay_estimator);
+                              options, delay_estimator, timing);
 }
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, FunctionBase* module,
-    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+    const CodegenOptions& options, const DelayEstimator* delay_estimator,
+    PipelineGeneratorTiming* timing) {
   XLS_VLOG(2) << "Generating pipelined module for module:";
   XLS_VLOG_LINES(2, module->DumpIr());
   XLS_VLOG_LINES(2, schedule.ToString());
@@ -61,8 +83,11 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   pass_options.delay_estimator = delay_estimator;
 
   // Convert to block and add in pipe stages according to schedule.
+  PipelineGeneratorTiming phase_timing;
+  absl::Time start = absl::Now();
   XLS_ASSIGN_OR_RETURN(CodegenPassUnit unit,
                        FunctionBaseToPipelinedBlock(schedule, options, module));
+  phase_timing.block_conversion = absl::Now() - start;
   if (module->IsProc()) {
     // Force using non-pretty printed codegen when generating procs.
     // TODO: google/xls#1331 - Update pretty-printer to support blocks with flow
@@ -71,16 +96,22 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   }
 
   PassResults results;
+  start = absl::Now();
   XLS_RETURN_IF_ERROR(
       CreateCodegenPassPipeline()->Run(&unit, pass_options, &results).status());
+  phase_timing.pass_pipeline = absl::Now() - start;
+  phase_timing.pass_invocations = std::move(results.invocations);
   XLS_RET_CHECK(unit.top_block != nullptr &&
                 unit.metadata.contains(unit.top_block) &&
                 unit.metadata.at(unit.top_block).signature.has_value());
   VerilogLineMap verilog_line_map;
+  start = absl::Now();
   XLS_ASSIGN_OR_RETURN(
       std::string verilog,
       GenerateVerilog(unit.top_block, pass_options.codegen_options,
                       &verilog_line_map));
+  phase_timing.verilog_generation = absl::Now() - start;
+  ReportTiming(phase_timing, timing);
 
   // TODO: google/xls#1323 - add all block signatures to ModuleGeneratorResult,
   // not just top.
@@ -91,7 +122,8 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PackagePipelineSchedules& schedules, Package* package,
-    const CodegenOptions& options, const DelayEstimator* delay_estimator) {
+    const CodegenOptions& options, const DelayEstimator* delay_estimator,
+    PipelineGeneratorTiming* timing) {
   XLS_VLOG(2) << "Generating pipelined module for module:";
   XLS_VLOG_LINES(2, package->DumpIr());
   if (VLOG_IS_ON(2)) {
@@ -105,8 +137,11 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   pass_options.delay_estimator = delay_estimator;
 
   // Convert to block and add in pipe stages according to schedule.
+  PipelineGeneratorTiming phase_timing;
+  absl::Time start = absl::Now();
   XLS_ASSIGN_OR_RETURN(CodegenPassUnit unit,
                        PackageToPipelinedBlocks(schedules, options, package));
+  phase_timing.block_conversion = absl::Now() - start;
   if (std::any_of(
           schedules.begin(), schedules.end(),
           [](const std::pair<FunctionBase*, PipelineSchedule>& element) {
@@ -120,15 +155,21 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   }
 
   PassResults results;
+  start = absl::Now();
   XLS_RETURN_IF_ERROR(
       CreateCodegenPassPipeline()->Run(&unit, pass_options, &results).status());
+  phase_timing.pass_pipeline = absl::Now() - start;
+  phase_timing.pass_invocations = std::move(results.invocations);
   XLS_RET_CHECK(unit.top_block != nullptr &&
                 unit.metadata.contains(unit.top_block) &&
                 unit.metadata.at(unit.top_block).signature.has_value());
   VerilogLineMap verilog_line_map;
+  start = absl::Now();
   XLS_ASSIGN_OR_RETURN(
       std::string verilog,
       GenerateVerilog(unit.top_block, options, &verilog_line_map));
+  phase_timing.verilog_generation = absl::Now() - start;
+  ReportTiming(phase_timing, timing);
 
   // TODO: google/xls#1323 - add all block signatures to ModuleGeneratorResult,
   // not just top.
@@ -16,8 +16,10 @@
 #define XLS_CODEGEN_PIPELINE_GENERATOR_H_
 
 #include <string>
+#include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/module_signature.pb.h"
@@ -27,6 +29,7 @@
 #include "xls/ir/function.h"
 #include "xls/ir/function_base.h"
 #include "xls/ir/package.h"
+#include "xls/passes/pass_base.h"
 #include "xls/scheduling/pipeline_schedule.h"
 
 namespace xls {
@@ -41,34 +44,54 @@ inline CodegenOptions BuildPipelineOptions() {
       .emit_as_pipeline(true);
 }
 
+// Wall-clock time spent in each phase of generating a pipelined module. Used
+// to profile codegen of large designs.
+struct PipelineGeneratorTiming {
+  // Conversion of the scheduled function/proc(s) into block(s), including the
+  // insertion of pipeline registers and flow control.
+  absl::Duration block_conversion;
+  // The codegen pass pipeline (see CreateCodegenPassPipeline).
+  absl::Duration pass_pipeline;
+  // Generation of the Verilog text from the final block.
+  absl::Duration verilog_generation;
+  // Each invocation of a pass in the codegen pass pipeline, in order.
+  std::vector<PassInvocation> pass_invocations;
+};
+
 // Emits the given function as a verilog module which follows the given
 // schedule. The module is pipelined with a latency and initiation interval
 // given in the signature.
 // If a delay estimator is provided, the signature also includes delay
 // information about the pipeline stages.
+// If `timing` is non-null, the time spent in each phase is written to it.
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
     const CodegenOptions& options = BuildPipelineOptions(),
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    PipelineGeneratorTiming* timing = nullptr);
 
 // Emits the given function or proc as a verilog module which follows the given
 // schedule. The module is pipelined with a latency and initiation interval
 // given in the signature.
 // If a delay estimator is provided, the signature also includes delay
 // information about the pipeline stages.
+// If `timing` is non-null, the time spent in each phase is written to it.
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, FunctionBase* module,
     const CodegenOptions& options = BuildPipelineOptions(),
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    PipelineGeneratorTiming* timing = nullptr);
 
 // Emits the given package as a verilog module which follows the given
 // schedules. Modules are pipelined with a latency and initiation interval
 // given in the signature. If a delay estimator is provided, the signature also
-// includes delay information about the pipeline stages.
+// includes delay information about the pipeline stages. If `timing` is
+// non-null, the time spent in each phase is written to it.
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PackagePipelineSchedules& schedules, Package* package,
     const CodegenOptions& options = BuildPipelineOptions(),
-    const DelayEstimator* delay_estimator = nullptr);
+    const DelayEstimator* delay_estimator = nullptr,
+    PipelineGeneratorTiming* timing = nullptr);
 
 }  // namespace verilog
 }  // namespace xls
@@ -18,12 +18,16 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/substitute.h"
+#include "absl/time/time.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/module_signature.pb.h"
 #include "xls/common/status/matchers.h"
@@ -48,6 +52,7 @@ namespace {
 using status_testing::IsOkAndHolds;
 using ::testing::ContainsRegex;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
 using ::testing::Not;
 
 constexpr char kTestName[] = "pipeline_generator_test";
@@ -1158,11 +1163,86 @@ proc ii_greater_than_one(tkn: token, st: bits[32], init={0}) {
                                  result.verilog_text);
 }
 
+TEST_P(PipelineGeneratorTest, ReportsPhaseTiming) {
+  Package package(TestBaseName());
+  FunctionBuilder fb(TestBaseName(), &package);
+  Type* u32 = package.GetBitsType(32);
+  BValue a = fb.Param("a", u32);
+  BValue b = fb.Param("b", u32);
+  fb.Negate(fb.Add(a, b));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      RunPipelineSchedule(func, TestDelayEstimator(),
+                          SchedulingOptions().pipeline_stages(2)));
+  PipelineGeneratorTiming timing;
+  XLS_ASSERT_OK(ToPipelineModuleText(
+                    schedule, func,
+                    BuildPipelineOptions().use_system_verilog(
+                        UseSystemVerilog()),
+                    /*delay_estimator=*/nullptr, &timing)
+                    .status());
+  EXPECT_GE(timing.block_conversion, absl::ZeroDuration());
+  EXPECT_GE(timing.pass_pipeline, absl::ZeroDuration());
+  EXPECT_GE(timing.verilog_generation, absl::ZeroDuration());
+  EXPECT_THAT(timing.pass_invocations, Not(IsEmpty()));
+}
+
 INSTANTIATE_TEST_SUITE_P(PipelineGeneratorTestInstantiation,
                          PipelineGeneratorTest,
                          testing::ValuesIn(kDefaultSimulationTargets),
                          ParameterizedTestName<PipelineGeneratorTest>);
 
+// Builds a function of `lanes` independent chains of `depth` adds which are
+// spread evenly over `stages` pipeline stages, so that every pipeline register
+// boundary carries one value per lane.
+void BM_PipelineGeneratorDeepPipeline(benchmark::State& state) {
+  const int64_t stages = state.range(0);
+  const int64_t lanes = state.range(1);
+  const int64_t depth = state.range(2);
+
+  Package package("benchmark");
+  FunctionBuilder fb("deep_pipeline", &package);
+  Type* u32 = package.GetBitsType(32);
+  BValue a = fb.Param("a", u32);
+  BValue b = fb.Param("b", u32);
+  ScheduleCycleMap cycle_map;
+  cycle_map[a.node()] = 0;
+  cycle_map[b.node()] = 0;
+  std::vector<BValue> lane_results;
+  for (int64_t lane = 0; lane < lanes; ++lane) {
+    BValue lane_id = fb.Literal(UBits(lane, 32));
+    cycle_map[lane_id.node()] = 0;
+    BValue value = fb.Add(a, lane_id);
+    cycle_map[value.node()] = 0;
+    for (int64_t d = 1; d < depth; ++d) {
+      value = fb.Add(value, b);
+      cycle_map[value.node()] = d * stages / depth;
+    }
+    lane_results.push_back(value);
+  }
+  BValue result = fb.Xor(lane_results);
+  cycle_map[result.node()] = stages - 1;
+  CHECK_OK(fb.Build().status());
+  Function* func = package.GetFunction("deep_pipeline").value();
+  PipelineSchedule schedule(func, cycle_map, stages);
+
+  for (auto _ : state) {
+    CHECK_OK(ToPipelineModuleText(schedule, func,
+                                  BuildPipelineOptions()
+                                      .valid_control("in_valid", "out_valid")
+                                      .reset("rst", /*asynchronous=*/false,
+                                             /*active_low=*/false,
+                                             /*reset_data_path=*/false))
+                 .status());
+  }
+  state.SetItemsProcessed(state.iterations() * func->node_count());
+}
+BENCHMARK(BM_PipelineGeneratorDeepPipeline)
+    ->ArgsProduct({{8, 64}, {64}, {256}})
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace
 }  // namespace verilog
 }  // namespace xls
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -33,8 +34,8 @@
 #include "absl/strings/str_replace.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
-#include "xls/common/indent.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/visitor.h"
 #include "xls/ir/bits_ops.h"
@@ -112,6 +113,20 @@ void LineInfo::End(const VastNode* node) {
 
 void LineInfo::Increase(int64_t delta) { current_line_number_ += delta; }
 
+void LineInfo::Append(const LineInfo& other) {
+  for (const auto& [node, other_spans] : other.spans_) {
+    CHECK(!other_spans.hanging_start_line.has_value())
+        << "LineInfo::Append called with a hanging span!";
+    PartialLineSpans& spans = spans_[node];
+    for (const LineSpan& span : other_spans.completed_spans) {
+      spans.completed_spans.push_back(
+          LineSpan(span.StartLine() + current_line_number_,
+                   span.EndLine() + current_line_number_));
+    }
+  }
+  current_line_number_ += other.current_line_number_;
+}
+
 std::optional<std::vector<LineSpan>> LineInfo::LookupNode(
     const VastNode* node) const {
   if (!spans_.contains(node)) {
@@ -123,6 +138,13 @@ std::optional<std::vector<LineSpan>> LineInfo::LookupNode(
   return spans_.at(node).completed_spans;
 }
 
+std::string VastNode::EmitToString(LineInfo* line_info) const {
+  std::string result;
+  VastSink sink(&result);
+  EmitTo(line_info, &sink);
+  return result;
+}
+
 std::string SanitizeIdentifier(std::string_view name) {
   if (name.empty()) {
     return "_";
@@ -212,21 +234,58 @@ UnpackedArrayType* VerilogFile::UnpackedArrayType(
 }
 
 std::string VerilogFile::Emit(LineInfo* line_info) const {
-  auto file_member_str = [=](const FileMember& member) -> std::string {
-    return absl::visit(
-        Visitor{[=](Include* m) -> std::string { return m->Emit(line_info); },
-                [=](Module* m) -> std::string { return m->Emit(line_info); },
-                [=](BlankLine* m) -> std::string { return m->Emit(line_info); },
-                [=](Comment* m) -> std::string { return m->Emit(line_info); }},
+  std::string out;
+  VastSink sink(&out);
+  EmitTo(line_info, &sink);
+  return out;
+}
+
+void VerilogFile::EmitTo(LineInfo* line_info, VastSink* sink,
+                         int64_t threads) const {
+  auto emit_file_member = [](const FileMember& member, LineInfo* line_info,
+                             VastSink* sink) {
+    absl::visit(
+        Visitor{[=](Include* m) { m->EmitTo(line_info, sink); },
+                [=](Module* m) { m->EmitTo(line_info, sink); },
+                [=](BlankLine* m) { m->EmitTo(line_info, sink); },
+                [=](Comment* m) { m->EmitTo(line_info, sink); }},
         member);
   };
 
-  std::string out;
-  for (const FileMember& member : members_) {
-    absl::StrAppend(&out, file_member_str(member), "\n");
-    LineInfoIncrease(line_info, 1);
+  if (threads <= 1 || members_.size() <= 1) {
+    for (const FileMember& member : members_) {
+      emit_file_member(member, line_info, sink);
+      sink->Write("\n");
+      LineInfoIncrease(line_info, 1);
+    }
+    return;
+  }
+
+  // Emit each member into its own buffer, recording its line information
+  // relative to the start of the member. Emission only reads the VAST so the
+  // members can be emitted concurrently.
+  struct EmittedMember {
+    std::string text;
+    LineInfo line_info;
+  };
+  std::vector<EmittedMember> emitted(members_.size());
+  ParallelFor(members_.size(), threads, [&](int64_t i) {
+    VastSink member_sink(&emitted[i].text);
+    emit_file_member(members_[i],
+                     line_info == nullptr ? nullptr : &emitted[i].line_info,
+                     &member_sink);
+  });
+
+  for (EmittedMember& member : emitted) {
+    sink->Write(member.text);
+    sink->Write("\n");
+    if (line_info != nullptr) {
+      line_info->Append(member.line_info);
+      line_info->Increase(1);
+    }
+    // Release the text as soon as it has been written.
+    std::string().swap(member.text);
   }
-  return out;
 }
 
 LocalParamItemRef* LocalParam::AddItem(std::string_view name,
@@ -251,24 +310,28 @@ std::string CaseArm::Emit(LineInfo* line_info) const {
   return result;
 }
 
-std::string StatementBlock::Emit(LineInfo* line_info) const {
+void StatementBlock::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
   // TODO(meheff): We can probably be smarter about optionally emitting the
   // begin/end.
   if (statements_.empty()) {
     LineInfoEnd(line_info, this);
-    return "begin end";
+    sink->Write("begin end");
+    return;
   }
-  std::string result = "begin\n";
+  sink->Write("begin\n");
   LineInfoIncrease(line_info, 1);
-  std::vector<std::string> lines;
-  for (const auto& statement : statements_) {
-    lines.push_back(statement->Emit(line_info));
+  sink->Indent();
+  for (int64_t i = 0; i < statements_.size(); ++i) {
+    if (i != 0) {
+      sink->Write("\n");
+    }
+    statements_[i]->EmitTo(line_info, sink);
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(absl::StrJoin(lines, "\n")), "\nend");
+  sink->Dedent();
+  sink->Write("\nend");
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 Port Port::FromProto(const PortProto& proto, VerilogFile* f) {
@@ -312,7 +375,7 @@ LogicRef* VerilogFunction::return_value_ref() {
   return file()->Make<LogicRef>(return_value_def_->loc(), return_value_def_);
 }
 
-std::string VerilogFunction::Emit(LineInfo* line_info) const {
+void VerilogFunction::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
   std::string return_type =
       return_value_def_->data_type()->EmitWithIdentifier(line_info, name());
@@ -320,18 +383,20 @@ std::string VerilogFunction::Emit(LineInfo* line_info) const {
       absl::StrJoin(argument_defs_, ", ", [=](std::string* out, RegDef* d) {
         absl::StrAppend(out, "input ", d->EmitNoSemi(line_info));
       });
+  sink->Write(
+      absl::StrFormat("function automatic%s (%s);\n", return_type, parameters));
   LineInfoIncrease(line_info, 1);
-  std::vector<std::string> lines;
+  sink->Indent();
   for (RegDef* reg_def : block_reg_defs_) {
-    lines.push_back(reg_def->Emit(line_info));
+    reg_def->EmitTo(line_info, sink);
+    sink->Write("\n");
     LineInfoIncrease(line_info, 1);
   }
-  lines.push_back(statement_block_->Emit(line_info));
+  statement_block_->EmitTo(line_info, sink);
   LineInfoIncrease(line_info, 1);
+  sink->Dedent();
+  sink->Write("\nendfunction");
   LineInfoEnd(line_info, this);
-  return absl::StrCat(
-      absl::StrFormat("function automatic%s (%s);\n", return_type, parameters),
-      Indent(absl::StrJoin(lines, "\n")), "\nendfunction");
 }
 
 std::string VerilogFunctionCall::Emit(LineInfo* line_info) const {
@@ -458,6 +523,11 @@ std::string FourValueBinaryLiteral::Emit(LineInfo* line_info) const {
                       absl::StrJoin(bits_, "", FourValueFormatter));
 }
 
+// Returns the given string wrapped in parentheses.
+static std::string ParenWrap(std::string_view s) {
+  return absl::StrFormat("(%s)", s);
+}
+
 // Returns a string representation of the given expression minus one.
 static std::string WidthToLimit(LineInfo* line_info, Expression* expr) {
   if (expr->IsLiteral()) {
@@ -465,9 +535,15 @@ static std::string WidthToLimit(LineInfo* line_info, Expression* expr) {
     uint64_t value = expr->AsLiteralOrDie()->bits().ToUint64().value();
     return absl::StrCat(value - 1);
   }
-  Literal* one = expr->file()->PlainLiteral(1, expr->loc());
-  Expression* width_minus_one = expr->file()->Sub(expr, one, expr->loc());
-  return width_minus_one->Emit(line_info);
+  // Emit the text of `expr - 1` as BinaryInfix would for VerilogFile::Sub.
+  // Nodes are not created here because emission must not mutate the file
+  // (files may be emitted concurrently, see VerilogFile::EmitTo).
+  std::string expr_string = expr->Emit(line_info);
+  if (expr->precedence() < Expression::kAddSubPrecedence ||
+      (expr->IsUnary() && expr->AsUnaryOrDie()->IsReduction())) {
+    expr_string = ParenWrap(expr_string);
+  }
+  return absl::StrCat(expr_string, " - 1");
 }
 
 std::string ScalarType::EmitWithIdentifier(LineInfo* line_info,
@@ -684,46 +760,50 @@ std::string IntegerDef::Emit(LineInfo* line_info) const {
 namespace {
 
 // "Match" statement for emitting a ModuleMember.
-std::string EmitModuleMember(LineInfo* line_info, const ModuleMember& member) {
-  return absl::visit(
-      Visitor{[=](Def* d) { return d->Emit(line_info); },
-              [=](LocalParam* p) { return p->Emit(line_info); },
-              [=](Parameter* p) { return p->Emit(line_info); },
-              [=](Instantiation* i) { return i->Emit(line_info); },
-              [=](ContinuousAssignment* c) { return c->Emit(line_info); },
-              [=](Comment* c) { return c->Emit(line_info); },
-              [=](BlankLine* b) { return b->Emit(line_info); },
-              [=](InlineVerilogStatement* s) { return s->Emit(line_info); },
-              [=](StructuredProcedure* sp) { return sp->Emit(line_info); },
-              [=](AlwaysComb* ac) { return ac->Emit(line_info); },
-              [=](AlwaysFf* af) { return af->Emit(line_info); },
-              [=](AlwaysFlop* af) { return af->Emit(line_info); },
-              [=](VerilogFunction* f) { return f->Emit(line_info); },
-              [=](Cover* c) { return c->Emit(line_info); },
-              [=](ConcurrentAssertion* ca) { return ca->Emit(line_info); },
-              [=](ModuleSection* s) { return s->Emit(line_info); }},
+void EmitModuleMember(LineInfo* line_info, VastSink* sink,
+                      const ModuleMember& member) {
+  absl::visit(
+      Visitor{[=](Def* d) { d->EmitTo(line_info, sink); },
+              [=](LocalParam* p) { p->EmitTo(line_info, sink); },
+              [=](Parameter* p) { p->EmitTo(line_info, sink); },
+              [=](Instantiation* i) { i->EmitTo(line_info, sink); },
+              [=](ContinuousAssignment* c) { c->EmitTo(line_info, sink); },
+              [=](Comment* c) { c->EmitTo(line_info, sink); },
+              [=](BlankLine* b) { b->EmitTo(line_info, sink); },
+              [=](InlineVerilogStatement* s) { s->EmitTo(line_info, sink); },
+              [=](StructuredProcedure* sp) { sp->EmitTo(line_info, sink); },
+              [=](AlwaysComb* ac) { ac->EmitTo(line_info, sink); },
+              [=](AlwaysFf* af) { af->EmitTo(line_info, sink); },
+              [=](AlwaysFlop* af) { af->EmitTo(line_info, sink); },
+              [=](VerilogFunction* f) { f->EmitTo(line_info, sink); },
+              [=](Cover* c) { c->EmitTo(line_info, sink); },
+              [=](ConcurrentAssertion* ca) { ca->EmitTo(line_info, sink); },
+              [=](ModuleSection* s) { s->EmitTo(line_info, sink); }},
       member);
 }
 
 }  // namespace
 
-std::string ModuleSection::Emit(LineInfo* line_info) const {
+void ModuleSection::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::vector<std::string> elements;
+  bool emitted_element = false;
   for (const ModuleMember& member : members_) {
     if (std::holds_alternative<ModuleSection*>(member)) {
       if (std::get<ModuleSection*>(member)->members_.empty()) {
         continue;
       }
     }
-    elements.push_back(EmitModuleMember(line_info, member));
+    if (emitted_element) {
+      sink->Write("\n");
+    }
+    EmitModuleMember(line_info, sink, member);
     LineInfoIncrease(line_info, 1);
+    emitted_element = true;
   }
-  if (!elements.empty()) {
+  if (emitted_element) {
     LineInfoIncrease(line_info, -1);
   }
   LineInfoEnd(line_info, this);
-  return absl::StrJoin(elements, "\n");
 }
 
 std::string ContinuousAssignment::Emit(LineInfo* line_info) const {
@@ -827,30 +907,33 @@ std::string SystemFunctionCall::Emit(LineInfo* line_info) const {
   return absl::StrFormat("$%s", name_);
 }
 
-std::string Module::Emit(LineInfo* line_info) const {
+void Module::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string result = absl::StrCat("module ", name_);
+  sink->Write(absl::StrCat("module ", name_));
   if (ports_.empty()) {
-    absl::StrAppend(&result, ";\n");
+    sink->Write(";\n");
     LineInfoIncrease(line_info, 1);
   } else {
-    absl::StrAppend(&result, "(\n  ");
+    sink->Write("(\n  ");
     LineInfoIncrease(line_info, 1);
-    absl::StrAppend(
-        &result,
-        absl::StrJoin(ports_, ",\n  ", [=](std::string* out, const Port& port) {
-          absl::StrAppendFormat(out, "%s %s", ToString(port.direction),
-                                port.wire->EmitNoSemi(line_info));
-          LineInfoIncrease(line_info, 1);
-        }));
-    absl::StrAppend(&result, "\n);\n");
+    for (int64_t i = 0; i < ports_.size(); ++i) {
+      if (i != 0) {
+        sink->Write(",\n  ");
+      }
+      sink->Write(absl::StrFormat("%s %s", ToString(ports_[i].direction),
+                                  ports_[i].wire->EmitNoSemi(line_info)));
+      LineInfoIncrease(line_info, 1);
+    }
+    sink->Write("\n);\n");
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, Indent(top_.Emit(line_info)), "\n");
+  sink->Indent();
+  top_.EmitTo(line_info, sink);
+  sink->Dedent();
+  sink->Write("\n");
   LineInfoIncrease(line_info, 1);
-  absl::StrAppend(&result, "endmodule");
+  sink->Write("endmodule");
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string Literal::Emit(LineInfo* line_info) const {
@@ -954,11 +1037,6 @@ std::string Index::Emit(LineInfo* line_info) const {
   return absl::StrFormat("%s[%s]", subject, index);
 }
 
-// Returns the given string wrapped in parentheses.
-static std::string ParenWrap(std::string_view s) {
-  return absl::StrFormat("(%s)", s);
-}
-
 std::string Ternary::Emit(LineInfo* line_info) const {
   auto maybe_paren_wrap = [this, line_info](Expression* e) {
     if (e->precedence() <= precedence()) {
@@ -1114,22 +1192,21 @@ static std::string CaseTypeToString(CaseType case_type) {
   return keyword;
 }
 
-std::string Case::Emit(LineInfo* line_info) const {
+void Case::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string result = absl::StrFormat(
-      "%s (%s)\n", CaseTypeToString(case_type_), subject_->Emit(line_info));
+  sink->Write(absl::StrFormat("%s (%s)\n", CaseTypeToString(case_type_),
+                              subject_->Emit(line_info)));
   LineInfoIncrease(line_info, 1);
+  sink->Indent();
   for (auto& arm : arms_) {
-    std::string arm_string = arm->Emit(line_info);
-    std::string stmts_string = arm->statements()->Emit(line_info);
-    absl::StrAppend(&result,
-                    Indent(absl::StrFormat("%s: %s", arm_string, stmts_string)),
-                    "\n");
+    sink->Write(absl::StrCat(arm->Emit(line_info), ": "));
+    arm->statements()->EmitTo(line_info, sink);
+    sink->Write("\n");
     LineInfoIncrease(line_info, 1);
   }
-  absl::StrAppend(&result, "endcase");
+  sink->Dedent();
+  sink->Write("endcase");
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 Conditional::Conditional(Expression* condition, VerilogFile* file,
@@ -1147,22 +1224,18 @@ StatementBlock* Conditional::AddAlternate(Expression* condition) {
   return alternates_.back().second;
 }
 
-std::string Conditional::Emit(LineInfo* line_info) const {
+void Conditional::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string result;
-  std::string cond = condition_->Emit(line_info);
-  std::string conseq = consequent()->Emit(line_info);
-  absl::StrAppendFormat(&result, "if (%s) %s", cond, conseq);
+  sink->Write(absl::StrFormat("if (%s) ", condition_->Emit(line_info)));
+  consequent()->EmitTo(line_info, sink);
   for (auto& alternate : alternates_) {
-    absl::StrAppend(&result, " else ");
+    sink->Write(" else ");
     if (alternate.first != nullptr) {
-      absl::StrAppendFormat(&result, "if (%s) ",
-                            alternate.first->Emit(line_info));
+      sink->Write(absl::StrFormat("if (%s) ", alternate.first->Emit(line_info)));
     }
-    absl::StrAppend(&result, alternate.second->Emit(line_info));
+    alternate.second->EmitTo(line_info, sink);
   }
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 WhileStatement::WhileStatement(Expression* condition, VerilogFile* file,
@@ -1171,12 +1244,11 @@ WhileStatement::WhileStatement(Expression* condition, VerilogFile* file,
       condition_(condition),
       statements_(file->Make<StatementBlock>(loc)) {}
 
-std::string WhileStatement::Emit(LineInfo* line_info) const {
+void WhileStatement::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string condition = condition_->Emit(line_info);
-  std::string stmts = statements()->Emit(line_info);
+  sink->Write(absl::StrFormat("while (%s) ", condition_->Emit(line_info)));
+  statements()->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return absl::StrFormat("while (%s) %s", condition, stmts);
 }
 
 RepeatStatement::RepeatStatement(Expression* repeat_count, VerilogFile* file,
@@ -1185,12 +1257,11 @@ RepeatStatement::RepeatStatement(Expression* repeat_count, VerilogFile* file,
       repeat_count_(repeat_count),
       statements_(file->Make<StatementBlock>(loc)) {}
 
-std::string RepeatStatement::Emit(LineInfo* line_info) const {
+void RepeatStatement::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string repeat_count = repeat_count_->Emit(line_info);
-  std::string stmts = statements()->Emit(line_info);
+  sink->Write(absl::StrFormat("repeat (%s) ", repeat_count_->Emit(line_info)));
+  statements()->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return absl::StrFormat("repeat (%s) %s", repeat_count, stmts);
 }
 
 std::string EventControl::Emit(LineInfo* line_info) const {
@@ -1239,11 +1310,11 @@ std::string WaitStatement::Emit(LineInfo* line_info) const {
   return result;
 }
 
-std::string Forever::Emit(LineInfo* line_info) const {
+void Forever::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string result = absl::StrCat("forever ", statement_->Emit(line_info));
+  sink->Write("forever ");
+  statement_->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string BlockingAssignment::Emit(LineInfo* line_info) const {
@@ -1280,7 +1351,7 @@ std::string EmitSensitivityListElement(LineInfo* line_info,
 
 }  // namespace
 
-std::string AlwaysBase::Emit(LineInfo* line_info) const {
+void AlwaysBase::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
   LineInfoIncrease(line_info, NumberOfNewlines(name()));
   std::string sensitivity_list = absl::StrJoin(
@@ -1288,25 +1359,24 @@ std::string AlwaysBase::Emit(LineInfo* line_info) const {
       [=](std::string* out, const SensitivityListElement& e) {
         absl::StrAppend(out, EmitSensitivityListElement(line_info, e));
       });
-  std::string statements = statements_->Emit(line_info);
+  sink->Write(absl::StrFormat("%s @ (%s) ", name(), sensitivity_list));
+  statements_->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return absl::StrFormat("%s @ (%s) %s", name(), sensitivity_list, statements);
 }
 
-std::string AlwaysComb::Emit(LineInfo* line_info) const {
+void AlwaysComb::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
   LineInfoIncrease(line_info, NumberOfNewlines(name()));
-  std::string result =
-      absl::StrFormat("%s %s", name(), statements_->Emit(line_info));
+  sink->Write(absl::StrCat(name(), " "));
+  statements_->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
-std::string Initial::Emit(LineInfo* line_info) const {
+void Initial::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string result = absl::StrCat("initial ", statements_->Emit(line_info));
+  sink->Write("initial ");
+  statements_->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 AlwaysFlop::AlwaysFlop(LogicRef* clk, Reset rst, VerilogFile* file,
@@ -1346,9 +1416,8 @@ void AlwaysFlop::AddRegister(LogicRef* reg, Expression* reg_next,
   assignment_block_->Add<NonblockingAssignment>(loc, reg, reg_next);
 }
 
-std::string AlwaysFlop::Emit(LineInfo* line_info) const {
+void AlwaysFlop::EmitTo(LineInfo* line_info, VastSink* sink) const {
   LineInfoStart(line_info, this);
-  std::string result;
   std::string sensitivity_list =
       absl::StrCat("posedge ", clk_->Emit(line_info));
   if (rst_.has_value() && rst_->asynchronous) {
@@ -1356,10 +1425,9 @@ std::string AlwaysFlop::Emit(LineInfo* line_info) const {
                           (rst_->active_low ? "negedge" : "posedge"),
                           rst_->signal->Emit(line_info));
   }
-  absl::StrAppendFormat(&result, "always @ (%s) %s", sensitivity_list,
-                        top_block_->Emit(line_info));
+  sink->Write(absl::StrFormat("always @ (%s) ", sensitivity_list));
+  top_block_->EmitTo(line_info, sink);
   LineInfoEnd(line_info, this);
-  return result;
 }
 
 std::string Instantiation::Emit(LineInfo* line_info) const {
@@ -36,6 +36,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "xls/codegen/module_signature.pb.h"
+#include "xls/codegen/vast_sink.h"
 #include "xls/common/logging/logging.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/format_preference.h"
@@ -142,6 +143,13 @@ class LineInfo {
   // Returns std::nullopt if the given node was never recorded.
   std::optional<std::vector<LineSpan>> LookupNode(const VastNode* node) const;
 
+  // Adds the spans recorded in `other` as if they had been recorded here
+  // starting at the current line, then advances the current line by the number
+  // of lines `other` advanced. Used to combine the line information of text
+  // emitted separately (e.g., concurrently). CHECK fails if `other` has a
+  // hanging span.
+  void Append(const LineInfo& other);
+
  private:
   int64_t current_line_number_ = 0;
   absl::flat_hash_map<const VastNode*, PartialLineSpans> spans_;
@@ -165,6 +173,20 @@ class VastNode {
 
   virtual std::string Emit(LineInfo* line_info) const = 0;
 
+  // Writes the text of the node to the given sink, recording line information
+  // exactly as Emit does. By default this writes the string returned by Emit.
+  // Nodes which span many lines (modules, procedures, statement blocks, etc.)
+  // override this to write their contents piece by piece at the sink's current
+  // indentation rather than building (and re-indenting) the text of all of
+  // their children.
+  virtual void EmitTo(LineInfo* line_info, VastSink* sink) const {
+    sink->Write(Emit(line_info));
+  }
+
+ protected:
+  // Implements Emit for nodes which override EmitTo.
+  std::string EmitToString(LineInfo* line_info) const;
+
  private:
   VerilogFile* file_;
   SourceInfo loc_;
@@ -503,7 +525,10 @@ class Forever : public Statement {
   Forever(Statement* statement, VerilogFile* file, const SourceInfo& loc)
       : Statement(file, loc), statement_(statement) {}
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   Statement* statement_;
@@ -549,7 +574,10 @@ class StatementBlock : public VastNode {
   template <typename T, typename... Args>
   inline T* Add(const SourceInfo& loc, Args&&... args);
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   std::vector<Statement*> statements_;
@@ -607,7 +635,10 @@ class Case : public Statement {
 
   StatementBlock* AddCaseArm(CaseLabel label);
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   Expression* subject_;
@@ -628,7 +659,10 @@ class Conditional : public Statement {
   // if a final alternate ("else") clause has been previously added.
   StatementBlock* AddAlternate(Expression* condition = nullptr);
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   Expression* condition_;
@@ -646,7 +680,10 @@ class WhileStatement : public Statement {
   WhileStatement(Expression* condition, VerilogFile* file,
                  const SourceInfo& loc);
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
   StatementBlock* statements() const { return statements_; }
 
@@ -661,7 +698,10 @@ class RepeatStatement : public Statement {
   RepeatStatement(Expression* repeat_count, VerilogFile* file,
                   const SourceInfo& loc);
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
   StatementBlock* statements() const { return statements_; }
 
@@ -740,6 +780,8 @@ class Expression : public VastNode {
   //   Lowest:    (0)  ?: (conditional operator)
   static constexpr int64_t kMaxPrecedence = 13;
   static constexpr int64_t kMinPrecedence = -1;
+  // Precedence of binary + and -.
+  static constexpr int64_t kAddSubPrecedence = 9;
   virtual int64_t precedence() const { return kMaxPrecedence; }
 };
 
@@ -1024,7 +1066,10 @@ class AlwaysFlop : public VastNode {
   void AddRegister(LogicRef* reg, Expression* reg_next, const SourceInfo& loc,
                    Expression* reset_value = nullptr);
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   LogicRef* clk_;
@@ -1065,7 +1110,10 @@ class AlwaysBase : public StructuredProcedure {
              VerilogFile* file, const SourceInfo& loc)
       : StructuredProcedure(file, loc),
         sensitivity_list_(sensitivity_list.begin(), sensitivity_list.end()) {}
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  protected:
   virtual std::string name() const = 0;
@@ -1089,7 +1137,10 @@ class AlwaysComb : public AlwaysBase {
  public:
   explicit AlwaysComb(VerilogFile* file, const SourceInfo& loc)
       : AlwaysBase({}, file, loc) {}
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  protected:
   std::string name() const override { return "always_comb"; }
@@ -1109,7 +1160,10 @@ class Initial : public StructuredProcedure {
  public:
   using StructuredProcedure::StructuredProcedure;
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 };
 
 class Concat : public Expression {
@@ -1532,7 +1586,10 @@ class VerilogFunction : public VastNode {
   // Returns the name of the function.
   std::string name() const { return name_; }
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   std::string name_;
@@ -1610,7 +1667,10 @@ class ModuleSection : public VastNode {
   // or any section contained in this section.
   std::vector<ModuleMember> GatherMembers() const;
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   std::vector<ModuleMember> members_;
@@ -1677,7 +1737,10 @@ class Module : public VastNode {
   absl::Span<const Port> ports() const { return ports_; }
   const std::string& name() const { return name_; }
 
-  std::string Emit(LineInfo* line_info) const override;
+  std::string Emit(LineInfo* line_info) const override {
+    return EmitToString(line_info);
+  }
+  void EmitTo(LineInfo* line_info, VastSink* sink) const override;
 
  private:
   // Add the given Def as a port on the module.
@@ -1734,6 +1797,13 @@ class VerilogFile {
 
   std::string Emit(LineInfo* line_info = nullptr) const;
 
+  // Writes the text of the file to the given sink. If `threads` is greater
+  // than one, the members of the file (modules, etc.) are emitted concurrently
+  // on up to that many threads, each into a separate buffer, and the buffers
+  // are written to the sink in order. The text and line information are
+  // identical to those of a sequential emission.
+  void EmitTo(LineInfo* line_info, VastSink* sink, int64_t threads = 1) const;
+
   verilog::Slice* Slice(IndexableExpression* subject, Expression* hi,
                         Expression* lo, const SourceInfo& loc) {
     return Make<verilog::Slice>(loc, subject, hi, lo);
@@ -1810,7 +1880,8 @@ class VerilogFile {
   }
 
   BinaryInfix* Add(Expression* lhs, Expression* rhs, const SourceInfo& loc) {
-    return Make<BinaryInfix>(loc, lhs, "+", rhs, /*precedence=*/9);
+    return Make<BinaryInfix>(loc, lhs, "+", rhs,
+                             Expression::kAddSubPrecedence);
   }
   BinaryInfix* LogicalAnd(Expression* lhs, Expression* rhs,
                           const SourceInfo& loc) {
@@ -1874,7 +1945,8 @@ class VerilogFile {
     return Make<BinaryInfix>(loc, lhs, ">>", rhs, /*precedence=*/8);
   }
   BinaryInfix* Sub(Expression* lhs, Expression* rhs, const SourceInfo& loc) {
-    return Make<BinaryInfix>(loc, lhs, "-", rhs, /*precedence=*/9);
+    return Make<BinaryInfix>(loc, lhs, "-", rhs,
+                             Expression::kAddSubPrecedence);
   }
 
   // Only for use in testing.
@@ -0,0 +1,85 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/codegen/vast_sink.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "absl/log/check.h"
+
+namespace xls {
+namespace verilog {
+
+VastSink::VastSink(std::ostream* out, int64_t buffer_size)
+    : stream_out_(out), buffer_size_(buffer_size) {
+  CHECK_GT(buffer_size, 0);
+  buffer_.reserve(buffer_size);
+}
+
+void VastSink::Write(std::string_view text) {
+  // Splits the text at newlines. Following `Indent`, the indentation is only
+  // emitted ahead of the first character of a non-empty line, so that no
+  // trailing whitespace is created.
+  while (!text.empty()) {
+    std::string_view::size_type newline = text.find('\n');
+    std::string_view line = text.substr(0, newline);
+    if (!line.empty()) {
+      if (at_line_start_) {
+        Append(indentation_);
+      }
+      Append(line);
+      at_line_start_ = false;
+    }
+    if (newline == std::string_view::npos) {
+      break;
+    }
+    Append("\n");
+    at_line_start_ = true;
+    text.remove_prefix(newline + 1);
+  }
+}
+
+void VastSink::Dedent(int64_t spaces) {
+  CHECK_GE(indentation_.size(), spaces);
+  indentation_.resize(indentation_.size() - spaces);
+}
+
+void VastSink::Append(std::string_view text) {
+  bytes_written_ += text.size();
+  if (string_out_ != nullptr) {
+    string_out_->append(text);
+    peak_held_bytes_ = std::max<int64_t>(peak_held_bytes_, string_out_->size());
+    return;
+  }
+  buffer_.append(text);
+  peak_held_bytes_ = std::max<int64_t>(peak_held_bytes_, buffer_.size());
+  if (buffer_.size() >= buffer_size_) {
+    Flush();
+  }
+}
+
+void VastSink::Flush() {
+  if (stream_out_ == nullptr || buffer_.empty()) {
+    return;
+  }
+  stream_out_->write(buffer_.data(), buffer_.size());
+  buffer_.clear();
+}
+
+}  // namespace verilog
+}  // namespace xls
@@ -0,0 +1,91 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_CODEGEN_VAST_SINK_H_
+#define XLS_CODEGEN_VAST_SINK_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "xls/common/indent.h"
+
+namespace xls {
+namespace verilog {
+
+// An output sink for emitted Verilog text which tracks the current
+// indentation. Text written while the indentation is non-zero is indented as
+// if it had been passed through `Indent` once per level, i.e., every non-empty
+// line is prefixed with the indentation. This lets nested constructs be
+// written directly to the output instead of being emitted into a string which
+// the enclosing construct then re-indents.
+//
+// The sink either appends to a string or writes to a stream through a buffer
+// of bounded size, so that arbitrarily large files can be emitted without
+// holding all of their text in memory.
+class VastSink {
+ public:
+  static constexpr int64_t kDefaultBufferSize = int64_t{1} << 16;
+
+  // Appends all text to `*out`.
+  explicit VastSink(std::string* out) : string_out_(out) {}
+
+  // Writes all text to `*out`, which must outlive the sink, whenever at least
+  // `buffer_size` bytes are pending, and on Flush/destruction.
+  explicit VastSink(std::ostream* out,
+                    int64_t buffer_size = kDefaultBufferSize);
+
+  ~VastSink() { Flush(); }
+
+  VastSink(const VastSink&) = delete;
+  VastSink& operator=(const VastSink&) = delete;
+
+  // Writes the given text, indenting each non-empty line which starts in it.
+  void Write(std::string_view text);
+
+  // Increases/decreases the indentation of subsequently written lines.
+  void Indent(int64_t spaces = kDefaultIndentSpaces) {
+    indentation_.append(spaces, ' ');
+  }
+  void Dedent(int64_t spaces = kDefaultIndentSpaces);
+
+  // Passes any buffered text on to the underlying stream.
+  void Flush();
+
+  // Returns the number of bytes written to the sink so far.
+  int64_t bytes_written() const { return bytes_written_; }
+
+  // Returns the largest number of bytes the sink has held at once. For a sink
+  // appending to a string this is the length of the string.
+  int64_t peak_held_bytes() const { return peak_held_bytes_; }
+
+ private:
+  void Append(std::string_view text);
+
+  std::string* string_out_ = nullptr;
+  std::ostream* stream_out_ = nullptr;
+  std::string buffer_;
+  int64_t buffer_size_ = 0;
+
+  std::string indentation_;
+  bool at_line_start_ = true;
+  int64_t bytes_written_ = 0;
+  int64_t peak_held_bytes_ = 0;
+};
+
+}  // namespace verilog
+}  // namespace xls
+
+#endif  // XLS_CODEGEN_VAST_SINK_H_
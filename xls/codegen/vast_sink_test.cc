@@ -0,0 +1,91 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/codegen/vast_sink.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/indent.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+TEST(VastSinkTest, WritesToString) {
+  std::string out;
+  VastSink sink(&out);
+  sink.Write("foo\n");
+  sink.Write("bar");
+  EXPECT_EQ(out, "foo\nbar");
+  EXPECT_EQ(sink.bytes_written(), 7);
+}
+
+TEST(VastSinkTest, IndentationMatchesIndent) {
+  std::string out;
+  VastSink sink(&out);
+  sink.Write("begin\n");
+  sink.Indent();
+  // Lines may be written in pieces, and empty lines are not indented.
+  sink.Write("a = 1;\n\nb");
+  sink.Write(" = 2;\n");
+  sink.Write("begin\n");
+  sink.Indent();
+  sink.Write("c = 3;");
+  sink.Dedent();
+  sink.Write("\nend");
+  sink.Dedent();
+  sink.Write("\nend");
+
+  EXPECT_EQ(out, absl::StrCat("begin\n",
+                              Indent(absl::StrCat("a = 1;\n\nb = 2;\nbegin\n",
+                                                  Indent("c = 3;"), "\nend")),
+                              "\nend"));
+}
+
+TEST(VastSinkTest, WritesToStreamThroughBuffer) {
+  std::ostringstream stream;
+  {
+    VastSink sink(&stream, /*buffer_size=*/4);
+    sink.Write("ab");
+    EXPECT_EQ(stream.str(), "");
+    sink.Indent(1);
+    sink.Write("\ncdef\n");
+    EXPECT_EQ(stream.str(), "ab\n cdef\n");
+    sink.Write("g");
+    sink.Flush();
+    EXPECT_EQ(stream.str(), "ab\n cdef\n g");
+    sink.Write("h");
+  }
+  EXPECT_EQ(stream.str(), "ab\n cdef\n gh");
+}
+
+TEST(VastSinkTest, PeakHeldBytes) {
+  std::string out;
+  VastSink string_sink(&out);
+  string_sink.Write("abc\ndef");
+  EXPECT_EQ(string_sink.peak_held_bytes(), 7);
+
+  std::ostringstream stream;
+  VastSink stream_sink(&stream, /*buffer_size=*/4);
+  stream_sink.Write("abc\ndef\nghijkl");
+  EXPECT_EQ(stream_sink.bytes_written(), 15);
+  EXPECT_EQ(stream_sink.peak_held_bytes(), 6);
+}
+
+}  // namespace
+}  // namespace verilog
+}  // namespace xls
@@ -14,7 +14,11 @@
 
 #include "xls/codegen/vast.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <ostream>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -22,6 +26,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "xls/codegen/vast_sink.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/foreign_function.h"
 #include "xls/ir/number_parser.h"
@@ -1537,12 +1543,180 @@ endmodule)");
             std::vector<LineSpan>{LineSpan(9, 9)});
 }
 
+TEST_P(VastTest, WidthExpressionWithLowPrecedence) {
+  VerilogFile f(GetFileType());
+  Module* m = f.AddModule("top", SourceInfo());
+  ParameterRef* p = m->AddParameter("P", f.PlainLiteral(7, SourceInfo()),
+                                    SourceInfo());
+  DataType* and_type = f.Make<BitVectorType>(
+      SourceInfo(), f.BitwiseAnd(p, p, SourceInfo()), /*is_signed=*/false);
+  DataType* reduction_type = f.Make<BitVectorType>(
+      SourceInfo(), f.OrReduce(p, SourceInfo()), /*is_signed=*/false);
+  DataType* ref_type =
+      f.Make<BitVectorType>(SourceInfo(), p, /*is_signed=*/false);
+  m->AddWire("a", and_type, SourceInfo());
+  m->AddWire("b", reduction_type, SourceInfo());
+  m->AddWire("c", ref_type, SourceInfo());
+  EXPECT_EQ(m->Emit(nullptr),
+            R"(module top;
+  parameter P = 7;
+  wire [(P & P) - 1:0] a;
+  wire [(|P) - 1:0] b;
+  wire [P - 1:0] c;
+endmodule)");
+}
+
+// Adds `module_count` modules, each containing a mix of the multi-line
+// constructs which are streamed by EmitTo, to the given file. Returns the
+// modules.
+std::vector<Module*> AddModulesForEmission(VerilogFile* f,
+                                           int64_t module_count,
+                                           int64_t registers_per_module) {
+  std::vector<Module*> modules;
+  f->Add(f->Make<Comment>(SourceInfo(), "Generated for emission tests."));
+  for (int64_t i = 0; i < module_count; ++i) {
+    Module* m = f->AddModule(absl::StrCat("m", i), SourceInfo());
+    modules.push_back(m);
+    LogicRef* clk =
+        m->AddInput("clk", f->BitVectorType(1, SourceInfo()), SourceInfo());
+    LogicRef* rst =
+        m->AddInput("rst", f->BitVectorType(1, SourceInfo()), SourceInfo());
+    LogicRef* in =
+        m->AddInput("in", f->BitVectorType(8, SourceInfo()), SourceInfo());
+    LogicRef* out =
+        m->AddOutput("out", f->BitVectorType(8, SourceInfo()), SourceInfo());
+    ModuleSection* section = m->Add<ModuleSection>(SourceInfo());
+    section->Add<Comment>(SourceInfo(), "registers");
+
+    VerilogFunction* func = m->Add<VerilogFunction>(
+        SourceInfo(), "incr", f->BitVectorType(8, SourceInfo()));
+    LogicRef* arg =
+        func->AddArgument("x", f->BitVectorType(8, SourceInfo()), SourceInfo());
+    func->AddStatement<BlockingAssignment>(
+        SourceInfo(), func->return_value_ref(),
+        f->Add(arg, f->PlainLiteral(1, SourceInfo()), SourceInfo()));
+
+    AlwaysFlop* flop = m->Add<AlwaysFlop>(
+        SourceInfo(), clk, Reset{rst, /*async*/ true, /*active_low*/ false});
+    Expression* previous = in;
+    for (int64_t r = 0; r < registers_per_module; ++r) {
+      LogicRef* reg =
+          m->AddReg(absl::StrCat("r", r), f->BitVectorType(8, SourceInfo()),
+                    SourceInfo(), /*init=*/nullptr, section);
+      flop->AddRegister(
+          reg,
+          f->Make<VerilogFunctionCall>(SourceInfo(), func,
+                                       std::vector<Expression*>{previous}),
+          SourceInfo(), f->Literal(0, 8, SourceInfo()));
+      previous = reg;
+    }
+
+    LogicRef* sel =
+        m->AddReg("sel", f->BitVectorType(8, SourceInfo()), SourceInfo());
+    AlwaysComb* comb = m->Add<AlwaysComb>(SourceInfo());
+    Case* case_statement =
+        comb->statements()->Add<Case>(SourceInfo(), previous);
+    case_statement->AddCaseArm(f->Literal(0, 8, SourceInfo()))
+        ->Add<BlockingAssignment>(SourceInfo(), sel, in);
+    Conditional* conditional =
+        case_statement->AddCaseArm(DefaultSentinel())
+            ->Add<Conditional>(SourceInfo(), rst);
+    conditional->consequent()->Add<BlockingAssignment>(
+        SourceInfo(), sel, f->Literal(0, 8, SourceInfo()));
+    conditional->AddAlternate()->Add<BlockingAssignment>(SourceInfo(), sel,
+                                                         previous);
+    m->Add<ContinuousAssignment>(SourceInfo(), out, sel);
+    f->Add(f->Make<BlankLine>(SourceInfo()));
+  }
+  return modules;
+}
+
+TEST_P(VastTest, EmitToMatchesEmit) {
+  VerilogFile f(GetFileType());
+  std::vector<Module*> modules =
+      AddModulesForEmission(&f, /*module_count=*/5, /*registers_per_module=*/3);
+
+  LineInfo line_info;
+  std::string expected = f.Emit(&line_info);
+
+  for (int64_t threads : {1, 2, 8}) {
+    std::ostringstream stream;
+    LineInfo streamed_line_info;
+    {
+      // Use a small buffer so that the text is written in many pieces.
+      VastSink sink(&stream, /*buffer_size=*/16);
+      f.EmitTo(&streamed_line_info, &sink, threads);
+      EXPECT_EQ(sink.bytes_written(), expected.size());
+    }
+    EXPECT_EQ(stream.str(), expected) << "threads: " << threads;
+
+    for (Module* m : modules) {
+      EXPECT_EQ(streamed_line_info.LookupNode(m), line_info.LookupNode(m))
+          << "threads: " << threads;
+      EXPECT_EQ(streamed_line_info.LookupNode(m->top()),
+                line_info.LookupNode(m->top()))
+          << "threads: " << threads;
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(VastTestInstantiation, VastTest,
                          testing::Values(false, true),
                          [](const testing::TestParamInfo<bool>& info) {
                            return info.param ? "SystemVerilog" : "Verilog";
                          });
 
+void BM_EmitVerilogFile(benchmark::State& state) {
+  VerilogFile f(FileType::kSystemVerilog);
+  AddModulesForEmission(&f, /*module_count=*/state.range(0),
+                        /*registers_per_module=*/state.range(1));
+  int64_t threads = state.range(2);
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    std::ostringstream stream;
+    VastSink sink(&stream);
+    f.EmitTo(/*line_info=*/nullptr, &sink, threads);
+    sink.Flush();
+    bytes += sink.bytes_written();
+    benchmark::DoNotOptimize(stream);
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_EmitVerilogFile)
+    ->ArgsProduct({{1, 64}, {1000}, {1, 4}})
+    ->ArgNames({"modules", "registers", "threads"});
+
+// Measures how much of the text emission holds in memory at once, comparing
+// emission into a string with streaming through the sink's bounded buffer.
+// Emission is single-threaded because threaded emission also holds the text of
+// each module until it is written.
+void BM_EmitVerilogFileMemory(benchmark::State& state) {
+  VerilogFile f(FileType::kSystemVerilog);
+  AddModulesForEmission(&f, /*module_count=*/state.range(0),
+                        /*registers_per_module=*/state.range(1));
+  bool streamed = state.range(2) != 0;
+  int64_t peak_held_bytes = 0;
+  int64_t file_bytes = 0;
+  for (auto _ : state) {
+    std::string text;
+    // A stream without a buffer discards everything written to it.
+    std::ostream discard(nullptr);
+    std::unique_ptr<VastSink> sink =
+        streamed ? std::make_unique<VastSink>(&discard)
+                 : std::make_unique<VastSink>(&text);
+    f.EmitTo(/*line_info=*/nullptr, sink.get());
+    sink->Flush();
+    peak_held_bytes = sink->peak_held_bytes();
+    file_bytes = sink->bytes_written();
+    benchmark::DoNotOptimize(text);
+  }
+  state.counters["peak_held_bytes"] = peak_held_bytes;
+  state.counters["file_bytes"] = file_bytes;
+}
+BENCHMARK(BM_EmitVerilogFileMemory)
+    ->ArgsProduct({{1, 64}, {1000}, {0, 1}})
+    ->ArgNames({"modules", "registers", "streamed"});
+
 }  // namespace
 }  // namespace verilog
 }  // namespace xls
@@ -0,0 +1,37 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_FILE_CONTENT_DIGEST_H_
+#define XLS_COMMON_FILE_CONTENT_DIGEST_H_
+
+#include <filesystem>  // NOLINT
+#include <string>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+
+namespace xls {
+
+// Returns the SHA-256 digest of `data` as a lowercase hex string.
+std::string Sha256Hex(std::string_view data);
+
+// Returns the SHA-256 digest of the contents of the file at `file_name` as a
+// lowercase hex string. Suitable for keying caches on what a file contains
+// rather than where it lives.
+absl::StatusOr<std::string> GetFileSha256Hex(
+    const std::filesystem::path& file_name);
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_FILE_CONTENT_DIGEST_H_
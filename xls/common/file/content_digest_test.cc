@@ -0,0 +1,53 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/file/content_digest.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/file/temp_file.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using ::testing::Ne;
+
+TEST(ContentDigestTest, Sha256HexOfKnownVectors) {
+  EXPECT_EQ(Sha256Hex(""),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  EXPECT_EQ(Sha256Hex("abc"),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST(ContentDigestTest, GetFileSha256HexHashesContents) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempFile a, TempFile::CreateWithContent("abc"));
+  XLS_ASSERT_OK_AND_ASSIGN(TempFile b, TempFile::CreateWithContent("abc"));
+  XLS_ASSERT_OK_AND_ASSIGN(TempFile c, TempFile::CreateWithContent("abd"));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string a_digest, GetFileSha256Hex(a.path()));
+  EXPECT_THAT(GetFileSha256Hex(b.path()), IsOkAndHolds(a_digest));
+  EXPECT_THAT(GetFileSha256Hex(c.path()), IsOkAndHolds(Ne(a_digest)));
+}
+
+TEST(ContentDigestTest, GetFileSha256HexOfMissingFileFails) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  EXPECT_FALSE(GetFileSha256Hex(temp_dir.path() / "missing").ok());
+}
+
+}  // namespace
+}  // namespace xls
@@ -23,10 +23,12 @@
 #include <cerrno>
 #include <cstring>
 #include <filesystem>  // NOLINT
+#include <functional>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <system_error>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -203,6 +205,28 @@ absl::Status SetFileContents(const std::filesystem::path& file_name,
   return SetFileContentsOrAppend(file_name, content, SetOrAppend::kSet);
 }
 
+absl::Status SetFileContentsAtomically(const std::filesystem::path& file_name,
+                                       std::string_view content) {
+  std::filesystem::path temp_path = file_name;
+  temp_path += absl::StrCat(
+      ".", getpid(), ".",
+      std::hash<std::thread::id>()(std::this_thread::get_id()), ".tmp");
+  std::error_code ec;
+  if (absl::Status status = SetFileContents(temp_path, content); !status.ok()) {
+    std::filesystem::remove(temp_path, ec);
+    return status;
+  }
+  std::filesystem::rename(temp_path, file_name, ec);
+  if (ec) {
+    xabsl::StatusBuilder builder = ErrnoToStatus(ec.value());
+    builder << "renaming " << temp_path.string() << " to "
+            << file_name.string();
+    std::filesystem::remove(temp_path, ec);
+    return std::move(builder);
+  }
+  return absl::OkStatus();
+}
+
 absl::Status AppendStringToFile(const std::filesystem::path& file_name,
                                 std::string_view content) {
   return SetFileContentsOrAppend(file_name, content, SetOrAppend::kAppend);
@@ -252,8 +276,11 @@ absl::Status ParseProtobinFile(const std::filesystem::path& file_name,
   return ParseProtobin(protobin, file_name, proto);
 }
 
-absl::Status SetProtobinFile(const std::filesystem::path& file_name,
-                             const google::protobuf::Message& proto) {
+namespace {
+
+absl::StatusOr<std::string> SerializeProtobin(
+    const std::filesystem::path& file_name,
+    const google::protobuf::Message& proto) {
   std::string bin_proto;
   if (!proto.IsInitialized()) {
     return absl::FailedPreconditionError(
@@ -268,9 +295,25 @@ absl::Status SetProtobinFile(const std::filesystem::path& file_name,
         " (this generally stems from massive protobufs that either exhaust "
         "memory or overflow a 32-bit buffer somewhere)."));
   }
+  return bin_proto;
+}
+
+}  // namespace
+
+absl::Status SetProtobinFile(const std::filesystem::path& file_name,
+                             const google::protobuf::Message& proto) {
+  XLS_ASSIGN_OR_RETURN(std::string bin_proto,
+                       SerializeProtobin(file_name, proto));
   return SetFileContents(file_name, bin_proto);
 }
 
+absl::Status SetProtobinFileAtomically(const std::filesystem::path& file_name,
+                                       const google::protobuf::Message& proto) {
+  XLS_ASSIGN_OR_RETURN(std::string bin_proto,
+                       SerializeProtobin(file_name, proto));
+  return SetFileContentsAtomically(file_name, bin_proto);
+}
+
 absl::Status SetTextProtoFile(const std::filesystem::path& file_name,
                               const google::protobuf::Message& proto) {
   if (!proto.IsInitialized()) {
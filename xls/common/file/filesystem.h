@@ -98,6 +98,14 @@ absl::StatusOr<std::string> GetFileContents(
 absl::Status SetFileContents(const std::filesystem::path& file_name,
                              std::string_view content);
 
+// As SetFileContents, but readers of `file_name` (including other processes)
+// see either its previous contents or all of `content`, never a partial write.
+// The data is written to a temporary file private to the calling thread next
+// to `file_name` which is then renamed over it. The temporary file is removed
+// on failure.
+absl::Status SetFileContentsAtomically(const std::filesystem::path& file_name,
+                                       std::string_view content);
+
 // Writes the contents of data into the file file_name, appending to any
 // existing content.
 //
@@ -218,6 +226,11 @@ absl::Status ParseProtobinFile(const std::filesystem::path& file_name,
 absl::Status SetProtobinFile(const std::filesystem::path& file_name,
                              const google::protobuf::Message& proto);
 
+// As SetProtobinFile, but writes the file atomically (see
+// SetFileContentsAtomically).
+absl::Status SetProtobinFileAtomically(const std::filesystem::path& file_name,
+                                       const google::protobuf::Message& proto);
+
 // Writes the protobuf provided to the file `filename` in a protobuf text
 // format, overwriting any existing content in the file.
 //
@@ -19,6 +19,7 @@
 #include <ios>
 #include <string>
 #include <system_error>  // NOLINT(build/c++11)
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -267,6 +268,32 @@ TEST(FilesystemTest, SetFileContentsOfDirectoryFails) {
   EXPECT_THAT(contents, StatusIs(absl::StatusCode::kFailedPrecondition));
 }
 
+TEST(FilesystemTest, SetFileContentsAtomicallyReplacesFile) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path path = temp_dir.path() / "file";
+
+  XLS_ASSERT_OK(SetFileContentsAtomically(path, "abcdefghi"));
+  EXPECT_THAT(GetFileContents(path), IsOkAndHolds("abcdefghi"));
+  XLS_ASSERT_OK(SetFileContentsAtomically(path, "123"));
+  EXPECT_THAT(GetFileContents(path), IsOkAndHolds("123"));
+
+  // No temporary files are left behind.
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::filesystem::path> entries,
+                           GetDirectoryEntries(temp_dir.path()));
+  EXPECT_EQ(entries.size(), 1);
+}
+
+TEST(FilesystemTest, SetFileContentsAtomicallyOfDirectoryFails) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path directory = temp_dir.path() / "directory";
+  XLS_ASSERT_OK(RecursivelyCreateDir(directory));
+
+  EXPECT_FALSE(SetFileContentsAtomically(directory, "abc").ok());
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<std::filesystem::path> entries,
+                           GetDirectoryEntries(temp_dir.path()));
+  EXPECT_EQ(entries.size(), 1);
+}
+
 TEST(FilesystemTest, AppendStringToFileCreatesFileWhenMissing) {
   absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
   XLS_ASSERT_OK(temp_dir);
@@ -335,6 +362,18 @@ TEST(FilesystemTest, SetProtobinFileWritesAFile) {
   EXPECT_EQ(content.field(), "hi");
 }
 
+TEST(FilesystemTest, SetProtobinFileAtomicallyWritesAFile) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  FilesystemTest test;
+  test.set_field("hi");
+
+  XLS_EXPECT_OK(SetProtobinFileAtomically(temp_dir.path() / "proto", test));
+
+  FilesystemTest content;
+  XLS_ASSERT_OK(ParseProtobinFile(temp_dir.path() / "proto", &content));
+  EXPECT_EQ(content.field(), "hi");
+}
+
 TEST(FilesystemTest, SetTextProtoFileWritesAFile) {
   absl::StatusOr<TempFile> temp_file = TempFile::Create();
   XLS_ASSERT_OK(temp_file);
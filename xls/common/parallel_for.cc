@@ -0,0 +1,56 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "xls/common/thread.h"
+
+namespace xls {
+
+void ParallelForWithWorker(
+    int64_t count, int64_t thread_count,
+    absl::FunctionRef<void(int64_t worker, int64_t index)> fn) {
+  const int64_t workers = std::min(count, std::max(thread_count, int64_t{1}));
+  std::atomic<int64_t> next_index = 0;
+  auto work = [&](int64_t worker) {
+    for (int64_t index = next_index++; index < count; index = next_index++) {
+      fn(worker, index);
+    }
+  };
+  std::vector<std::unique_ptr<Thread>> threads;
+  threads.reserve(std::max(workers - 1, int64_t{0}));
+  for (int64_t worker = 1; worker < workers; ++worker) {
+    threads.push_back(
+        std::make_unique<Thread>([&work, worker]() { work(worker); }));
+  }
+  work(0);
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+}
+
+void ParallelFor(int64_t count, int64_t thread_count,
+                 absl::FunctionRef<void(int64_t index)> fn) {
+  ParallelForWithWorker(count, thread_count,
+                        [&](int64_t, int64_t index) { fn(index); });
+}
+
+}  // namespace xls
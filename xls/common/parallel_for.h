@@ -0,0 +1,41 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_PARALLEL_FOR_H_
+#define XLS_COMMON_PARALLEL_FOR_H_
+
+#include <cstdint>
+
+#include "absl/functional/function_ref.h"
+
+namespace xls {
+
+// Calls `fn(worker, index)` for each `index` in `[0, count)` using up to
+// `thread_count` workers and returns once all calls have completed. Each worker
+// repeatedly claims the lowest unclaimed index, so indices are started in
+// increasing order. `worker` is in `[0, min(count, thread_count))` and identifies
+// the worker making the call; calls with the same `worker` never run
+// concurrently, so per-worker state may be indexed by it. Worker 0 runs on the
+// calling thread, and if only one worker is needed no threads are created.
+void ParallelForWithWorker(
+    int64_t count, int64_t thread_count,
+    absl::FunctionRef<void(int64_t worker, int64_t index)> fn);
+
+// As above, for callers which need no per-worker state.
+void ParallelFor(int64_t count, int64_t thread_count,
+                 absl::FunctionRef<void(int64_t index)> fn);
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_PARALLEL_FOR_H_
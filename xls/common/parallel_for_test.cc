@@ -0,0 +1,72 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/parallel_for.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace {
+
+
+TEST(ParallelForTest, CallsEachIndexOnce) {
+  for (int64_t thread_count : {0, 1, 3, 64}) {
+    std::vector<std::atomic<int64_t>> calls(100);
+    ParallelFor(calls.size(), thread_count,
+                [&](int64_t index) { ++calls[index]; });
+    for (const std::atomic<int64_t>& count : calls) {
+      EXPECT_EQ(count.load(), 1) << "thread_count: " << thread_count;
+    }
+  }
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  ParallelFor(0, 4, [&](int64_t index) { ADD_FAILURE() << index; });
+}
+
+TEST(ParallelForTest, WorkerIdsAreBoundedAndExclusive) {
+  constexpr int64_t kThreads = 4;
+  // A worker's calls never overlap, so a per-worker counter needs no
+  // synchronization.
+  std::vector<int64_t> per_worker(kThreads, 0);
+  std::vector<std::atomic<bool>> busy(kThreads);
+  ParallelForWithWorker(1000, kThreads, [&](int64_t worker, int64_t index) {
+    ASSERT_GE(worker, 0);
+    ASSERT_LT(worker, kThreads);
+    EXPECT_FALSE(busy[worker].exchange(true));
+    ++per_worker[worker];
+    busy[worker] = false;
+  });
+  int64_t total = 0;
+  for (int64_t count : per_worker) {
+    total += count;
+  }
+  EXPECT_EQ(total, 1000);
+}
+
+TEST(ParallelForTest, SingleWorkerRunsInOrderOnCallingThread) {
+  std::vector<int64_t> order;
+  ParallelForWithWorker(5, 1, [&](int64_t worker, int64_t index) {
+    EXPECT_EQ(worker, 0);
+    order.push_back(index);
+  });
+  EXPECT_EQ(order, (std::vector<int64_t>{0, 1, 2, 3, 4}));
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,11 +14,14 @@
 
 #include "xls/data_structures/binary_search.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -105,4 +108,47 @@ absl::StatusOr<int64_t> BinarySearchMinTrueWithStatus(
   return lowest_true;
 }
 
+absl::StatusOr<int64_t> KArySearchMinTrueWithStatus(
+    int64_t start, int64_t end, int64_t parallelism,
+    absl::FunctionRef<absl::StatusOr<std::vector<bool>>(
+        absl::Span<const int64_t> candidates)>
+        f,
+    BinarySearchAssumptions assumptions) {
+  XLS_RET_CHECK_LE(start, end);
+  XLS_RET_CHECK_GE(parallelism, 1);
+  if (assumptions != BinarySearchAssumptions::kEndKnownTrue) {
+    XLS_ASSIGN_OR_RETURN(std::vector<bool> f_end, f({end}));
+    XLS_RET_CHECK_EQ(f_end.size(), 1);
+    if (!f_end.front()) {
+      return absl::InvalidArgumentError(
+          "Highest value in range fails condition of binary search.");
+    }
+  }
+  // Invariant: everything at or below `highest_false` is known false (`start`
+  // has not been evaluated yet) and `lowest_true` is known true.
+  int64_t highest_false = start - 1;
+  int64_t lowest_true = end;
+  std::vector<int64_t> candidates;
+  while (highest_false < lowest_true - 1) {
+    // Split (highest_false, lowest_true) into k + 1 parts. Each part is at
+    // least one value wide, so the candidates are distinct and in range.
+    const int64_t width = lowest_true - highest_false;
+    const int64_t k = std::min(parallelism, width - 1);
+    candidates.clear();
+    for (int64_t i = 1; i <= k; ++i) {
+      candidates.push_back(highest_false + (width * i) / (k + 1));
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<bool> results, f(candidates));
+    XLS_RET_CHECK_EQ(results.size(), candidates.size());
+    for (int64_t i = 0; i < k; ++i) {
+      if (results[i]) {
+        lowest_true = candidates[i];
+        break;
+      }
+      highest_false = candidates[i];
+    }
+  }
+  return lowest_true;
+}
+
 }  // namespace xls
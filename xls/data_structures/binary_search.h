@@ -16,10 +16,12 @@
 #define XLS_DATA_STRUCTURES_BINARY_SEARCH_H_
 
 #include <cstdint>
+#include <vector>
 
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 
 namespace xls {
 
@@ -55,6 +57,20 @@ absl::StatusOr<int64_t> BinarySearchMinTrueWithStatus(
     absl::FunctionRef<absl::StatusOr<bool>(int64_t i)> f,
     BinarySearchAssumptions assumptions = BinarySearchAssumptions::kNone);
 
+// Like BinarySearchMinTrueWithStatus, but each round narrows the range by
+// evaluating up to `parallelism` evenly spaced candidates at once. `f` is
+// passed the candidates in increasing order and must return one result per
+// candidate; it may evaluate them concurrently. This takes about
+// log(end - start) / log(parallelism + 1) rounds rather than log2(end - start)
+// calls. With `parallelism` of 1 the candidates are exactly the midpoints
+// probed by BinarySearchMinTrueWithStatus.
+absl::StatusOr<int64_t> KArySearchMinTrueWithStatus(
+    int64_t start, int64_t end, int64_t parallelism,
+    absl::FunctionRef<absl::StatusOr<std::vector<bool>>(
+        absl::Span<const int64_t> candidates)>
+        f,
+    BinarySearchAssumptions assumptions = BinarySearchAssumptions::kNone);
+
 }  // namespace xls
 
 #endif  // XLS_DATA_STRUCTURES_BINARY_SEARCH_H_
@@ -14,9 +14,14 @@
 
 #include "xls/data_structures/binary_search.h"
 
+#include <cstdint>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/status/matchers.h"
 
 namespace xls {
@@ -80,6 +85,63 @@ TEST(BinarySearchTest, MinTrueWithStatus) {
   }
 }
 
+TEST(BinarySearchTest, KAryMinTrueWithStatus) {
+  const int64_t kMaxSize = 10;
+  for (int64_t parallelism : {1, 2, 3, 16}) {
+    for (int start = 0; start < kMaxSize; ++start) {
+      for (int end = start; end < kMaxSize; ++end) {
+        for (int target = start; target <= end; ++target) {
+          auto got = KArySearchMinTrueWithStatus(
+              start, end, parallelism,
+              [&](absl::Span<const int64_t> candidates)
+                  -> absl::StatusOr<std::vector<bool>> {
+                EXPECT_LE(candidates.size(), parallelism);
+                std::vector<bool> results;
+                for (int64_t c : candidates) {
+                  EXPECT_GE(c, start);
+                  EXPECT_LE(c, end);
+                  results.push_back(c >= target);
+                }
+                return results;
+              });
+          EXPECT_THAT(got, IsOkAndHolds(target));
+        }
+      }
+    }
+  }
+}
+
+TEST(BinarySearchTest, KAryNumRounds) {
+  int64_t rounds = 0;
+  // 3 candidates split the range into quarters, so a range of 4^5 values takes
+  // 5 rounds.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      int64_t got,
+      KArySearchMinTrueWithStatus(
+          1, 1024, /*parallelism=*/3,
+          [&](absl::Span<const int64_t> candidates)
+              -> absl::StatusOr<std::vector<bool>> {
+            ++rounds;
+            std::vector<bool> results;
+            for (int64_t c : candidates) {
+              results.push_back(c >= 700);
+            }
+            return results;
+          },
+          BinarySearchAssumptions::kEndKnownTrue));
+  EXPECT_EQ(got, 700);
+  EXPECT_EQ(rounds, 5);
+
+  EXPECT_THAT(KArySearchMinTrueWithStatus(
+                  0, 10, /*parallelism=*/4,
+                  [&](absl::Span<const int64_t> candidates)
+                      -> absl::StatusOr<std::vector<bool>> {
+                    return std::vector<bool>(candidates.size(), false);
+                  }),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Highest value in range fails condition")));
+}
+
 TEST(BinarySearchTest, NumTimesFunctionCalled) {
   int64_t f_called = 0;
   // Note: some compilers dislike the lambda living inside the macro, so we
@@ -15,6 +15,7 @@
 #include "xls/data_structures/min_cut.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <limits>
 #include <set>
@@ -25,6 +26,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/numeric/int128.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -273,9 +275,10 @@ int64_t AugmentFlow(const Graph& graph, NodeId source, NodeId sink,
   return 0;
 }
 
-}  // namespace
-
-GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
+// Returns the set of nodes reachable from the source in the residual graph of
+// a maximum flow computed with Dinic's algorithm, indexed by NodeId.
+std::vector<bool> DinicSourcePartition(const Graph& graph, NodeId source,
+                                       NodeId sink) {
   // This loop is the core of the Ford-Fulkerson method. Starting with zero flow
   // on all edges, flow is increased along a path from source to sink with
   // residual capacity (called an augmenting path). When no further augmenting
@@ -287,34 +290,389 @@ GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
 
   // Once a maximum flow is found, walk the residual graph from the source. All
   // reachable nodes form one partition.
-  absl::flat_hash_set<NodeId> reachable_from_source;
+  std::vector<bool> reachable_from_source(graph.node_count(), false);
   std::deque<NodeId> frontier = {source};
-  reachable_from_source.insert(source);
+  reachable_from_source[int64_t{source}] = true;
   while (!frontier.empty()) {
     NodeId node = frontier.front();
     frontier.pop_front();
     for (EdgeId successor_edge_id : residual_graph.successors(node)) {
       const ResidualEdge& edge = residual_graph.edge(successor_edge_id);
-      if (edge.capacity > 0 && !reachable_from_source.contains(edge.to)) {
-        reachable_from_source.insert(edge.to);
+      if (edge.capacity > 0 && !reachable_from_source[int64_t{edge.to}]) {
+        reachable_from_source[int64_t{edge.to}] = true;
         frontier.push_back(edge.to);
       }
     }
   }
-  CHECK(!reachable_from_source.contains(sink));
+  return reachable_from_source;
+}
+
+// The residual graph in compressed sparse row (CSR) form. The arcs leaving
+// each node are stored contiguously in flat arrays, in the same order as the
+// edges of `ResidualGraph`, so scanning a node's arcs touches consecutive
+// memory rather than following a vector of edge IDs per node.
+class CsrResidualGraph {
+ public:
+  explicit CsrResidualGraph(const Graph& graph)
+      : first_arc_(graph.node_count() + 1, 0),
+        head_(2 * graph.edge_count()),
+        capacity_(2 * graph.edge_count()),
+        reverse_(2 * graph.edge_count()) {
+    for (EdgeId edge_id = EdgeId{0}; edge_id <= graph.max_edge_id();
+         ++edge_id) {
+      const Edge& edge = graph.edge(edge_id);
+      ++first_arc_[int64_t{edge.from} + 1];
+      ++first_arc_[int64_t{edge.to} + 1];
+    }
+    for (int64_t node = 0; node < graph.node_count(); ++node) {
+      first_arc_[node + 1] += first_arc_[node];
+    }
+    // Each edge becomes a forward arc with capacity equal to its weight and a
+    // backward arc with capacity zero.
+    std::vector<int64_t> next_arc(first_arc_.begin(), first_arc_.end() - 1);
+    for (EdgeId edge_id = EdgeId{0}; edge_id <= graph.max_edge_id();
+         ++edge_id) {
+      const Edge& edge = graph.edge(edge_id);
+      int64_t forward = next_arc[int64_t{edge.from}]++;
+      int64_t backward = next_arc[int64_t{edge.to}]++;
+      head_[forward] = int64_t{edge.to};
+      capacity_[forward] = edge.weight;
+      reverse_[forward] = backward;
+      head_[backward] = int64_t{edge.from};
+      capacity_[backward] = 0;
+      reverse_[backward] = forward;
+    }
+  }
+
+  int64_t node_count() const { return first_arc_.size() - 1; }
+  int64_t arc_count() const { return head_.size(); }
+
+  // The arcs leaving `node` are those in [first_arc(node), last_arc(node)).
+  int64_t first_arc(int64_t node) const { return first_arc_[node]; }
+  int64_t last_arc(int64_t node) const { return first_arc_[node + 1]; }
+
+  int64_t head(int64_t arc) const { return head_[arc]; }
+  int64_t capacity(int64_t arc) const { return capacity_[arc]; }
+  int64_t reverse(int64_t arc) const { return reverse_[arc]; }
+
+  // Push flow along the given arc. The capacity of this arc is reduced and
+  // the capacity of its reverse arc is increased.
+  void PushFlow(int64_t arc, int64_t amount) {
+    DCHECK_GE(capacity_[arc], amount);
+    capacity_[arc] -= amount;
+    capacity_[reverse_[arc]] += amount;
+  }
+
+ private:
+  std::vector<int64_t> first_arc_;
+  std::vector<int32_t> head_;
+  std::vector<int64_t> capacity_;
+  std::vector<int64_t> reverse_;
+};
+
+// Computes a maximum flow with the highest-label push-relabel algorithm.
+//
+// This is the single-phase variant: nodes whose excess cannot reach the sink
+// are relabeled above the source and return their excess to it, so the result
+// is a flow rather than a preflow. Two heuristics keep the number of relabels
+// down:
+//
+//  - Global relabeling periodically recomputes exact labels (distances to the
+//    sink, or to the source plus `n` for nodes cut off from the sink) with a
+//    reverse BFS of the residual graph.
+//  - The gap heuristic: when no node has some label `k < n`, no node labeled
+//    above `k` can reach the sink, so all are lifted to `n` immediately.
+//
+// Excesses are kept in 128 bits since edges of maximum weight (commonly used
+// to forbid cutting an edge) would overflow a 64-bit sum.
+class PushRelabel {
+ public:
+  PushRelabel(CsrResidualGraph* graph, int64_t source, int64_t sink)
+      : graph_(graph),
+        n_(graph->node_count()),
+        source_(source),
+        sink_(sink),
+        label_(n_, 0),
+        excess_(n_, 0),
+        current_arc_(n_),
+        active_(2 * n_ + 1),
+        bucket_head_(n_, -1),
+        bucket_next_(n_, -1),
+        bucket_prev_(n_, -1) {}
+
+  void Run() {
+    // Saturate every arc out of the source.
+    for (int64_t arc = graph_->first_arc(source_);
+         arc < graph_->last_arc(source_); ++arc) {
+      int64_t amount = graph_->capacity(arc);
+      if (amount > 0) {
+        graph_->PushFlow(arc, amount);
+        excess_[graph_->head(arc)] += amount;
+        excess_[source_] -= amount;
+      }
+    }
+    GlobalRelabel();
+
+    while (true) {
+      while (highest_active_ >= 0 && active_[highest_active_].empty()) {
+        --highest_active_;
+      }
+      if (highest_active_ < 0) {
+        break;
+      }
+      int64_t node = active_[highest_active_].back();
+      active_[highest_active_].pop_back();
+      // Nodes are not removed from `active_` when lifted by the gap
+      // heuristic, so skip stale entries.
+      if (label_[node] != highest_active_ || excess_[node] == 0) {
+        continue;
+      }
+      Discharge(node);
+      if (work_since_global_relabel_ > kGlobalRelabelFrequency *
+                                           (6 * n_ + graph_->arc_count())) {
+        GlobalRelabel();
+      }
+    }
+    XLS_VLOG(4) << absl::StreamFormat(
+        "Push-relabel: %d pushes, %d relabels, %d global relabels, %d gaps",
+        pushes_, relabels_, global_relabels_, gaps_);
+  }
+
+ private:
+  // Fraction of the (weighted) work of a relabel of every node after which
+  // labels are recomputed from scratch.
+  static constexpr double kGlobalRelabelFrequency = 0.5;
+
+  // Pushes excess out of `node` along admissible arcs, relabeling as needed,
+  // until no excess remains.
+  void Discharge(int64_t node) {
+    while (excess_[node] > 0) {
+      int64_t& arc = current_arc_[node];
+      if (arc == graph_->last_arc(node)) {
+        Relabel(node);
+        continue;
+      }
+      int64_t to = graph_->head(arc);
+      if (graph_->capacity(arc) > 0 && label_[node] == label_[to] + 1) {
+        int64_t amount = static_cast<int64_t>(
+            std::min(excess_[node], absl::int128{graph_->capacity(arc)}));
+        if (excess_[to] == 0 && to != source_ && to != sink_) {
+          Activate(to);
+        }
+        graph_->PushFlow(arc, amount);
+        excess_[node] -= amount;
+        excess_[to] += amount;
+        ++pushes_;
+      } else {
+        ++arc;
+      }
+    }
+  }
+
+  // Raises the label of `node` to one more than its lowest residual neighbor.
+  void Relabel(int64_t node) {
+    ++relabels_;
+    const int64_t old_label = label_[node];
+    int64_t new_label = 2 * n_;
+    for (int64_t arc = graph_->first_arc(node); arc < graph_->last_arc(node);
+         ++arc) {
+      if (graph_->capacity(arc) > 0) {
+        new_label = std::min(new_label, label_[graph_->head(arc)] + 1);
+      }
+    }
+    // Any node with excess has a residual path back to the source.
+    CHECK_LT(new_label, 2 * n_);
+    work_since_global_relabel_ +=
+        graph_->last_arc(node) - graph_->first_arc(node) + 12;
+    current_arc_[node] = graph_->first_arc(node);
+
+    if (old_label < n_) {
+      RemoveFromBucket(node);
+      if (bucket_head_[old_label] == -1) {
+        // Gap: neither `node` nor anything labeled above it can reach the
+        // sink any more.
+        Gap(old_label);
+        label_[node] = std::max(new_label, n_);
+        return;
+      }
+    }
+    label_[node] = new_label;
+    if (new_label < n_) {
+      AddToBucket(node);
+    }
+  }
+
+  // Lifts every node with a label in (label, n) to n.
+  void Gap(int64_t label) {
+    ++gaps_;
+    for (int64_t l = label + 1; l <= max_bucket_label_; ++l) {
+      for (int64_t node = bucket_head_[l]; node != -1;
+           node = bucket_next_[node]) {
+        label_[node] = n_;
+        current_arc_[node] = graph_->first_arc(node);
+        if (excess_[node] > 0) {
+          Activate(node);
+        }
+      }
+      bucket_head_[l] = -1;
+    }
+    max_bucket_label_ = label - 1;
+  }
+
+  // Recomputes every label as the exact distance to the sink in the residual
+  // graph, or `n` plus the distance to the source for nodes which cannot
+  // reach the sink.
+  void GlobalRelabel() {
+    ++global_relabels_;
+    work_since_global_relabel_ = 0;
+    std::fill(label_.begin(), label_.end(), 2 * n_);
+    auto reverse_bfs = [&](int64_t root, int64_t root_label) {
+      std::deque<int64_t> queue = {root};
+      label_[root] = root_label;
+      while (!queue.empty()) {
+        int64_t node = queue.front();
+        queue.pop_front();
+        for (int64_t arc = graph_->first_arc(node);
+             arc < graph_->last_arc(node); ++arc) {
+          int64_t from = graph_->head(arc);
+          if (label_[from] == 2 * n_ &&
+              graph_->capacity(graph_->reverse(arc)) > 0) {
+            label_[from] = label_[node] + 1;
+            queue.push_back(from);
+          }
+        }
+      }
+    };
+    label_[source_] = n_;
+    reverse_bfs(sink_, 0);
+    reverse_bfs(source_, n_);
+
+    for (std::vector<int64_t>& active : active_) {
+      active.clear();
+    }
+    highest_active_ = -1;
+    std::fill(bucket_head_.begin(), bucket_head_.end(), -1);
+    max_bucket_label_ = -1;
+    for (int64_t node = 0; node < n_; ++node) {
+      current_arc_[node] = graph_->first_arc(node);
+      if (node == source_ || node == sink_) {
+        continue;
+      }
+      if (label_[node] < n_) {
+        AddToBucket(node);
+      }
+      if (excess_[node] > 0) {
+        Activate(node);
+      }
+    }
+  }
+
+  void Activate(int64_t node) {
+    active_[label_[node]].push_back(node);
+    highest_active_ = std::max(highest_active_, label_[node]);
+  }
+
+  // Buckets hold every node with a label below `n`, for the gap heuristic.
+  void AddToBucket(int64_t node) {
+    int64_t label = label_[node];
+    bucket_prev_[node] = -1;
+    bucket_next_[node] = bucket_head_[label];
+    if (bucket_head_[label] != -1) {
+      bucket_prev_[bucket_head_[label]] = node;
+    }
+    bucket_head_[label] = node;
+    max_bucket_label_ = std::max(max_bucket_label_, label);
+  }
+  void RemoveFromBucket(int64_t node) {
+    if (bucket_prev_[node] == -1) {
+      bucket_head_[label_[node]] = bucket_next_[node];
+    } else {
+      bucket_next_[bucket_prev_[node]] = bucket_next_[node];
+    }
+    if (bucket_next_[node] != -1) {
+      bucket_prev_[bucket_next_[node]] = bucket_prev_[node];
+    }
+  }
+
+  CsrResidualGraph* graph_;
+  const int64_t n_;
+  const int64_t source_;
+  const int64_t sink_;
+
+  std::vector<int64_t> label_;
+  std::vector<absl::int128> excess_;
+  std::vector<int64_t> current_arc_;
+
+  // Active nodes (those other than the source and sink with excess), indexed
+  // by label.
+  std::vector<std::vector<int64_t>> active_;
+  int64_t highest_active_ = -1;
+
+  // Doubly-linked lists of the nodes with each label below `n`.
+  std::vector<int64_t> bucket_head_;
+  std::vector<int64_t> bucket_next_;
+  std::vector<int64_t> bucket_prev_;
+  int64_t max_bucket_label_ = -1;
+
+  int64_t work_since_global_relabel_ = 0;
+  int64_t pushes_ = 0;
+  int64_t relabels_ = 0;
+  int64_t global_relabels_ = 0;
+  int64_t gaps_ = 0;
+};
+
+// Returns the set of nodes reachable from the source in the residual graph of
+// a maximum flow computed with the push-relabel algorithm, indexed by NodeId.
+std::vector<bool> PushRelabelSourcePartition(const Graph& graph,
+                                             NodeId source, NodeId sink) {
+  CsrResidualGraph residual_graph(graph);
+  PushRelabel(&residual_graph, int64_t{source}, int64_t{sink}).Run();
+
+  std::vector<bool> reachable_from_source(graph.node_count(), false);
+  std::vector<int64_t> frontier = {int64_t{source}};
+  reachable_from_source[int64_t{source}] = true;
+  while (!frontier.empty()) {
+    int64_t node = frontier.back();
+    frontier.pop_back();
+    for (int64_t arc = residual_graph.first_arc(node);
+         arc < residual_graph.last_arc(node); ++arc) {
+      int64_t to = residual_graph.head(arc);
+      if (residual_graph.capacity(arc) > 0 && !reachable_from_source[to]) {
+        reachable_from_source[to] = true;
+        frontier.push_back(to);
+      }
+    }
+  }
+  return reachable_from_source;
+}
+
+}  // namespace
+
+GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink,
+                            MaxFlowAlgorithm algorithm) {
+  std::vector<bool> reachable_from_source;
+  switch (algorithm) {
+    case MaxFlowAlgorithm::kDinic:
+      reachable_from_source = DinicSourcePartition(graph, source, sink);
+      break;
+    case MaxFlowAlgorithm::kPushRelabel:
+      reachable_from_source = PushRelabelSourcePartition(graph, source, sink);
+      break;
+  }
+  CHECK(!reachable_from_source[int64_t{sink}]);
 
   GraphCut min_cut;
   min_cut.weight = 0;
   for (NodeId node_id = NodeId(0); node_id <= graph.max_node_id(); ++node_id) {
-    if (reachable_from_source.contains(node_id)) {
+    if (reachable_from_source[int64_t{node_id}]) {
       min_cut.source_partition.push_back(node_id);
     } else {
       min_cut.sink_partition.push_back(node_id);
     }
     for (EdgeId edge_id : graph.successors(node_id)) {
       const Edge& edge = graph.edge(edge_id);
-      if (reachable_from_source.contains(edge.from) &&
-          !reachable_from_source.contains(edge.to)) {
+      if (reachable_from_source[int64_t{edge.from}] &&
+          !reachable_from_source[int64_t{edge.to}]) {
         min_cut.weight += edge.weight;
       }
     }
@@ -21,6 +21,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/random/distributions.h"
 #include "absl/random/mocking_bit_gen.h"
@@ -37,7 +38,9 @@ namespace {
 
 using ::testing::UnorderedElementsAre;
 
-TEST(MinCutTest, TrivialGraph) {
+class MinCutTest : public ::testing::TestWithParam<MaxFlowAlgorithm> {};
+
+TEST_P(MinCutTest, TrivialGraph) {
   //    s
   //    |
   // 42 |
@@ -47,23 +50,23 @@ TEST(MinCutTest, TrivialGraph) {
   NodeId s = graph.AddNode("s");
   NodeId t = graph.AddNode("t");
   graph.AddEdge(s, t, 42);
-  GraphCut min_cut = MinCutBetweenNodes(graph, s, t);
+  GraphCut min_cut = MinCutBetweenNodes(graph, s, t, GetParam());
   EXPECT_EQ(min_cut.weight, 42);
   EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(s));
   EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(t));
 }
 
-TEST(MinCutTest, TrivialUnconnectedGraph) {
+TEST_P(MinCutTest, TrivialUnconnectedGraph) {
   Graph graph;
   NodeId s = graph.AddNode("s");
   NodeId t = graph.AddNode("t");
-  GraphCut min_cut = MinCutBetweenNodes(graph, s, t);
+  GraphCut min_cut = MinCutBetweenNodes(graph, s, t, GetParam());
   EXPECT_EQ(min_cut.weight, 0);
   EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(s));
   EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(t));
 }
 
-TEST(MinCutTest, DiamondGraph) {
+TEST_P(MinCutTest, DiamondGraph) {
   //       a
   //      / \
   // 100 /   \ 1
@@ -82,13 +85,13 @@ TEST(MinCutTest, DiamondGraph) {
   graph.AddEdge(a, c, 1);
   graph.AddEdge(b, d, 42);
   graph.AddEdge(c, d, 1234);
-  GraphCut min_cut = MinCutBetweenNodes(graph, a, d);
+  GraphCut min_cut = MinCutBetweenNodes(graph, a, d, GetParam());
   EXPECT_EQ(min_cut.weight, 43);
   EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, b));
   EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(c, d));
 }
 
-TEST(MinCutTest, DiamondGraphWithReplicatedEdges) {
+TEST_P(MinCutTest, DiamondGraphWithReplicatedEdges) {
   //            a
   //           / \
   //      100 /   \ 1 x (2)
@@ -117,13 +120,13 @@ TEST(MinCutTest, DiamondGraphWithReplicatedEdges) {
   graph.AddEdge(c, d, 1234);
   graph.AddEdge(c, d, 1234);
 
-  GraphCut min_cut = MinCutBetweenNodes(graph, a, d);
+  GraphCut min_cut = MinCutBetweenNodes(graph, a, d, GetParam());
   EXPECT_EQ(min_cut.weight, 102);
   EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a));
   EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(b, c, d));
 }
 
-TEST(MinCutTest, ComplexGraph) {
+TEST_P(MinCutTest, ComplexGraph) {
   //       a
   //      / \
   // 100 /   \ 16
@@ -158,7 +161,7 @@ TEST(MinCutTest, ComplexGraph) {
   graph.AddEdge(d, f, 6);
   graph.AddEdge(e, f, 4);
   graph.AddEdge(f, g, 12);
-  GraphCut min_cut = MinCutBetweenNodes(graph, a, g);
+  GraphCut min_cut = MinCutBetweenNodes(graph, a, g, GetParam());
   EXPECT_EQ(min_cut.weight, 43);
   EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, b, c, d, e));
   EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(f, g));
@@ -228,7 +231,7 @@ Graph MakeLargeGraph(bool acyclic, NodeId* source, NodeId* sink,
   return graph;
 }
 
-TEST(MinCutTest, LargeDirectedGraphs) {
+TEST_P(MinCutTest, LargeDirectedGraphs) {
   // Construct some random directed graphs and verify that the min cut is at
   // least at a local minimum. Verifying it actually is the min cut is hard
   // without reimplementing the algorithm.
@@ -242,7 +245,7 @@ TEST(MinCutTest, LargeDirectedGraphs) {
                                      nodes_in_layer);
         // It's hard to verify that this is *actually* the min cut, but do basic
         // validation of the partition.
-        GraphCut min_cut = MinCutBetweenNodes(graph, source, sink);
+        GraphCut min_cut = MinCutBetweenNodes(graph, source, sink, GetParam());
         EXPECT_EQ(
             min_cut.source_partition.size() + min_cut.sink_partition.size(),
             graph.node_count());
@@ -284,7 +287,7 @@ TEST(MinCutTest, LargeDirectedGraphs) {
   }
 }
 
-TEST(MinCutTest, MaxFlowToMinCutTraversalTest) {
+TEST_P(MinCutTest, MaxFlowToMinCutTraversalTest) {
   // Test a fix for b/155115565 where the residual graph was not properly
   // traversed to identify the partitions after max flow was computed.
   Graph graph;
@@ -310,11 +313,11 @@ TEST(MinCutTest, MaxFlowToMinCutTraversalTest) {
   graph.AddEdge(f, sink, std::numeric_limits<int64_t>::max());
   graph.AddEdge(g, sink, std::numeric_limits<int64_t>::max());
 
-  GraphCut min_cut = MinCutBetweenNodes(graph, source, sink);
+  GraphCut min_cut = MinCutBetweenNodes(graph, source, sink, GetParam());
   EXPECT_EQ(min_cut.weight, 11);
 }
 
-TEST(MinCutTest, ResidualGraphTraversalTest) {
+TEST_P(MinCutTest, ResidualGraphTraversalTest) {
   // Test a graph which requires traversing a backeards edge in the residual
   // graph in an augmented path. The first augmenting path is
   // source->a->d->sink. The next augmenting path is
@@ -359,10 +362,58 @@ TEST(MinCutTest, ResidualGraphTraversalTest) {
   graph.AddEdge(e, f, 1);
   graph.AddEdge(f, sink, 1);
 
-  GraphCut min_cut = MinCutBetweenNodes(graph, source, sink);
+  GraphCut min_cut = MinCutBetweenNodes(graph, source, sink, GetParam());
   EXPECT_EQ(min_cut.weight, 2);
 }
 
+TEST(MinCutAlgorithmsTest, AlgorithmsGiveIdenticalCuts) {
+  for (bool acyclic : {false, true}) {
+    for (int64_t layer_count = 5; layer_count < 40; layer_count += 7) {
+      for (int64_t nodes_in_layer = 5; nodes_in_layer < 40;
+           nodes_in_layer += 7) {
+        NodeId source;
+        NodeId sink;
+        Graph graph = MakeLargeGraph(acyclic, &source, &sink, layer_count,
+                                     nodes_in_layer);
+        GraphCut dinic =
+            MinCutBetweenNodes(graph, source, sink, MaxFlowAlgorithm::kDinic);
+        GraphCut push_relabel = MinCutBetweenNodes(
+            graph, source, sink, MaxFlowAlgorithm::kPushRelabel);
+        EXPECT_EQ(dinic.weight, push_relabel.weight);
+        EXPECT_EQ(dinic.source_partition, push_relabel.source_partition);
+        EXPECT_EQ(dinic.sink_partition, push_relabel.sink_partition);
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MinCutTestInstantiation, MinCutTest,
+    ::testing::Values(MaxFlowAlgorithm::kDinic, MaxFlowAlgorithm::kPushRelabel),
+    [](const ::testing::TestParamInfo<MaxFlowAlgorithm>& info) {
+      return info.param == MaxFlowAlgorithm::kDinic ? "Dinic" : "PushRelabel";
+    });
+
+// Args: layer count, nodes per layer, algorithm.
+void BM_MinCutLargeGraph(benchmark::State& state) {
+  NodeId source;
+  NodeId sink;
+  Graph graph = MakeLargeGraph(/*acyclic=*/true, &source, &sink,
+                               state.range(0), state.range(1));
+  MaxFlowAlgorithm algorithm = static_cast<MaxFlowAlgorithm>(state.range(2));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        MinCutBetweenNodes(graph, source, sink, algorithm));
+  }
+  state.counters["edges"] = graph.edge_count();
+}
+
+BENCHMARK(BM_MinCutLargeGraph)
+    ->ArgsProduct({{16, 64, 256},
+                   {16, 64, 256},
+                   {static_cast<int64_t>(MaxFlowAlgorithm::kDinic),
+                    static_cast<int64_t>(MaxFlowAlgorithm::kPushRelabel)}});
+
 }  // namespace
 }  // namespace min_cut
 }  // namespace xls
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -206,8 +207,8 @@ CachingDelayEstimator::CachingDelayEstimator(std::string_view name,
 
 absl::StatusOr<int64_t> CachingDelayEstimator::GetOperationDelayInPs(
     Node* node) const {
-  if (ContainsNodeDelay(node)) {
-    return GetNodeDelay(node);
+  if (std::optional<int64_t> delay = LookupNodeDelay(node); delay.has_value()) {
+    return *delay;
   }
 
   XLS_ASSIGN_OR_RETURN(int64_t delay, cached_.GetOperationDelayInPs(node));
@@ -15,16 +15,20 @@
 #ifndef XLS_DELAY_MODEL_DELAY_ESTIMATOR_H_
 #define XLS_DELAY_MODEL_DELAY_ESTIMATOR_H_
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
@@ -90,6 +94,10 @@ class FirstMatchDelayEstimator : public DelayEstimator {
 
 // Cache the delay of an underlying delay estimator. This class is safe for
 // concurrent access.
+//
+// The cache is split into shards, each with its own lock, so that threads
+// estimating the delays of different nodes (e.g., when scheduling in parallel)
+// rarely contend on the same lock.
 class CachingDelayEstimator : public DelayEstimator {
  public:
   CachingDelayEstimator(std::string_view name, const DelayEstimator& cached);
@@ -99,27 +107,47 @@ class CachingDelayEstimator : public DelayEstimator {
   absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override;
 
  private:
+  static constexpr int64_t kShardCount = 32;
+
+  // Aligned to a cache line so that locking one shard does not invalidate the
+  // cache line holding the lock of another.
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<Node*, int64_t> delays ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard& GetShard(Node* node) const {
+    return shards_[absl::Hash<Node*>()(node) % kShardCount];
+  }
+
+  std::optional<int64_t> LookupNodeDelay(Node* node) const {
+    Shard& shard = GetShard(node);
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.delays.find(node);
+    if (it == shard.delays.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
   bool ContainsNodeDelay(Node* node) const {
-    absl::ReaderMutexLock lock(&cache_mutex_);
-    return cache_.contains(node);
+    return LookupNodeDelay(node).has_value();
   }
 
   int64_t GetNodeDelay(Node* node) const {
-    absl::ReaderMutexLock lock(&cache_mutex_);
-    return cache_.at(node);
+    return LookupNodeDelay(node).value();
   }
 
   void AddNodeDelay(Node* node, int64_t delay) const {
-    absl::WriterMutexLock lock(&cache_mutex_);
-    cache_.emplace(node, delay);
+    Shard& shard = GetShard(node);
+    absl::WriterMutexLock lock(&shard.mutex);
+    shard.delays.emplace(node, delay);
   }
 
   XLS_FRIEND_TEST(DelayEstimatorTest, CachingDelayEstimator);
 
   const DelayEstimator& cached_;
-  mutable absl::Mutex cache_mutex_;
-  mutable absl::flat_hash_map<Node*, int64_t> cache_
-      ABSL_GUARDED_BY(cache_mutex_);
+  mutable std::array<Shard, kShardCount> shards_;
 };
 
 enum class DelayEstimatorPrecedence {
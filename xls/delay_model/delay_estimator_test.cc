@@ -21,9 +21,14 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
+#include "xls/delay_model/delay_estimators.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
@@ -228,6 +233,40 @@ TEST_F(DelayEstimatorTest, CachingDelayEstimator) {
   EXPECT_THAT(caching.GetNodeDelay(f->return_value()), 1);
 }
 
+TEST_F(DelayEstimatorTest, CachingDelayEstimatorConcurrentAccess) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f, benchmark_support::GenerateBalancedTree(
+                        p.get(), /*depth=*/6, /*fan_out=*/2,
+                        benchmark_support::strategy::BinaryAdd(),
+                        benchmark_support::strategy::DistinctLiteral()));
+  XLS_ASSERT_OK_AND_ASSIGN(DelayEstimator * unit, GetDelayEstimator("unit"));
+  CachingDelayEstimator caching("caching", *unit);
+
+  std::vector<Node*> nodes(f->nodes().begin(), f->nodes().end());
+  std::vector<std::vector<int64_t>> delays(8);
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 0; i < delays.size(); ++i) {
+    threads.push_back(std::make_unique<Thread>([&, i]() {
+      for (Node* node : nodes) {
+        absl::StatusOr<int64_t> delay = caching.GetOperationDelayInPs(node);
+        delays[i].push_back(delay.ok() ? *delay : -1);
+      }
+    }));
+  }
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+
+  for (int64_t i = 0; i < nodes.size(); ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(int64_t expected,
+                             unit->GetOperationDelayInPs(nodes[i]));
+    for (const std::vector<int64_t>& thread_delays : delays) {
+      EXPECT_EQ(thread_delays[i], expected);
+    }
+  }
+}
+
 // A Delay Estimator that can only handle one kind of operation.
 class TestNodeMatchEstimator : public DelayEstimator {
  public:
@@ -279,4 +318,52 @@ TEST_F(DelayEstimatorTest, FirstMatchDelegationEstimator) {
   }
 }
 
+// The function whose nodes are estimated by the benchmarks below.
+std::vector<Node*>& BenchmarkNodes() {
+  static std::vector<Node*>* nodes = [] {
+    Package* p = new Package("benchmark_pkg");
+    absl::StatusOr<Function*> f = benchmark_support::GenerateBalancedTree(
+        p, /*depth=*/10, /*fan_out=*/2,
+        benchmark_support::strategy::BinaryAdd(),
+        benchmark_support::strategy::DistinctLiteral());
+    CHECK_OK(f.status());
+    return new std::vector<Node*>((*f)->nodes().begin(), (*f)->nodes().end());
+  }();
+  return *nodes;
+}
+
+// Estimates the delay of every node with a generated delay model.
+void BM_GeneratedDelayModel(benchmark::State& state, std::string_view model) {
+  absl::StatusOr<DelayEstimator*> estimator = GetDelayEstimator(model);
+  CHECK_OK(estimator.status());
+  const std::vector<Node*>& nodes = BenchmarkNodes();
+  for (auto _ : state) {
+    for (Node* node : nodes) {
+      benchmark::DoNotOptimize((*estimator)->GetOperationDelayInPs(node));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nodes.size());
+}
+
+// Estimates the delay of every node through a caching estimator shared by all
+// benchmark threads, as concurrent schedulers do.
+void BM_CachingDelayEstimator(benchmark::State& state) {
+  static CachingDelayEstimator* caching = [] {
+    absl::StatusOr<DelayEstimator*> estimator = GetDelayEstimator("asap7");
+    CHECK_OK(estimator.status());
+    return new CachingDelayEstimator("caching", **estimator);
+  }();
+  const std::vector<Node*>& nodes = BenchmarkNodes();
+  for (auto _ : state) {
+    for (Node* node : nodes) {
+      benchmark::DoNotOptimize(caching->GetOperationDelayInPs(node));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nodes.size());
+}
+
+BENCHMARK_CAPTURE(BM_GeneratedDelayModel, asap7, "asap7");
+BENCHMARK_CAPTURE(BM_GeneratedDelayModel, sky130, "sky130");
+BENCHMARK(BM_CachingDelayEstimator)->ThreadRange(1, 16)->UseRealTime();
+
 }  // namespace xls
@@ -529,16 +529,27 @@ class RegressionEstimator(Estimator):
     return self.delay_function(xargs)
 
   def cpp_delay_code(self, node_identifier: str) -> str:
+    # Each delay expression is evaluated once into a local and the fitted
+    # parameters are emitted as literals, so the generated code is a
+    # straight-line evaluation of the regression.
+    lines = []
     terms = [repr(self.params[0])]
     for i, expression in enumerate(self.delay_expressions):
-      e_str = _delay_expression_cpp_expression(expression, node_identifier)
+      lines.append(
+          'const auto expression_{} = {};'.format(
+              i,
+              _delay_expression_cpp_expression(expression, node_identifier),
+          )
+      )
+      e_str = 'expression_{}'.format(i)
       terms.append('{!r} * {}'.format(self.params[2 * i + 1], e_str))
       terms.append(
           '{w!r} * std::log2({e} < 1.0 ? 1.0 : {e})'.format(
               w=self.params[2 * i + 2], e=e_str
           )
       )
-    return 'return std::round({});'.format(' + '.join(terms))
+    lines.append('return std::round({});'.format(' + '.join(terms)))
+    return '\n'.join(lines)
 
 
 class BoundingBoxEstimator(Estimator):
@@ -566,19 +577,17 @@ class BoundingBoxEstimator(Estimator):
       )
 
   def cpp_delay_code(self, node_identifier: str) -> str:
+    # Evaluate each delay factor once rather than once per data point.
     lines = []
+    for i, factor in enumerate(self.delay_factors):
+      lines.append(
+          'const int64_t factor_%d = %s;'
+          % (i, _delay_factor_cpp_expression(factor, node_identifier))
+      )
     for raw_data_point in self.raw_data_points:
       test_expr_terms = []
       for i, x_value in enumerate(raw_data_point.delay_factors):
-        test_expr_terms.append(
-            '%s <= %d'
-            % (
-                _delay_factor_cpp_expression(
-                    self.delay_factors[i], node_identifier
-                ),
-                x_value,
-            )
-        )
+        test_expr_terms.append('factor_%d <= %d' % (i, x_value))
       lines.append(
           'if (%s) { return %d; }'
           % (' && '.join(test_expr_terms), raw_data_point.delay_ps)
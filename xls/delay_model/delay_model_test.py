@@ -112,20 +112,18 @@ class DelayModelTest(absltest.TestCase):
                 'op: "kBar" bit_count: 64 operands { bit_count: 64 }')), 1234)
     self.assertEqualIgnoringWhitespace(
         bar.cpp_delay_code('node'), """
-          if (node->GetType()->GetFlatBitCount() <= 3 &&
-              node->operand(0)->GetType()->GetFlatBitCount() <= 7) {
+          const int64_t factor_0 = node->GetType()->GetFlatBitCount();
+          const int64_t factor_1 = node->operand(0)->GetType()->GetFlatBitCount();
+          if (factor_0 <= 3 && factor_1 <= 7) {
             return 23;
           }
-          if (node->GetType()->GetFlatBitCount() <= 12 &&
-              node->operand(0)->GetType()->GetFlatBitCount() <= 42) {
+          if (factor_0 <= 12 && factor_1 <= 42) {
             return 100;
           }
-          if (node->GetType()->GetFlatBitCount() <= 32 &&
-              node->operand(0)->GetType()->GetFlatBitCount() <= 10) {
+          if (factor_0 <= 32 && factor_1 <= 10) {
             return 122;
           }
-          if (node->GetType()->GetFlatBitCount() <= 64 &&
-              node->operand(0)->GetType()->GetFlatBitCount() <= 64) {
+          if (factor_0 <= 64 && factor_1 <= 64) {
             return 1234;
           }
           return absl::UnimplementedError(
@@ -169,15 +167,11 @@ class DelayModelTest(absltest.TestCase):
         delta=2)
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 =
+              static_cast<float>(node->GetType()->GetFlatBitCount());
           return std::round(
-              0.0 + 0.0 * static_cast<float>(node->GetType()->GetFlatBitCount()) +
-              0.0 *
-              std::log2(
-                 static_cast<float>(node->GetType()->GetFlatBitCount()) < 1.0
-                 ? 1.0
-                 : static_cast<float>(node->GetType()->GetFlatBitCount())
-              )
-            );
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """)
 
   def test_one_regression_estimator_operand_count(self):
@@ -206,12 +200,10 @@ class DelayModelTest(absltest.TestCase):
         foo.operation_delay(_parse_operation(gen_operation(256))), 18, delta=1)
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = static_cast<float>(node->operand_count());
           return std::round(
-              0.0 + 0.0 * static_cast<float>(node->operand_count()) +
-              0.0 * std::log2(
-                static_cast<float>(node->operand_count()) < 1.0 ? 1.0 :
-                static_cast<float>(node->operand_count())
-              ));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """)
 
   def test_two_factor_regression_estimator(self):
@@ -250,18 +242,15 @@ class DelayModelTest(absltest.TestCase):
         delta=50)
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 =
+              static_cast<float>(node->GetType()->GetFlatBitCount());
+          const auto expression_1 =
+              static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount());
           return std::round(
-              0.0 + 0.0 * static_cast<float>(node->GetType()->GetFlatBitCount()) +
-              0.0 * std::log2(
-                static_cast<float>(node->GetType()->GetFlatBitCount()) < 1.0 ?
-                 1.0 : static_cast<float>(node->GetType()->GetFlatBitCount())
-              ) +
-              0.0 * static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()) +
-              0.0 * std::log2(
-                static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()) < 1.0 ?
-                  1.0 :
-                  static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount())
-              ));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0) +
+              0.0 * expression_1 +
+              0.0 * std::log2(expression_1 < 1.0 ? 1.0 : expression_1));
         """)
 
   def test_fixed_op_model(self):
@@ -440,9 +429,10 @@ class DelayModelTest(absltest.TestCase):
         + static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_binop_delay_expression_sub(self):
@@ -495,9 +485,10 @@ class DelayModelTest(absltest.TestCase):
         - static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_binop_delay_expression_divide(self):
@@ -553,9 +544,10 @@ class DelayModelTest(absltest.TestCase):
         ))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_binop_delay_expression_max(self):
@@ -608,9 +600,10 @@ class DelayModelTest(absltest.TestCase):
         static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_binop_delay_expression_min(self):
@@ -663,9 +656,10 @@ class DelayModelTest(absltest.TestCase):
         static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_binop_delay_expression_multiply(self):
@@ -716,9 +710,10 @@ class DelayModelTest(absltest.TestCase):
         * static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount()))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_binop_delay_expression_power(self):
@@ -765,9 +760,10 @@ class DelayModelTest(absltest.TestCase):
         static_cast<float>(node->GetType()->GetFlatBitCount()))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_constant_delay_expression(self):
@@ -809,9 +805,10 @@ class DelayModelTest(absltest.TestCase):
     expression_str = r"""static_cast<float>(99)"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_estimator_nested_delay_expression(self):
@@ -865,9 +862,10 @@ class DelayModelTest(absltest.TestCase):
         static_cast<float>(node->operand(1)->GetType()->GetFlatBitCount())))"""
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          const auto expression_0 = {expr};
           return std::round(
-              0.0 + 0.0 * {expr} +
-              0.0 * std::log2({expr} < 1.0 ? 1.0 : {expr}));
+              0.0 + 0.0 * expression_0 +
+              0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
         """.format(expr=expression_str))
 
   def test_regression_op_model_with_bounding_box_specialization(self):
@@ -893,19 +891,18 @@ class DelayModelTest(absltest.TestCase):
           absl::StatusOr<int64_t> FooDelay(Node* node) {
             if (std::all_of(node->operands().begin(), node->operands().end(),
                 [&](Node* n) { return n == node->operand(0); })) {
-              if (node->GetType()->GetFlatBitCount() <= 1) { return 2; }
-              if (node->GetType()->GetFlatBitCount() <= 2) { return 4; }
+              const int64_t factor_0 = node->GetType()->GetFlatBitCount();
+              if (factor_0 <= 1) { return 2; }
+              if (factor_0 <= 2) { return 4; }
               return absl::UnimplementedError(
                 "Unhandled node for delay estimation: " +
                 node->ToStringWithOperandTypes());
             }
+            const auto expression_0 =
+                static_cast<float>(node->GetType()->GetFlatBitCount());
             return std::round(
-                0.0 + 0.0 * static_cast<float>(node->GetType()->GetFlatBitCount()) +
-                0.0 * std::log2(
-                  static_cast<float>(node->GetType()->GetFlatBitCount()) < 1.0 ?
-                   1.0 :
-                  static_cast<float>(node->GetType()->GetFlatBitCount())
-                ));
+                0.0 + 0.0 * expression_0 +
+                0.0 * std::log2(expression_0 < 1.0 ? 1.0 : expression_0));
           }
         """)
 
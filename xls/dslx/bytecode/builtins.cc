@@ -178,7 +178,8 @@ absl::Status RunBuiltinBitSlice(const Bytecode& bytecode,
   return RunTernaryBuiltin(
       [](const InterpValue& subject, const InterpValue& start,
          const InterpValue& width) -> absl::StatusOr<InterpValue> {
-        XLS_ASSIGN_OR_RETURN(Bits subject_bits, subject.GetBits());
+        XLS_RET_CHECK(subject.HasBits());
+        const Bits& subject_bits = subject.GetBitsOrDie();
         XLS_ASSIGN_OR_RETURN(int64_t start_index, start.GetBitValueSigned());
         if (start_index >= subject_bits.bit_count()) {
           start_index = subject_bits.bit_count();
@@ -199,9 +200,11 @@ absl::Status RunBuiltinBitSliceUpdate(const Bytecode& bytecode,
   return RunTernaryBuiltin(
       [](const InterpValue& subject, const InterpValue& start,
          const InterpValue& update_value) -> absl::StatusOr<InterpValue> {
-        XLS_ASSIGN_OR_RETURN(Bits subject_bits, subject.GetBits());
-        XLS_ASSIGN_OR_RETURN(Bits start_bits, start.GetBits());
-        XLS_ASSIGN_OR_RETURN(Bits update_value_bits, update_value.GetBits());
+        XLS_RET_CHECK(subject.HasBits() && start.HasBits() &&
+                      update_value.HasBits());
+        const Bits& subject_bits = subject.GetBitsOrDie();
+        const Bits& start_bits = start.GetBitsOrDie();
+        const Bits& update_value_bits = update_value.GetBitsOrDie();
 
         if (bits_ops::UGreaterThanOrEqual(start_bits,
                                           subject_bits.bit_count())) {
@@ -241,7 +244,7 @@ absl::Status BuiltinRangeInternal(InterpreterStack& stack) {
           XLS_ASSIGN_OR_RETURN(cur, cur.Add(one));
           XLS_ASSIGN_OR_RETURN(done, cur.Ge(end));
         }
-        return InterpValue::MakeArray(elements);
+        return InterpValue::MakeArray(std::move(elements));
       },
       stack);
 }
@@ -286,7 +289,8 @@ absl::Status RunBuiltinOneHotSel(const Bytecode& bytecode,
   return RunBinaryBuiltin(
       [](const InterpValue& selector,
          const InterpValue& cases_array) -> absl::StatusOr<InterpValue> {
-        XLS_ASSIGN_OR_RETURN(Bits selector_bits, selector.GetBits());
+        XLS_RET_CHECK(selector.HasBits());
+        const Bits& selector_bits = selector.GetBitsOrDie();
         XLS_ASSIGN_OR_RETURN(const std::vector<InterpValue>* cases,
                              cases_array.GetValues());
         if (cases->empty()) {
@@ -301,8 +305,8 @@ absl::Status RunBuiltinOneHotSel(const Bytecode& bytecode,
             continue;
           }
 
-          XLS_ASSIGN_OR_RETURN(Bits case_bits, cases->at(i).GetBits());
-          result = bits_ops::Or(result, case_bits);
+          XLS_RET_CHECK(cases->at(i).HasBits());
+          result = bits_ops::Or(result, cases->at(i).GetBitsOrDie());
         }
 
         return InterpValue::MakeBits(cases->at(0).tag(), result);
@@ -315,7 +319,8 @@ absl::Status RunBuiltinPrioritySel(const Bytecode& bytecode,
   return RunBinaryBuiltin(
       [](const InterpValue& selector,
          const InterpValue& cases_array) -> absl::StatusOr<InterpValue> {
-        XLS_ASSIGN_OR_RETURN(Bits selector_bits, selector.GetBits());
+        XLS_RET_CHECK(selector.HasBits());
+        const Bits& selector_bits = selector.GetBitsOrDie();
         XLS_ASSIGN_OR_RETURN(const std::vector<InterpValue>* cases,
                              cases_array.GetValues());
         if (cases->empty()) {
@@ -326,8 +331,9 @@ absl::Status RunBuiltinPrioritySel(const Bytecode& bytecode,
                              cases->at(0).GetBitCount());
         for (int64_t i = 0; i < cases->size(); i++) {
           if (selector_bits.Get(i)) {
-            XLS_ASSIGN_OR_RETURN(Bits case_bits, cases->at(i).GetBits());
-            return InterpValue::MakeBits(cases->at(0).tag(), case_bits);
+            XLS_RET_CHECK(cases->at(i).HasBits());
+            return InterpValue::MakeBits(cases->at(0).tag(),
+                                         cases->at(i).GetBitsOrDie());
           }
         }
 
@@ -344,7 +350,7 @@ absl::Status RunBuiltinSignex(const Bytecode& bytecode,
          const InterpValue& type_value) -> absl::StatusOr<InterpValue> {
         XLS_ASSIGN_OR_RETURN(int64_t old_bit_count, value.GetBitCount());
         XLS_ASSIGN_OR_RETURN(int64_t new_bit_count, type_value.GetBitCount());
-        XLS_ASSIGN_OR_RETURN(Bits bits, value.GetBits());
+        const Bits& bits = value.GetBitsOrDie();
         if (new_bit_count < old_bit_count) {
           return InterpValue::MakeBits(
               type_value.IsSigned(),
@@ -370,13 +376,12 @@ absl::Status RunBuiltinSMulp(const Bytecode& bytecode,
             MulpOffsetForSimulation(product_bitwidth, /*shift_size=*/1));
         XLS_ASSIGN_OR_RETURN(InterpValue product, lhs.Mul(rhs));
         // Return unsigned partial product.
-        XLS_ASSIGN_OR_RETURN(Bits product_raw_bits, product.GetBits());
-        product = InterpValue::MakeUnsigned(product_raw_bits);
+        product = InterpValue::MakeUnsigned(product.GetBitsOrDie());
         XLS_ASSIGN_OR_RETURN(InterpValue product_minus_offset,
                              product.Sub(offset));
         outputs.push_back(offset);
         outputs.push_back(product_minus_offset);
-        return InterpValue::MakeTuple(outputs);
+        return InterpValue::MakeTuple(std::move(outputs));
       },
       stack);
 }
@@ -398,7 +403,7 @@ absl::Status RunBuiltinUMulp(const Bytecode& bytecode,
                              product.Sub(offset));
         outputs.push_back(offset);
         outputs.push_back(product_minus_offset);
-        return InterpValue::MakeTuple(outputs);
+        return InterpValue::MakeTuple(std::move(outputs));
       },
       stack);
 }
@@ -419,9 +424,9 @@ absl::Status RunBuiltinAndReduce(const Bytecode& bytecode,
   XLS_VLOG(3) << "Executing builtin AndReduce.";
   XLS_RET_CHECK(!stack.empty());
   XLS_ASSIGN_OR_RETURN(InterpValue value, stack.Pop());
-  XLS_ASSIGN_OR_RETURN(Bits bits, value.GetBits());
-  bits = bits_ops::AndReduce(bits);
-  stack.Push(InterpValue::MakeBool(bits.IsOne()));
+  XLS_RET_CHECK(value.HasBits());
+  const Bits& bits = value.GetBitsOrDie();
+  stack.Push(InterpValue::MakeBool(bits.IsAllOnes()));
   return absl::OkStatus();
 }
 
@@ -515,7 +520,8 @@ absl::Status RunBuiltinClz(const Bytecode& bytecode, InterpreterStack& stack) {
   XLS_RET_CHECK(!stack.empty());
 
   XLS_ASSIGN_OR_RETURN(InterpValue input, stack.Pop());
-  XLS_ASSIGN_OR_RETURN(Bits bits, input.GetBits());
+  XLS_RET_CHECK(input.HasBits());
+  const Bits& bits = input.GetBitsOrDie();
   stack.Push(
       InterpValue::MakeUBits(bits.bit_count(), bits.CountLeadingZeros()));
 
@@ -539,7 +545,8 @@ absl::Status RunBuiltinCtz(const Bytecode& bytecode, InterpreterStack& stack) {
   XLS_RET_CHECK(!stack.empty());
 
   XLS_ASSIGN_OR_RETURN(InterpValue input, stack.Pop());
-  XLS_ASSIGN_OR_RETURN(Bits bits, input.GetBits());
+  XLS_RET_CHECK(input.HasBits());
+  const Bits& bits = input.GetBitsOrDie();
   stack.Push(
       InterpValue::MakeUBits(bits.bit_count(), bits.CountTrailingZeros()));
 
@@ -559,7 +566,8 @@ absl::Status RunBuiltinEnumerate(const Bytecode& bytecode,
     elements.push_back(
         InterpValue::MakeTuple({InterpValue::MakeU32(i), values->at(i)}));
   }
-  XLS_ASSIGN_OR_RETURN(InterpValue result, InterpValue::MakeArray(elements));
+  XLS_ASSIGN_OR_RETURN(InterpValue result,
+                       InterpValue::MakeArray(std::move(elements)));
   stack.Push(result);
   return absl::OkStatus();
 }
@@ -569,9 +577,9 @@ absl::Status RunBuiltinOrReduce(const Bytecode& bytecode,
   XLS_VLOG(3) << "Executing builtin OrReduce.";
   XLS_RET_CHECK(!stack.empty());
   XLS_ASSIGN_OR_RETURN(InterpValue value, stack.Pop());
-  XLS_ASSIGN_OR_RETURN(Bits bits, value.GetBits());
-  bits = bits_ops::OrReduce(bits);
-  stack.Push(InterpValue::MakeBool(bits.IsOne()));
+  XLS_RET_CHECK(value.HasBits());
+  const Bits& bits = value.GetBitsOrDie();
+  stack.Push(InterpValue::MakeBool(!bits.IsZero()));
   return absl::OkStatus();
 }
 
@@ -617,9 +625,8 @@ absl::Status RunBuiltinRev(const Bytecode& bytecode, InterpreterStack& stack) {
     return absl::InvalidArgumentError(
         "Argument to `rev` builtin must be an unsigned bits-typed value.");
   }
-  XLS_ASSIGN_OR_RETURN(Bits bits, value.GetBits());
-  stack.Push(
-      InterpValue::MakeBits(/*is_signed=*/false, bits_ops::Reverse(bits)));
+  stack.Push(InterpValue::MakeBits(/*is_signed=*/false,
+                                   bits_ops::Reverse(value.GetBitsOrDie())));
   return absl::OkStatus();
 }
 
@@ -653,9 +660,9 @@ absl::Status RunBuiltinXorReduce(const Bytecode& bytecode,
   XLS_VLOG(3) << "Executing builtin XorReduce.";
   XLS_RET_CHECK(!stack.empty());
   XLS_ASSIGN_OR_RETURN(InterpValue value, stack.Pop());
-  XLS_ASSIGN_OR_RETURN(Bits bits, value.GetBits());
-  bits = bits_ops::XorReduce(bits);
-  stack.Push(InterpValue::MakeBool(bits.IsOne()));
+  XLS_RET_CHECK(value.HasBits());
+  const Bits& bits = value.GetBitsOrDie();
+  stack.Push(InterpValue::MakeBool(bits.PopCount() % 2 == 1));
   return absl::OkStatus();
 }
 
@@ -52,7 +52,6 @@
 #include "re2/re2.h"
 
 namespace xls::dslx {
-namespace {
 
 absl::StatusOr<Bytecode::Op> OpFromString(std::string_view s) {
   if (s == "uadd") {
@@ -100,6 +99,12 @@ absl::StatusOr<Bytecode::Op> OpFromString(std::string_view s) {
   if (s == "fail") {
     return Bytecode::Op::kFail;
   }
+  if (s == "fused_binop") {
+    return Bytecode::Op::kFusedBinop;
+  }
+  if (s == "fused_compare_jump_rel_if") {
+    return Bytecode::Op::kFusedCompareJumpRelIf;
+  }
   if (s == "ge") {
     return Bytecode::Op::kGe;
   }
@@ -145,6 +150,9 @@ absl::StatusOr<Bytecode::Op> OpFromString(std::string_view s) {
   if (s == "match_arm") {
     return Bytecode::Op::kMatchArm;
   }
+  if (s == "mod") {
+    return Bytecode::Op::kMod;
+  }
   if (s == "smul") {
     return Bytecode::Op::kSMul;
   }
@@ -212,8 +220,6 @@ absl::StatusOr<Bytecode::Op> OpFromString(std::string_view s) {
       absl::StrCat("String was not a bytecode op: `", s, "`"));
 }
 
-}  // namespace
-
 std::string OpToString(Bytecode::Op op) {
   switch (op) {
     case Bytecode::Op::kSAdd:
@@ -320,6 +326,10 @@ std::string OpToString(Bytecode::Op op) {
       return "width_slice";
     case Bytecode::Op::kXor:
       return "xor";
+    case Bytecode::Op::kFusedBinop:
+      return "fused_binop";
+    case Bytecode::Op::kFusedCompareJumpRelIf:
+      return "fused_compare_jump_rel_if";
   }
   return absl::StrCat("<invalid: ", static_cast<int>(op), ">");
 }
@@ -542,6 +552,20 @@ absl::StatusOr<const Bytecode::ChannelData*> Bytecode::channel_data() const {
   return &std::get<ChannelData>(data_.value());
 }
 
+absl::StatusOr<const Bytecode::FusedBinopData*> Bytecode::fused_binop_data()
+    const {
+  XLS_RET_CHECK(data_.has_value());
+  XLS_RET_CHECK(std::holds_alternative<FusedBinopData>(data_.value()));
+  return &std::get<FusedBinopData>(data_.value());
+}
+
+absl::StatusOr<const Bytecode::CompareJumpData*> Bytecode::compare_jump_data()
+    const {
+  XLS_RET_CHECK(data_.has_value());
+  XLS_RET_CHECK(std::holds_alternative<CompareJumpData>(data_.value()));
+  return &std::get<CompareJumpData>(data_.value());
+}
+
 absl::StatusOr<Bytecode::SlotIndex> Bytecode::slot_index() const {
   XLS_RET_CHECK(data_.has_value());
   XLS_RET_CHECK(std::holds_alternative<SlotIndex>(data_.value()));
@@ -655,6 +679,26 @@ std::string Bytecode::ToString(bool source_locs) const {
       std::string operator()(const SpawnData& spawn_data) {
         return spawn_data.spawn()->ToString();
       }
+
+      std::string operator()(const FusedBinopData& fused) {
+        std::string rhs =
+            std::holds_alternative<SlotIndex>(fused.rhs())
+                ? absl::StrCat("slot:", std::get<SlotIndex>(fused.rhs()).value())
+                : std::get<InterpValue>(fused.rhs()).ToString();
+        std::string result =
+            absl::StrFormat("%s slot:%d %s", OpToString(fused.binop()),
+                            fused.lhs().value(), rhs);
+        if (fused.dest().has_value()) {
+          absl::StrAppend(&result, " -> slot:", fused.dest()->value());
+        }
+        return result;
+      }
+
+      std::string operator()(const CompareJumpData& compare_jump) {
+        return absl::StrFormat("%s %s %+d", OpToString(compare_jump.compare()),
+                               compare_jump.literal().ToString(),
+                               compare_jump.target().value());
+      }
     };
 
     std::string data_string = absl::visit(DataVisitor(), data_.value());
@@ -760,6 +804,16 @@ std::vector<Bytecode> BytecodeFunction::CloneBytecodes() const {
         bytecodes.emplace_back(
             Bytecode(bc.source_span(), bc.op(),
                      std::get<InterpValue>(bc.data().value())));
+      } else if (std::holds_alternative<Bytecode::FusedBinopData>(
+                     bc.data().value())) {
+        bytecodes.emplace_back(Bytecode(
+            bc.source_span(), bc.op(),
+            std::get<Bytecode::FusedBinopData>(bc.data().value())));
+      } else if (std::holds_alternative<Bytecode::CompareJumpData>(
+                     bc.data().value())) {
+        bytecodes.emplace_back(Bytecode(
+            bc.source_span(), bc.op(),
+            std::get<Bytecode::CompareJumpData>(bc.data().value())));
       } else {
         const std::unique_ptr<Type>& type =
             std::get<std::unique_ptr<Type>>(bc.data().value());
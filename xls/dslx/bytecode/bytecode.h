@@ -181,6 +181,20 @@ class Bytecode {
     kWidthSlice,
     // Performs a bitwise XOR of the top two values on the stack.
     kXor,
+
+    // Superinstructions: these are never produced by the emitter, only by
+    // `FuseSuperinstructions` (see bytecode_optimizer.h), and each one stands
+    // in for a common sequence of the ops above.
+
+    // Applies the binary op held in the `FusedBinopData` data member to a
+    // slot value and a slot-or-literal value without staging either on the
+    // stack. The result is pushed, or stored to a slot if the data member
+    // names one. Replaces `load; load|literal; <binop>[; store]`.
+    kFusedBinop,
+    // Compares TOS0 against the literal held in the `CompareJumpData` data
+    // member using its comparison op, pops TOS0, and jumps (relative) if the
+    // comparison is true. Replaces `literal; <cmp>; jump_rel_if`.
+    kFusedCompareJumpRelIf,
   };
 
   // Indicates the amount by which the PC should be adjusted.
@@ -369,9 +383,50 @@ class Bytecode {
     std::unique_ptr<ValueFormatDescriptor> value_fmt_desc_;
   };
 
+  // Operands for a kFusedBinop superinstruction.
+  class FusedBinopData {
+   public:
+    FusedBinopData(Op binop, SlotIndex lhs,
+                   std::variant<SlotIndex, InterpValue> rhs,
+                   std::optional<SlotIndex> dest)
+        : binop_(binop), lhs_(lhs), rhs_(std::move(rhs)), dest_(dest) {}
+
+    // The (non-fused) binary op being applied.
+    Op binop() const { return binop_; }
+    SlotIndex lhs() const { return lhs_; }
+    // The RHS operand is either another slot or an immediate literal.
+    const std::variant<SlotIndex, InterpValue>& rhs() const { return rhs_; }
+    // When present the result is stored here instead of being pushed.
+    const std::optional<SlotIndex>& dest() const { return dest_; }
+
+   private:
+    Op binop_;
+    SlotIndex lhs_;
+    std::variant<SlotIndex, InterpValue> rhs_;
+    std::optional<SlotIndex> dest_;
+  };
+
+  // Operands for a kFusedCompareJumpRelIf superinstruction.
+  class CompareJumpData {
+   public:
+    CompareJumpData(Op compare, InterpValue literal, JumpTarget target)
+        : compare_(compare), literal_(std::move(literal)), target_(target) {}
+
+    // The (non-fused) comparison op; TOS0 is its LHS and `literal` its RHS.
+    Op compare() const { return compare_; }
+    const InterpValue& literal() const { return literal_; }
+    JumpTarget target() const { return target_; }
+
+   private:
+    Op compare_;
+    InterpValue literal_;
+    JumpTarget target_;
+  };
+
   using Data = std::variant<InterpValue, JumpTarget, NumElements, SlotIndex,
                             std::unique_ptr<Type>, InvocationData, MatchArmItem,
-                            SpawnData, TraceData, ChannelData>;
+                            SpawnData, TraceData, ChannelData, FusedBinopData,
+                            CompareJumpData>;
 
   static Bytecode MakeDup(Span span);
   static Bytecode MakeIndex(Span span);
@@ -423,6 +478,8 @@ class Bytecode {
   absl::StatusOr<const SpawnData*> spawn_data() const;
   absl::StatusOr<const TraceData*> trace_data() const;
   absl::StatusOr<const ChannelData*> channel_data() const;
+  absl::StatusOr<const FusedBinopData*> fused_binop_data() const;
+  absl::StatusOr<const CompareJumpData*> compare_jump_data() const;
   absl::StatusOr<const Type*> type_data() const;
   absl::StatusOr<InterpValue> value_data() const;
 
@@ -452,6 +509,9 @@ class Bytecode {
 
 std::string OpToString(Bytecode::Op op);
 
+// Inverse of `OpToString`.
+absl::StatusOr<Bytecode::Op> OpFromString(std::string_view s);
+
 // Holds all the bytecode implementing a function along with useful metadata.
 class BytecodeFunction {
  public:
@@ -476,6 +536,10 @@ class BytecodeFunction {
   // Creates and returns a [caller-owned] copy of the internal bytecodes.
   std::vector<Bytecode> CloneBytecodes() const;
 
+  // Moves the internal bytecodes out to the caller, leaving this function
+  // empty; e.g. for rewriting them into a new BytecodeFunction.
+  std::vector<Bytecode> TakeBytecodes() { return std::move(bytecodes_); }
+
  private:
   BytecodeFunction(const Module* owner, const Function* source_fn,
                    const TypeInfo* type_info, std::vector<Bytecode> bytecode);
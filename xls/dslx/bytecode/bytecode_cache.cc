@@ -13,40 +13,193 @@
 // limitations under the License.
 #include "xls/dslx/bytecode/bytecode_cache.h"
 
+#include <map>
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/file/content_digest.h"
+#include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/bytecode/bytecode.pb.h"
 #include "xls/dslx/bytecode/bytecode_emitter.h"
+#include "xls/dslx/bytecode/bytecode_optimizer.h"
+#include "xls/dslx/bytecode/bytecode_store.h"
+#include "xls/dslx/bytecode/bytecode_to_proto.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/type_system/parametric_env.h"
 #include "xls/dslx/type_system/type_info.h"
 
 namespace xls::dslx {
+namespace {
 
-BytecodeCache::BytecodeCache(ImportData* import_data)
-    : import_data_(import_data) {}
+// Bump whenever the emitter, optimizer or serialized form changes in a way that
+// makes previously stored bytecode invalid.
+constexpr std::string_view kStoreFormatVersion = "1";
+
+}  // namespace
+
+BytecodeCache::BytecodeCache(ImportData* import_data,
+                             SharedBytecodeStore* store)
+    : import_data_(import_data), store_(store) {}
+
+std::optional<std::string> BytecodeCache::GetModuleClosureDigest(
+    const Module* module) {
+  {
+    absl::MutexLock lock(&closure_digests_mutex_);
+    auto it = module_closure_digests_.find(module);
+    if (it != module_closure_digests_.end()) {
+      return it->second;
+    }
+  }
+
+  // Ordered by module name so the digest doesn't depend on import order.
+  std::map<std::string, std::string> source_digests;
+  auto compute = [&]() -> std::optional<std::string> {
+    std::vector<const Module*> worklist = {module};
+    absl::flat_hash_set<const Module*> seen = {module};
+    while (!worklist.empty()) {
+      const Module* m = worklist.back();
+      worklist.pop_back();
+      if (!m->fs_path().has_value()) {
+        return std::nullopt;
+      }
+      std::optional<std::string_view> text =
+          import_data_->GetSourceText(*m->fs_path());
+      if (!text.has_value()) {
+        XLS_VLOG(2) << "Not storing bytecode for module " << m->name()
+                    << ": its source text was not recorded";
+        return std::nullopt;
+      }
+      // Spans in stored bytecode name the file, so it's part of the key too.
+      source_digests[m->name()] =
+          absl::StrCat(m->fs_path()->string(), ":", Sha256Hex(*text));
+
+      absl::StatusOr<TypeInfo*> type_info = import_data_->GetRootTypeInfo(m);
+      if (!type_info.ok()) {
+        return std::nullopt;
+      }
+      for (const auto& [import, info] : (*type_info)->imports()) {
+        if (seen.insert(info.module).second) {
+          worklist.push_back(info.module);
+        }
+      }
+    }
+    std::string closure;
+    for (const auto& [name, digest] : source_digests) {
+      absl::StrAppend(&closure, name, ":", digest, "\n");
+    }
+    return Sha256Hex(closure);
+  };
+  std::optional<std::string> digest = compute();
+
+  absl::MutexLock lock(&closure_digests_mutex_);
+  // Another thread may have computed the same digest in the meantime; both are
+  // equal, so keep the first.
+  return module_closure_digests_.emplace(module, std::move(digest))
+      .first->second;
+}
+
+std::optional<std::string> BytecodeCache::GetStoreKey(
+    const Function& f, const std::optional<ParametricEnv>& caller_bindings) {
+  std::optional<std::string> closure_digest =
+      GetModuleClosureDigest(f.owner());
+  if (!closure_digest.has_value()) {
+    return std::nullopt;
+  }
+  // The span distinguishes functions with the same name, e.g. those of
+  // different procs.
+  return Sha256Hex(absl::StrCat(
+      kStoreFormatVersion, "\n", *closure_digest, "\n", f.span().ToString(),
+      "\n", caller_bindings.has_value() ? caller_bindings->ToString() : ""));
+}
 
 absl::StatusOr<BytecodeFunction*> BytecodeCache::GetOrCreateBytecodeFunction(
     const Function& f, const TypeInfo* type_info,
     const std::optional<ParametricEnv>& caller_bindings) {
   XLS_RET_CHECK(type_info != nullptr);
   Key key = std::make_tuple(&f, type_info, caller_bindings);
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      return it->second.get();
+    }
+  }
+
+  // Hashing the import closure doesn't touch the cache, so it's done without
+  // holding the lock to keep other interpreters' lookups from waiting on it.
+  std::optional<std::string> store_key;
+  if (store_ != nullptr) {
+    store_key = GetStoreKey(f, caller_bindings);
+  }
+
+  absl::MutexLock lock(&mutex_);
   if (!cache_.contains(key)) {
-    XLS_ASSIGN_OR_RETURN(
-        std::unique_ptr<BytecodeFunction> bf,
-        BytecodeEmitter::Emit(import_data_, type_info, f, caller_bindings));
+    std::unique_ptr<BytecodeFunction> bf;
+    if (store_key.has_value()) {
+      if (std::shared_ptr<const BytecodeFunctionProto> proto =
+              store_->Get(*store_key)) {
+        absl::StatusOr<std::unique_ptr<BytecodeFunction>> restored =
+            BytecodeFunctionFromProto(*proto, f, type_info, *import_data_);
+        if (restored.ok()) {
+          bf = std::move(restored).value();
+        } else {
+          XLS_VLOG(1) << "Could not restore stored bytecode for "
+                      << f.identifier() << ": " << restored.status();
+        }
+      }
+    }
+
+    if (bf == nullptr) {
+      XLS_ASSIGN_OR_RETURN(
+          bf,
+          BytecodeEmitter::Emit(import_data_, type_info, f, caller_bindings));
+      // Cached functions are executed repeatedly, so they're worth the extra
+      // pass to form superinstructions.
+      XLS_ASSIGN_OR_RETURN(bf, OptimizeBytecodeFunction(std::move(bf)));
+      if (store_key.has_value()) {
+        absl::StatusOr<BytecodeFunctionProto> proto =
+            BytecodeFunctionToProto(*bf);
+        if (proto.ok()) {
+          store_->Put(*store_key, std::move(proto).value());
+        } else {
+          XLS_VLOG(2) << "Not storing bytecode for " << f.identifier() << ": "
+                      << proto.status();
+        }
+      }
+    }
     cache_.emplace(key, std::move(bf));
   }
 
   return cache_.at(key).get();
 }
 
+void BytecodeCache::EvictModule(const Module* module) {
+  {
+    absl::MutexLock lock(&mutex_);
+    const TypeInfoOwner& type_info_owner = import_data_->type_info_owner();
+    absl::erase_if(cache_, [&](const auto& item) {
+      const auto& [f, type_info, caller_bindings] = item.first;
+      return f->owner() == module ||
+             type_info_owner.GetCreatingModule(type_info) == module;
+    });
+  }
+  // Digests of modules that import `module` are stale as well, so start over.
+  absl::MutexLock lock(&closure_digests_mutex_);
+  module_closure_digests_.clear();
+}
+
 }  // namespace xls::dslx
@@ -16,12 +16,16 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/dslx/bytecode/bytecode.h"
 #include "xls/dslx/bytecode/bytecode_cache_interface.h"
+#include "xls/dslx/bytecode/bytecode_store.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/type_system/parametric_env.h"
@@ -29,20 +33,51 @@
 
 namespace xls::dslx {
 
+// Thread-safe: a single cache may be shared by interpreters running
+// concurrently against the same ImportData (e.g. parallel test execution).
+// Returned BytecodeFunctions are immutable and owned by the cache.
+//
+// If a `store` is given, functions are first looked up there (in serialized
+// form) before being emitted, and newly emitted functions are added to it.
+// Store entries are keyed on a digest of the source text of the function's
+// module and everything it transitively imports, as recorded in the ImportData
+// when they were parsed (see ImportData::SetSourceText), so they're only used
+// for modules whose source was recorded; the ImportData must have
+// record_source_texts() set before those modules are parsed.
 class BytecodeCache : public BytecodeCacheInterface {
  public:
-  explicit BytecodeCache(ImportData* import_data);
+  explicit BytecodeCache(ImportData* import_data,
+                         SharedBytecodeStore* store = nullptr);
 
   absl::StatusOr<BytecodeFunction*> GetOrCreateBytecodeFunction(
       const Function& f, const TypeInfo* type_info,
       const std::optional<ParametricEnv>& caller_bindings) override;
 
+  void EvictModule(const Module* module) override;
+
  private:
   using Key = std::tuple<const Function*, const TypeInfo*,
                          std::optional<ParametricEnv>>;
 
+  // Returns the key for `f` in `store_`, or nullopt if the sources it depends
+  // on cannot be read.
+  std::optional<std::string> GetStoreKey(
+      const Function& f, const std::optional<ParametricEnv>& caller_bindings)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns a digest of the source text of `module` and its transitive
+  // imports, or nullopt if any of them was not recorded.
+  std::optional<std::string> GetModuleClosureDigest(const Module* module)
+      ABSL_LOCKS_EXCLUDED(mutex_, closure_digests_mutex_);
+
   ImportData* import_data_;
-  absl::flat_hash_map<Key, std::unique_ptr<BytecodeFunction>> cache_;
+  SharedBytecodeStore* store_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::unique_ptr<BytecodeFunction>> cache_
+      ABSL_GUARDED_BY(mutex_);
+  absl::Mutex closure_digests_mutex_;
+  absl::flat_hash_map<const Module*, std::optional<std::string>>
+      module_closure_digests_ ABSL_GUARDED_BY(closure_digests_mutex_);
 };
 
 }  // namespace xls::dslx
@@ -37,6 +37,10 @@ class BytecodeCacheInterface {
   virtual absl::StatusOr<BytecodeFunction*> GetOrCreateBytecodeFunction(
       const Function& f, const TypeInfo* type_info,
       const std::optional<ParametricEnv>& caller_bindings) = 0;
+
+  // Drops any cached bytecode for functions in (or type information of) the
+  // given module, which is about to be destroyed.
+  virtual void EvictModule(const Module* module) {}
 };
 
 }  // namespace xls::dslx
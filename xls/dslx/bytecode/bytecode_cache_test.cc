@@ -0,0 +1,274 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/bytecode_cache.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/bytecode/bytecode_interpreter.h"
+#include "xls/dslx/bytecode/bytecode_store.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/frontend/module.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+// Exercises most kinds of bytecode data: literals (including enum and function
+// values), parametric invocations, types for casts and match arms.
+constexpr std::string_view kProgram = R"(
+enum Color : u2 {
+  RED = 0,
+  GREEN = 1,
+  BLUE = 2,
+}
+
+fn widen<N: u32>(x: bits[N]) -> u32 { x as u32 }
+
+fn pick(c: Color) -> u32 {
+  match c {
+    Color::RED => u32:1,
+    Color::GREEN => u32:2,
+    _ => u32:3,
+  }
+}
+
+fn main(x: u8) -> u32 {
+  let (a, b) = (x, Color::GREEN);
+  widen(a) + pick(b) + widen(u4:3)
+}
+)";
+
+struct MainResult {
+  InterpValue value;
+  // Bytecode for `main`, with source locations.
+  std::string bytecode;
+};
+
+// Typechecks `text` as the module at `path` in a fresh ImportData whose
+// bytecode cache uses `store`, then runs `main(u8:5)`.
+absl::StatusOr<MainResult> RunMainOnText(std::string_view text,
+                                         const std::filesystem::path& path,
+                                         SharedBytecodeStore* store) {
+  std::unique_ptr<ImportData> import_data = CreateImportDataPtrForTest();
+  import_data->set_record_source_texts(store != nullptr);
+  auto cache = std::make_unique<BytecodeCache>(import_data.get(), store);
+  BytecodeCache* cache_ptr = cache.get();
+  import_data->SetBytecodeCache(std::move(cache));
+  XLS_ASSIGN_OR_RETURN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(text, path.string(), "top", import_data.get()));
+  XLS_ASSIGN_OR_RETURN(Function * f,
+                       tm.module->GetMemberOrError<Function>("main"));
+  XLS_ASSIGN_OR_RETURN(BytecodeFunction * bf,
+                       cache_ptr->GetOrCreateBytecodeFunction(
+                           *f, tm.type_info, /*caller_bindings=*/std::nullopt));
+  XLS_ASSIGN_OR_RETURN(
+      InterpValue value,
+      BytecodeInterpreter::Interpret(import_data.get(), bf,
+                                     {InterpValue::MakeUBits(8, 5)}));
+  return MainResult{
+      .value = std::move(value),
+      .bytecode = BytecodesToString(bf->bytecodes(), /*source_locs=*/true)};
+}
+
+// As RunMainOnText, with the module read from `path`.
+absl::StatusOr<MainResult> RunMain(const std::filesystem::path& path,
+                                   SharedBytecodeStore* store) {
+  XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+  return RunMainOnText(text, path, store);
+}
+
+class BytecodeCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+    temp_dir_ = std::move(temp_dir);
+    module_path_ = temp_dir_->path() / "top.x";
+    XLS_ASSERT_OK(SetFileContents(module_path_, kProgram));
+  }
+
+  std::filesystem::path cache_dir() const {
+    return temp_dir_->path() / "cache";
+  }
+
+  std::optional<TempDirectory> temp_dir_;
+  std::filesystem::path module_path_;
+};
+
+TEST_F(BytecodeCacheTest, StoreIsSharedAcrossImportData) {
+  SharedBytecodeStore store;
+  XLS_ASSERT_OK_AND_ASSIGN(MainResult emitted, RunMain(module_path_, &store));
+  EXPECT_EQ(emitted.value, InterpValue::MakeU32(10));
+  // `main`, `pick` and both instantiations of `widen`.
+  EXPECT_EQ(store.stats().misses, 4);
+  EXPECT_EQ(store.stats().memory_hits, 0);
+
+  XLS_ASSERT_OK_AND_ASSIGN(MainResult restored, RunMain(module_path_, &store));
+  EXPECT_EQ(restored.value, emitted.value);
+  EXPECT_EQ(restored.bytecode, emitted.bytecode);
+  EXPECT_EQ(store.stats().misses, 4);
+  EXPECT_EQ(store.stats().memory_hits, 4);
+  // Without a directory nothing is written out.
+  EXPECT_EQ(store.stats().writes, 0);
+}
+
+TEST_F(BytecodeCacheTest, StoreIsReusedFromDisk) {
+  std::optional<MainResult> emitted;
+  {
+    SharedBytecodeStore store(cache_dir());
+    XLS_ASSERT_OK(RecursivelyCreateDir(cache_dir()));
+    XLS_ASSERT_OK_AND_ASSIGN(emitted, RunMain(module_path_, &store));
+    EXPECT_EQ(store.stats().writes, 4);
+  }
+
+  SharedBytecodeStore store(cache_dir(), /*read_only=*/true);
+  XLS_ASSERT_OK_AND_ASSIGN(MainResult restored, RunMain(module_path_, &store));
+  EXPECT_EQ(restored.value, emitted->value);
+  EXPECT_EQ(restored.bytecode, emitted->bytecode);
+  EXPECT_EQ(store.stats().disk_hits, 4);
+  EXPECT_EQ(store.stats().misses, 0);
+}
+
+TEST_F(BytecodeCacheTest, ChangedSourceMissesStore) {
+  XLS_ASSERT_OK(RecursivelyCreateDir(cache_dir()));
+  SharedBytecodeStore store(cache_dir());
+  XLS_ASSERT_OK(RunMain(module_path_, &store).status());
+
+  XLS_ASSERT_OK(SetFileContents(module_path_,
+                                absl::StrCat("// A comment moves every span.\n",
+                                             kProgram)));
+  XLS_ASSERT_OK_AND_ASSIGN(MainResult result, RunMain(module_path_, &store));
+  EXPECT_EQ(result.value, InterpValue::MakeU32(10));
+  EXPECT_EQ(store.stats().memory_hits, 0);
+  EXPECT_EQ(store.stats().disk_hits, 0);
+  EXPECT_EQ(store.stats().misses, 8);
+}
+
+TEST_F(BytecodeCacheTest, StoreIsKeyedOnParsedSourceNotFileOnDisk) {
+  SharedBytecodeStore store;
+  XLS_ASSERT_OK(SetFileContents(module_path_, "// Not what was parsed.\n"));
+  XLS_ASSERT_OK(RunMainOnText(kProgram, module_path_, &store).status());
+  EXPECT_EQ(store.stats().misses, 4);
+
+  XLS_ASSERT_OK(SetFileContents(module_path_, "// Nor is this.\n"));
+  XLS_ASSERT_OK(RunMainOnText(kProgram, module_path_, &store).status());
+  EXPECT_EQ(store.stats().misses, 4);
+  EXPECT_EQ(store.stats().memory_hits, 4);
+}
+
+TEST_F(BytecodeCacheTest, ReadOnlyStoreWritesNothing) {
+  XLS_ASSERT_OK(RecursivelyCreateDir(cache_dir()));
+  SharedBytecodeStore store(cache_dir(), /*read_only=*/true);
+  XLS_ASSERT_OK(RunMain(module_path_, &store).status());
+  XLS_ASSERT_OK(RunMain(module_path_, &store).status());
+  EXPECT_EQ(store.stats().writes, 0);
+  // Entries are still shared in memory.
+  EXPECT_EQ(store.stats().memory_hits, 4);
+  EXPECT_TRUE(std::filesystem::is_empty(cache_dir()));
+}
+
+TEST(BytecodeCacheSourceTextTest, RecordedOnlyOnRequestAndDroppedOnEviction) {
+  ImportData import_data = CreateImportDataForTest();
+  import_data.SetSourceText("a.x", "fn f() {}");
+  EXPECT_FALSE(import_data.GetSourceText("a.x").has_value());
+
+  import_data.set_record_source_texts(true);
+  import_data.SetSourceText("a.x", "fn f() {}");
+  EXPECT_EQ(import_data.GetSourceText("a.x"), "fn f() {}");
+
+  Module module("a", std::filesystem::path("a.x"));
+  XLS_ASSERT_OK(import_data.EvictModule(&module));
+  EXPECT_FALSE(import_data.GetSourceText("a.x").has_value());
+}
+
+// Mimics interpreter_main startup on a module of `state.range(0)` functions:
+// parse, typecheck, and emit and run `main`, which calls all of them. The store
+// is absent (state.range(1) == 0), a cold directory (1) or a warm read-only
+// directory (2), as for a first and a later run with --bytecode_cache_dir.
+void BM_RunMainWithStore(benchmark::State& state) {
+  std::string program;
+  std::string body = "  let y = x as u32;\n";
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    absl::StrAppendFormat(&program, R"(
+fn f%d(x: u32) -> u32 {
+  for (i, acc): (u32, u32) in u32:0..u32:4 {
+    match i {
+      u32:0 => acc + x,
+      u32:1 => acc ^ (x << u32:%d),
+      _ => (acc * u32:3) | i,
+    }
+  }(u32:%d)
+}
+)",
+                          i, i % 32, i);
+    absl::StrAppendFormat(&body, "  let y = f%d(y);\n", i);
+  }
+  absl::StrAppend(&program, "\nfn main(x: u8) -> u32 {\n", body, "  y\n}\n");
+
+  absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
+  CHECK_OK(temp_dir.status());
+  std::filesystem::path module_path = temp_dir->path() / "top.x";
+  std::filesystem::path cache_dir = temp_dir->path() / "cache";
+  CHECK_OK(SetFileContents(module_path, program));
+  CHECK_OK(RecursivelyCreateDir(cache_dir));
+  if (state.range(1) == 2) {
+    SharedBytecodeStore store(cache_dir);
+    CHECK_OK(RunMain(module_path, &store).status());
+  }
+
+  for (auto _ : state) {
+    std::optional<SharedBytecodeStore> store;
+    if (state.range(1) == 1) {
+      state.PauseTiming();
+      std::filesystem::remove_all(cache_dir);
+      CHECK_OK(RecursivelyCreateDir(cache_dir));
+      state.ResumeTiming();
+      store.emplace(cache_dir);
+    } else if (state.range(1) == 2) {
+      store.emplace(cache_dir, /*read_only=*/true);
+    }
+    absl::StatusOr<MainResult> result =
+        RunMain(module_path, store.has_value() ? &*store : nullptr);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_RunMainWithStore)
+    ->ArgsProduct({{16, 128}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace xls::dslx
@@ -407,6 +407,19 @@ absl::Status BytecodeInterpreter::EvalNextInstruction() {
       XLS_RETURN_IF_ERROR(EvalXor(bytecode));
       break;
     }
+    case Bytecode::Op::kFusedBinop: {
+      XLS_RETURN_IF_ERROR(EvalFusedBinop(bytecode));
+      break;
+    }
+    case Bytecode::Op::kFusedCompareJumpRelIf: {
+      XLS_ASSIGN_OR_RETURN(std::optional<int64_t> new_pc,
+                           EvalFusedCompareJumpRelIf(frame->pc(), bytecode));
+      if (new_pc.has_value()) {
+        frame->set_pc(new_pc.value());
+        return absl::OkStatus();
+      }
+      break;
+    }
   }
   frame->IncrementPc();
   return absl::OkStatus();
@@ -425,26 +438,87 @@ absl::Status BytecodeInterpreter::EvalBinop(
 
 absl::Status BytecodeInterpreter::EvalAdd(const Bytecode& bytecode,
                                           bool is_signed) {
-  return EvalBinop([&](const InterpValue& lhs,
-                       const InterpValue& rhs) -> absl::StatusOr<InterpValue> {
-    XLS_ASSIGN_OR_RETURN(InterpValue output, lhs.Add(rhs));
-
-    // Slow path: when rollover warning hook is enabled.
-    if (options_.rollover_hook() != nullptr) {
-      auto make_big_int = [is_signed](const Bits& bits) {
-        return is_signed ? BigInt::MakeSigned(bits)
-                         : BigInt::MakeUnsigned(bits);
-      };
-      bool rollover =
-          make_big_int(lhs.GetBitsOrDie()) + make_big_int(rhs.GetBitsOrDie()) !=
-          make_big_int(output.GetBitsOrDie());
-      if (rollover) {
-        options_.rollover_hook()(bytecode.source_span());
-      }
+  return EvalBinop([&](const InterpValue& lhs, const InterpValue& rhs) {
+    return ApplyBinop(bytecode.op(), bytecode.source_span(), lhs, rhs);
+  });
+}
+
+absl::StatusOr<InterpValue> BytecodeInterpreter::ApplyBinop(
+    Bytecode::Op op, const Span& span, const InterpValue& lhs,
+    const InterpValue& rhs) {
+  // Slow path for arithmetic ops: only taken when the rollover warning hook is
+  // enabled.
+  const bool check_rollover_enabled = options_.rollover_hook() != nullptr;
+  auto check_rollover = [&](bool is_signed, const InterpValue& output,
+                            auto big_op) {
+    auto make_big_int = [is_signed](const Bits& bits) {
+      return is_signed ? BigInt::MakeSigned(bits) : BigInt::MakeUnsigned(bits);
+    };
+    bool rollover = big_op(make_big_int(lhs.GetBitsOrDie()),
+                           make_big_int(rhs.GetBitsOrDie())) !=
+                    make_big_int(output.GetBitsOrDie());
+    if (rollover) {
+      options_.rollover_hook()(span);
     }
+  };
 
-    return output;
-  });
+  switch (op) {
+    case Bytecode::Op::kUAdd:
+    case Bytecode::Op::kSAdd: {
+      XLS_ASSIGN_OR_RETURN(InterpValue output, lhs.Add(rhs));
+      if (check_rollover_enabled) {
+        check_rollover(op == Bytecode::Op::kSAdd, output,
+                       [](const BigInt& a, const BigInt& b) { return a + b; });
+      }
+      return output;
+    }
+    case Bytecode::Op::kUSub:
+    case Bytecode::Op::kSSub: {
+      XLS_ASSIGN_OR_RETURN(InterpValue output, lhs.Sub(rhs));
+      if (check_rollover_enabled) {
+        check_rollover(op == Bytecode::Op::kSSub, output,
+                       [](const BigInt& a, const BigInt& b) { return a - b; });
+      }
+      return output;
+    }
+    case Bytecode::Op::kUMul:
+    case Bytecode::Op::kSMul: {
+      XLS_ASSIGN_OR_RETURN(InterpValue output, lhs.Mul(rhs));
+      if (check_rollover_enabled) {
+        check_rollover(op == Bytecode::Op::kSMul, output,
+                       [](const BigInt& a, const BigInt& b) { return a * b; });
+      }
+      return output;
+    }
+    case Bytecode::Op::kAnd:
+      return lhs.BitwiseAnd(rhs);
+    case Bytecode::Op::kOr:
+      return lhs.BitwiseOr(rhs);
+    case Bytecode::Op::kXor:
+      return lhs.BitwiseXor(rhs);
+    case Bytecode::Op::kConcat:
+      return lhs.Concat(rhs);
+    case Bytecode::Op::kShl:
+      return lhs.Shl(rhs);
+    case Bytecode::Op::kShr:
+      return lhs.IsSigned() ? lhs.Shra(rhs) : lhs.Shrl(rhs);
+    case Bytecode::Op::kEq:
+      return InterpValue::MakeBool(lhs.Eq(rhs));
+    case Bytecode::Op::kNe:
+      return InterpValue::MakeBool(lhs.Ne(rhs));
+    case Bytecode::Op::kLt:
+      return lhs.Lt(rhs);
+    case Bytecode::Op::kLe:
+      return lhs.Le(rhs);
+    case Bytecode::Op::kGt:
+      return lhs.Gt(rhs);
+    case Bytecode::Op::kGe:
+      return lhs.Ge(rhs);
+    default:
+      return absl::InternalError(absl::StrCat(
+          "BytecodeInterpreter::ApplyBinop; not a fusable binop: ",
+          OpToString(op)));
+  }
 }
 
 absl::Status BytecodeInterpreter::EvalAnd(const Bytecode& bytecode) {
@@ -981,25 +1055,8 @@ absl::Status BytecodeInterpreter::EvalMatchArm(const Bytecode& bytecode) {
 
 absl::Status BytecodeInterpreter::EvalMul(const Bytecode& bytecode,
                                           bool is_signed) {
-  return EvalBinop([&](const InterpValue& lhs,
-                       const InterpValue& rhs) -> absl::StatusOr<InterpValue> {
-    XLS_ASSIGN_OR_RETURN(InterpValue output, lhs.Mul(rhs));
-
-    // Slow path: when rollover warning hook is enabled.
-    if (options_.rollover_hook() != nullptr) {
-      auto make_big_int = [is_signed](const Bits& bits) {
-        return is_signed ? BigInt::MakeSigned(bits)
-                         : BigInt::MakeUnsigned(bits);
-      };
-      bool rollover =
-          make_big_int(lhs.GetBitsOrDie()) * make_big_int(rhs.GetBitsOrDie()) !=
-          make_big_int(output.GetBitsOrDie());
-      if (rollover) {
-        options_.rollover_hook()(bytecode.source_span());
-      }
-    }
-
-    return output;
+  return EvalBinop([&](const InterpValue& lhs, const InterpValue& rhs) {
+    return ApplyBinop(bytecode.op(), bytecode.source_span(), lhs, rhs);
   });
 }
 
@@ -1218,26 +1275,58 @@ absl::StatusOr<std::optional<int64_t>> BytecodeInterpreter::EvalJumpRelIf(
 
 absl::Status BytecodeInterpreter::EvalSub(const Bytecode& bytecode,
                                           bool is_signed) {
-  return EvalBinop([&](const InterpValue& lhs,
-                       const InterpValue& rhs) -> absl::StatusOr<InterpValue> {
-    XLS_ASSIGN_OR_RETURN(InterpValue output, lhs.Sub(rhs));
-
-    // Slow path: when rollover warning hook is enabled.
-    if (options_.rollover_hook() != nullptr) {
-      auto make_big_int = [is_signed](const Bits& bits) {
-        return is_signed ? BigInt::MakeSigned(bits)
-                         : BigInt::MakeUnsigned(bits);
-      };
-      bool rollover =
-          make_big_int(lhs.GetBitsOrDie()) - make_big_int(rhs.GetBitsOrDie()) !=
-          make_big_int(output.GetBitsOrDie());
-      if (rollover) {
-        options_.rollover_hook()(bytecode.source_span());
-      }
+  return EvalBinop([&](const InterpValue& lhs, const InterpValue& rhs) {
+    return ApplyBinop(bytecode.op(), bytecode.source_span(), lhs, rhs);
+  });
+}
+
+absl::Status BytecodeInterpreter::EvalFusedBinop(const Bytecode& bytecode) {
+  XLS_ASSIGN_OR_RETURN(const Bytecode::FusedBinopData* data,
+                       bytecode.fused_binop_data());
+  Frame& frame = frames_.back();
+  auto get_slot = [&](Bytecode::SlotIndex slot)
+      -> absl::StatusOr<const InterpValue*> {
+    if (frame.slots().size() <= slot.value()) {
+      return absl::InternalError(absl::StrFormat(
+          "Attempted to access local data in slot %d, which is out of range.",
+          slot.value()));
     }
+    return &frame.slots()[slot.value()];
+  };
 
-    return output;
-  });
+  XLS_ASSIGN_OR_RETURN(const InterpValue* lhs, get_slot(data->lhs()));
+  const InterpValue* rhs;
+  if (std::holds_alternative<Bytecode::SlotIndex>(data->rhs())) {
+    XLS_ASSIGN_OR_RETURN(
+        rhs, get_slot(std::get<Bytecode::SlotIndex>(data->rhs())));
+  } else {
+    rhs = &std::get<InterpValue>(data->rhs());
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      InterpValue result,
+      ApplyBinop(data->binop(), bytecode.source_span(), *lhs, *rhs));
+  if (data->dest().has_value()) {
+    frame.StoreSlot(data->dest().value(), std::move(result));
+  } else {
+    stack_.Push(std::move(result));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::optional<int64_t>>
+BytecodeInterpreter::EvalFusedCompareJumpRelIf(int64_t pc,
+                                               const Bytecode& bytecode) {
+  XLS_ASSIGN_OR_RETURN(const Bytecode::CompareJumpData* data,
+                       bytecode.compare_jump_data());
+  XLS_ASSIGN_OR_RETURN(InterpValue lhs, Pop());
+  XLS_ASSIGN_OR_RETURN(InterpValue compared,
+                       ApplyBinop(data->compare(), bytecode.source_span(), lhs,
+                                  data->literal()));
+  if (compared.IsTrue()) {
+    return pc + data->target().value();
+  }
+  return std::nullopt;
 }
 
 absl::Status BytecodeInterpreter::EvalSwap(const Bytecode& bytecode) {
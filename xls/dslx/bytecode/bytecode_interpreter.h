@@ -164,6 +164,18 @@ class BytecodeInterpreter {
       const std::function<absl::StatusOr<InterpValue>(
           const InterpValue& lhs, const InterpValue& rhs)>& op);
 
+  // Computes `lhs <op> rhs` for the binary ops that may appear in a
+  // superinstruction (including the add/sub/mul rollover reporting, which is
+  // attributed to `span`).
+  absl::StatusOr<InterpValue> ApplyBinop(Bytecode::Op op, const Span& span,
+                                         const InterpValue& lhs,
+                                         const InterpValue& rhs);
+
+  // Superinstructions; see bytecode_optimizer.h.
+  absl::Status EvalFusedBinop(const Bytecode& bytecode);
+  absl::StatusOr<std::optional<int64_t>> EvalFusedCompareJumpRelIf(
+      int64_t pc, const Bytecode& bytecode);
+
   absl::StatusOr<BytecodeFunction*> GetBytecodeFn(
       Function& function, const Invocation* invocation,
       const ParametricEnv& caller_bindings);
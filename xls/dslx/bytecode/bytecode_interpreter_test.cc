@@ -22,10 +22,13 @@
 #include <utility>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "xls/common/file/temp_file.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
@@ -35,6 +38,7 @@
 #include "xls/dslx/bytecode/bytecode.h"
 #include "xls/dslx/bytecode/bytecode_emitter.h"
 #include "xls/dslx/bytecode/bytecode_interpreter_options.h"
+#include "xls/dslx/bytecode/bytecode_optimizer.h"
 #include "xls/dslx/bytecode/interpreter_stack.h"
 #include "xls/dslx/command_line_utils.h"
 #include "xls/dslx/create_import_data.h"
@@ -2545,5 +2549,72 @@ fn main(x: s2, y: s2) -> s2 {
   }
 }
 
+// Runs a loop-heavy function (`state.range(0)` iterations of arithmetic,
+// comparisons and a conditional) as emitted (state.range(1) == 0) or after
+// superinstruction fusion (1). Emission happens once, outside the timed loop.
+void BM_InterpretLoop(benchmark::State& state) {
+  std::string program = absl::StrFormat(R"(
+fn main(x: u32) -> u32 {
+  for (i, acc): (u32, u32) in u32:0..u32:%d {
+    let t = acc + i;
+    let u = t ^ x;
+    let v = u * u32:3;
+    if v > u32:0x8000 { v - i } else { v + u32:7 }
+  }(x)
+}
+)",
+                                        state.range(0));
+  ImportData import_data(CreateImportDataForTest());
+  absl::StatusOr<TypecheckedModule> tm =
+      ParseAndTypecheckOrPrintError(program, &import_data);
+  CHECK_OK(tm.status());
+  absl::StatusOr<Function*> f = tm->module->GetMemberOrError<Function>("main");
+  CHECK_OK(f.status());
+  absl::StatusOr<std::unique_ptr<BytecodeFunction>> bf =
+      BytecodeEmitter::Emit(&import_data, tm->type_info, **f, ParametricEnv());
+  CHECK_OK(bf.status());
+  if (state.range(1) != 0) {
+    bf = OptimizeBytecodeFunction(*std::move(bf));
+    CHECK_OK(bf.status());
+  }
+  state.counters["bytecodes"] = (*bf)->bytecodes().size();
+
+  std::vector<InterpValue> args = {InterpValue::MakeU32(0x1234)};
+  for (auto _ : state) {
+    absl::StatusOr<InterpValue> result =
+        BytecodeInterpreter::Interpret(&import_data, bf->get(), args);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InterpretLoop)->ArgsProduct({{16, 1024}, {0, 1}});
+
+// Runs `state.range(0)` `jump_dest` instructions, which do nothing, so the
+// per-item time is the fixed cost the interpreter loop pays to dispatch any
+// instruction. Comparing it with BM_InterpretLoop's per-iteration time shows
+// how much of a real workload dispatch accounts for, i.e. the most that a
+// different dispatch technique (such as computed goto) could save.
+void BM_InterpretDispatchOnly(benchmark::State& state) {
+  std::vector<Bytecode> bytecodes;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kJumpDest);
+  }
+  bytecodes.emplace_back(kFakeSpan, Bytecode::Op::kLiteral,
+                         InterpValue::MakeU32(0));
+  absl::StatusOr<std::unique_ptr<BytecodeFunction>> bf =
+      BytecodeFunction::Create(/*owner=*/nullptr, /*source_fn=*/nullptr,
+                               /*type_info=*/nullptr, std::move(bytecodes));
+  CHECK_OK(bf.status());
+  for (auto _ : state) {
+    absl::StatusOr<InterpValue> result = BytecodeInterpreter::Interpret(
+        /*import_data=*/nullptr, bf->get(), {});
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InterpretDispatchOnly)->Arg(4096);
+
 }  // namespace
 }  // namespace xls::dslx
@@ -0,0 +1,203 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/bytecode_optimizer.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/interp_value.h"
+
+namespace xls::dslx {
+namespace {
+
+using Op = Bytecode::Op;
+
+bool IsComparison(Op op) {
+  switch (op) {
+    case Op::kEq:
+    case Op::kNe:
+    case Op::kLt:
+    case Op::kLe:
+    case Op::kGt:
+    case Op::kGe:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Binary ops whose interpreter implementation only depends on their two
+// operands (and not on any other stack or frame state).
+bool IsFusableBinop(Op op) {
+  switch (op) {
+    case Op::kUAdd:
+    case Op::kSAdd:
+    case Op::kUSub:
+    case Op::kSSub:
+    case Op::kUMul:
+    case Op::kSMul:
+    case Op::kAnd:
+    case Op::kOr:
+    case Op::kXor:
+    case Op::kConcat:
+    case Op::kShl:
+    case Op::kShr:
+      return true;
+    default:
+      return IsComparison(op);
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<Bytecode>> FuseSuperinstructions(
+    std::vector<Bytecode> bytecodes) {
+  const int64_t size = bytecodes.size();
+  auto op_at = [&](int64_t pc) -> std::optional<Op> {
+    if (pc >= size) {
+      return std::nullopt;
+    }
+    return bytecodes[pc].op();
+  };
+
+  std::vector<Bytecode> result;
+  result.reserve(size);
+  // Maps each original PC to the PC of the instruction that now implements it.
+  std::vector<int64_t> old_to_new(size + 1);
+  // For every instruction in `result` that performs a relative jump, the
+  // original PC the jump was relative to.
+  std::vector<std::optional<int64_t>> jump_origins;
+  jump_origins.reserve(size);
+
+  int64_t pc = 0;
+  while (pc < size) {
+    const int64_t new_pc = result.size();
+    const Bytecode& bytecode = bytecodes[pc];
+
+    std::optional<Op> next_op = op_at(pc + 1);
+    std::optional<Op> binop = op_at(pc + 2);
+    if (bytecode.op() == Op::kLoad &&
+        (next_op == Op::kLoad || next_op == Op::kLiteral) &&
+        binop.has_value() && IsFusableBinop(*binop)) {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex lhs, bytecode.slot_index());
+      std::variant<Bytecode::SlotIndex, InterpValue> rhs =
+          Bytecode::SlotIndex(0);
+      if (next_op == Op::kLoad) {
+        XLS_ASSIGN_OR_RETURN(rhs, bytecodes[pc + 1].slot_index());
+      } else {
+        XLS_ASSIGN_OR_RETURN(rhs, bytecodes[pc + 1].value_data());
+      }
+      int64_t consumed = 3;
+      std::optional<Bytecode::SlotIndex> dest;
+      if (op_at(pc + 3) == Op::kStore) {
+        XLS_ASSIGN_OR_RETURN(dest, bytecodes[pc + 3].slot_index());
+        consumed = 4;
+      }
+      // The binop's span is the one used for error and rollover reporting.
+      result.push_back(Bytecode(
+          bytecodes[pc + 2].source_span(), Op::kFusedBinop,
+          Bytecode::FusedBinopData(*binop, lhs, std::move(rhs), dest)));
+      jump_origins.push_back(std::nullopt);
+      for (int64_t i = pc; i < pc + consumed; ++i) {
+        old_to_new[i] = new_pc;
+      }
+      pc += consumed;
+      continue;
+    }
+
+    if (bytecode.op() == Op::kLiteral && next_op.has_value() &&
+        IsComparison(*next_op) && op_at(pc + 2) == Op::kJumpRelIf) {
+      XLS_ASSIGN_OR_RETURN(InterpValue literal, bytecode.value_data());
+      XLS_ASSIGN_OR_RETURN(Bytecode::JumpTarget target,
+                           bytecodes[pc + 2].jump_target());
+      result.push_back(
+          Bytecode(bytecodes[pc + 1].source_span(), Op::kFusedCompareJumpRelIf,
+                   Bytecode::CompareJumpData(*next_op, std::move(literal),
+                                             target)));
+      jump_origins.push_back(pc + 2);
+      for (int64_t i = pc; i < pc + 3; ++i) {
+        old_to_new[i] = new_pc;
+      }
+      pc += 3;
+      continue;
+    }
+
+    old_to_new[pc] = new_pc;
+    if (bytecode.op() == Op::kJumpRel || bytecode.op() == Op::kJumpRelIf) {
+      jump_origins.push_back(pc);
+    } else {
+      jump_origins.push_back(std::nullopt);
+    }
+    result.push_back(std::move(bytecodes[pc]));
+    ++pc;
+  }
+  old_to_new[size] = result.size();
+
+  // Retarget all relative jumps now that the final layout is known.
+  for (int64_t new_pc = 0; new_pc < result.size(); ++new_pc) {
+    if (!jump_origins[new_pc].has_value()) {
+      continue;
+    }
+    const int64_t origin = jump_origins[new_pc].value();
+    Bytecode& bytecode = result[new_pc];
+    const Bytecode::CompareJumpData* compare_jump = nullptr;
+    int64_t old_target;
+    if (bytecode.op() == Op::kFusedCompareJumpRelIf) {
+      XLS_ASSIGN_OR_RETURN(compare_jump, bytecode.compare_jump_data());
+      old_target = compare_jump->target().value();
+    } else {
+      XLS_ASSIGN_OR_RETURN(Bytecode::JumpTarget target, bytecode.jump_target());
+      old_target = target.value();
+    }
+    const int64_t old_dest = origin + old_target;
+    XLS_RET_CHECK(old_dest >= 0 && old_dest < size)
+        << "Jump at PC " << origin << " targets out-of-range PC " << old_dest;
+    const int64_t new_dest = old_to_new[old_dest];
+    XLS_RET_CHECK(result[new_dest].op() == Op::kJumpDest)
+        << "Jump at PC " << origin << " does not target a jump_dest.";
+    Bytecode::JumpTarget new_target(new_dest - new_pc);
+    if (compare_jump != nullptr) {
+      bytecode = Bytecode(bytecode.source_span(), bytecode.op(),
+                          Bytecode::CompareJumpData(compare_jump->compare(),
+                                                    compare_jump->literal(),
+                                                    new_target));
+    } else {
+      bytecode = Bytecode(bytecode.source_span(), bytecode.op(), new_target);
+    }
+  }
+
+  XLS_VLOG(3) << "FuseSuperinstructions: " << size << " bytecodes => "
+              << result.size();
+  return result;
+}
+
+absl::StatusOr<std::unique_ptr<BytecodeFunction>> OptimizeBytecodeFunction(
+    std::unique_ptr<BytecodeFunction> bf) {
+  XLS_ASSIGN_OR_RETURN(std::vector<Bytecode> bytecodes,
+                       FuseSuperinstructions(bf->TakeBytecodes()));
+  return BytecodeFunction::Create(bf->owner(), bf->source_fn(),
+                                  bf->type_info(), std::move(bytecodes));
+}
+
+}  // namespace xls::dslx
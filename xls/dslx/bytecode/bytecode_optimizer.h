@@ -0,0 +1,48 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_BYTECODE_BYTECODE_OPTIMIZER_H_
+#define XLS_DSLX_BYTECODE_BYTECODE_OPTIMIZER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "xls/dslx/bytecode/bytecode.h"
+
+namespace xls::dslx {
+
+// Rewrites common instruction sequences in emitted bytecode into
+// superinstructions that operate directly on frame slots, so the interpreter
+// dispatches (and copies values through the stack) fewer times:
+//
+//  load a; load b; <binop>[; store c]       => fused_binop
+//  load a; literal L; <binop>[; store c]    => fused_binop
+//  literal L; <cmp>; jump_rel_if T          => fused_compare_jump_rel_if
+//
+// Relative jump targets are rewritten to account for removed instructions.
+// Jumps may only land on `jump_dest` instructions, which are never absorbed
+// into a superinstruction, so no jump can target the interior of a fused
+// sequence.
+absl::StatusOr<std::vector<Bytecode>> FuseSuperinstructions(
+    std::vector<Bytecode> bytecodes);
+
+// Convenience wrapper that returns a new BytecodeFunction holding the fused
+// form of `bf`'s bytecode (with the same owner/source fn/type info).
+absl::StatusOr<std::unique_ptr<BytecodeFunction>> OptimizeBytecodeFunction(
+    std::unique_ptr<BytecodeFunction> bf);
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_BYTECODE_BYTECODE_OPTIMIZER_H_
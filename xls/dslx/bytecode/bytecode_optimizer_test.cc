@@ -0,0 +1,136 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/bytecode_optimizer.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/bytecode/bytecode_interpreter.h"
+#include "xls/dslx/bytecode/bytecode_interpreter_options.h"
+#include "xls/dslx/frontend/pos.h"
+#include "xls/dslx/interp_value.h"
+
+namespace xls::dslx {
+namespace {
+
+using Op = Bytecode::Op;
+using SlotIndex = Bytecode::SlotIndex;
+
+absl::StatusOr<InterpValue> RunBytecodes(
+    std::vector<Bytecode> bytecodes, std::vector<InterpValue> args = {}) {
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<BytecodeFunction> bf,
+      BytecodeFunction::Create(/*owner=*/nullptr, /*source_fn=*/nullptr,
+                               /*type_info=*/nullptr, std::move(bytecodes)));
+  return BytecodeInterpreter::Interpret(/*import_data=*/nullptr, bf.get(),
+                                        args);
+}
+
+TEST(BytecodeOptimizerTest, FusesLoadLoadBinopStore) {
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(0)));
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(1)));
+  bytecodes.push_back(Bytecode(Span::Fake(), Op::kUAdd));
+  bytecodes.push_back(Bytecode::MakeStore(Span::Fake(), SlotIndex(2)));
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(2)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Bytecode> fused,
+                           FuseSuperinstructions(std::move(bytecodes)));
+  EXPECT_EQ(BytecodesToString(fused, /*source_locs=*/false),
+            R"(000 fused_binop uadd slot:0 slot:1 -> slot:2
+001 load 2)");
+  EXPECT_THAT(RunBytecodes(std::move(fused), {InterpValue::MakeU32(3),
+                                             InterpValue::MakeU32(4)}),
+              status_testing::IsOkAndHolds(InterpValue::MakeU32(7)));
+}
+
+TEST(BytecodeOptimizerTest, FusesCompareJumpAndRetargetsLoop) {
+  // Counts slot 0 up to 5:
+  //
+  //   x = 0
+  //   do { x = x + 1 } while (x < 5)
+  //   x
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(Span::Fake(), InterpValue::MakeU32(0)));
+  bytecodes.push_back(Bytecode::MakeStore(Span::Fake(), SlotIndex(0)));
+  bytecodes.push_back(Bytecode::MakeJumpDest(Span::Fake()));
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(0)));
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(Span::Fake(), InterpValue::MakeU32(1)));
+  bytecodes.push_back(Bytecode(Span::Fake(), Op::kUAdd));
+  bytecodes.push_back(Bytecode::MakeDup(Span::Fake()));
+  bytecodes.push_back(Bytecode::MakeStore(Span::Fake(), SlotIndex(0)));
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(Span::Fake(), InterpValue::MakeU32(5)));
+  bytecodes.push_back(Bytecode(Span::Fake(), Op::kLt));
+  bytecodes.push_back(
+      Bytecode::MakeJumpRelIf(Span::Fake(), Bytecode::JumpTarget(-8)));
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(0)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Bytecode> fused,
+                           FuseSuperinstructions(std::move(bytecodes)));
+  EXPECT_EQ(BytecodesToString(fused, /*source_locs=*/false),
+            R"(000 literal u32:0
+001 store 0
+002 jump_dest
+003 fused_binop uadd slot:0 u32:1
+004 dup
+005 store 0
+006 fused_compare_jump_rel_if lt u32:5 -4
+007 load 0)");
+  EXPECT_THAT(RunBytecodes(std::move(fused)),
+              status_testing::IsOkAndHolds(InterpValue::MakeU32(5)));
+}
+
+TEST(BytecodeOptimizerTest, RetargetsForwardJumpOverFusedCode) {
+  // if (true) { 1 } else { a + b }
+  std::vector<Bytecode> bytecodes;
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(Span::Fake(), InterpValue::MakeBool(true)));
+  bytecodes.push_back(
+      Bytecode::MakeJumpRelIf(Span::Fake(), Bytecode::JumpTarget(5)));
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(0)));
+  bytecodes.push_back(Bytecode::MakeLoad(Span::Fake(), SlotIndex(1)));
+  bytecodes.push_back(Bytecode(Span::Fake(), Op::kUAdd));
+  bytecodes.push_back(
+      Bytecode::MakeJumpRel(Span::Fake(), Bytecode::JumpTarget(3)));
+  bytecodes.push_back(Bytecode::MakeJumpDest(Span::Fake()));
+  bytecodes.push_back(
+      Bytecode::MakeLiteral(Span::Fake(), InterpValue::MakeU32(1)));
+  bytecodes.push_back(Bytecode::MakeJumpDest(Span::Fake()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Bytecode> fused,
+                           FuseSuperinstructions(std::move(bytecodes)));
+  EXPECT_EQ(BytecodesToString(fused, /*source_locs=*/false),
+            R"(000 literal u1:1
+001 jump_rel_if +3
+002 fused_binop uadd slot:0 slot:1
+003 jump_rel +3
+004 jump_dest
+005 literal u32:1
+006 jump_dest)");
+  EXPECT_THAT(RunBytecodes(std::move(fused), {InterpValue::MakeU32(3),
+                                             InterpValue::MakeU32(4)}),
+              status_testing::IsOkAndHolds(InterpValue::MakeU32(1)));
+}
+
+}  // namespace
+}  // namespace xls::dslx
@@ -0,0 +1,108 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/bytecode_store.h"
+
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+#include "xls/dslx/bytecode/bytecode.pb.h"
+
+namespace xls::dslx {
+
+SharedBytecodeStore::SharedBytecodeStore(
+    std::optional<std::filesystem::path> dir, bool read_only)
+    : dir_(std::move(dir)), read_only_(read_only) {}
+
+std::optional<std::filesystem::path> SharedBytecodeStore::PathForKey(
+    std::string_view key) const {
+  if (!dir_.has_value()) {
+    return std::nullopt;
+  }
+  return *dir_ / absl::StrFormat("%s.bytecode.pb", key);
+}
+
+std::shared_ptr<const BytecodeFunctionProto> SharedBytecodeStore::Get(
+    std::string_view key) {
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++memory_hits_;
+      return it->second;
+    }
+  }
+
+  std::optional<std::filesystem::path> path = PathForKey(key);
+  if (!path.has_value() || !FileExists(*path).ok()) {
+    ++misses_;
+    return nullptr;
+  }
+  auto proto = std::make_shared<BytecodeFunctionProto>();
+  if (absl::Status status = ParseProtobinFile(*path, proto.get());
+      !status.ok()) {
+    XLS_VLOG(1) << "Ignoring unreadable bytecode cache entry " << *path << ": "
+                << status;
+    ++misses_;
+    return nullptr;
+  }
+  ++disk_hits_;
+
+  absl::MutexLock lock(&mutex_);
+  // Another thread may have loaded the same entry in the meantime; either copy
+  // is fine, but keep the first so all callers share it.
+  auto [it, inserted] = entries_.emplace(key, std::move(proto));
+  return it->second;
+}
+
+void SharedBytecodeStore::Put(std::string_view key,
+                              BytecodeFunctionProto proto) {
+  auto shared = std::make_shared<const BytecodeFunctionProto>(std::move(proto));
+  {
+    absl::MutexLock lock(&mutex_);
+    entries_.emplace(key, shared);
+  }
+
+  std::optional<std::filesystem::path> path = PathForKey(key);
+  if (read_only_ || !path.has_value()) {
+    return;
+  }
+  // Written via a rename so concurrent readers (possibly in other processes)
+  // never see a partially written entry.
+  if (absl::Status status = SetProtobinFileAtomically(*path, *shared);
+      !status.ok()) {
+    XLS_VLOG(1) << "Could not write bytecode cache entry " << *path << ": "
+                << status;
+    return;
+  }
+  ++writes_;
+}
+
+SharedBytecodeStore::Stats SharedBytecodeStore::stats() const {
+  return Stats{.memory_hits = memory_hits_.load(),
+               .disk_hits = disk_hits_.load(),
+               .misses = misses_.load(),
+               .writes = writes_.load()};
+}
+
+}  // namespace xls::dslx
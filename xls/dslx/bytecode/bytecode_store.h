@@ -0,0 +1,85 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_BYTECODE_BYTECODE_STORE_H_
+#define XLS_DSLX_BYTECODE_BYTECODE_STORE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/dslx/bytecode/bytecode.pb.h"
+
+namespace xls::dslx {
+
+// Holds serialized bytecode functions keyed on a digest of everything that went
+// into emitting them (see BytecodeCache), so they can be reused by other
+// BytecodeCaches -- e.g. one per ImportData in the same process -- and, when a
+// directory is given, by later processes.
+//
+// Thread-safe. Lookups that hit in memory only take a reader lock, so a single
+// store (especially a read-only one) can be shared by many concurrently
+// running interpreters.
+class SharedBytecodeStore {
+ public:
+  struct Stats {
+    int64_t memory_hits = 0;
+    int64_t disk_hits = 0;
+    int64_t misses = 0;
+    int64_t writes = 0;
+  };
+
+  // If `dir` is given, entries missing from memory are looked up there and
+  // (unless `read_only`) new entries are written there, one file per key.
+  explicit SharedBytecodeStore(
+      std::optional<std::filesystem::path> dir = std::nullopt,
+      bool read_only = false);
+
+  // Returns the entry for `key`, or nullptr if there is none. Unreadable or
+  // corrupt files on disk are treated as misses.
+  std::shared_ptr<const BytecodeFunctionProto> Get(std::string_view key);
+
+  // Records `proto` as the entry for `key`. Failures to write to disk are
+  // logged and otherwise ignored; the cache is an optimization only.
+  void Put(std::string_view key, BytecodeFunctionProto proto);
+
+  Stats stats() const;
+  bool read_only() const { return read_only_; }
+
+ private:
+  std::optional<std::filesystem::path> PathForKey(std::string_view key) const;
+
+  const std::optional<std::filesystem::path> dir_;
+  const bool read_only_;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::shared_ptr<const BytecodeFunctionProto>>
+      entries_ ABSL_GUARDED_BY(mutex_);
+
+  std::atomic<int64_t> memory_hits_ = 0;
+  std::atomic<int64_t> disk_hits_ = 0;
+  std::atomic<int64_t> misses_ = 0;
+  std::atomic<int64_t> writes_ = 0;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_BYTECODE_BYTECODE_STORE_H_
@@ -0,0 +1,379 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode/bytecode_to_proto.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/casts.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/bytecode/bytecode.pb.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/frontend/ast_node.h"
+#include "xls/dslx/frontend/pos.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/type.h"
+#include "xls/dslx/type_system/type_info.h"
+#include "xls/dslx/type_system/type_info_to_proto.h"
+
+namespace xls::dslx {
+namespace {
+
+using Op = Bytecode::Op;
+
+absl::StatusOr<ParametricEnvProto> ToProto(const ParametricEnv& env) {
+  ParametricEnvProto proto;
+  for (const ParametricEnvItem& item : env.bindings()) {
+    ParametricEnvItemProto* item_proto = proto.add_items();
+    item_proto->set_identifier(item.identifier);
+    XLS_ASSIGN_OR_RETURN(*item_proto->mutable_value(),
+                         InterpValueToProto(item.value));
+  }
+  return proto;
+}
+
+absl::StatusOr<ParametricEnv> FromProto(const ParametricEnvProto& proto,
+                                        const ImportData& import_data) {
+  std::vector<std::pair<std::string, InterpValue>> items;
+  items.reserve(proto.items_size());
+  for (const ParametricEnvItemProto& item : proto.items()) {
+    XLS_ASSIGN_OR_RETURN(InterpValue value,
+                         InterpValueFromProto(item.value(), import_data));
+    items.push_back({item.identifier(), std::move(value)});
+  }
+  return ParametricEnv(items);
+}
+
+absl::StatusOr<MatchArmItemProto> ToProto(
+    const Bytecode::MatchArmItem& item) {
+  using Kind = Bytecode::MatchArmItem::Kind;
+  MatchArmItemProto proto;
+  switch (item.kind()) {
+    case Kind::kInterpValue: {
+      XLS_ASSIGN_OR_RETURN(InterpValue value, item.interp_value());
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_interp_value(),
+                           InterpValueToProto(value));
+      break;
+    }
+    case Kind::kLoad: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, item.slot_index());
+      proto.set_load(slot.value());
+      break;
+    }
+    case Kind::kStore: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::SlotIndex slot, item.slot_index());
+      proto.set_store(slot.value());
+      break;
+    }
+    case Kind::kRange: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::MatchArmItem::RangeData range,
+                           item.range());
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_range()->mutable_start(),
+                           InterpValueToProto(range.start));
+      XLS_ASSIGN_OR_RETURN(*proto.mutable_range()->mutable_limit(),
+                           InterpValueToProto(range.limit));
+      break;
+    }
+    case Kind::kTuple: {
+      XLS_ASSIGN_OR_RETURN(std::vector<Bytecode::MatchArmItem> elements,
+                           item.tuple_elements());
+      MatchArmItemProto::TupleProto* tuple = proto.mutable_tuple();
+      for (const Bytecode::MatchArmItem& element : elements) {
+        XLS_ASSIGN_OR_RETURN(*tuple->add_elements(), ToProto(element));
+      }
+      break;
+    }
+    case Kind::kWildcard:
+      proto.set_wildcard(true);
+      break;
+  }
+  return proto;
+}
+
+absl::StatusOr<Bytecode::MatchArmItem> FromProto(
+    const MatchArmItemProto& proto, const ImportData& import_data) {
+  switch (proto.item_oneof_case()) {
+    case MatchArmItemProto::ItemOneofCase::kInterpValue: {
+      XLS_ASSIGN_OR_RETURN(
+          InterpValue value,
+          InterpValueFromProto(proto.interp_value(), import_data));
+      return Bytecode::MatchArmItem::MakeInterpValue(value);
+    }
+    case MatchArmItemProto::ItemOneofCase::kLoad:
+      return Bytecode::MatchArmItem::MakeLoad(
+          Bytecode::SlotIndex(proto.load()));
+    case MatchArmItemProto::ItemOneofCase::kStore:
+      return Bytecode::MatchArmItem::MakeStore(
+          Bytecode::SlotIndex(proto.store()));
+    case MatchArmItemProto::ItemOneofCase::kRange: {
+      XLS_ASSIGN_OR_RETURN(
+          InterpValue start,
+          InterpValueFromProto(proto.range().start(), import_data));
+      XLS_ASSIGN_OR_RETURN(
+          InterpValue limit,
+          InterpValueFromProto(proto.range().limit(), import_data));
+      return Bytecode::MatchArmItem::MakeRange(std::move(start),
+                                               std::move(limit));
+    }
+    case MatchArmItemProto::ItemOneofCase::kTuple: {
+      std::vector<Bytecode::MatchArmItem> elements;
+      elements.reserve(proto.tuple().elements_size());
+      for (const MatchArmItemProto& element : proto.tuple().elements()) {
+        XLS_ASSIGN_OR_RETURN(Bytecode::MatchArmItem item,
+                             FromProto(element, import_data));
+        elements.push_back(std::move(item));
+      }
+      return Bytecode::MatchArmItem::MakeTuple(std::move(elements));
+    }
+    case MatchArmItemProto::ItemOneofCase::kWildcard:
+      return Bytecode::MatchArmItem::MakeWildcard();
+    case MatchArmItemProto::ItemOneofCase::ITEM_ONEOF_NOT_SET:
+      break;
+  }
+  return absl::InvalidArgumentError("MatchArmItemProto has no item set.");
+}
+
+absl::StatusOr<BytecodeProto> ToProto(const Bytecode& bytecode) {
+  BytecodeProto proto;
+  *proto.mutable_source_span() = SpanToProto(bytecode.source_span());
+  proto.set_op(OpToString(bytecode.op()));
+  if (!bytecode.has_data()) {
+    return proto;
+  }
+
+  const Bytecode::Data& data = bytecode.data().value();
+  if (const auto* value = std::get_if<InterpValue>(&data)) {
+    XLS_ASSIGN_OR_RETURN(*proto.mutable_value(), InterpValueToProto(*value));
+  } else if (const auto* target = std::get_if<Bytecode::JumpTarget>(&data)) {
+    proto.set_jump_target(target->value());
+  } else if (const auto* n = std::get_if<Bytecode::NumElements>(&data)) {
+    proto.set_num_elements(n->value());
+  } else if (const auto* slot = std::get_if<Bytecode::SlotIndex>(&data)) {
+    proto.set_slot_index(slot->value());
+  } else if (const auto* type = std::get_if<std::unique_ptr<Type>>(&data)) {
+    XLS_ASSIGN_OR_RETURN(*proto.mutable_type(), TypeToProto(**type));
+  } else if (const auto* invocation =
+                 std::get_if<Bytecode::InvocationData>(&data)) {
+    InvocationDataProto* invocation_proto = proto.mutable_invocation();
+    *invocation_proto->mutable_span() =
+        SpanToProto(invocation->invocation()->span());
+    if (invocation->caller_bindings().has_value()) {
+      XLS_ASSIGN_OR_RETURN(*invocation_proto->mutable_caller_bindings(),
+                           ToProto(*invocation->caller_bindings()));
+    }
+    if (invocation->callee_bindings().has_value()) {
+      XLS_ASSIGN_OR_RETURN(*invocation_proto->mutable_callee_bindings(),
+                           ToProto(*invocation->callee_bindings()));
+    }
+  } else if (const auto* item = std::get_if<Bytecode::MatchArmItem>(&data)) {
+    XLS_ASSIGN_OR_RETURN(*proto.mutable_match_arm_item(), ToProto(*item));
+  } else if (const auto* fused =
+                 std::get_if<Bytecode::FusedBinopData>(&data)) {
+    FusedBinopDataProto* fused_proto = proto.mutable_fused_binop();
+    fused_proto->set_binop(OpToString(fused->binop()));
+    fused_proto->set_lhs(fused->lhs().value());
+    if (const auto* rhs_slot =
+            std::get_if<Bytecode::SlotIndex>(&fused->rhs())) {
+      fused_proto->set_rhs_slot(rhs_slot->value());
+    } else {
+      XLS_ASSIGN_OR_RETURN(
+          *fused_proto->mutable_rhs_literal(),
+          InterpValueToProto(std::get<InterpValue>(fused->rhs())));
+    }
+    if (fused->dest().has_value()) {
+      fused_proto->set_dest(fused->dest()->value());
+    }
+  } else if (const auto* compare_jump =
+                 std::get_if<Bytecode::CompareJumpData>(&data)) {
+    CompareJumpDataProto* compare_jump_proto = proto.mutable_compare_jump();
+    compare_jump_proto->set_compare(OpToString(compare_jump->compare()));
+    XLS_ASSIGN_OR_RETURN(*compare_jump_proto->mutable_literal(),
+                         InterpValueToProto(compare_jump->literal()));
+    compare_jump_proto->set_target(compare_jump->target().value());
+  } else {
+    return absl::UnimplementedError(
+        absl::StrFormat("Cannot serialize data of bytecode op `%s`",
+                        OpToString(bytecode.op())));
+  }
+  return proto;
+}
+
+// Indexes every invocation in a function body by span, so invocation data can
+// be resolved without repeatedly scanning the module.
+class InvocationIndex {
+ public:
+  static absl::StatusOr<InvocationIndex> Create(const Function& f) {
+    InvocationIndex index;
+    std::vector<const AstNode*> worklist = {&f};
+    while (!worklist.empty()) {
+      const AstNode* node = worklist.back();
+      worklist.pop_back();
+      if (node->kind() == AstNodeKind::kInvocation) {
+        const auto* invocation = down_cast<const Invocation*>(node);
+        // Desugaring could in principle produce invocations that share a span;
+        // those cannot be told apart, so refuse to index them.
+        bool inserted =
+            index.by_span_.emplace(invocation->span().ToString(), invocation)
+                .second;
+        XLS_RET_CHECK(inserted)
+            << "Multiple invocations @ " << invocation->span();
+      }
+      for (const AstNode* child : node->GetChildren(/*want_types=*/false)) {
+        worklist.push_back(child);
+      }
+    }
+    return index;
+  }
+
+  absl::StatusOr<const Invocation*> Find(const Span& span) const {
+    auto it = by_span_.find(span.ToString());
+    if (it == by_span_.end()) {
+      return absl::NotFoundError(
+          absl::StrFormat("Could not find invocation @ %s", span.ToString()));
+    }
+    return it->second;
+  }
+
+ private:
+  // Keyed on the span's string form, as Span itself is not hashable.
+  absl::flat_hash_map<std::string, const Invocation*> by_span_;
+};
+
+absl::StatusOr<Bytecode> FromProto(const BytecodeProto& proto,
+                                   const InvocationIndex& invocations,
+                                   const ImportData& import_data) {
+  Span span = SpanFromProto(proto.source_span());
+  XLS_ASSIGN_OR_RETURN(Op op, OpFromString(proto.op()));
+  switch (proto.data_oneof_case()) {
+    case BytecodeProto::DataOneofCase::DATA_ONEOF_NOT_SET:
+      return Bytecode(span, op);
+    case BytecodeProto::DataOneofCase::kValue: {
+      XLS_ASSIGN_OR_RETURN(InterpValue value,
+                           InterpValueFromProto(proto.value(), import_data));
+      return Bytecode(span, op, std::move(value));
+    }
+    case BytecodeProto::DataOneofCase::kJumpTarget:
+      return Bytecode(span, op, Bytecode::JumpTarget(proto.jump_target()));
+    case BytecodeProto::DataOneofCase::kNumElements:
+      return Bytecode(span, op, Bytecode::NumElements(proto.num_elements()));
+    case BytecodeProto::DataOneofCase::kSlotIndex:
+      return Bytecode(span, op, Bytecode::SlotIndex(proto.slot_index()));
+    case BytecodeProto::DataOneofCase::kType: {
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<Type> type,
+                           TypeFromProto(proto.type(), import_data));
+      return Bytecode(span, op, std::move(type));
+    }
+    case BytecodeProto::DataOneofCase::kInvocation: {
+      const InvocationDataProto& invocation_proto = proto.invocation();
+      XLS_ASSIGN_OR_RETURN(
+          const Invocation* invocation,
+          invocations.Find(SpanFromProto(invocation_proto.span())));
+      std::optional<ParametricEnv> caller_bindings;
+      if (invocation_proto.has_caller_bindings()) {
+        XLS_ASSIGN_OR_RETURN(
+            caller_bindings,
+            FromProto(invocation_proto.caller_bindings(), import_data));
+      }
+      std::optional<ParametricEnv> callee_bindings;
+      if (invocation_proto.has_callee_bindings()) {
+        XLS_ASSIGN_OR_RETURN(
+            callee_bindings,
+            FromProto(invocation_proto.callee_bindings(), import_data));
+      }
+      return Bytecode(span, op,
+                      Bytecode::InvocationData(invocation,
+                                               std::move(caller_bindings),
+                                               std::move(callee_bindings)));
+    }
+    case BytecodeProto::DataOneofCase::kMatchArmItem: {
+      XLS_ASSIGN_OR_RETURN(Bytecode::MatchArmItem item,
+                           FromProto(proto.match_arm_item(), import_data));
+      return Bytecode(span, op, std::move(item));
+    }
+    case BytecodeProto::DataOneofCase::kFusedBinop: {
+      const FusedBinopDataProto& fused = proto.fused_binop();
+      XLS_ASSIGN_OR_RETURN(Op binop, OpFromString(fused.binop()));
+      std::variant<Bytecode::SlotIndex, InterpValue> rhs =
+          Bytecode::SlotIndex(fused.rhs_slot());
+      if (fused.has_rhs_literal()) {
+        XLS_ASSIGN_OR_RETURN(
+            rhs, InterpValueFromProto(fused.rhs_literal(), import_data));
+      }
+      std::optional<Bytecode::SlotIndex> dest;
+      if (fused.has_dest()) {
+        dest = Bytecode::SlotIndex(fused.dest());
+      }
+      return Bytecode(span, op,
+                      Bytecode::FusedBinopData(binop,
+                                               Bytecode::SlotIndex(fused.lhs()),
+                                               std::move(rhs), dest));
+    }
+    case BytecodeProto::DataOneofCase::kCompareJump: {
+      const CompareJumpDataProto& compare_jump = proto.compare_jump();
+      XLS_ASSIGN_OR_RETURN(Op compare, OpFromString(compare_jump.compare()));
+      XLS_ASSIGN_OR_RETURN(
+          InterpValue literal,
+          InterpValueFromProto(compare_jump.literal(), import_data));
+      return Bytecode(span, op,
+                      Bytecode::CompareJumpData(
+                          compare, std::move(literal),
+                          Bytecode::JumpTarget(compare_jump.target())));
+    }
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown bytecode data case: %d",
+                      static_cast<int>(proto.data_oneof_case())));
+}
+
+}  // namespace
+
+absl::StatusOr<BytecodeFunctionProto> BytecodeFunctionToProto(
+    const BytecodeFunction& bf) {
+  BytecodeFunctionProto proto;
+  for (const Bytecode& bytecode : bf.bytecodes()) {
+    XLS_ASSIGN_OR_RETURN(*proto.add_bytecodes(), ToProto(bytecode));
+  }
+  return proto;
+}
+
+absl::StatusOr<std::unique_ptr<BytecodeFunction>> BytecodeFunctionFromProto(
+    const BytecodeFunctionProto& proto, const Function& source_fn,
+    const TypeInfo* type_info, const ImportData& import_data) {
+  XLS_ASSIGN_OR_RETURN(InvocationIndex invocations,
+                       InvocationIndex::Create(source_fn));
+  std::vector<Bytecode> bytecodes;
+  bytecodes.reserve(proto.bytecodes_size());
+  for (const BytecodeProto& bytecode_proto : proto.bytecodes()) {
+    XLS_ASSIGN_OR_RETURN(Bytecode bytecode,
+                         FromProto(bytecode_proto, invocations, import_data));
+    bytecodes.push_back(std::move(bytecode));
+  }
+  return BytecodeFunction::Create(source_fn.owner(), &source_fn, type_info,
+                                  std::move(bytecodes));
+}
+
+}  // namespace xls::dslx
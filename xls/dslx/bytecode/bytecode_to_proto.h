@@ -0,0 +1,47 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_BYTECODE_BYTECODE_TO_PROTO_H_
+#define XLS_DSLX_BYTECODE_BYTECODE_TO_PROTO_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "xls/dslx/bytecode/bytecode.h"
+#include "xls/dslx/bytecode/bytecode.pb.h"
+#include "xls/dslx/frontend/ast.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/type_system/type_info.h"
+
+namespace xls::dslx {
+
+// Converts the bytecode of `bf` to protobuf form, e.g. for persisting it across
+// processes.
+//
+// Returns an Unimplemented error for bytecode that holds state which cannot be
+// recreated from source positions alone: spawns, traces and channel ops.
+absl::StatusOr<BytecodeFunctionProto> BytecodeFunctionToProto(
+    const BytecodeFunction& bf);
+
+// Recreates the BytecodeFunction for `source_fn` from `proto`. AST nodes are
+// resolved by span, so `source_fn` (and every module it refers to) must have
+// been parsed from the same text as when the proto was created, and be present
+// in `import_data`.
+absl::StatusOr<std::unique_ptr<BytecodeFunction>> BytecodeFunctionFromProto(
+    const BytecodeFunctionProto& proto, const Function& source_fn,
+    const TypeInfo* type_info, const ImportData& import_data);
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_BYTECODE_BYTECODE_TO_PROTO_H_
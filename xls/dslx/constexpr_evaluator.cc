@@ -95,12 +95,17 @@ absl::StatusOr<std::unique_ptr<BitsType>> InstantiateParametricNumberType(
   }
 
   if (type_info->IsKnownConstExpr(expr) ||
-      type_info->IsKnownNonConstExpr(expr)) {
+      type_info->IsKnownNonConstExpr(expr) ||
+      type_info->IsCachedNonConstExprResult(expr, bindings)) {
     return absl::OkStatus();
   }
   ConstexprEvaluator evaluator(import_data, type_info, warning_collector,
                                bindings, type);
-  return expr->AcceptExpr(&evaluator);
+  XLS_RETURN_IF_ERROR(expr->AcceptExpr(&evaluator));
+  if (!type_info->IsKnownConstExpr(expr)) {
+    type_info->NoteNonConstExprResult(expr, bindings);
+  }
+  return absl::OkStatus();
 }
 
 /* static */ absl::StatusOr<InterpValue> ConstexprEvaluator::EvaluateToValue(
@@ -121,7 +126,8 @@ absl::StatusOr<std::unique_ptr<BitsType>> InstantiateParametricNumberType(
 // if it is not constexpr.
 #define EVAL_AS_CONSTEXPR_OR_RETURN(EXPR)                                     \
   if (!type_info_->IsKnownConstExpr(EXPR) &&                                  \
-      !type_info_->IsKnownNonConstExpr(EXPR)) {                               \
+      !type_info_->IsKnownNonConstExpr(EXPR) &&                               \
+      !type_info_->IsCachedNonConstExprResult(EXPR, bindings_)) {             \
     Type* sub_type = nullptr;                                                 \
     if (type_info_->GetItem(EXPR).has_value()) {                              \
       sub_type = type_info_->GetItem(EXPR).value();                           \
@@ -129,6 +135,9 @@ absl::StatusOr<std::unique_ptr<BitsType>> InstantiateParametricNumberType(
     ConstexprEvaluator sub_eval(import_data_, type_info_, warning_collector_, \
                                 bindings_, sub_type);                         \
     XLS_RETURN_IF_ERROR(EXPR->AcceptExpr(&sub_eval));                         \
+    if (!type_info_->IsKnownConstExpr(EXPR)) {                                \
+      type_info_->NoteNonConstExprResult(EXPR, bindings_);                    \
+    }                                                                         \
   }                                                                           \
   if (!type_info_->IsKnownConstExpr(EXPR)) {                                  \
     return absl::OkStatus();                                                  \
@@ -172,6 +181,7 @@ absl::Status ConstexprEvaluator::HandleZeroMacro(const ZeroMacro* expr) {
 absl::Status ConstexprEvaluator::HandleArray(const Array* expr) {
   XLS_VLOG(3) << "ConstexprEvaluator::HandleArray : " << expr->ToString();
   std::vector<InterpValue> values;
+  values.reserve(expr->members().size());
   for (const Expr* member : expr->members()) {
     GET_CONSTEXPR_OR_RETURN(InterpValue value, member);
     values.push_back(value);
@@ -194,8 +204,9 @@ absl::Status ConstexprEvaluator::HandleArray(const Array* expr) {
     int64_t int_size = int_size_or.value();
     int64_t remaining = int_size - values.size();
     if (expr->has_ellipsis()) {
-      while (remaining-- > 0) {
-        values.push_back(values.back());
+      if (remaining > 0) {
+        InterpValue fill = values.back();
+        values.resize(int_size, fill);
       }
     } else {
       XLS_RET_CHECK_EQ(remaining, 0);
@@ -203,7 +214,8 @@ absl::Status ConstexprEvaluator::HandleArray(const Array* expr) {
   }
 
   // No need to fire up the interpreter. We can handle this one.
-  XLS_ASSIGN_OR_RETURN(InterpValue array, InterpValue::MakeArray(values));
+  XLS_ASSIGN_OR_RETURN(InterpValue array,
+                       InterpValue::MakeArray(std::move(values)));
   type_info_->NoteConstExpr(expr, array);
   return absl::OkStatus();
 }
@@ -511,11 +523,6 @@ absl::StatusOr<InterpValue> EvaluateNumber(const Number& expr,
 
 absl::Status ConstexprEvaluator::HandleNumber(const Number* expr) {
   // Numbers should always be [constexpr] evaluatable.
-  absl::flat_hash_map<std::string, InterpValue> env;
-  XLS_ASSIGN_OR_RETURN(
-      env, MakeConstexprEnv(import_data_, type_info_, warning_collector_, expr,
-                            bindings_));
-
   std::unique_ptr<BitsType> temp_type;
   const Type* type_ptr;
   if (expr->type_annotation() != nullptr) {
@@ -531,6 +538,11 @@ absl::Status ConstexprEvaluator::HandleNumber(const Number* expr) {
     const BitsType* bt = down_cast<const BitsType*>(type_ptr);
     XLS_RET_CHECK(bt != nullptr);
     if (bt->size().IsParametric()) {
+      // Only a parametric annotation needs the environment; building it for
+      // every literal (e.g. each element of a large constant table) is costly.
+      XLS_ASSIGN_OR_RETURN(
+          auto env, MakeConstexprEnv(import_data_, type_info_,
+                                     warning_collector_, expr, bindings_));
       XLS_ASSIGN_OR_RETURN(temp_type, InstantiateParametricNumberType(env, bt));
       type_ptr = temp_type.get();
     }
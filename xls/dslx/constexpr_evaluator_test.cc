@@ -13,6 +13,7 @@
 // limitations under the License.
 #include "xls/dslx/constexpr_evaluator.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -20,10 +21,13 @@
 #include <utility>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "xls/common/casts.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
@@ -557,5 +561,69 @@ fn main() -> u32 {
   EXPECT_EQ(value.GetBitValueViaSign().value(), 5);
 }
 
+TEST(ConstexprEvaluatorTest, NonConstexprResultsAreMemoized) {
+  constexpr std::string_view kModule = R"(
+fn main(x: u32) -> u32 {
+  (x + u32:1) * u32:2
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(TestData test_data, CreateTestData(kModule));
+  Module* module = test_data.module.get();
+  TypeInfo* type_info = test_data.type_info;
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f,
+                           module->GetMemberOrError<Function>("main"));
+  Expr* body = GetSingleBodyExpr(f);
+  XLS_ASSERT_OK_AND_ASSIGN(Type * type, GetType(type_info, body));
+
+  WarningCollector warnings(kAllWarningsSet);
+  XLS_ASSERT_OK(ConstexprEvaluator::Evaluate(&test_data.import_data, type_info,
+                                             &warnings, ParametricEnv(), body,
+                                             type));
+  EXPECT_FALSE(type_info->IsKnownConstExpr(body));
+
+  // Evaluating again is answered by the memo instead of walking the tree.
+  const int64_t hits = type_info->non_const_expr_cache_hits();
+  XLS_ASSERT_OK(ConstexprEvaluator::Evaluate(&test_data.import_data, type_info,
+                                             &warnings, ParametricEnv(), body,
+                                             type));
+  EXPECT_EQ(type_info->non_const_expr_cache_hits(), hits + 1);
+  EXPECT_FALSE(type_info->IsKnownConstExpr(body));
+
+  // Once the parameter is known to be constexpr, the memo no longer applies.
+  type_info->NoteConstExpr(f->params()[0]->name_def(),
+                           InterpValue::MakeU32(20));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue value,
+      ConstexprEvaluator::EvaluateToValue(&test_data.import_data, type_info,
+                                          &warnings, ParametricEnv(), body,
+                                          type));
+  EXPECT_EQ(value, InterpValue::MakeU32(42));
+}
+
+// Typechecks a module with `state.range(0)` 256-entry constant tables (in the
+// style of the AES S-boxes) and a function that combines lookups into all of
+// them.
+void BM_TypecheckConstantTables(benchmark::State& state) {
+  std::string program;
+  std::string lookup = "u8:0";
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    std::string table;
+    for (int64_t j = 0; j < 256; ++j) {
+      absl::StrAppendFormat(&table, "u8:0x%02x, ", (j * 7 + i) % 256);
+    }
+    absl::StrAppendFormat(&program, "const TABLE_%d = u8[256]:[%s];\n", i,
+                          table);
+    lookup = absl::StrFormat("(%s ^ TABLE_%d[x])", lookup, i);
+  }
+  absl::StrAppendFormat(&program, "fn lookup(x: u8) -> u8 { %s }\n", lookup);
+  for (auto _ : state) {
+    ImportData import_data = CreateImportDataForTest();
+    XLS_ASSERT_OK(
+        ParseAndTypecheck(program, "test.x", "test", &import_data).status());
+  }
+}
+BENCHMARK(BM_TypecheckConstantTables)->Range(1, 64);
+
 }  // namespace
 }  // namespace xls::dslx
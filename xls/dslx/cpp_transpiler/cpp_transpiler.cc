@@ -36,19 +36,20 @@ namespace xls::dslx {
 absl::StatusOr<CppSource> TranspileToCpp(Module* module,
                                          ImportData* import_data,
                                          std::string_view output_header_path,
-                                         std::string_view namespaces) {
+                                         std::string_view namespaces,
+                                         bool emit_native_layout) {
   constexpr std::string_view kHeaderTemplate =
       R"(// AUTOMATICALLY GENERATED FILE FROM `xls/dslx/cpp_transpiler`. DO NOT EDIT!
 #ifndef $0
 #define $0
 #include <array>
-#include <cstdint>
+$4#include <cstdint>
 #include <ostream>
 #include <string>
-#include <vector>
+$5#include <vector>
 
 #include "absl/status/statusor.h"
-#include "xls/public/value.h"
+$6#include "xls/public/value.h"
 
 $2$1$3
 
@@ -58,8 +59,8 @@ $2$1$3
   constexpr std::string_view kSourceTemplate =
       R"(// AUTOMATICALLY GENERATED FILE FROM `xls/dslx/cpp_transpiler`. DO NOT EDIT!
 #include <array>
-#include <string>
-#include <vector>
+%s#include <string>
+%s#include <vector>
 
 #include "%s"
 #include "absl/base/macros.h"
@@ -92,8 +93,41 @@ static bool FitsInNBitsUnsigned(uint64_t value, int64_t n) {
 static std::string __indent(int64_t amount) {
   return std::string(amount * 2, ' ');
 }
-
+%s
 %s%s%s
+)";
+
+  // Helpers for the native layout conversions. The JIT stores a signed value
+  // zero-extended to the width of its storage, while the C++ types hold it
+  // sign-extended.
+  constexpr std::string_view kNativeHelpers = R"(
+// Converts a signed `bit_count`-bit value from its C++ representation to the
+// XLS JIT native representation.
+template <typename T>
+static T ToNativeBits(T value, int64_t bit_count) {
+  if constexpr (std::is_enum_v<T>) {
+    return static_cast<T>(
+        ToNativeBits(static_cast<std::underlying_type_t<T>>(value), bit_count));
+  } else {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(
+        static_cast<U>(value) & ((uint64_t{1} << bit_count) - 1)));
+  }
+}
+
+// Inverse of ToNativeBits: sign-extends a `bit_count`-bit native value.
+template <typename T>
+static T FromNativeBits(T value, int64_t bit_count) {
+  if constexpr (std::is_enum_v<T>) {
+    return static_cast<T>(FromNativeBits(
+        static_cast<std::underlying_type_t<T>>(value), bit_count));
+  } else {
+    using U = std::make_unsigned_t<T>;
+    uint64_t sign = uint64_t{1} << (bit_count - 1);
+    uint64_t bits = static_cast<U>(value) & ((uint64_t{1} << bit_count) - 1);
+    return static_cast<T>(static_cast<U>((bits ^ sign) - sign));
+  }
+}
 )";
   XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
                        import_data->GetRootTypeInfo(module));
@@ -101,7 +135,8 @@ static std::string __indent(int64_t amount) {
   std::vector<std::string> source;
   for (const TypeDefinition& def : module->GetTypeDefinitions()) {
     XLS_ASSIGN_OR_RETURN(std::unique_ptr<CppTypeGenerator> generator,
-                         CppTypeGenerator::Create(def, type_info, import_data));
+                         CppTypeGenerator::Create(def, type_info, import_data,
+                                                  emit_native_layout));
     XLS_ASSIGN_OR_RETURN(CppSource result, generator->GetCppSource());
     header.push_back(result.header);
     source.push_back(result.source);
@@ -124,12 +159,23 @@ static std::string __indent(int64_t amount) {
     namespace_end = absl::StrCat("\n\n}  // namespace ", namespaces);
   }
 
+  // Extra includes and helpers are only emitted when requested so that the
+  // default output is unchanged.
+  auto include_if_native = [&](std::string_view include) -> std::string {
+    return emit_native_layout ? absl::StrCat("#include ", include, "\n") : "";
+  };
+
   return CppSource{
       absl::Substitute(kHeaderTemplate, header_guard,
                        absl::StrJoin(header, "\n\n"), namespace_begin,
-                       namespace_end),
-      absl::StrFormat(kSourceTemplate, output_header_path, namespace_begin,
-                      absl::StrJoin(source, "\n\n"), namespace_end)};
+                       namespace_end, include_if_native("<cstddef>"),
+                       include_if_native("<type_traits>"),
+                       include_if_native("\"absl/types/span.h\"")),
+      absl::StrFormat(kSourceTemplate, include_if_native("<cstring>"),
+                      include_if_native("<type_traits>"), output_header_path,
+                      emit_native_layout ? kNativeHelpers : "",
+                      namespace_begin, absl::StrJoin(source, "\n\n"),
+                      namespace_end)};
 }
 
 }  // namespace xls::dslx
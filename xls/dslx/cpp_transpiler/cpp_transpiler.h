@@ -30,6 +30,14 @@ namespace xls::dslx {
 // setters and converters into XLS Value types, each with appropriate size and
 // completeness validation. See the associated unit test for concrete examples.
 //
+// If `emit_native_layout` is true, each generated struct is additionally laid
+// out exactly like the XLS JIT's native representation of the type (checked
+// with static assertions) and gets ToNative/FromNative methods which convert
+// to and from that representation with plain memory copies rather than via
+// XLS Values. Single-value and span-based (bulk) variants are provided. This
+// is only supported for structs whose leaves are bits types of at most 64 bits
+// or enums, possibly nested in arrays and other structs.
+//
 // Note that the given Module must have been typechecked.
 //
 // The APIs emitted here are not guaranteed to be stable over time. For example,
@@ -41,7 +49,8 @@ namespace xls::dslx {
 absl::StatusOr<CppSource> TranspileToCpp(Module* module,
                                          ImportData* import_data,
                                          std::string_view output_header_path,
-                                         std::string_view namespaces = "");
+                                         std::string_view namespaces = "",
+                                         bool emit_native_layout = false);
 
 }  // namespace xls::dslx
 
@@ -357,5 +357,116 @@ struct MyUnsupportedWideStruct {
               HasSubstr("enum class MyUnsupportedWideEnum : uint64_t"));
 }
 
+TEST(CppTranspilerTest, StructsWithNativeLayout) {
+  constexpr std::string_view kModule = R"(
+pub enum MyEnum : s3 {
+  A = 0,
+  B = 1,
+}
+
+pub struct Inner {
+  a: s7,
+  e: MyEnum,
+}
+
+pub struct Outer {
+  flag: u1,
+  x: u32,
+  inners: Inner[2],
+  y: s64,
+}
+)";
+
+  auto import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule module,
+      ParseAndTypecheck(kModule, "fake_path", "MyModule", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      TranspileToCpp(module.module, &import_data, "/tmp/fake_path.h",
+                     /*namespaces=*/"", /*emit_native_layout=*/true));
+
+  // `Inner` is two bytes; `Outer` pads `x` to offset 4 and `y` to offset 16.
+  EXPECT_THAT(result.header,
+              HasSubstr("static constexpr int64_t kNativeSize = 2;"));
+  EXPECT_THAT(result.header,
+              HasSubstr("static constexpr int64_t kNativeSize = 24;"));
+  EXPECT_THAT(result.header,
+              HasSubstr("static constexpr int64_t kNativeAlignment = 8;"));
+  EXPECT_THAT(result.header,
+              HasSubstr("static_assert(offsetof(Outer, x) == 4);"));
+  EXPECT_THAT(result.header,
+              HasSubstr("static_assert(offsetof(Outer, inners) == 8);"));
+  EXPECT_THAT(result.header,
+              HasSubstr("static_assert(offsetof(Outer, y) == 16);"));
+  EXPECT_THAT(result.header,
+              HasSubstr("static absl::Status ToNative(absl::Span<const Outer> "
+                        "values, absl::Span<uint8_t> buffer);"));
+
+  // Only the narrow signed leaves need conversion; `y` fills its storage.
+  EXPECT_THAT(
+      result.source,
+      HasSubstr("native.inners[i0].a = ToNativeBits(native.inners[i0].a, 7);"));
+  EXPECT_THAT(result.source,
+              HasSubstr("result.inners[i0].e = "
+                        "FromNativeBits(result.inners[i0].e, 3);"));
+  EXPECT_THAT(result.source, testing::Not(HasSubstr("ToNativeBits(native.y")));
+}
+
+TEST(CppTranspilerTest, NativeLayoutDoesNotChangeDefaultOutput) {
+  constexpr std::string_view kModule = R"(
+pub struct MyStruct {
+  x: u32,
+  y: s7,
+}
+)";
+
+  auto import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule module,
+      ParseAndTypecheck(kModule, "fake_path", "MyModule", &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      TranspileToCpp(module.module, &import_data, "/tmp/fake_path.h"));
+  EXPECT_THAT(result.header, testing::Not(HasSubstr("kNativeSize")));
+  EXPECT_THAT(result.header, testing::Not(HasSubstr("<type_traits>")));
+  EXPECT_THAT(result.source, testing::Not(HasSubstr("ToNativeBits")));
+}
+
+TEST(CppTranspilerTest, NativeLayoutUnsupportedTypes) {
+  constexpr std::string_view kTupleModule = R"(
+struct MyStruct {
+  t: (u8, u16),
+}
+)";
+  constexpr std::string_view kWideModule = R"(
+struct MyStruct {
+  wide_field: bits[100],
+}
+)";
+
+  {
+    auto import_data = CreateImportDataForTest();
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TypecheckedModule module,
+        ParseAndTypecheck(kTupleModule, "fake_path", "MyModule", &import_data));
+    EXPECT_THAT(
+        TranspileToCpp(module.module, &import_data, "/tmp/fake_path.h",
+                       /*namespaces=*/"", /*emit_native_layout=*/true),
+        StatusIs(absl::StatusCode::kUnimplemented,
+                 HasSubstr("Native layout is not supported for tuple types")));
+  }
+  {
+    auto import_data = CreateImportDataForTest();
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TypecheckedModule module,
+        ParseAndTypecheck(kWideModule, "fake_path", "MyModule", &import_data));
+    EXPECT_THAT(TranspileToCpp(module.module, &import_data, "/tmp/fake_path.h",
+                               /*namespaces=*/"", /*emit_native_layout=*/true),
+                StatusIs(absl::StatusCode::kUnimplemented,
+                         HasSubstr("wider than 64 bits")));
+  }
+}
+
 }  // namespace
 }  // namespace xls::dslx
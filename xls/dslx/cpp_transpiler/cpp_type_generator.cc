@@ -14,6 +14,7 @@
 
 #include "xls/dslx/cpp_transpiler/cpp_type_generator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -30,6 +31,8 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/variant.h"
 #include "xls/common/indent.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/visitor.h"
 #include "xls/dslx/bytecode/bytecode.h"
@@ -39,6 +42,7 @@
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/interp_value.h"
+#include "xls/dslx/type_system/type.h"
 #include "xls/dslx/type_system/type_info.h"
 
 namespace xls::dslx {
@@ -54,6 +58,138 @@ absl::StatusOr<InterpValue> InterpretExpr(
   return BytecodeInterpreter::Interpret(import_data, bf.get(), /*args=*/{});
 }
 
+// Size and alignment in bytes of a type in the native layout used by the XLS
+// JIT (see xls/jit/type_layout.h). This is the LLVM layout of the type: bits
+// types are stored in the smallest power-of-two number of bytes which holds
+// them, arrays are contiguous, and structs are laid out like C structs.
+struct NativeLayout {
+  int64_t size;
+  int64_t alignment;
+  // Byte offsets of the members if the type is a struct.
+  std::vector<int64_t> member_offsets;
+};
+
+// Returns the width in bits of the given bits-like (bits or enum) type, or
+// std::nullopt if the type is not bits-like.
+absl::StatusOr<std::optional<int64_t>> GetBitsLikeWidth(const Type& type) {
+  if (const auto* bits = dynamic_cast<const BitsType*>(&type)) {
+    return bits->size().GetAsInt64();
+  }
+  if (const auto* enum_type = dynamic_cast<const EnumType*>(&type)) {
+    return enum_type->size().GetAsInt64();
+  }
+  return std::nullopt;
+}
+
+// Returns the number of bytes the JIT uses to store a bits-like value of the
+// given width. Mirrors LlvmTypeConverter::GetLlvmBitCount.
+int64_t NativeBitsByteCount(int64_t bit_count) {
+  if (bit_count <= 8) {
+    return 1;
+  }
+  return (int64_t{1} << CeilOfLog2(bit_count)) / 8;
+}
+
+// Computes the native layout of `type`. Only types whose native layout is
+// identical to the layout of the C++ type emitted for them are supported:
+// tuples (std::tuple has an unspecified layout), bits types wider than 64 bits
+// and zero-sized aggregates are rejected.
+absl::StatusOr<NativeLayout> ComputeNativeLayout(const Type& type) {
+  XLS_ASSIGN_OR_RETURN(std::optional<int64_t> bit_count,
+                       GetBitsLikeWidth(type));
+  if (bit_count.has_value()) {
+    if (*bit_count > 64) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Native layout is not supported for types wider than 64 bits: %s",
+          type.ToString()));
+    }
+    int64_t bytes = NativeBitsByteCount(*bit_count);
+    return NativeLayout{.size = bytes, .alignment = bytes};
+  }
+  if (const auto* array = dynamic_cast<const ArrayType*>(&type)) {
+    XLS_ASSIGN_OR_RETURN(int64_t dim, array->size().GetAsInt64());
+    if (dim == 0) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Native layout is not supported for empty arrays: %s",
+          type.ToString()));
+    }
+    XLS_ASSIGN_OR_RETURN(NativeLayout element,
+                         ComputeNativeLayout(array->element_type()));
+    return NativeLayout{.size = element.size * dim,
+                        .alignment = element.alignment};
+  }
+  if (const auto* struct_type = dynamic_cast<const StructType*>(&type)) {
+    if (struct_type->size() == 0) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Native layout is not supported for empty structs: %s",
+          type.ToString()));
+    }
+    NativeLayout layout{.size = 0, .alignment = 1};
+    for (const std::unique_ptr<Type>& member : struct_type->members()) {
+      XLS_ASSIGN_OR_RETURN(NativeLayout member_layout,
+                           ComputeNativeLayout(*member));
+      int64_t offset = RoundUpToNearest(layout.size, member_layout.alignment);
+      layout.member_offsets.push_back(offset);
+      layout.size = offset + member_layout.size;
+      layout.alignment = std::max(layout.alignment, member_layout.alignment);
+    }
+    layout.size = RoundUpToNearest(layout.size, layout.alignment);
+    return layout;
+  }
+  return absl::UnimplementedError(
+      absl::StrFormat("Native layout is not supported for %s types: %s",
+                      type.GetDebugTypeName(), type.ToString()));
+}
+
+// Appends to `lines` statements which apply `helper` (ToNativeBits or
+// FromNativeBits) to every signed leaf of `lvalue` which is narrower than its
+// C++ storage. The JIT holds such values zero-extended to the storage width
+// while the C++ types hold them sign-extended. All other leaves already have
+// the same representation in both.
+absl::Status AppendNativeFixups(const Type& type, std::string_view lvalue,
+                                std::string_view helper, int64_t nesting,
+                                std::vector<std::string>& lines) {
+  XLS_ASSIGN_OR_RETURN(std::optional<int64_t> bit_count,
+                       GetBitsLikeWidth(type));
+  if (bit_count.has_value()) {
+    bool is_signed = false;
+    if (const auto* bits = dynamic_cast<const BitsType*>(&type)) {
+      is_signed = bits->is_signed();
+    } else {
+      is_signed = dynamic_cast<const EnumType&>(type).is_signed();
+    }
+    if (is_signed && *bit_count != NativeBitsByteCount(*bit_count) * 8) {
+      lines.push_back(absl::StrFormat("%s = %s(%s, %d);", lvalue, helper,
+                                      lvalue, *bit_count));
+    }
+    return absl::OkStatus();
+  }
+  if (const auto* array = dynamic_cast<const ArrayType*>(&type)) {
+    XLS_ASSIGN_OR_RETURN(int64_t dim, array->size().GetAsInt64());
+    std::string ind_var = absl::StrCat("i", nesting);
+    std::vector<std::string> body;
+    XLS_RETURN_IF_ERROR(AppendNativeFixups(
+        array->element_type(), absl::StrFormat("%s[%s]", lvalue, ind_var),
+        helper, nesting + 1, body));
+    if (!body.empty()) {
+      lines.push_back(absl::StrFormat("for (int64_t %s = 0; %s < %d; ++%s) {",
+                                      ind_var, ind_var, dim, ind_var));
+      lines.push_back(Indent(absl::StrJoin(body, "\n"), 2));
+      lines.push_back("}");
+    }
+    return absl::OkStatus();
+  }
+  const auto* struct_type = dynamic_cast<const StructType*>(&type);
+  XLS_RET_CHECK(struct_type != nullptr) << type.ToString();
+  for (int64_t i = 0; i < struct_type->size(); ++i) {
+    XLS_RETURN_IF_ERROR(AppendNativeFixups(
+        struct_type->GetMemberType(i),
+        absl::StrFormat("%s.%s", lvalue, struct_type->GetMemberName(i)),
+        helper, nesting, lines));
+  }
+  return absl::OkStatus();
+}
+
 // A type generator for emitting a C++ enum representing a dslx::EnumDef.
 class EnumCppTypeGenerator : public CppTypeGenerator {
  public:
@@ -422,8 +558,8 @@ class StructCppTypeGenerator : public CppTypeGenerator {
   ~StructCppTypeGenerator() override = default;
 
   static absl::StatusOr<std::unique_ptr<StructCppTypeGenerator>> Create(
-      const StructDef* struct_def, TypeInfo* type_info,
-      ImportData* import_data) {
+      const StructDef* struct_def, TypeInfo* type_info, ImportData* import_data,
+      bool emit_native_layout) {
     std::vector<std::unique_ptr<CppEmitter>> member_emitters;
     for (const auto& i : struct_def->members()) {
       XLS_ASSIGN_OR_RETURN(std::unique_ptr<CppEmitter> emitter,
@@ -431,9 +567,13 @@ class StructCppTypeGenerator : public CppTypeGenerator {
                                               type_info, import_data));
       member_emitters.push_back(std::move(emitter));
     }
-    return std::make_unique<StructCppTypeGenerator>(
+    auto generator = std::make_unique<StructCppTypeGenerator>(
         DslxTypeNameToCpp(struct_def->identifier()), struct_def->identifier(),
         struct_def, std::move(member_emitters));
+    if (emit_native_layout) {
+      XLS_RETURN_IF_ERROR(generator->InitNativeLayout(type_info));
+    }
+    return std::move(generator);
   }
 
   absl::StatusOr<CppSource> GetCppSource() const override {
@@ -469,6 +609,12 @@ class StructCppTypeGenerator : public CppTypeGenerator {
                         scalar_widths.end());
       hdr_pieces.push_back("");
     }
+    CppSource native_methods;
+    if (native_layout_.has_value()) {
+      native_methods = NativeMethods();
+      hdr_pieces.push_back(native_methods.header);
+      hdr_pieces.push_back("");
+    }
     hdr_pieces.push_back(from_value_method.header);
     hdr_pieces.push_back(to_value_method.header);
     hdr_pieces.push_back(to_string_method.header);
@@ -490,10 +636,183 @@ class StructCppTypeGenerator : public CppTypeGenerator {
                        verify_method.source, operator_eq_method.source,
                        operator_stream_method.source},
                       "\n\n");
+    if (native_layout_.has_value()) {
+      absl::StrAppend(&header, "\n", NativeLayoutAssertions());
+      absl::StrAppend(&source, "\n\n", native_methods.source);
+    }
     return CppSource{.header = header, .source = source};
   }
 
  protected:
+  // Computes the native layout of the struct and the fixups required to move
+  // values between the C++ and native representations.
+  absl::Status InitNativeLayout(TypeInfo* type_info) {
+    XLS_ASSIGN_OR_RETURN(Type * type,
+                         type_info->GetItemOrError(struct_def_->name_def()));
+    const auto* meta_type = dynamic_cast<const MetaType*>(type);
+    XLS_RET_CHECK(meta_type != nullptr) << type->ToString();
+    const Type& struct_type = *meta_type->wrapped();
+    XLS_ASSIGN_OR_RETURN(native_layout_, ComputeNativeLayout(struct_type),
+                         _ << "; in struct " << dslx_type());
+    XLS_RETURN_IF_ERROR(AppendNativeFixups(struct_type, "native",
+                                           "ToNativeBits", /*nesting=*/0,
+                                           to_native_fixups_));
+    XLS_RETURN_IF_ERROR(AppendNativeFixups(struct_type, "result",
+                                           "FromNativeBits", /*nesting=*/0,
+                                           from_native_fixups_));
+    return absl::OkStatus();
+  }
+
+  // Returns static assertions that the C++ struct has exactly the native
+  // layout, so the native conversions can copy it wholesale.
+  std::string NativeLayoutAssertions() const {
+    std::vector<std::string> pieces;
+    pieces.push_back(absl::StrFormat(
+        "static_assert(std::is_standard_layout_v<%s>);", cpp_type()));
+    pieces.push_back(absl::StrFormat(
+        "static_assert(std::is_trivially_copyable_v<%s>);", cpp_type()));
+    pieces.push_back(absl::StrFormat(
+        "static_assert(sizeof(%s) == %s::kNativeSize);", cpp_type(),
+        cpp_type()));
+    pieces.push_back(absl::StrFormat(
+        "static_assert(alignof(%s) == %s::kNativeAlignment);", cpp_type(),
+        cpp_type()));
+    for (int64_t i = 0; i < struct_def_->size(); ++i) {
+      pieces.push_back(absl::StrFormat(
+          "static_assert(offsetof(%s, %s) == %d);", cpp_type(),
+          struct_def_->GetMemberName(i), native_layout_->member_offsets[i]));
+    }
+    return absl::StrJoin(pieces, "\n");
+  }
+
+  // Emits conversions to and from the JIT native layout, for single values and
+  // for contiguous arrays of values (which the JIT lays out with a stride of
+  // kNativeSize).
+  CppSource NativeMethods() const {
+    auto size_check = [&](std::string_view required_size) {
+      return absl::StrFormat(
+          "if (buffer.size() < %s) {\n"
+          "  return absl::InvalidArgumentError(absl::StrFormat(\n"
+          "      \"Native buffer of %%d bytes is too small for %s (need "
+          "%%d).\",\n"
+          "      buffer.size(), %s));\n"
+          "}",
+          required_size, cpp_type(), required_size);
+    };
+    std::string single_size_check = size_check("kNativeSize");
+    std::string bulk_size_check = size_check("values.size() * kNativeSize");
+    bool has_fixups = !to_native_fixups_.empty();
+
+    std::vector<std::string> to_native;
+    to_native.push_back(single_size_check);
+    to_native.push_back("XLS_RETURN_IF_ERROR(Verify());");
+    if (has_fixups) {
+      to_native.push_back(absl::StrFormat("%s native = *this;", cpp_type()));
+      to_native.insert(to_native.end(), to_native_fixups_.begin(),
+                       to_native_fixups_.end());
+      to_native.push_back("std::memcpy(buffer.data(), &native, kNativeSize);");
+    } else {
+      to_native.push_back("std::memcpy(buffer.data(), this, kNativeSize);");
+    }
+    to_native.push_back("return absl::OkStatus();");
+
+    std::vector<std::string> from_native;
+    from_native.push_back(single_size_check);
+    from_native.push_back(absl::StrFormat("%s result;", cpp_type()));
+    from_native.push_back("std::memcpy(&result, buffer.data(), kNativeSize);");
+    from_native.insert(from_native.end(), from_native_fixups_.begin(),
+                       from_native_fixups_.end());
+    from_native.push_back("XLS_RETURN_IF_ERROR(result.Verify());");
+    from_native.push_back("return result;");
+
+    // Without fixups the C++ and native representations of an array of values
+    // are byte-identical, so the bulk conversions are a single copy.
+    std::vector<std::string> bulk_to_native;
+    bulk_to_native.push_back(bulk_size_check);
+    if (has_fixups) {
+      bulk_to_native.push_back(
+          "for (int64_t i = 0; i < values.size(); ++i) {\n"
+          "  XLS_RETURN_IF_ERROR(values[i].ToNative(\n"
+          "      buffer.subspan(i * kNativeSize, kNativeSize)));\n"
+          "}");
+    } else {
+      bulk_to_native.push_back(absl::StrFormat(
+          "for (const %s& value : values) {\n"
+          "  XLS_RETURN_IF_ERROR(value.Verify());\n"
+          "}\n"
+          "if (!values.empty()) {\n"
+          "  std::memcpy(buffer.data(), values.data(), "
+          "values.size() * kNativeSize);\n"
+          "}",
+          cpp_type()));
+    }
+    bulk_to_native.push_back("return absl::OkStatus();");
+
+    std::vector<std::string> bulk_from_native;
+    bulk_from_native.push_back(bulk_size_check);
+    if (has_fixups) {
+      bulk_from_native.push_back(
+          "for (int64_t i = 0; i < values.size(); ++i) {\n"
+          "  XLS_ASSIGN_OR_RETURN(\n"
+          "      values[i], FromNative(buffer.subspan(i * kNativeSize, "
+          "kNativeSize)));\n"
+          "}");
+    } else {
+      bulk_from_native.push_back(absl::StrFormat(
+          "if (!values.empty()) {\n"
+          "  std::memcpy(values.data(), buffer.data(), "
+          "values.size() * kNativeSize);\n"
+          "}\n"
+          "for (const %s& value : values) {\n"
+          "  XLS_RETURN_IF_ERROR(value.Verify());\n"
+          "}",
+          cpp_type()));
+    }
+    bulk_from_native.push_back("return absl::OkStatus();");
+
+    std::vector<std::string> header;
+    header.push_back(absl::StrFormat(
+        "static constexpr int64_t kNativeSize = %d;", native_layout_->size));
+    header.push_back(
+        absl::StrFormat("static constexpr int64_t kNativeAlignment = %d;",
+                        native_layout_->alignment));
+    header.push_back(
+        "absl::Status ToNative(absl::Span<uint8_t> buffer) const;");
+    header.push_back(absl::StrFormat(
+        "static absl::StatusOr<%s> FromNative(absl::Span<const uint8_t> "
+        "buffer);",
+        cpp_type()));
+    header.push_back(absl::StrFormat(
+        "static absl::Status ToNative(absl::Span<const %s> values, "
+        "absl::Span<uint8_t> buffer);",
+        cpp_type()));
+    header.push_back(absl::StrFormat(
+        "static absl::Status FromNative(absl::Span<const uint8_t> buffer, "
+        "absl::Span<%s> values);",
+        cpp_type()));
+
+    std::vector<std::string> source;
+    source.push_back(absl::StrFormat(
+        "absl::Status %s::ToNative(absl::Span<uint8_t> buffer) const {\n%s\n}",
+        cpp_type(), Indent(absl::StrJoin(to_native, "\n"), 2)));
+    source.push_back(absl::StrFormat(
+        "absl::StatusOr<%s> %s::FromNative(absl::Span<const uint8_t> buffer) "
+        "{\n%s\n}",
+        cpp_type(), cpp_type(), Indent(absl::StrJoin(from_native, "\n"), 2)));
+    source.push_back(absl::StrFormat(
+        "absl::Status %s::ToNative(absl::Span<const %s> values, "
+        "absl::Span<uint8_t> buffer) {\n%s\n}",
+        cpp_type(), cpp_type(),
+        Indent(absl::StrJoin(bulk_to_native, "\n"), 2)));
+    source.push_back(absl::StrFormat(
+        "absl::Status %s::FromNative(absl::Span<const uint8_t> buffer, "
+        "absl::Span<%s> values) {\n%s\n}",
+        cpp_type(), cpp_type(),
+        Indent(absl::StrJoin(bulk_from_native, "\n"), 2)));
+    return CppSource{.header = absl::StrJoin(header, "\n"),
+                     .source = absl::StrJoin(source, "\n\n")};
+  }
+
   CppSource FromValueMethod() const {
     std::vector<std::string> pieces;
     pieces.push_back(absl::StrFormat(
@@ -650,13 +969,18 @@ class StructCppTypeGenerator : public CppTypeGenerator {
 
   const StructDef* struct_def_;
   std::vector<std::unique_ptr<CppEmitter>> member_emitters_;
+  // Only populated if native layout support was requested.
+  std::optional<NativeLayout> native_layout_;
+  std::vector<std::string> to_native_fixups_;
+  std::vector<std::string> from_native_fixups_;
 };
 
 }  // namespace
 
 /* static */ absl::StatusOr<std::unique_ptr<CppTypeGenerator>>
 CppTypeGenerator::Create(const TypeDefinition& type_definition,
-                         TypeInfo* type_info, ImportData* import_data) {
+                         TypeInfo* type_info, ImportData* import_data,
+                         bool emit_native_layout) {
   return absl::visit(
       Visitor{[&](const TypeAlias* type_alias)
                   -> absl::StatusOr<std::unique_ptr<CppTypeGenerator>> {
@@ -665,8 +989,8 @@ CppTypeGenerator::Create(const TypeDefinition& type_definition,
               },
               [&](const StructDef* struct_def)
                   -> absl::StatusOr<std::unique_ptr<CppTypeGenerator>> {
-                return StructCppTypeGenerator::Create(struct_def, type_info,
-                                                      import_data);
+                return StructCppTypeGenerator::Create(
+                    struct_def, type_info, import_data, emit_native_layout);
               },
               [&](const EnumDef* enum_def)
                   -> absl::StatusOr<std::unique_ptr<CppTypeGenerator>> {
@@ -52,10 +52,14 @@ class CppTypeGenerator {
   // not a tuple or array).
   std::string dslx_type() const { return dslx_type_; }
 
-  // Returns a type generator for the given TypeDefinition.
+  // Returns a type generator for the given TypeDefinition. If
+  // `emit_native_layout` is true, generated structs additionally match the
+  // byte layout the XLS JIT uses for the type and provide ToNative/FromNative
+  // conversions; an error is returned for structs which cannot be represented
+  // that way (e.g., those containing tuples or bits types wider than 64 bits).
   static absl::StatusOr<std::unique_ptr<CppTypeGenerator>> Create(
       const TypeDefinition& type_definition, TypeInfo* type_info,
-      ImportData* import_data);
+      ImportData* import_data, bool emit_native_layout = false);
 
  protected:
   std::string cpp_type_;
@@ -0,0 +1,48 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Types transpiled with native_layout = True. Only types which have a native
+// layout (no tuples, no bits wider than 64, no empty aggregates) are used.
+
+enum SignedEnum : s3 {
+  kNegOne = s3:-1,
+  kZero = 0,
+  kThree = 3,
+}
+
+enum UnsignedEnum : u5 {
+  kA = 1,
+  kB = 17,
+}
+
+// Padded between every member but needs no conversion of its leaves.
+struct Plain {
+  a: u16,
+  b: u8,
+  c: u32,
+}
+
+struct Inner {
+  a: s7,
+  e: SignedEnum,
+}
+
+struct Outer {
+  flag: u1,
+  x: u32,
+  inners: Inner[2],
+  u: UnsignedEnum,
+  y: s64,
+  z: s20,
+}
@@ -0,0 +1,180 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/cpp_transpiler/test_native_types_lib.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+#include "xls/jit/llvm_type_converter.h"
+#include "xls/jit/orc_jit.h"
+#include "xls/jit/type_layout.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using testing::HasSubstr;
+
+// Packs and unpacks values of the transpiled types with the layout the JIT
+// uses for the corresponding IR types.
+class TestNativeTypesTest : public ::testing::Test {
+ protected:
+  TestNativeTypesTest()
+      : orc_jit_(OrcJit::Create().value()),
+        type_converter_(
+            orc_jit_->GetContext(),
+            orc_jit_->CreateDataLayout(/*aot_specification=*/false).value()) {}
+
+  TypeLayout GetLayout(const Value& value) {
+    return type_converter_.CreateTypeLayout(package_.GetTypeForValue(value));
+  }
+
+  Package package_{"test_native_types"};
+  std::unique_ptr<OrcJit> orc_jit_;
+  LlvmTypeConverter type_converter_;
+};
+
+test::Outer MakeOuter(int64_t i) {
+  return test::Outer{
+      .flag = (i % 2) == 1,
+      .x = static_cast<uint32_t>(0x12345678 + i),
+      .inners = {{test::Inner{.a = static_cast<int8_t>(-64 + i),
+                              .e = test::SignedEnum::kNegOne},
+                  test::Inner{.a = static_cast<int8_t>(63 - i),
+                              .e = test::SignedEnum::kThree}}},
+      .u = (i % 2) == 0 ? test::UnsignedEnum::kA : test::UnsignedEnum::kB,
+      .y = -1234567890123 * (i + 1),
+      .z = static_cast<int32_t>(-(1 << 19) + i),
+  };
+}
+
+TEST_F(TestNativeTypesTest, LayoutMatchesJit) {
+  XLS_ASSERT_OK_AND_ASSIGN(Value plain,
+                           test::Plain{.a = 1, .b = 2, .c = 3}.ToValue());
+  TypeLayout plain_layout = GetLayout(plain);
+  EXPECT_EQ(plain_layout.size(), test::Plain::kNativeSize);
+
+  XLS_ASSERT_OK_AND_ASSIGN(Value outer, MakeOuter(0).ToValue());
+  TypeLayout outer_layout = GetLayout(outer);
+  EXPECT_EQ(outer_layout.size(), test::Outer::kNativeSize);
+}
+
+TEST_F(TestNativeTypesTest, PlainRoundTrip) {
+  test::Plain plain{.a = 0xbeef, .b = 0x7f, .c = 0xdeadbeef};
+  XLS_ASSERT_OK_AND_ASSIGN(Value value, plain.ToValue());
+  TypeLayout layout = GetLayout(value);
+
+  std::vector<uint8_t> jit_buffer(layout.size());
+  layout.ValueToNativeLayout(value, jit_buffer.data());
+  EXPECT_THAT(test::Plain::FromNative(jit_buffer), IsOkAndHolds(plain));
+
+  std::vector<uint8_t> buffer(test::Plain::kNativeSize);
+  XLS_ASSERT_OK(plain.ToNative(absl::MakeSpan(buffer)));
+  EXPECT_EQ(layout.NativeLayoutToValue(buffer.data()), value);
+}
+
+TEST_F(TestNativeTypesTest, SignedFieldsAndEnumsRoundTrip) {
+  test::Outer outer = MakeOuter(3);
+  XLS_ASSERT_OK_AND_ASSIGN(Value value, outer.ToValue());
+  TypeLayout layout = GetLayout(value);
+
+  // Values packed by the JIT read back as the same struct, with the narrow
+  // signed fields and the signed enum sign-extended again.
+  std::vector<uint8_t> jit_buffer(layout.size());
+  layout.ValueToNativeLayout(value, jit_buffer.data());
+  XLS_ASSERT_OK_AND_ASSIGN(test::Outer from_native,
+                           test::Outer::FromNative(jit_buffer));
+  EXPECT_EQ(from_native, outer);
+  EXPECT_EQ(from_native.inners[0].a, outer.inners[0].a);
+  EXPECT_EQ(from_native.inners[0].e, test::SignedEnum::kNegOne);
+  EXPECT_EQ(from_native.z, outer.z);
+
+  // Values packed by ToNative are read by the JIT as the same value.
+  std::vector<uint8_t> buffer(test::Outer::kNativeSize);
+  XLS_ASSERT_OK(outer.ToNative(absl::MakeSpan(buffer)));
+  EXPECT_EQ(layout.NativeLayoutToValue(buffer.data()), value);
+}
+
+TEST_F(TestNativeTypesTest, BulkRoundTrip) {
+  std::vector<test::Outer> outers;
+  std::vector<test::Plain> plains;
+  for (int64_t i = 0; i < 5; ++i) {
+    outers.push_back(MakeOuter(i));
+    plains.push_back(test::Plain{.a = static_cast<uint16_t>(i),
+                                 .b = static_cast<uint8_t>(2 * i),
+                                 .c = static_cast<uint32_t>(3 * i)});
+  }
+
+  // Pack an array of values with the JIT layout of the element type; the JIT
+  // lays arrays out with a stride of the element size.
+  XLS_ASSERT_OK_AND_ASSIGN(Value outer_value, outers[0].ToValue());
+  TypeLayout outer_layout = GetLayout(outer_value);
+  std::vector<uint8_t> jit_buffer(outers.size() * outer_layout.size());
+  for (int64_t i = 0; i < outers.size(); ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(Value value, outers[i].ToValue());
+    outer_layout.ValueToNativeLayout(
+        value, jit_buffer.data() + i * outer_layout.size());
+  }
+  std::vector<test::Outer> outers_copy(outers.size());
+  XLS_ASSERT_OK(
+      test::Outer::FromNative(jit_buffer, absl::MakeSpan(outers_copy)));
+  EXPECT_EQ(outers_copy, outers);
+
+  std::vector<uint8_t> buffer(outers.size() * test::Outer::kNativeSize);
+  XLS_ASSERT_OK(test::Outer::ToNative(outers, absl::MakeSpan(buffer)));
+  for (int64_t i = 0; i < outers.size(); ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(Value value, outers[i].ToValue());
+    EXPECT_EQ(outer_layout.NativeLayoutToValue(
+                  buffer.data() + i * test::Outer::kNativeSize),
+              value);
+  }
+
+  // Types without signed leaves take the single-copy bulk path.
+  std::vector<uint8_t> plain_buffer(plains.size() * test::Plain::kNativeSize);
+  XLS_ASSERT_OK(test::Plain::ToNative(plains, absl::MakeSpan(plain_buffer)));
+  std::vector<test::Plain> plains_copy(plains.size());
+  XLS_ASSERT_OK(
+      test::Plain::FromNative(plain_buffer, absl::MakeSpan(plains_copy)));
+  EXPECT_EQ(plains_copy, plains);
+}
+
+TEST_F(TestNativeTypesTest, ConversionErrors) {
+  std::vector<uint8_t> small_buffer(test::Outer::kNativeSize - 1);
+  EXPECT_THAT(MakeOuter(0).ToNative(absl::MakeSpan(small_buffer)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("too small for Outer")));
+  EXPECT_THAT(test::Outer::FromNative(small_buffer).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("too small for Outer")));
+
+  // Values which are not valid for their DSLX type are rejected.
+  test::Outer bad = MakeOuter(0);
+  bad.inners[1].e = static_cast<test::SignedEnum>(2);
+  std::vector<uint8_t> buffer(test::Outer::kNativeSize);
+  EXPECT_THAT(bad.ToNative(absl::MakeSpan(buffer)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,6 +14,7 @@
 
 #include "xls/dslx/frontend/parser.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,12 +23,14 @@
 #include <variant>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest-spi.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xls/common/casts.h"
 #include "xls/common/logging/logging.h"
@@ -2029,4 +2032,31 @@ fn will_fail(x:u32) -> u32 {
       << module_or.status();
 }
 
+// Parses a generated module (in the style of table generator output) of
+// roughly `state.range(0)` KiB and reports throughput.
+static void BM_ParseGeneratedTables(benchmark::State& state) {
+  std::string program;
+  for (int64_t i = 0; program.size() < state.range(0) * 1024; ++i) {
+    std::string entries;
+    for (int64_t j = 0; j < 64; ++j) {
+      absl::StrAppendFormat(&entries, "  u32:0x%08x, // entry %d\n",
+                            ((i * 64 + j) * 2654435761) & 0xffffffff, j);
+    }
+    absl::StrAppendFormat(
+        &program,
+        "const TABLE_%d = u32[64]:[\n%s];\n"
+        "fn lookup_%d(x: u6) -> u32 { TABLE_%d[x] + u32:%d }\n",
+        i, entries, i, i, i);
+  }
+  for (auto _ : state) {
+    Scanner s("generated_tables.x", program);
+    Parser parser("generated_tables", &s);
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Module> module,
+                             parser.ParseModule());
+    benchmark::DoNotOptimize(module);
+  }
+  state.SetBytesProcessed(state.iterations() * program.size());
+}
+BENCHMARK(BM_ParseGeneratedTables)->Range(64, 16 * 1024);
+
 }  // namespace xls::dslx
@@ -18,9 +18,15 @@
 #include <string>
 #include <string_view>
 
+#include "absl/base/attributes.h"
+#include "absl/base/const_init.h"
+#include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "re2/re2.h"
 
 namespace xls::dslx {
@@ -41,6 +47,33 @@ namespace xls::dslx {
       absl::StrFormat("Cannot convert string to span: \"%s\"", s));
 }
 
+/* static */ const std::string* Pos::InternFilename(std::string_view filename) {
+  static const absl::NoDestructor<std::string> kEmpty;
+  if (filename.empty()) {
+    return kEmpty.get();
+  }
+  // Interned filenames are never freed (there is one per distinct file, not
+  // per position), so each thread remembers the ones it has already seen and
+  // only takes the lock the first time it sees a filename.
+  thread_local absl::flat_hash_map<std::string_view, const std::string*> seen;
+  if (auto it = seen.find(filename); it != seen.end()) {
+    return it->second;
+  }
+  ABSL_CONST_INIT static absl::Mutex mu(absl::kConstInit);
+  static absl::NoDestructor<absl::node_hash_set<std::string>> interned;
+  const std::string* result;
+  {
+    absl::MutexLock lock(&mu);
+    auto it = interned->find(filename);
+    if (it == interned->end()) {
+      it = interned->insert(std::string(filename)).first;
+    }
+    result = &*it;
+  }
+  seen.emplace(*result, result);
+  return result;
+}
+
 /* static */ absl::StatusOr<Pos> Pos::FromString(std::string_view s) {
   std::string filename;
   int64_t lineno, colno;
@@ -33,23 +33,24 @@ class Pos {
  public:
   static absl::StatusOr<Pos> FromString(std::string_view s);
 
-  Pos() : lineno_(0), colno_(0) {}
-  Pos(std::string filename, int64_t lineno, int64_t colno)
-      : filename_(std::move(filename)), lineno_(lineno), colno_(colno) {}
+  Pos() : filename_(InternFilename("")), lineno_(0), colno_(0) {}
+  Pos(std::string_view filename, int64_t lineno, int64_t colno)
+      : filename_(InternFilename(filename)), lineno_(lineno), colno_(colno) {}
 
   std::string ToString() const {
-    return absl::StrFormat("%s:%d:%d", filename_, lineno_ + 1, colno_ + 1);
+    return absl::StrFormat("%s:%d:%d", *filename_, lineno_ + 1, colno_ + 1);
   }
   std::string ToStringNoFile() const {
     return absl::StrFormat("%d:%d", lineno_ + 1, colno_ + 1);
   }
 
   std::string ToRepr() const {
-    return absl::StrFormat("Pos(\"%s\", %d, %d)", filename_, lineno_, colno_);
+    return absl::StrFormat("Pos(\"%s\", %d, %d)", *filename_, lineno_,
+                           colno_);
   }
 
   bool operator<(const Pos& other) const {
-    CHECK_EQ(filename_, other.filename_);
+    CheckSameFile(other);
     if (lineno_ < other.lineno_) {
       return true;
     }
@@ -62,7 +63,7 @@ class Pos {
     return false;
   }
   bool operator==(const Pos& other) const {
-    CHECK_EQ(filename_, other.filename_);
+    CheckSameFile(other);
     return lineno_ == other.lineno_ && colno_ == other.colno_;
   }
   bool operator!=(const Pos& other) const { return !(*this == other); }
@@ -72,7 +73,7 @@ class Pos {
   bool operator>(const Pos& other) const { return !(*this <= other); }
   bool operator>=(const Pos& other) const { return !((*this) < other); }
 
-  const std::string& filename() const { return filename_; }
+  const std::string& filename() const { return *filename_; }
 
   // Note: these lineno/colno values are zero-based.
   int64_t lineno() const { return lineno_; }
@@ -83,10 +84,42 @@ class Pos {
   // 0").
   int64_t GetHumanLineno() const { return lineno_ + 1; }
 
-  Pos BumpCol() const { return Pos(filename_, lineno_, colno_ + 1); }
+  Pos BumpCol() const { return WithLineCol(lineno_, colno_ + 1); }
+
+  // Returns a position at the given line/column in the same file as this one.
+  // This is cheaper than constructing a new position from the filename.
+  Pos WithLineCol(int64_t lineno, int64_t colno) const {
+    Pos result = *this;
+    result.lineno_ = lineno;
+    result.colno_ = colno;
+    return result;
+  }
 
  private:
-  std::string filename_;
+  // Returns the canonical (process-lifetime) copy of `filename`.
+  //
+  // Every AST node holds positions, so sharing one copy of the filename keeps
+  // positions cheap to create and copy, and lets files be compared by address.
+  // Looking up a filename the calling thread has interned before does not
+  // take a lock.
+  //
+  // Interned filenames are never freed. That costs one string per distinct
+  // filename the process ever sees, not per position or per parse. Even a
+  // long-running dslx_ls only interns the URIs of the buffers it is sent and
+  // the paths of the files they import, and re-parsing a buffer on every edit
+  // reuses the same entry. Scoping the table to an ImportData would instead
+  // mean threading it through every place a Pos is made, including spans
+  // parsed back from strings, in exchange for memory that is small and
+  // bounded by the files being edited. The per-thread lookup caches go away
+  // with their threads.
+  static const std::string* InternFilename(std::string_view filename);
+
+  void CheckSameFile(const Pos& other) const {
+    CHECK(filename_ == other.filename_)
+        << *filename_ << " vs " << *other.filename_;
+  }
+
+  const std::string* filename_;
   int64_t lineno_;
   int64_t colno_;
 };
@@ -14,10 +14,14 @@
 
 #include "xls/dslx/frontend/pos.h"
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
 
 namespace xls::dslx {
 namespace {
@@ -38,6 +42,40 @@ TEST(PosTest, PosLt) {
   EXPECT_GE(Pos(kFakeFile, 0, 0), Pos(kFakeFile, 0, 0));
 }
 
+TEST(PosTest, PositionsInTheSameFileShareFilename) {
+  std::string filename = "/my/foo.x";
+  Pos a(filename, 0, 0);
+  filename = "/my/bar.x";
+  Pos b("/my/foo.x", 3, 4);
+  EXPECT_EQ(a.filename(), "/my/foo.x");
+  EXPECT_EQ(&a.filename(), &b.filename());
+  EXPECT_NE(&a.filename(), &Pos(filename, 0, 0).filename());
+  EXPECT_EQ(b.WithLineCol(1, 2), Pos("/my/foo.x", 1, 2));
+  EXPECT_EQ(Pos().filename(), "");
+}
+
+TEST(PosTest, FilenamesInternedOnDifferentThreadsAreShared) {
+  constexpr int64_t kThreadCount = 8;
+  std::vector<const std::string*> filenames(kThreadCount);
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t i = 0; i < kThreadCount; ++i) {
+      threads.push_back(std::make_unique<Thread>([&filenames, i] {
+        // Intern twice so that the second lookup hits the thread's cache.
+        Pos first("/my/threaded.x", 0, 0);
+        filenames[i] = &Pos("/my/threaded.x", 1, 1).filename();
+        EXPECT_EQ(filenames[i], &first.filename());
+      }));
+    }
+    for (std::unique_ptr<Thread>& thread : threads) {
+      thread->Join();
+    }
+  }
+  for (const std::string* filename : filenames) {
+    EXPECT_EQ(filename, &Pos("/my/threaded.x", 0, 0).filename());
+  }
+}
+
 TEST(SpanTest, SpanContainsOther) {
   const char* kFakeFile = "<fake>";
   const Pos origin = Pos(kFakeFile, 0, 0);
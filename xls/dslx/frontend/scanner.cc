@@ -14,6 +14,7 @@
 
 #include "xls/dslx/frontend/scanner.h"
 
+#include <array>
 #include <cctype>
 #include <cstdint>
 #include <optional>
@@ -42,6 +43,32 @@
 
 namespace xls::dslx {
 
+namespace {
+
+// Lookup table for the characters that are considered whitespace -- skipping
+// whitespace is a large fraction of the scanning work for big (e.g. generated)
+// sources, so this avoids a chain of comparisons per character.
+constexpr std::array<bool, 256> kWhitespaceTable = [] {
+  std::array<bool, 256> table{};
+  for (char c : {' ', '\r', '\n', '\t', '\xa0'}) {
+    table[static_cast<uint8_t>(c)] = true;
+  }
+  return table;
+}();
+
+bool IsWhitespace(char c) { return kWhitespaceTable[static_cast<uint8_t>(c)]; }
+
+// Returns the index of the first non-whitespace character in `text` at or after
+// `index` (or the size of `text` if there is none).
+int64_t SkipWhitespace(std::string_view text, int64_t index) {
+  while (index < text.size() && IsWhitespace(text[index])) {
+    ++index;
+  }
+  return index;
+}
+
+}  // namespace
+
 absl::Status ScanErrorStatus(const Span& span, std::string_view message) {
   return absl::InvalidArgumentError(
       absl::StrFormat("ScanError: %s %s", span.ToString(), message));
@@ -74,25 +101,48 @@ bool Scanner::TryDropChar(char target) {
   return false;
 }
 
-Token Scanner::PopComment(const Pos& start_pos) {
-  std::string chars;
-  while (!AtCharEof()) {
-    char c = PopChar();
-    chars.append(1, c);
-    if (c == '\n') {
-      break;
-    }
+void Scanner::AdvanceTo(int64_t end) {
+  CHECK_LE(index_, end);
+  CHECK_LE(end, text_.size());
+  std::string_view skipped =
+      std::string_view(text_).substr(index_, end - index_);
+  // Note: `find` is implemented with memchr, which is vectorized, so long runs
+  // without newlines are cheap to step over.
+  size_t last_newline = std::string_view::npos;
+  for (size_t i = skipped.find('\n'); i != std::string_view::npos;
+       i = skipped.find('\n', i + 1)) {
+    lineno_ += 1;
+    last_newline = i;
+  }
+  if (last_newline == std::string_view::npos) {
+    colno_ += skipped.size();
+  } else {
+    colno_ = skipped.size() - last_newline - 1;
   }
-  return Token(TokenKind::kComment, Span(start_pos, GetPos()), chars);
+  index_ = end;
+}
+
+std::string_view Scanner::PopRestOfLine() {
+  const int64_t start = index_;
+  const size_t newline = std::string_view(text_).find('\n', index_);
+  const int64_t end =
+      newline == std::string_view::npos ? text_.size() : newline + 1;
+  AdvanceTo(end);
+  return std::string_view(text_).substr(start, end - start);
+}
+
+Token Scanner::PopComment(const Pos& start_pos) {
+  std::string chars(PopRestOfLine());
+  return Token(TokenKind::kComment, Span(start_pos, GetPos()),
+               std::move(chars));
 }
 
 absl::StatusOr<Token> Scanner::PopWhitespace(const Pos& start_pos) {
   CHECK(AtWhitespace());
-  std::string chars;
-  while (!AtCharEof() && AtWhitespace()) {
-    chars.append(1, PopChar());
-  }
-  return Token(TokenKind::kWhitespace, Span(start_pos, GetPos()), chars);
+  const int64_t start = index_;
+  AdvanceTo(SkipWhitespace(text_, index_));
+  return Token(TokenKind::kWhitespace, Span(start_pos, GetPos()),
+               text_.substr(start, index_ - start));
 }
 
 // This is too simple to need to return absl::Status. Just never call it
@@ -288,26 +338,25 @@ absl::StatusOr<std::string> Scanner::ScanUntilDoubleQuote() {
 
 absl::StatusOr<Token> Scanner::ScanIdentifierOrKeyword(char startc,
                                                        const Pos& start_pos) {
-  // The leading character is `startc` so we scan out trailing identifiers.
+  // The leading character is `startc` (which has already been popped) so we
+  // scan out trailing identifiers.
   auto is_trailing_identifier_char = [](char c) {
-    return std::isalpha(c) != 0 || std::isdigit(c) != 0 || c == '_' ||
-           c == '!' || c == '\'';
+    return absl::ascii_isalnum(c) || c == '_' || c == '!' || c == '\'';
   };
-  std::string s = ScanWhile(startc, is_trailing_identifier_char);
+  std::string_view s = ScanWhile(index_ - 1, is_trailing_identifier_char);
   Span span(start_pos, GetPos());
   if (std::optional<Keyword> keyword = GetKeyword(s)) {
     return Token(span, *keyword);
   }
-  return Token(TokenKind::kIdentifier, span, std::move(s));
+  return Token(TokenKind::kIdentifier, span, std::string(s));
 }
 
 std::optional<CommentData> Scanner::TryPopComment() {
   const Pos start_pos = GetPos();
   if (!AtEof() && PeekChar() == '/' && PeekChar2OrNull() == '/') {
     DropChar(2);
-    Token token = PopComment(start_pos);
-    CHECK(token.GetValue().has_value());
-    return CommentData{token.span(), token.GetValue().value()};
+    std::string text(PopRestOfLine());
+    return CommentData{Span(start_pos, GetPos()), std::move(text)};
   }
   return std::nullopt;
 }
@@ -337,29 +386,34 @@ absl::StatusOr<Token> Scanner::ScanString(const Pos& start_pos) {
         Span(start_pos, GetPos()),
         "Expected close quote character to terminate open quote character.");
   }
-  return Token(TokenKind::kString, Span(start_pos, GetPos()), value);
+  return Token(TokenKind::kString, Span(start_pos, GetPos()),
+               std::move(value));
 }
 
 absl::StatusOr<Token> Scanner::ScanNumber(char startc, const Pos& start_pos) {
+  // `startc` has already been popped; the token text starts there.
+  const int64_t start_index = index_ - 1;
   bool negative = startc == '-';
   if (negative) {
     startc = PopChar();
   }
 
-  std::string s;
+  std::string_view s;
   if (startc == '0' && TryDropChar('x')) {  // Hex radix.
-    s = ScanWhile("0x", [](char c) {
+    const int64_t digits_index = index_;
+    s = ScanWhile(start_index, [](char c) {
       return ('0' <= c && c <= '9') || ('a' <= c && c <= 'f') ||
              ('A' <= c && c <= 'F') || c == '_';
     });
-    if (s == "0x") {
+    if (index_ == digits_index) {
       return ScanErrorStatus(Span(GetPos(), GetPos()),
                              "Expected hex characters following 0x prefix.");
     }
   } else if (startc == '0' && TryDropChar('b')) {  // Bin prefix.
-    s = ScanWhile("0b",
+    const int64_t digits_index = index_;
+    s = ScanWhile(start_index,
                   [](char c) { return ('0' <= c && c <= '1') || c == '_'; });
-    if (s == "0b") {
+    if (index_ == digits_index) {
       return ScanErrorStatus(Span(GetPos(), GetPos()),
                              "Expected binary characters following 0b prefix");
     }
@@ -369,58 +423,33 @@ absl::StatusOr<Token> Scanner::ScanNumber(char startc, const Pos& start_pos) {
           absl::StrFormat("Invalid digit for binary number: '%c'", PeekChar()));
     }
   } else {
-    s = ScanWhile(startc, [](char c) { return std::isdigit(c) != 0; });
-    if (absl::StartsWith(s, "0") && s.size() != 1) {
+    s = ScanWhile(start_index, absl::ascii_isdigit);
+    std::string_view digits = negative ? s.substr(1) : s;
+    if (absl::StartsWith(digits, "0") && digits.size() != 1) {
       return ScanErrorStatus(
           Span(GetPos(), GetPos()),
           "Invalid radix for number, expect 0b or 0x because of leading 0.");
     }
-    CHECK(!s.empty())
+    CHECK(!digits.empty())
         << "Must have seen numerical digits to attempt to scan a number.";
   }
-  if (negative) {
-    s = "-" + s;
-  }
-  return Token(TokenKind::kNumber, Span(start_pos, GetPos()), s);
+  return Token(TokenKind::kNumber, Span(start_pos, GetPos()), std::string(s));
 }
 
-bool Scanner::AtWhitespace() const {
-  switch (PeekChar()) {
-    case ' ':
-    case '\r':
-    case '\n':
-    case '\t':
-    case '\xa0':
-      return true;
-    default:
-      return false;
-  }
-}
+bool Scanner::AtWhitespace() const { return IsWhitespace(PeekChar()); }
 
 void Scanner::DropLeadingWhitespace() {
-  while (!AtCharEof()) {
-    if (AtWhitespace()) {
-      DropChar();
-    } else {
-      break;
-    }
-  }
+  AdvanceTo(SkipWhitespace(text_, index_));
 }
 
 void Scanner::DropCommentsAndLeadingWhitespace() {
-  while (!AtCharEof()) {
-    if (AtWhitespace()) {
-      DropChar();
-    } else if (PeekChar() == '/' && PeekChar2OrNull() == '/') {
-      DropChar(2);  // Get rid of leading "//"
-      while (!AtCharEof()) {
-        if (PopChar() == '\n') {
-          break;
-        }
-      }
-    } else {
+  while (true) {
+    DropLeadingWhitespace();
+    if (AtCharEof() || PeekChar() != '/' || PeekChar2OrNull() != '/') {
       break;
     }
+    DropChar(2);  // Get rid of leading "//"
+    (void)PopRestOfLine();
   }
 }
 
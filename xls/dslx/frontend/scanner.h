@@ -16,7 +16,6 @@
 #define XLS_DSLX_FRONTEND_SCANNER_H_
 
 #include <cstdint>
-#include <functional>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -55,6 +54,7 @@ class Scanner {
   Scanner(std::string filename, std::string text,
           bool include_whitespace_and_comments = false)
       : filename_(std::move(filename)),
+        file_start_(filename_, 0, 0),
         text_(std::move(text)),
         include_whitespace_and_comments_(include_whitespace_and_comments) {}
 
@@ -64,9 +64,7 @@ class Scanner {
   //
   // TODO(leary): 2020-09-08 Attempt to privatize this, ideally consumers would
   // only care about the positions of tokens, not of the scanner itself.
-  Pos GetPos() const {
-    return Pos(filename_, lineno_, colno_);
-  }
+  Pos GetPos() const { return file_start_.WithLineCol(lineno_, colno_); }
 
   // Pops a token from the current position in the character stream, or returns
   // a status error if no token can be scanned out.
@@ -147,19 +145,21 @@ class Scanner {
   absl::StatusOr<Token> ScanChar(const Pos& start_pos);
 
   // Scans from the current position until ftake returns false or EOF is
-  // reached.
-  std::string ScanWhile(std::string s, const std::function<bool(char)>& ftake) {
-    while (!AtCharEof()) {
-      char peek = PeekChar();
-      if (!ftake(peek)) {
-        break;
-      }
-      s.append(1, PopChar());
+  // reached, and returns the text from `start_index` (which may precede the
+  // current position, e.g. to include already-popped prefix characters) to the
+  // new position.
+  //
+  // Precondition: `ftake` must not accept newlines, as the column is advanced
+  // in bulk.
+  template <typename TakeFn>
+  std::string_view ScanWhile(int64_t start_index, TakeFn ftake) {
+    int64_t end = index_;
+    while (end < text_.size() && ftake(text_[end])) {
+      ++end;
     }
-    return s;
-  }
-  std::string ScanWhile(char c, const std::function<bool(char)>& ftake) {
-    return ScanWhile(std::string(1, c), ftake);
+    colno_ += end - index_;
+    index_ = end;
+    return std::string_view(text_).substr(start_index, end - start_index);
   }
 
   // Scans the identifier-looping entity beginning with startc.
@@ -231,9 +231,16 @@ class Scanner {
   // (including if we are at end of file) returns false.
   bool TryDropChar(char target);
 
+  // Advances the character cursor to `end`, updating the line/column for any
+  // newlines in between.
+  void AdvanceTo(int64_t end);
+
   // Pops all the characters from the current character cursor to the end of
-  // line (or end of file) and returns that. (This is useful presuming a leading
-  // EOL-comment-delimiter was observed.)
+  // line (inclusive, or end of file) and returns them. (This is useful
+  // presuming a leading EOL-comment-delimiter was observed.)
+  std::string_view PopRestOfLine();
+
+  // As above, but returns the characters as a comment token.
   Token PopComment(const Pos& start_pos);
 
   // Pops all the whitespace characters and returns them as a token. This is
@@ -263,6 +270,7 @@ class Scanner {
   absl::StatusOr<std::string> ProcessNextStringChar();
 
   std::string filename_;
+  Pos file_start_;
   std::string text_;
   bool include_whitespace_and_comments_;
   int64_t index_ = 0;
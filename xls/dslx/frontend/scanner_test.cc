@@ -19,11 +19,13 @@
 #include <utility>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/error_test_utils.h"
 #include "xls/dslx/frontend/comment_data.h"
@@ -481,4 +483,43 @@ bar  // another thing
   }
 }
 
+TEST(ScannerTest, PositionsAfterWhitespaceAndCommentRuns) {
+  std::string text = "a \t\n\n   // c\n\t  bb  0x1f\n  // d";
+  Scanner s("fake_file.x", text);
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, s.PopAll());
+  ASSERT_EQ(tokens.size(), 4);
+  EXPECT_EQ(tokens[0].span(),
+            Span(Pos("fake_file.x", 0, 0), Pos("fake_file.x", 0, 1)));
+  EXPECT_EQ(tokens[1].span(),
+            Span(Pos("fake_file.x", 3, 3), Pos("fake_file.x", 3, 5)));
+  EXPECT_EQ(tokens[1].GetStringValue(), "bb");
+  EXPECT_EQ(tokens[2].span(),
+            Span(Pos("fake_file.x", 3, 7), Pos("fake_file.x", 3, 11)));
+  EXPECT_EQ(tokens[2].GetStringValue(), "0x1f");
+  EXPECT_EQ(tokens[3].kind(), TokenKind::kEof);
+  EXPECT_EQ(s.GetPos(), Pos("fake_file.x", 4, 6));
+  ASSERT_EQ(s.comments().size(), 2);
+  EXPECT_EQ(s.comments()[0].text, " c\n");
+  EXPECT_EQ(s.comments()[1].text, " d");
+}
+
+// Scans a generated source (in the style of table generator output) of
+// roughly `state.range(0)` KiB and reports throughput.
+void BM_ScanGeneratedTable(benchmark::State& state) {
+  std::string text;
+  for (int64_t i = 0; text.size() < state.range(0) * 1024; ++i) {
+    absl::StrAppendFormat(&text,
+                          "    // entry %d\n    u32:0x%08x, u32:%d, "
+                          "some_identifier_%d,\n",
+                          i, (i * 2654435761) & 0xffffffff, i, i % 64);
+  }
+  for (auto _ : state) {
+    Scanner s("generated_table_source.x", text);
+    XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, s.PopAll());
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ScanGeneratedTable)->Range(64, 16 * 1024);
+
 }  // namespace xls::dslx
@@ -109,7 +109,7 @@ class Token {
  public:
   Token(TokenKind kind, Span span,
         std::optional<std::string> value = std::nullopt)
-      : kind_(kind), span_(std::move(span)), payload_(value) {}
+      : kind_(kind), span_(std::move(span)), payload_(std::move(value)) {}
 
   Token(Span span, Keyword keyword)
       : kind_(TokenKind::kKeyword), span_(std::move(span)), payload_(keyword) {}
@@ -147,10 +147,10 @@ class Token {
     return kind_ == TokenKind::kKeyword && GetKeyword() == target;
   }
   bool IsIdentifier(std::string_view target) const {
-    return kind_ == TokenKind::kIdentifier && *GetValue() == target;
+    return kind_ == TokenKind::kIdentifier && GetStringValue() == target;
   }
   bool IsNumber(std::string_view target) const {
-    return kind_ == TokenKind::kNumber && *GetValue() == target;
+    return kind_ == TokenKind::kNumber && GetStringValue() == target;
   }
 
   bool IsKindIn(
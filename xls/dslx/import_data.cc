@@ -14,8 +14,10 @@
 
 #include "xls/dslx/import_data.h"
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -43,6 +45,17 @@ namespace xls::dslx {
   return ImportTokens(absl::StrSplit(module_name, '.'));
 }
 
+std::optional<ImportData::ParsedImport> ImportData::TakeParsedImport(
+    const ImportTokens& subject) {
+  auto it = parsed_imports_.find(subject);
+  if (it == parsed_imports_.end()) {
+    return std::nullopt;
+  }
+  ParsedImport result = std::move(it->second);
+  parsed_imports_.erase(it);
+  return result;
+}
+
 absl::StatusOr<ModuleInfo*> ImportData::Get(const ImportTokens& subject) const {
   auto it = modules_.find(subject);
   if (it == modules_.end()) {
@@ -64,6 +77,35 @@ absl::StatusOr<ModuleInfo*> ImportData::Put(
   return pmodule_info;
 }
 
+std::vector<std::filesystem::path> ImportData::GetModulePaths() const {
+  std::vector<std::filesystem::path> paths;
+  paths.reserve(modules_.size());
+  for (const auto& [subject, module_info] : modules_) {
+    paths.push_back(module_info->path());
+  }
+  return paths;
+}
+
+absl::Status ImportData::EvictModule(const Module* module) {
+  for (const auto& [subject, module_info] : modules_) {
+    XLS_RET_CHECK(&module_info->module() != module)
+        << "Cannot evict module " << module->name()
+        << " which is in the import cache as " << subject.ToString();
+  }
+  Module* key = const_cast<Module*>(module);
+  top_level_bindings_.erase(key);
+  top_level_bindings_done_.erase(key);
+  typecheck_wip_.erase(key);
+  if (module->fs_path().has_value()) {
+    source_texts_.erase(module->fs_path()->string());
+  }
+  if (bytecode_cache_ != nullptr) {
+    bytecode_cache_->EvictModule(module);
+  }
+  type_info_owner_.EvictModule(module);
+  return absl::OkStatus();
+}
+
 absl::StatusOr<TypeInfo*> ImportData::GetRootTypeInfoForNode(
     const AstNode* node) {
   XLS_RET_CHECK(node != nullptr);
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <filesystem>  // NOLINT
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -133,6 +134,18 @@ class ImportData {
   absl::StatusOr<ModuleInfo*> Put(const ImportTokens& subject,
                                   std::unique_ptr<ModuleInfo> module_info);
 
+  // Returns the paths of all modules in the import cache.
+  std::vector<std::filesystem::path> GetModulePaths() const;
+
+  // Drops all state held for `module` (type information, top-level bindings,
+  // cached bytecode) so that the module can be destroyed while this
+  // ImportData, and the imports it has cached, live on.
+  //
+  // This is for modules that were typechecked against this ImportData without
+  // being Put() into it, e.g. an editor buffer that is re-typechecked on every
+  // change (nothing else may import such a module).
+  absl::Status EvictModule(const Module* module);
+
   TypeInfoOwner& type_info_owner() { return type_info_owner_; }
 
   // Helper that gets the "root" type information for the module of the given
@@ -202,6 +215,65 @@ class ImportData {
   // into this ImportData set.
   WarningKindSet enabled_warnings() const { return enabled_warnings_; }
 
+  // Counts of import requests (see DoImport()): a "hit" is an import whose
+  // module had already been parsed and typechecked.
+  //
+  // Typechecked modules are only cached for the lifetime of an ImportData, so
+  // these counts never include work saved across processes. Persisting type
+  // information would need TypeInfoProto to capture everything a TypeInfo
+  // holds (constexpr values, parametric invocation data, imports, ...) and a
+  // way to attach it to a freshly parsed module; today it records only node
+  // types.
+  const CacheStats& import_cache_stats() const { return import_cache_stats_; }
+  CacheStats& import_cache_stats() { return import_cache_stats_; }
+
+  // Number of threads that may be used to locate and parse the import closure
+  // of a module ahead of typechecking it (see PrefetchImports()).
+  int64_t import_threads() const { return import_threads_; }
+  void set_import_threads(int64_t value) { import_threads_ = value; }
+
+  // A module that has been located and parsed, but not yet typechecked.
+  struct ParsedImport {
+    std::filesystem::path path;
+    std::unique_ptr<Module> module;
+  };
+
+  // Notes a module parsed ahead of time for the import of `subject`, to be
+  // picked up by DoImport() instead of parsing the file again.
+  void AddParsedImport(const ImportTokens& subject, ParsedImport parsed) {
+    parsed_imports_.emplace(subject, std::move(parsed));
+  }
+  bool HasParsedImport(const ImportTokens& subject) const {
+    return parsed_imports_.contains(subject);
+  }
+  std::optional<ParsedImport> TakeParsedImport(const ImportTokens& subject);
+
+  // Whether SetSourceText() keeps the text it is given. Off by default, so that
+  // only users of a consumer keyed on module source (e.g. a BytecodeCache with
+  // a SharedBytecodeStore) hold on to a copy of every parsed file. Must be set
+  // before the modules of interest are parsed.
+  void set_record_source_texts(bool value) { record_source_texts_ = value; }
+  bool record_source_texts() const { return record_source_texts_; }
+
+  // Notes `text` as the source the module at `path` was parsed from, so that
+  // consumers keyed on module source (e.g. the bytecode store) see exactly what
+  // was parsed without reading the file again. Does nothing unless
+  // record_source_texts() is set.
+  void SetSourceText(const std::filesystem::path& path, std::string text) {
+    if (record_source_texts_) {
+      source_texts_[path.string()] = std::move(text);
+    }
+  }
+  // Returns the source noted for `path` by SetSourceText(), if any.
+  std::optional<std::string_view> GetSourceText(
+      const std::filesystem::path& path) const {
+    auto it = source_texts_.find(path.string());
+    if (it == source_texts_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
  private:
   friend ImportData CreateImportData(const std::filesystem::path&,
                                      absl::Span<const std::filesystem::path>,
@@ -235,6 +307,11 @@ class ImportData {
   absl::Span<const std::filesystem::path> additional_search_paths_;
   WarningKindSet enabled_warnings_;
   std::unique_ptr<BytecodeCacheInterface> bytecode_cache_;
+  CacheStats import_cache_stats_;
+  int64_t import_threads_ = 1;
+  absl::flat_hash_map<ImportTokens, ParsedImport> parsed_imports_;
+  bool record_source_texts_ = false;
+  absl::flat_hash_map<std::string, std::string> source_texts_;
 
   // See comment on AddToImporterStack() above.
   std::vector<ImportRecord> importer_stack_;
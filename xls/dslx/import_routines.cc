@@ -14,12 +14,15 @@
 
 #include "xls/dslx/import_routines.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "absl/cleanup/cleanup.h"
@@ -35,8 +38,10 @@
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/module.h"
 #include "xls/dslx/frontend/parser.h"
 #include "xls/dslx/frontend/pos.h"
@@ -142,6 +147,99 @@ static absl::StatusOr<std::filesystem::path> FindExistingPath(
                       GetCurrentDirectory().value(), stdlib_path));
 }
 
+// Reads and parses the module for `subject`, which lives at `path`. The text
+// read is returned in `source_text`.
+static absl::StatusOr<std::unique_ptr<Module>> ParseImport(
+    const ImportTokens& subject, const std::filesystem::path& path,
+    std::string* source_text) {
+  XLS_ASSIGN_OR_RETURN(*source_text, GetFileContents(path));
+
+  absl::Span<std::string const> pieces = subject.pieces();
+  std::string fully_qualified_name = absl::StrJoin(pieces, ".");
+  XLS_VLOG(3) << "Parsing " << fully_qualified_name << " from " << path;
+
+  Scanner scanner(path, *source_text);
+  Parser parser(/*module_name=*/fully_qualified_name, &scanner);
+  return parser.ParseModule();
+}
+
+// Appends the subjects of all imports in `module` that have not been seen
+// before to `frontier`.
+static void CollectImports(const Module& module,
+                           absl::flat_hash_set<ImportTokens>& seen,
+                           std::vector<ImportTokens>& frontier) {
+  for (const ModuleMember& member : module.top()) {
+    if (!std::holds_alternative<Import*>(member)) {
+      continue;
+    }
+    ImportTokens subject(std::get<Import*>(member)->subject());
+    if (seen.insert(subject).second) {
+      frontier.push_back(std::move(subject));
+    }
+  }
+}
+
+absl::Status PrefetchImports(const Module& module, ImportData* import_data,
+                             int64_t thread_count) {
+  XLS_RET_CHECK(import_data != nullptr);
+  XLS_RET_CHECK_GE(thread_count, 1);
+
+  absl::flat_hash_set<ImportTokens> seen;
+  std::vector<ImportTokens> frontier;
+  CollectImports(module, seen, frontier);
+
+  int64_t prefetched = 0;
+  while (!frontier.empty()) {
+    // Modules that are already typechecked (or parsed) have had their imports
+    // handled already.
+    std::vector<ImportTokens> subjects;
+    for (ImportTokens& subject : frontier) {
+      if (!import_data->Contains(subject) &&
+          !import_data->HasParsedImport(subject)) {
+        subjects.push_back(std::move(subject));
+      }
+    }
+    frontier.clear();
+
+    // Each worker only writes its own result slots, so the results can be
+    // merged below in a deterministic order.
+    std::vector<std::filesystem::path> paths(subjects.size());
+    std::vector<std::string> source_texts(subjects.size());
+    std::vector<absl::StatusOr<std::unique_ptr<Module>>> modules(
+        subjects.size());
+    ParallelFor(subjects.size(), thread_count, [&](int64_t i) {
+      absl::StatusOr<std::filesystem::path> path = FindExistingPath(
+          subjects[i], import_data->stdlib_path(),
+          import_data->additional_search_paths(), Span::Fake());
+      if (!path.ok()) {
+        modules[i] = path.status();
+        return;
+      }
+      paths[i] = *std::move(path);
+      modules[i] = ParseImport(subjects[i], paths[i], &source_texts[i]);
+    });
+
+    for (int64_t i = 0; i < subjects.size(); ++i) {
+      if (!modules[i].ok()) {
+        XLS_VLOG(3) << "Not prefetching " << subjects[i].ToString() << ": "
+                    << modules[i].status();
+        continue;
+      }
+      std::unique_ptr<Module> parsed = *std::move(modules[i]);
+      CollectImports(*parsed, seen, frontier);
+      import_data->SetSourceText(paths[i], std::move(source_texts[i]));
+      import_data->AddParsedImport(
+          subjects[i], ImportData::ParsedImport{std::move(paths[i]),
+                                                std::move(parsed)});
+      ++prefetched;
+    }
+  }
+  XLS_VLOG(2) << "Prefetched " << prefetched << " import(s) of "
+              << module.name() << " using up to " << thread_count
+              << " thread(s)";
+  return absl::OkStatus();
+}
+
 absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
                                      const ImportTokens& subject,
                                      ImportData* import_data,
@@ -149,11 +247,28 @@ absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
   XLS_RET_CHECK(import_data != nullptr);
   if (import_data->Contains(subject)) {
     XLS_VLOG(3) << "DoImport (cached) subject: " << subject.ToString();
+    ++import_data->import_cache_stats().hits;
     return import_data->Get(subject);
   }
+  ++import_data->import_cache_stats().misses;
 
   XLS_VLOG(3) << "DoImport (uncached) subject: " << subject.ToString();
 
+  if (std::optional<ImportData::ParsedImport> parsed =
+          import_data->TakeParsedImport(subject)) {
+    XLS_VLOG(3) << "Typechecking prefetched " << subject.ToString();
+    XLS_RETURN_IF_ERROR(
+        import_data->AddToImporterStack(import_span, parsed->path));
+    absl::Cleanup cleanup = absl::MakeCleanup(
+        [&] { CHECK_OK(import_data->PopFromImporterStack(import_span)); });
+    XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                         ftypecheck(parsed->module.get()));
+    return import_data->Put(
+        subject, std::make_unique<ModuleInfo>(std::move(parsed->module),
+                                              type_info,
+                                              std::move(parsed->path)));
+  }
+
   XLS_ASSIGN_OR_RETURN(
       std::filesystem::path found_path,
       FindExistingPath(subject, import_data->stdlib_path(),
@@ -163,16 +278,10 @@ absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
   absl::Cleanup cleanup = absl::MakeCleanup(
       [&] { CHECK_OK(import_data->PopFromImporterStack(import_span)); });
 
-  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(found_path));
-
-  absl::Span<std::string const> pieces = subject.pieces();
-  std::string fully_qualified_name = absl::StrJoin(pieces, ".");
-  XLS_VLOG(3) << "Parsing and typechecking " << fully_qualified_name
-              << ": start";
-
-  Scanner scanner(found_path, contents);
-  Parser parser(/*module_name=*/fully_qualified_name, &scanner);
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
+  std::string source_text;
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module,
+                       ParseImport(subject, found_path, &source_text));
+  import_data->SetSourceText(found_path, std::move(source_text));
   XLS_ASSIGN_OR_RETURN(TypeInfo * type_info, ftypecheck(module.get()));
   return import_data->Put(
       subject, std::make_unique<ModuleInfo>(std::move(module), type_info,
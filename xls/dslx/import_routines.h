@@ -15,8 +15,10 @@
 #ifndef XLS_DSLX_IMPORT_ROUTINES_H_
 #define XLS_DSLX_IMPORT_ROUTINES_H_
 
+#include <cstdint>
 #include <functional>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/import_data.h"
@@ -49,6 +51,20 @@ absl::StatusOr<ModuleInfo*> DoImport(const TypecheckModuleFn& ftypecheck,
                                      ImportData* import_data,
                                      const Span& import_span);
 
+// Locates and parses the transitive import closure of `module` using up to
+// `thread_count` threads, stashing the parsed modules in `import_data` so that
+// subsequent DoImport() calls only need to typecheck them.
+//
+// Typechecking itself remains sequential (and in the same order as without
+// prefetching): type information for imported modules is shared and mutated
+// as parametric functions are instantiated, so it cannot be built
+// concurrently.
+//
+// Failures to find or parse a module are not reported here; the affected
+// import is simply left for DoImport() to process (and report) as usual.
+absl::Status PrefetchImports(const Module& module, ImportData* import_data,
+                             int64_t thread_count);
+
 }  // namespace xls::dslx
 
 #endif  // XLS_DSLX_IMPORT_ROUTINES_H_
@@ -0,0 +1,165 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/import_routines.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/create_import_data.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/warning_kind.h"
+
+namespace xls::dslx {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+constexpr int64_t kLibCount = 6;
+
+// Writes `kLibCount` libraries that all import (and instantiate a parametric
+// function from) a shared `common` module, and returns the text of a module
+// that imports every library.
+absl::StatusOr<std::string> WriteWideImportGraph(
+    const std::filesystem::path& dir) {
+  XLS_RETURN_IF_ERROR(SetFileContents(dir / "common.x", R"(
+pub fn widen<N: u32>(x: bits[N]) -> u64 { x as u64 }
+)"));
+  std::string entry;
+  std::string sum = "u64:0";
+  for (int64_t i = 0; i < kLibCount; ++i) {
+    XLS_RETURN_IF_ERROR(SetFileContents(
+        dir / absl::StrFormat("lib%d.x", i),
+        absl::StrFormat(R"(import common;
+pub fn f(x: u%d) -> u64 { common::widen(x) + u64:%d }
+)",
+                        i + 1, i)));
+    absl::StrAppendFormat(&entry, "import lib%d;\n", i);
+    absl::StrAppendFormat(&sum, " + lib%d::f(u%d:0)", i, i + 1);
+  }
+  absl::StrAppendFormat(&entry, "fn main() -> u64 { %s }\n", sum);
+  return entry;
+}
+
+TEST(ImportRoutinesTest, PrefetchedImportsTypecheckLikeSequentialOnes) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK_AND_ASSIGN(std::string entry,
+                           WriteWideImportGraph(temp_dir.path()));
+  std::vector<std::filesystem::path> search_paths = {temp_dir.path()};
+
+  for (int64_t threads : {1, 4}) {
+    ImportData import_data = CreateImportData(
+        kDefaultDslxStdlibPath, search_paths, kDefaultWarningsSet);
+    import_data.set_import_threads(threads);
+    XLS_ASSERT_OK_AND_ASSIGN(
+        TypecheckedModule tm,
+        ParseAndTypecheck(entry, "entry.x", "entry", &import_data));
+    EXPECT_NE(tm.module->GetFunction("main"), std::nullopt);
+
+    // Every library plus `common` is imported exactly once; `common` is a hit
+    // for every library after the first.
+    EXPECT_EQ(import_data.import_cache_stats().misses, kLibCount + 1)
+        << "threads: " << threads;
+    EXPECT_EQ(import_data.import_cache_stats().hits, kLibCount - 1)
+        << "threads: " << threads;
+    for (int64_t i = 0; i < kLibCount; ++i) {
+      ImportTokens subject({absl::StrFormat("lib%d", i)});
+      EXPECT_TRUE(import_data.Contains(subject));
+      EXPECT_FALSE(import_data.HasParsedImport(subject));
+    }
+  }
+}
+
+TEST(ImportRoutinesTest, PrefetchLeavesMissingImportsToDoImport) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::vector<std::filesystem::path> search_paths = {temp_dir.path()};
+  ImportData import_data = CreateImportData(
+      kDefaultDslxStdlibPath, search_paths, kDefaultWarningsSet);
+  import_data.set_import_threads(4);
+  EXPECT_THAT(ParseAndTypecheck("import does_not_exist;\n", "entry.x", "entry",
+                                &import_data),
+              StatusIs(absl::StatusCode::kNotFound,
+                       HasSubstr("Could not find DSLX file for import")));
+}
+
+// Typechecks a module that imports `state.range(0)` independent sibling
+// modules, with `state.range(1)` import threads. Wall-clock time, since the
+// point of import threads is to parse the siblings concurrently.
+void BM_ParseAndTypecheckWideImports(benchmark::State& state) {
+  absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
+  CHECK_OK(temp_dir.status());
+  std::string entry;
+  std::string sum = "u32:0";
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    std::string lib;
+    for (int64_t j = 0; j < 32; ++j) {
+      absl::StrAppendFormat(&lib, R"(
+pub fn f%d(x: u32) -> u32 {
+  let y = for (k, acc): (u32, u32) in u32:0..u32:4 {
+    match k {
+      u32:0 => acc + x,
+      u32:1 => acc ^ (x << u32:%d),
+      _ => (acc * u32:3) | k,
+    }
+  }(u32:%d);
+  y + u32:%d
+}
+)",
+                            j, j % 32, j, i);
+    }
+    CHECK_OK(SetFileContents(temp_dir->path() / absl::StrFormat("lib%d.x", i),
+                             lib));
+    absl::StrAppendFormat(&entry, "import lib%d;\n", i);
+    absl::StrAppendFormat(&sum, " + lib%d::f0(u32:%d)", i, i);
+  }
+  absl::StrAppendFormat(&entry, "fn main() -> u32 { %s }\n", sum);
+  std::vector<std::filesystem::path> search_paths = {temp_dir->path()};
+
+  for (auto _ : state) {
+    ImportData import_data = CreateImportData(
+        kDefaultDslxStdlibPath, search_paths, kDefaultWarningsSet);
+    import_data.set_import_threads(state.range(1));
+    absl::StatusOr<TypecheckedModule> tm =
+        ParseAndTypecheck(entry, "entry.x", "entry", &import_data);
+    CHECK_OK(tm.status());
+    benchmark::DoNotOptimize(tm);
+  }
+}
+BENCHMARK(BM_ParseAndTypecheckWideImports)
+    ->Args({16, 1})
+    ->Args({16, 16})
+    ->Args({64, 1})
+    ->Args({64, 16})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace xls::dslx
@@ -41,6 +41,21 @@
 #include "xls/ir/format_preference.h"
 
 namespace xls::dslx {
+namespace {
+
+// Small-value fast path: values of at most 64 bits are held in a single inline
+// word, so arithmetic on them can be done directly on that word (with the
+// result masked back to the value's width) instead of going through the
+// general-purpose bits_ops routines, which build intermediate Bits.
+bool FitsInWord(const Bits& bits) { return bits.bit_count() <= 64; }
+
+uint64_t LowWord(const Bits& bits) { return bits.bitmap().GetWord(0); }
+
+Bits WordToBits(uint64_t word, int64_t bit_count) {
+  return Bits::FromBitmap(InlineBitmap::FromWord(word, bit_count));
+}
+
+}  // namespace
 
 std::string TagToString(InterpValueTag tag) {
   switch (tag) {
@@ -435,50 +450,58 @@ absl::StatusOr<InterpValue> InterpValue::Lt(const InterpValue& other) const {
 }
 
 absl::StatusOr<InterpValue> InterpValue::BitwiseNegate() const {
-  XLS_ASSIGN_OR_RETURN(Bits b, GetBits());
-  return InterpValue(tag_, bits_ops::Not(b));
+  XLS_RET_CHECK(HasBits());
+  return InterpValue(tag_, bits_ops::Not(GetBitsOrDie()));
 }
 
 absl::StatusOr<InterpValue> InterpValue::BitwiseXor(
     const InterpValue& other) const {
-  XLS_ASSIGN_OR_RETURN(Bits lhs, GetBits());
-  XLS_ASSIGN_OR_RETURN(Bits rhs, other.GetBits());
-  return InterpValue(tag_, bits_ops::Xor(lhs, rhs));
+  XLS_RET_CHECK(HasBits() && other.HasBits());
+  return InterpValue(tag_,
+                     bits_ops::Xor(GetBitsOrDie(), other.GetBitsOrDie()));
 }
 
 absl::StatusOr<InterpValue> InterpValue::BitwiseOr(
     const InterpValue& other) const {
-  XLS_ASSIGN_OR_RETURN(Bits lhs, GetBits());
-  XLS_ASSIGN_OR_RETURN(Bits rhs, other.GetBits());
-  return InterpValue(tag_, bits_ops::Or(lhs, rhs));
+  XLS_RET_CHECK(HasBits() && other.HasBits());
+  return InterpValue(tag_, bits_ops::Or(GetBitsOrDie(), other.GetBitsOrDie()));
 }
 
 absl::StatusOr<InterpValue> InterpValue::BitwiseAnd(
     const InterpValue& other) const {
   XLS_RET_CHECK_EQ(tag(), other.tag());
-  XLS_ASSIGN_OR_RETURN(Bits lhs, GetBits());
-  XLS_ASSIGN_OR_RETURN(Bits rhs, other.GetBits());
-  return InterpValue(tag_, bits_ops::And(lhs, rhs));
+  XLS_RET_CHECK(HasBits() && other.HasBits());
+  return InterpValue(tag_,
+                     bits_ops::And(GetBitsOrDie(), other.GetBitsOrDie()));
 }
 
 absl::StatusOr<InterpValue> InterpValue::Sub(const InterpValue& other) const {
-  XLS_ASSIGN_OR_RETURN(Bits lhs, GetBits());
-  XLS_ASSIGN_OR_RETURN(Bits rhs, other.GetBits());
+  XLS_RET_CHECK(HasBits() && other.HasBits());
+  const Bits& lhs = GetBitsOrDie();
+  const Bits& rhs = other.GetBitsOrDie();
   if (lhs.bit_count() != rhs.bit_count()) {
     return absl::InvalidArgumentError(
         absl::StrFormat("Interpreter value sub requires lhs and rhs to have "
                         "same bit count; got %d vs %d",
                         lhs.bit_count(), rhs.bit_count()));
   }
+  if (FitsInWord(lhs)) {
+    return InterpValue(
+        tag_, WordToBits(LowWord(lhs) - LowWord(rhs), lhs.bit_count()));
+  }
   return InterpValue(tag_, bits_ops::Sub(lhs, rhs));
 }
 
 absl::StatusOr<InterpValue> InterpValue::Add(const InterpValue& other) const {
   XLS_RET_CHECK(IsBits() && other.IsBits());
   XLS_RET_CHECK_EQ(tag(), other.tag());
-  XLS_RET_CHECK_EQ(GetBitCount().value(), other.GetBitCount().value());
-  XLS_ASSIGN_OR_RETURN(Bits lhs, GetBits());
-  XLS_ASSIGN_OR_RETURN(Bits rhs, other.GetBits());
+  const Bits& lhs = GetBitsOrDie();
+  const Bits& rhs = other.GetBitsOrDie();
+  XLS_RET_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
+  if (FitsInWord(lhs)) {
+    return InterpValue(
+        tag_, WordToBits(LowWord(lhs) + LowWord(rhs), lhs.bit_count()));
+  }
   return InterpValue(tag_, bits_ops::Add(lhs, rhs));
 }
 
@@ -505,13 +528,20 @@ absl::StatusOr<InterpValue> InterpValue::SCmp(const InterpValue& other,
 }
 
 absl::StatusOr<InterpValue> InterpValue::Mul(const InterpValue& other) const {
-  XLS_ASSIGN_OR_RETURN(Bits lhs, GetBits());
-  XLS_ASSIGN_OR_RETURN(Bits rhs, other.GetBits());
+  XLS_RET_CHECK(HasBits() && other.HasBits());
+  const Bits& lhs = GetBitsOrDie();
+  const Bits& rhs = other.GetBitsOrDie();
   if (lhs.bit_count() != rhs.bit_count()) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "Cannot mul different width values: lhs %d bits, rhs %d bits",
         lhs.bit_count(), rhs.bit_count()));
   }
+  // The low N bits of a product are the same for signed and unsigned
+  // interpretations, so a single wrapping word multiply suffices.
+  if (FitsInWord(lhs)) {
+    return InterpValue(
+        tag_, WordToBits(LowWord(lhs) * LowWord(rhs), lhs.bit_count()));
+  }
   return InterpValue(tag_, bits_ops::UMul(lhs, rhs).Slice(0, lhs.bit_count()));
 }
 
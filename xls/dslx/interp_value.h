@@ -297,13 +297,13 @@ class InterpValue {
   InterpValueTag tag() const { return tag_; }
 
   absl::StatusOr<const std::vector<InterpValue>*> GetValues() const {
-    if (!std::holds_alternative<std::vector<InterpValue>>(payload_)) {
+    if (!std::holds_alternative<SharedValues>(payload_)) {
       return absl::InvalidArgumentError("Value does not hold element values");
     }
-    return &std::get<std::vector<InterpValue>>(payload_);
+    return std::get<SharedValues>(payload_).get();
   }
   const std::vector<InterpValue>& GetValuesOrDie() const {
-    return std::get<std::vector<InterpValue>>(payload_);
+    return *std::get<SharedValues>(payload_);
   }
   absl::StatusOr<const FnData*> GetFunction() const {
     if (!std::holds_alternative<FnData>(payload_)) {
@@ -345,7 +345,7 @@ class InterpValue {
   }
 
   bool HasValues() const {
-    return std::holds_alternative<std::vector<InterpValue>>(payload_);
+    return std::holds_alternative<SharedValues>(payload_);
   }
 
   bool IsToken() const { return tag_ == InterpValueTag::kToken; }
@@ -403,12 +403,27 @@ class InterpValue {
   //
   // TODO(leary): 2020-02-10 When all Python bindings are eliminated we can more
   // easily make an interpreter scoped lifetime that InterpValues can live in.
-  using Payload =
-      std::variant<Bits, EnumData, std::vector<InterpValue>, FnData,
-                   std::shared_ptr<TokenData>, std::shared_ptr<Channel>>;
+  //
+  // Bits (and the bits held by enum values) are stored inline: InlineBitmap
+  // keeps up to 64 bits without a heap allocation, so common scalar values
+  // never allocate.
+  //
+  // Tuple/array elements are immutable once constructed and are shared between
+  // copies of the value, so copying an aggregate (e.g. pushing it onto the
+  // interpreter stack or loading it from a frame slot) is a reference count
+  // bump instead of a deep copy. Operations that "modify" an aggregate (e.g.
+  // Update) build a new element vector.
+  using SharedValues = std::shared_ptr<const std::vector<InterpValue>>;
+  using Payload = std::variant<Bits, EnumData, SharedValues, FnData,
+                               std::shared_ptr<TokenData>,
+                               std::shared_ptr<Channel>>;
 
   InterpValue(InterpValueTag tag, Payload payload)
       : tag_(tag), payload_(std::move(payload)) {}
+  InterpValue(InterpValueTag tag, std::vector<InterpValue> values)
+      : tag_(tag),
+        payload_(std::make_shared<const std::vector<InterpValue>>(
+            std::move(values))) {}
 
   using CompareF = bool (*)(const Bits& lhs, const Bits& rhs);
 
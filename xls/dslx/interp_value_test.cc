@@ -14,13 +14,16 @@
 
 #include "xls/dslx/interp_value.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
 
@@ -263,5 +266,87 @@ TEST(InterpValueTest, MakeMaxValue) {
             "s16:32767");
 }
 
+TEST(InterpValueTest, SmallValueArithmeticWraps) {
+  InterpValue u8_max = InterpValue::MakeUBits(8, 0xff);
+  InterpValue u8_two = InterpValue::MakeUBits(8, 2);
+  EXPECT_THAT(u8_max.Add(u8_two), IsOkAndHolds(InterpValue::MakeUBits(8, 1)));
+  EXPECT_THAT(u8_two.Sub(u8_max), IsOkAndHolds(InterpValue::MakeUBits(8, 3)));
+  EXPECT_THAT(u8_max.Mul(u8_two),
+              IsOkAndHolds(InterpValue::MakeUBits(8, 0xfe)));
+
+  InterpValue s4_neg_two = InterpValue::MakeSBits(4, -2);
+  InterpValue s4_three = InterpValue::MakeSBits(4, 3);
+  EXPECT_THAT(s4_neg_two.Mul(s4_three),
+              IsOkAndHolds(InterpValue::MakeSBits(4, -6)));
+  EXPECT_THAT(s4_neg_two.Sub(s4_three),
+              IsOkAndHolds(InterpValue::MakeSBits(4, -5)));
+
+  InterpValue u64_max = InterpValue::MakeMaxValue(/*is_signed=*/false, 64);
+  EXPECT_THAT(u64_max.Add(InterpValue::MakeUBits(64, 1)),
+              IsOkAndHolds(InterpValue::MakeUBits(64, 0)));
+  EXPECT_THAT(u64_max.Mul(u64_max),
+              IsOkAndHolds(InterpValue::MakeUBits(64, 1)));
+
+  // Wider values take the general path.
+  InterpValue u65_max = InterpValue::MakeMaxValue(/*is_signed=*/false, 65);
+  EXPECT_THAT(u65_max.Add(InterpValue::MakeUBits(65, 1)),
+              IsOkAndHolds(InterpValue::MakeUBits(65, 0)));
+}
+
+TEST(InterpValueTest, AggregateCopiesShareElements) {
+  InterpValue array =
+      InterpValue::MakeArray({InterpValue::MakeU32(1), InterpValue::MakeU32(2)})
+          .value();
+  InterpValue copy = array;
+  EXPECT_EQ(&array.GetValuesOrDie(), &copy.GetValuesOrDie());
+
+  // Updating produces a new value and leaves the shared original untouched.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue updated,
+      copy.Update(InterpValue::MakeU32(0), InterpValue::MakeU32(42)));
+  EXPECT_NE(&updated.GetValuesOrDie(), &array.GetValuesOrDie());
+  EXPECT_EQ(array.ToString(), "[u32:1, u32:2]");
+  EXPECT_EQ(copy.ToString(), "[u32:1, u32:2]");
+  EXPECT_EQ(updated.ToString(), "[u32:42, u32:2]");
+}
+
+// Adds and multiplies values of `state.range(0)` bits; widths up to 64 take the
+// single-word fast path, wider ones the general Bits path.
+void BM_AddMul(benchmark::State& state) {
+  const int64_t bit_count = state.range(0);
+  InterpValue x = InterpValue::MakeUBits(bit_count, 0x12);
+  const InterpValue y = InterpValue::MakeUBits(bit_count, 0x7);
+  for (auto _ : state) {
+    absl::StatusOr<InterpValue> sum = x.Add(y);
+    CHECK_OK(sum.status());
+    absl::StatusOr<InterpValue> product = sum->Mul(y);
+    CHECK_OK(product.status());
+    x = *std::move(product);
+    benchmark::DoNotOptimize(x);
+  }
+}
+BENCHMARK(BM_AddMul)->Arg(8)->Arg(32)->Arg(64)->Arg(65)->Arg(128);
+
+// Copies an array of `state.range(0)` two-element tuples, as the bytecode
+// interpreter does whenever it loads an aggregate from a slot or pushes it
+// on the stack, and reads one element of the copy.
+void BM_CopyAggregate(benchmark::State& state) {
+  std::vector<InterpValue> elements;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    elements.push_back(InterpValue::MakeTuple(
+        {InterpValue::MakeU32(i), InterpValue::MakeUBits(8, i % 256)}));
+  }
+  absl::StatusOr<InterpValue> array = InterpValue::MakeArray(elements);
+  CHECK_OK(array.status());
+  const InterpValue index = InterpValue::MakeU32(state.range(0) / 2);
+  for (auto _ : state) {
+    InterpValue copy = *array;
+    absl::StatusOr<InterpValue> element = copy.Index(index);
+    CHECK_OK(element.status());
+    benchmark::DoNotOptimize(element);
+  }
+}
+BENCHMARK(BM_CopyAggregate)->Arg(4)->Arg(64)->Arg(1024);
+
 }  // namespace
 }  // namespace xls::dslx
@@ -37,6 +37,9 @@
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/stopwatch.h"
+#include "xls/common/thread.h"
+#include "xls/dslx/bytecode/bytecode_store.h"
 #include "xls/dslx/command_line_utils.h"
 #include "xls/dslx/run_routines/run_comparator.h"
 #include "xls/dslx/run_routines/run_routines.h"
@@ -57,9 +60,11 @@ ABSL_FLAG(bool, execute, true, "Execute tests within the entry module.");
 ABSL_FLAG(std::string, compare, "jit",
           "Compare DSL-interpreted results with an IR execution for each"
           " function for consistency checking; options: none|jit|interpreter.");
-ABSL_FLAG(
-    int64_t, seed, 0,
-    "Seed for quickcheck random stimulus; 0 for an nondetermistic value.");
+ABSL_FLAG(int64_t, seed, 0,
+          "Seed for quickcheck random stimulus; 0 for an nondetermistic "
+          "value. A given seed yields the same samples for any "
+          "--test_threads; they differ from the samples interpreters that "
+          "predate per-batch random streams drew for the same seed.");
 ABSL_FLAG(std::string, test_filter, "",
           "Regexp that must be a full match of test name(s) to run.");
 
@@ -79,6 +84,18 @@ ABSL_FLAG(bool, trace_channels, false,
 ABSL_FLAG(int64_t, max_ticks, 100000,
           "If non-zero, the maximum number of ticks to execute on any proc. If "
           "exceeded an error is returned.");
+ABSL_FLAG(int64_t, test_threads, 1,
+          "Number of threads to use for running unit tests concurrently, for "
+          "evaluating quickcheck samples, and for parsing imports ahead of "
+          "typechecking; 0 means use all available CPUs. Test results are "
+          "reported in module order regardless of this setting.");
+ABSL_FLAG(std::string, bytecode_cache_dir, "",
+          "If given, directory in which emitted bytecode is stored, keyed on "
+          "the source text it was emitted from, so later runs over unchanged "
+          "modules can skip emitting it again.");
+ABSL_FLAG(bool, bytecode_cache_read_only, false,
+          "Only read from --bytecode_cache_dir; never add entries to it. "
+          "Useful when many interpreters share a prepopulated cache.");
 // LINT.ThenChange(//xls/build_rules/xls_dslx_rules.bzl)
 
 namespace xls::dslx {
@@ -100,7 +117,7 @@ absl::StatusOr<TestResult> RealMain(
     const std::optional<std::string>& test_filter,
     FormatPreference format_preference, CompareFlag compare_flag, bool execute,
     bool warnings_as_errors, std::optional<int64_t> seed, bool trace_channels,
-    std::optional<int64_t> max_ticks,
+    std::optional<int64_t> max_ticks, int64_t test_threads,
     std::optional<std::string_view> xml_output_file) {
   XLS_ASSIGN_OR_RETURN(
       WarningKindSet warnings,
@@ -141,6 +158,16 @@ absl::StatusOr<TestResult> RealMain(
     }
     test_filter_re_ptr = &test_filter_re.value();
   }
+
+  std::unique_ptr<SharedBytecodeStore> bytecode_store;
+  if (std::string dir = absl::GetFlag(FLAGS_bytecode_cache_dir); !dir.empty()) {
+    bool read_only = absl::GetFlag(FLAGS_bytecode_cache_read_only);
+    if (!read_only) {
+      XLS_RETURN_IF_ERROR(RecursivelyCreateDir(dir));
+    }
+    bytecode_store = std::make_unique<SharedBytecodeStore>(dir, read_only);
+  }
+
   ParseAndTestOptions options = {.dslx_paths = dslx_paths,
                                  .test_filter = test_filter_re_ptr,
                                  .format_preference = format_preference,
@@ -150,11 +177,23 @@ absl::StatusOr<TestResult> RealMain(
                                  .warnings_as_errors = warnings_as_errors,
                                  .warnings = warnings,
                                  .trace_channels = trace_channels,
-                                 .max_ticks = max_ticks};
+                                 .max_ticks = max_ticks,
+                                 .test_threads = test_threads,
+                                 .bytecode_store = bytecode_store.get()};
 
+  Stopwatch stopwatch;
   XLS_ASSIGN_OR_RETURN(
       TestResultData test_result,
       ParseAndTest(program, module_name, entry_module_path, options));
+  XLS_VLOG(1) << "Parsed, typechecked and tested " << entry_module_path
+              << " in " << stopwatch.GetElapsedTime();
+
+  if (bytecode_store != nullptr) {
+    SharedBytecodeStore::Stats stats = bytecode_store->stats();
+    XLS_VLOG(1) << "Bytecode cache: " << stats.memory_hits << " memory hits, "
+                << stats.disk_hits << " disk hits, " << stats.misses
+                << " misses, " << stats.writes << " writes";
+  }
 
   if (xml_output_file.has_value()) {
     test_xml::TestSuites suites = test_result.ToXmlSuites(module_name);
@@ -194,6 +233,14 @@ int main(int argc, char* argv[]) {
       absl::GetFlag(FLAGS_max_ticks) == 0
           ? std::nullopt
           : std::optional<int64_t>(absl::GetFlag(FLAGS_max_ticks));
+  int64_t test_threads = absl::GetFlag(FLAGS_test_threads);
+  if (test_threads < 0) {
+    XLS_LOG(QFATAL) << "Invalid -test_threads flag: " << test_threads
+                    << "; must be non-negative";
+  }
+  if (test_threads == 0) {
+    test_threads = xls::AvailableCPUs();
+  }
 
   xls::dslx::CompareFlag compare_flag;
   if (compare_flag_str == "none") {
@@ -257,7 +304,8 @@ int main(int argc, char* argv[]) {
 
   absl::StatusOr<xls::dslx::TestResult> test_result = xls::dslx::RealMain(
       args[0], dslx_paths, test_filter, preference, compare_flag, execute,
-      warnings_as_errors, seed, trace_channels, max_ticks, xml_output_file);
+      warnings_as_errors, seed, trace_channels, max_ticks, test_threads,
+      xml_output_file);
   if (!test_result.ok()) {
     return xls::ExitStatus(test_result.status());
   }
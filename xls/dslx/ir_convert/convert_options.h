@@ -15,6 +15,8 @@
 #ifndef XLS_DSLX_IR_CONVERT_CONVERT_OPTIONS_H_
 #define XLS_DSLX_IR_CONVERT_CONVERT_OPTIONS_H_
 
+#include <cstdint>
+
 #include "xls/dslx/warning_kind.h"
 
 namespace xls::dslx {
@@ -41,6 +43,19 @@ struct ConvertOptions {
   //
   // Note that this is only used in IR conversion routines that do typechecking.
   WarningKindSet enabled_warnings = kDefaultWarningsSet;
+
+  // Number of threads used to convert functions to IR. When greater than one,
+  // (non-proc) functions whose callees have all been converted are converted
+  // concurrently, each into its own staging package, and then merged into the
+  // output package in conversion order.
+  //
+  // The merged package is semantically equivalent to serial conversion, and
+  // its text is the same for any thread count greater than one, but it is not
+  // textually identical to the output of serial conversion: node ids, names
+  // derived from them and the order of some functions differ.
+  // Golden IR files and anything keyed on the IR text (e.g. the codegen cache)
+  // should therefore be produced with a single thread.
+  int64_t convert_threads = 1;
 };
 
 }  // namespace xls::dslx
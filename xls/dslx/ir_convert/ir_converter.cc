@@ -24,6 +24,8 @@
 
 #include "xls/dslx/ir_convert/ir_converter.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
@@ -39,9 +41,12 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/channel_direction.h"
@@ -70,7 +75,10 @@
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_scanner.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
 #include "xls/ir/verifier.h"
 
 namespace xls::dslx {
@@ -231,6 +239,207 @@ absl::Status CreateBoundaryChannels(absl::Span<Param* const> params,
   return absl::OkStatus();
 }
 
+// Returns whether the given record may be converted concurrently with others
+// (see ConvertFunctionsConcurrently()). Procs are always converted serially as
+// their conversion shares channel and member state through
+// ProcConversionData.
+bool IsConcurrentlyConvertible(const ConversionRecord& record) {
+  return record.f()->tag() == FunctionTag::kNormal &&
+         !record.f()->proc().has_value();
+}
+
+// Assigns every concurrently-convertible record in `order` to a "wave": a
+// record's wave is one more than the latest wave of any of its callees, so all
+// records in a wave can be converted at the same time once the previous waves
+// are done. Procs get wave -1.
+//
+// Returns nullopt if some function calls something that isn't converted
+// earlier in `order` (in which case the functions must be converted serially).
+std::optional<std::vector<int64_t>> GetConversionWaves(
+    absl::Span<const ConversionRecord> order) {
+  absl::flat_hash_map<std::pair<const Function*, ParametricEnv>, int64_t>
+      record_index;
+  std::vector<int64_t> waves(order.size(), -1);
+  for (int64_t i = 0; i < order.size(); ++i) {
+    const ConversionRecord& record = order[i];
+    if (!IsConcurrentlyConvertible(record)) {
+      continue;
+    }
+    int64_t wave = 0;
+    for (const Callee& callee : record.callees()) {
+      auto it = record_index.find(
+          std::make_pair(callee.f(), callee.parametric_env()));
+      if (it == record_index.end()) {
+        return std::nullopt;
+      }
+      wave = std::max(wave, waves[it->second] + 1);
+    }
+    waves[i] = wave;
+    record_index.emplace(std::make_pair(record.f(), record.parametric_env()),
+                         i);
+  }
+  return waves;
+}
+
+// The result of converting a single function record into its own staging
+// package.
+struct StagedConversion {
+  std::unique_ptr<Package> package;
+  PackageData package_data;
+  // Placeholder functions standing in for already-converted callees.
+  absl::flat_hash_set<xls::Function*> stubs;
+  absl::Status status;
+};
+
+// Adds a function to `package` with the name and signature of `f` (which may
+// live in another package) whose body just returns zero. Calls to the stub are
+// redirected to the real function when the staging package is merged.
+absl::StatusOr<xls::Function*> AddStubFunction(xls::Function* f,
+                                               Package* package) {
+  FunctionBuilder fb(f->name(), package);
+  for (xls::Param* param : f->params()) {
+    XLS_ASSIGN_OR_RETURN(xls::Type * type,
+                         package->MapTypeFromOtherPackage(param->GetType()));
+    fb.Param(param->name(), type);
+  }
+  XLS_ASSIGN_OR_RETURN(
+      xls::Type * return_type,
+      package->MapTypeFromOtherPackage(f->GetType()->return_type()));
+  fb.Literal(ZeroOfType(return_type));
+  return fb.Build();
+}
+
+// Converts `order[index]` into a fresh package, with stubs for the functions
+// produced by its callees' (already staged) conversions.
+absl::Status StageConversion(absl::Span<const ConversionRecord> order,
+                             int64_t index,
+                             const absl::flat_hash_map<
+                                 std::pair<const Function*, ParametricEnv>,
+                                 int64_t>& record_index,
+                             const Package& output_package,
+                             ImportData* import_data,
+                             const ConvertOptions& options,
+                             std::vector<StagedConversion>& staged) {
+  const ConversionRecord& record = order[index];
+  StagedConversion& result = staged[index];
+  result.package = std::make_unique<Package>(output_package.name());
+  result.package_data.package = result.package.get();
+  // Source locations are copied verbatim when merging, so file numbers have to
+  // agree with the output package.
+  for (const auto& [fileno, filename] : output_package.fileno_to_name()) {
+    result.package->SetFileno(fileno, filename);
+  }
+
+  for (const Callee& callee : record.callees()) {
+    const StagedConversion& callee_staged = staged.at(
+        record_index.at(std::make_pair(callee.f(), callee.parametric_env())));
+    for (const std::unique_ptr<xls::Function>& f :
+         callee_staged.package->functions()) {
+      if (callee_staged.stubs.contains(f.get()) ||
+          result.package->TryGetFunction(f->name()).has_value()) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(xls::Function * stub,
+                           AddStubFunction(f.get(), result.package.get()));
+      result.stubs.insert(stub);
+      if (auto it = callee_staged.package_data.ir_to_dslx.find(f.get());
+          it != callee_staged.package_data.ir_to_dslx.end()) {
+        result.package_data.ir_to_dslx[stub] = it->second;
+      }
+    }
+  }
+
+  ProcConversionData proc_data;
+  return ConvertOneFunctionInternal(result.package_data, record, import_data,
+                                    &proc_data, options);
+}
+
+// Moves the functions of a staged conversion into the output package, pointing
+// calls to stubs at the real callees.
+absl::Status MergeStagedConversion(const StagedConversion& staged,
+                                   PackageData& package_data) {
+  absl::flat_hash_map<const xls::Function*, xls::Function*> remapping;
+  for (const std::unique_ptr<xls::Function>& f : staged.package->functions()) {
+    std::optional<xls::Function*> existing =
+        package_data.package->TryGetFunction(f->name());
+    if (staged.stubs.contains(f.get())) {
+      XLS_RET_CHECK(existing.has_value())
+          << "Callee " << f->name() << " was not converted";
+      remapping[f.get()] = existing.value();
+      continue;
+    }
+    if (existing.has_value()) {
+      // Functions that are materialized on demand (e.g. builtins applied via
+      // `map`) can be produced by several conversions.
+      remapping[f.get()] = existing.value();
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(
+        xls::Function * merged,
+        f->Clone(f->name(), package_data.package, remapping));
+    remapping[f.get()] = merged;
+    if (auto it = staged.package_data.ir_to_dslx.find(f.get());
+        it != staged.package_data.ir_to_dslx.end()) {
+      package_data.ir_to_dslx[merged] = it->second;
+    }
+    if (staged.package_data.wrappers.contains(f.get())) {
+      package_data.wrappers.insert(merged);
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Converts the (non-proc) functions in `order` using `options.convert_threads`
+// threads, wave by wave (see GetConversionWaves()), then merges them into the
+// output package in conversion order.
+absl::Status ConvertFunctionsConcurrently(
+    absl::Span<const ConversionRecord> order, absl::Span<const int64_t> waves,
+    ImportData* import_data, const ConvertOptions& options,
+    PackageData& package_data) {
+  absl::flat_hash_map<std::pair<const Function*, ParametricEnv>, int64_t>
+      record_index;
+  std::vector<std::vector<int64_t>> records_by_wave;
+  for (int64_t i = 0; i < order.size(); ++i) {
+    if (waves[i] < 0) {
+      continue;
+    }
+    record_index.emplace(
+        std::make_pair(order[i].f(), order[i].parametric_env()), i);
+    if (records_by_wave.size() <= waves[i]) {
+      records_by_wave.resize(waves[i] + 1);
+    }
+    records_by_wave[waves[i]].push_back(i);
+    // Number files in conversion order, like serial conversion does.
+    if (std::optional<std::filesystem::path> path =
+            order[i].module()->fs_path();
+        path.has_value()) {
+      package_data.package->GetOrCreateFileno(std::string{path.value()});
+    }
+  }
+
+  std::vector<StagedConversion> staged(order.size());
+  for (const std::vector<int64_t>& wave : records_by_wave) {
+    XLS_VLOG(3) << "Converting " << wave.size() << " function(s) concurrently";
+    ParallelFor(wave.size(), options.convert_threads, [&](int64_t i) {
+      const int64_t index = wave[i];
+      XLS_VLOG(3) << "Converting to IR: " << order[index].ToString();
+      staged[index].status =
+          StageConversion(order, index, record_index, *package_data.package,
+                          import_data, options, staged);
+    });
+    for (int64_t index : wave) {
+      XLS_RETURN_IF_ERROR(staged[index].status);
+    }
+  }
+
+  for (int64_t i = 0; i < order.size(); ++i) {
+    if (waves[i] >= 0) {
+      XLS_RETURN_IF_ERROR(MergeStagedConversion(staged[i], package_data));
+    }
+  }
+  return absl::OkStatus();
+}
+
 // Converts the functions in the call graph in a specified order.
 //
 // Args:
@@ -306,11 +515,28 @@ absl::Status ConvertCallGraph(absl::Span<const ConversionRecord> order,
         first_proc_config->type_info(), package_data, &proc_data));
   }
 
-  for (const ConversionRecord& record : order) {
+  const absl::Time start = absl::Now();
+  std::optional<std::vector<int64_t>> waves;
+  if (options.convert_threads > 1) {
+    waves = GetConversionWaves(order);
+  }
+  if (waves.has_value()) {
+    XLS_RETURN_IF_ERROR(ConvertFunctionsConcurrently(
+        order, waves.value(), import_data, options, package_data));
+  }
+  for (int64_t i = 0; i < order.size(); ++i) {
+    if (waves.has_value() && waves.value()[i] >= 0) {
+      continue;  // Already converted above.
+    }
+    const ConversionRecord& record = order[i];
     XLS_VLOG(3) << "Converting to IR: " << record.ToString();
     XLS_RETURN_IF_ERROR(ConvertOneFunctionInternal(
         package_data, record, import_data, &proc_data, options));
   }
+  XLS_VLOG(1) << "Converted " << order.size() << " function(s) to IR in "
+              << absl::Now() - start << " ("
+              << (waves.has_value() ? options.convert_threads : 1)
+              << " thread(s))";
 
   XLS_VLOG(3) << "Verifying converted package";
   if (options.verify_ir) {
@@ -437,21 +663,17 @@ absl::Status CheckPackageName(std::string_view name) {
   return absl::OkStatus();
 }
 
-// Adds IR-converted symbols from the module specified by "path" to the given
-// "package".
+// Parses, typechecks and converts the given module text into `package`.
 //
-// TODO(leary): 2021-07-21 We should be able to reuse the type checking if
-// there are overlapping nodes in the module DAG between files to process. For
-// now we throw it away for each file and re-derive it (we need to refactor to
-// make the modules outlive any given AddPathToPackage() if we want to
-// appropriately reuse things in ImportData).
-absl::Status AddContentsToPackage(std::string_view file_contents,
-                                  std::string_view module_name,
-                                  std::optional<std::string_view> path,
-                                  std::optional<std::string_view> entry,
-                                  const ConvertOptions& convert_options,
-                                  ImportData* import_data, Package* package,
-                                  bool* printed_error) {
+// The parsed module is returned to the caller, as `import_data` holds type
+// information that refers to it; it must be kept alive for as long as
+// `import_data` is in use.
+absl::StatusOr<std::unique_ptr<Module>> AddContentsToPackage(
+    std::string_view file_contents, std::string_view module_name,
+    std::optional<std::string_view> path,
+    std::optional<std::string_view> entry,
+    const ConvertOptions& convert_options, ImportData* import_data,
+    Package* package, bool* printed_error) {
   // Parse the module text.
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<Module> module,
@@ -482,7 +704,7 @@ absl::Status AddContentsToPackage(std::string_view file_contents,
     XLS_RETURN_IF_ERROR(ConvertModuleIntoPackage(module.get(), import_data,
                                                  convert_options, package));
   }
-  return absl::OkStatus();
+  return module;
 }
 
 }  // namespace
@@ -513,15 +735,28 @@ absl::StatusOr<std::unique_ptr<Package>> ConvertFilesToPackage(
         "Top cannot be supplied with multiple input paths (need a single input "
         "path to know where to resolve the entry function");
   }
+  // Input files commonly share imports (e.g. the standard library), so all of
+  // them are converted against a single ImportData: each imported module is
+  // parsed and typechecked once rather than once per input file.
+  ImportData import_data(CreateImportData(stdlib_path, dslx_paths,
+                                          convert_options.enabled_warnings));
+  std::vector<std::unique_ptr<Module>> entry_modules;
   for (std::string_view path : paths) {
-    ImportData import_data(CreateImportData(stdlib_path, dslx_paths,
-                                            convert_options.enabled_warnings));
     XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
     XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(path));
-    XLS_RETURN_IF_ERROR(AddContentsToPackage(
-        text, module_name, /*path=*/path, /*entry=*/top, convert_options,
-        &import_data, package.get(), printed_error));
+    XLS_ASSIGN_OR_RETURN(
+        std::unique_ptr<Module> module,
+        AddContentsToPackage(text, module_name, /*path=*/path, /*entry=*/top,
+                             convert_options, &import_data, package.get(),
+                             printed_error));
+    entry_modules.push_back(std::move(module));
   }
+  XLS_VLOG(1) << "Import cache: "
+              << import_data.import_cache_stats().ToString();
+  XLS_VLOG(1) << "Instantiation cache: "
+              << import_data.type_info_owner()
+                     .instantiation_cache_stats()
+                     .ToString();
 
   return package;
 }
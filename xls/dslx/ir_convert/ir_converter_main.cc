@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>  // NOLINT
 #include <iostream>
@@ -61,6 +62,13 @@ ABSL_FLAG(std::string, disable_warnings, "",
           "recommended, but can be used in exceptional circumstances");
 ABSL_FLAG(bool, warnings_as_errors, true,
           "Whether to fail early, as an error, if warnings are detected");
+ABSL_FLAG(int64_t, convert_threads, 1,
+          "Number of threads used to convert functions to IR. Functions whose "
+          "callees have been converted are converted concurrently and then "
+          "merged into the output package in a deterministic order. With more "
+          "than one thread the IR is equivalent to, but not textually "
+          "identical with, single-threaded output (node ids and names "
+          "differ), so do not use it to produce golden files.");
 // LINT.ThenChange(//xls/build_rules/xls_ir_rules.bzl)
 
 namespace xls::dslx {
@@ -87,7 +95,8 @@ absl::Status RealMain(absl::Span<const std::string_view> paths,
                       const std::string& stdlib_path,
                       absl::Span<const std::filesystem::path> dslx_paths,
                       bool emit_fail_as_assert, bool verify_ir,
-                      bool warnings_as_errors, bool* printed_error) {
+                      bool warnings_as_errors, int64_t convert_threads,
+                      bool* printed_error) {
   XLS_ASSIGN_OR_RETURN(
       WarningKindSet enabled_warnings,
       WarningKindSetFromDisabledString(absl::GetFlag(FLAGS_disable_warnings)));
@@ -97,6 +106,7 @@ absl::Status RealMain(absl::Span<const std::string_view> paths,
       .verify_ir = verify_ir,
       .warnings_as_errors = warnings_as_errors,
       .enabled_warnings = enabled_warnings,
+      .convert_threads = convert_threads,
   };
 
   // The following checks are performed inside ConvertFilesToPackage(), but we
@@ -164,10 +174,15 @@ int main(int argc, char* argv[]) {
   bool emit_fail_as_assert = absl::GetFlag(FLAGS_emit_fail_as_assert);
   bool verify_ir = absl::GetFlag(FLAGS_verify);
   bool warnings_as_errors = absl::GetFlag(FLAGS_warnings_as_errors);
+  int64_t convert_threads = absl::GetFlag(FLAGS_convert_threads);
+  if (convert_threads < 1) {
+    XLS_LOG(QFATAL) << "--convert_threads must be positive; got "
+                    << convert_threads;
+  }
   bool printed_error = false;
   absl::Status status = xls::dslx::RealMain(
       args, top, package_name, stdlib_path, dslx_paths, emit_fail_as_assert,
-      verify_ir, warnings_as_errors, &printed_error);
+      verify_ir, warnings_as_errors, convert_threads, &printed_error);
   if (printed_error) {
     return EXIT_FAILURE;
   }
@@ -144,6 +144,20 @@ class IrConverterMainTest(test_base.TestCase):
     """),
     )
 
+  def test_multi_file_shared_import(self) -> None:
+    # Both inputs import the same module; it is parsed and typechecked once and
+    # shared between the conversions.
+    ir = self._ir_convert(
+        {
+            'c.x': 'pub const K = u32:7;',
+            'a.x': 'import c;\nfn f() -> u32 { c::K + u32:1 }',
+            'b.x': 'import c;\nfn f() -> u32 { c::K + u32:2 }',
+        },
+        package_name='my_entry',
+    ).ir
+    self.assertIn('fn __a__f() -> bits[32]', ir)
+    self.assertIn('fn __b__f() -> bits[32]', ir)
+
 
 if __name__ == '__main__':
   test_base.main()
@@ -20,9 +20,12 @@
 
 #include "xls/dslx/ir_convert/ir_converter.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -37,12 +40,20 @@
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/ir_convert/convert_options.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
 
 namespace xls::dslx {
 namespace {
 
+using status_testing::IsOkAndHolds;
 using status_testing::StatusIs;
 using ::testing::HasSubstr;
+using ::testing::UnorderedElementsAreArray;
 
 constexpr ConvertOptions kFailNoPos = {
     .emit_positions = false,
@@ -2074,5 +2085,70 @@ proc Counter {
   ExpectIr(converted, TestName());
 }
 
+TEST(IrConverterTest, ConcurrentConversionEvaluatesLikeSerialConversion) {
+  constexpr std::string_view kProgram = R"(
+fn add_n<N: u32>(x: u32) -> u32 { x + N }
+
+fn double<N: u32>(x: bits[N]) -> bits[N] { x + x }
+
+fn sum(a: u32[4]) -> u32 {
+  for (i, acc): (u32, u32) in u32:0..u32:4 {
+    acc + a[i]
+  }(u32:0)
+}
+
+fn leaf1(x: u32) -> u32 { add_n<u32:1>(x) }
+
+fn leaf2(x: u32) -> u32 { add_n<u32:2>(double(x)) }
+
+fn main(x: u32) -> u32 {
+  let a = map(u32[4]:[1, 2, 3, 4], clz);
+  let b = map(a, leaf1);
+  sum(b) + leaf2(x) + add_n<u32:1>(x)
+}
+)";
+  auto convert = [&](int64_t threads)
+      -> absl::StatusOr<std::unique_ptr<Package>> {
+    ImportData import_data = CreateImportDataForTest();
+    XLS_ASSIGN_OR_RETURN(TypecheckedModule tm,
+                         ParseAndTypecheck(kProgram, "test_module.x",
+                                           "test_module", &import_data));
+    return ConvertModuleToPackage(tm.module, &import_data,
+                                  ConvertOptions{.convert_threads = threads});
+  };
+  auto function_names = [](Package* package) {
+    std::vector<std::string> names;
+    for (const std::unique_ptr<xls::Function>& f : package->functions()) {
+      names.push_back(f->name());
+    }
+    return names;
+  };
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> serial, convert(1));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> concurrent, convert(4));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> concurrent_again,
+                           convert(8));
+
+  // The output does not depend on the number of threads (once there is more
+  // than one). It is not textually identical to serial output, since node ids
+  // differ, so only the set of functions and their behavior are compared.
+  EXPECT_EQ(concurrent->DumpIr(), concurrent_again->DumpIr());
+  EXPECT_THAT(function_names(concurrent.get()),
+              UnorderedElementsAreArray(function_names(serial.get())));
+
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * serial_main,
+                           serial->GetFunction("__test_module__main"));
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * concurrent_main,
+                           concurrent->GetFunction("__test_module__main"));
+  for (int64_t x : {0, 7, 100}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        Value want, DropInterpreterEvents(InterpretFunction(
+                        serial_main, {Value(UBits(x, 32))})));
+    EXPECT_THAT(DropInterpreterEvents(
+                    InterpretFunction(concurrent_main, {Value(UBits(x, 32))})),
+                IsOkAndHolds(want));
+  }
+}
+
 }  // namespace
 }  // namespace xls::dslx
@@ -15,13 +15,14 @@
 // Very simple language server for dslx that
 //  - keeps track of open files and updates them whenever they are
 //    changed in the editor (hidden under the hood).
-//  - On every change, attempts to parse and send back diagnostics
+//  - After changes, attempts to parse and send back diagnostics
 //    on errors/warnings.
 //
 // Heavily commented below as this serves as a sample.
 
 #include <unistd.h>
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <iostream>
 #include <ostream>
@@ -30,6 +31,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "nlohmann/json.hpp"
@@ -49,6 +51,9 @@ static constexpr char kDslxPath[] = "DSLX_PATH";
 ABSL_FLAG(std::string, dslx_path,
           getenv(kDslxPath) != nullptr ? getenv(kDslxPath) : "",
           "Additional paths to search for modules (colon delimited).");
+ABSL_FLAG(int64_t, import_threads, 1,
+          "Number of threads to use for parsing the imports of a file ahead "
+          "of typechecking it.");
 
 namespace xls::dslx {
 namespace {
@@ -116,7 +121,8 @@ absl::Status RealMain() {
            << "\tcwd=" << fs::current_path().string() << "\n";
 
   // Adapter that interfaces between dslx parsing and LSP
-  LanguageServerAdapter language_server_adapter(stdlib_path, dslx_paths);
+  LanguageServerAdapter language_server_adapter(
+      stdlib_path, dslx_paths, absl::GetFlag(FLAGS_import_threads));
 
   // The dispatcher receives json rpc requests
   // (https://www.jsonrpc.org/specification) which are passed in
@@ -161,17 +167,33 @@ absl::Status RealMain() {
   // The text buffer collection can call a callback whenever there is a change.
   // We're using this to hook up our parser that then can send diagnostic
   // messages back.
+  //
+  // Analysis is deferred until every message that is already available on
+  // stdin has been dispatched (or a request needs the buffer's analysis), so a
+  // burst of changes -- e.g. from fast typing -- is analyzed once rather than
+  // once per change.
+  absl::flat_hash_set<std::string> changed_uris;
   buffers.SetChangeListener(
       [&](const std::string& uri, const EditTextBuffer* buffer) {
         if (buffer == nullptr) {
+          changed_uris.erase(uri);
           return;  // buffer got deleted. No interest.
         }
-        TextChangeHandler(uri, *buffer, dispatcher, language_server_adapter);
+        changed_uris.insert(uri);
       });
+  auto analyze_if_changed = [&](const std::string& uri) {
+    if (!changed_uris.erase(uri)) {
+      return;
+    }
+    if (const EditTextBuffer* buffer = buffers.findBufferByUri(uri)) {
+      TextChangeHandler(uri, *buffer, dispatcher, language_server_adapter);
+    }
+  };
 
   dispatcher.AddRequestHandler(
       "textDocument/documentSymbol",
       [&](const verible::lsp::DocumentSymbolParams& params) {
+        analyze_if_changed(params.textDocument.uri);
         return language_server_adapter.GenerateDocumentSymbols(
             params.textDocument.uri);
       });
@@ -179,6 +201,7 @@ absl::Status RealMain() {
   dispatcher.AddRequestHandler(
       "textDocument/definition",
       [&](const verible::lsp::DefinitionParams& params) {
+        analyze_if_changed(params.textDocument.uri);
         return language_server_adapter.FindDefinitions(params.textDocument.uri,
                                                        params.position);
       });
@@ -186,6 +209,7 @@ absl::Status RealMain() {
   dispatcher.AddRequestHandler(
       "textDocument/formatting",
       [&](const verible::lsp::DocumentFormattingParams& params) {
+        analyze_if_changed(params.textDocument.uri);
         auto text_edits_or =
             language_server_adapter.FormatDocument(params.textDocument.uri);
         if (text_edits_or.ok()) {
@@ -199,6 +223,7 @@ absl::Status RealMain() {
   dispatcher.AddRequestHandler(
       "textDocument/documentLink",
       [&](const verible::lsp::DocumentLinkParams& params) {
+        analyze_if_changed(params.textDocument.uri);
         return language_server_adapter.ProvideImportLinks(
             params.textDocument.uri);
       });
@@ -209,6 +234,11 @@ absl::Status RealMain() {
     status = stream_splitter.PullFrom([](char* buf, int size) -> int {  //
       return static_cast<int>(read(STDIN_FILENO, buf, size));
     });
+    std::vector<std::string> to_analyze(changed_uris.begin(),
+                                        changed_uris.end());
+    for (const std::string& uri : to_analyze) {
+      analyze_if_changed(uri);
+    }
   }
 
   LspLog() << status << "\n";
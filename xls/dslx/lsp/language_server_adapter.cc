@@ -20,6 +20,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <system_error>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,8 @@
 #include "external/verible/common/lsp/lsp-protocol.h"
 #include "xls/common/indent.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/bytecode/bytecode_cache.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/extract_module_name.h"
 #include "xls/dslx/fmt/ast_fmt.h"
@@ -40,12 +43,14 @@
 #include "xls/dslx/frontend/ast_utils.h"
 #include "xls/dslx/frontend/bindings.h"
 #include "xls/dslx/frontend/comment_data.h"
+#include "xls/dslx/frontend/module.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/import_data.h"
 #include "xls/dslx/lsp/document_symbols.h"
 #include "xls/dslx/lsp/find_definition.h"
 #include "xls/dslx/lsp/lsp_type_utils.h"
 #include "xls/dslx/parse_and_typecheck.h"
+#include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/warning_collector.h"
 #include "xls/dslx/warning_kind.h"
 
@@ -86,12 +91,21 @@ void AppendDiagnosticFromTypecheck(
   }
 }
 
+// Returns whether `status` is a positional error located in `file`.
+bool IsErrorInFile(const absl::Status& status, std::string_view file) {
+  absl::StatusOr<PositionalErrorData> data = GetPositionalErrorData(status);
+  return data.ok() && data->span.filename() == file;
+}
+
 }  // namespace
 
 LanguageServerAdapter::LanguageServerAdapter(
     std::string_view stdlib,
-    const std::vector<std::filesystem::path>& dslx_paths)
-    : stdlib_(stdlib), dslx_paths_(dslx_paths) {}
+    const std::vector<std::filesystem::path>& dslx_paths,
+    int64_t import_threads)
+    : stdlib_(stdlib),
+      dslx_paths_(dslx_paths),
+      import_threads_(import_threads) {}
 
 const LanguageServerAdapter::ParseData* LanguageServerAdapter::FindParsedForUri(
     std::string_view uri) const {
@@ -101,6 +115,31 @@ const LanguageServerAdapter::ParseData* LanguageServerAdapter::FindParsedForUri(
   return nullptr;
 }
 
+std::optional<LanguageServerAdapter::FileStamp>
+LanguageServerAdapter::GetFileStamp(const std::filesystem::path& path) {
+  std::error_code ec;
+  std::filesystem::file_time_type last_write_time =
+      std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  std::uintmax_t size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return FileStamp{.last_write_time = last_write_time, .size = size};
+}
+
+bool LanguageServerAdapter::ImportsUpToDate(const ParseData& parsed) {
+  for (const auto& [path, stamp] : parsed.import_stamps) {
+    std::optional<FileStamp> current = GetFileStamp(path);
+    if (!current.has_value() || !(*current == stamp)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 absl::Status LanguageServerAdapter::Update(std::string_view file_uri,
                                            std::string_view dslx_code) {
   const absl::Time start = absl::Now();
@@ -114,27 +153,85 @@ absl::Status LanguageServerAdapter::Update(std::string_view file_uri,
   auto inserted = uri_parse_data_.emplace(file_uri, nullptr);
   std::unique_ptr<ParseData>& insert_value = inserted.first->second;
 
-  ImportData import_data =
-      CreateImportData(stdlib_, dslx_paths_, kAllWarningsSet);
+  // Reuse the previous analysis' import data -- and with it the typechecked
+  // imported modules -- as long as the imported files are unchanged.
+  std::unique_ptr<ImportData> import_data;
+  if (insert_value != nullptr && insert_value->import_data_reusable &&
+      ImportsUpToDate(*insert_value)) {
+    if (insert_value->contents == dslx_code) {
+      return insert_value->status();
+    }
+    std::unique_ptr<ImportData> previous =
+        std::move(insert_value->import_data);
+    absl::Status evicted =
+        insert_value->module_owner == nullptr
+            ? absl::OkStatus()
+            : previous->EvictModule(insert_value->module_owner.get());
+    if (evicted.ok()) {
+      import_data = std::move(previous);
+    } else {
+      LspLog() << "Could not reuse imports for " << file_uri << ": " << evicted
+               << "\n";
+    }
+  }
+  const bool reused_imports = import_data != nullptr;
+  insert_value.reset();
+  if (!reused_imports) {
+    import_data = std::make_unique<ImportData>(
+        CreateImportData(stdlib_, dslx_paths_, kAllWarningsSet));
+    // The bytecode cache refers back to its import data, so it has to be
+    // (re)created once the import data is at its final address.
+    import_data->SetBytecodeCache(
+        std::make_unique<BytecodeCache>(import_data.get()));
+    import_data->set_import_threads(import_threads_);
+  }
   const std::string& module_name = module_name_or.value();
 
+  // Keeps ownership of the module here so it can be evicted from the import
+  // data on the next update.
   std::vector<CommentData> comments;
-  absl::StatusOr<TypecheckedModule> typechecked_module =
-      ParseAndTypecheck(dslx_code, /*path=*/file_uri,
-                        /*module_name=*/module_name, &import_data, &comments);
+  std::unique_ptr<Module> module;
+  absl::StatusOr<TypecheckedModule> typechecked_module = ParseAndTypecheckOwned(
+      dslx_code, /*path=*/file_uri, /*module_name=*/module_name,
+      import_data.get(), &module, &comments);
 
-  if (typechecked_module.ok()) {
-    insert_value.reset(new ParseData{
-        std::move(import_data), TypecheckedModuleWithComments{
-                                    .tm = std::move(typechecked_module).value(),
-                                    .comments = Comments::Create(comments),
-                                }});
-  } else {
-    insert_value.reset(
-        new ParseData{std::move(import_data), typechecked_module.status()});
+  // A failure while typechecking an imported module can leave type
+  // information behind for a module that no longer exists, so only keep the
+  // import data if the analysis failed (if at all) in the buffer itself.
+  const bool import_data_reusable =
+      typechecked_module.ok() ||
+      IsErrorInFile(typechecked_module.status(), file_uri);
+  auto make_tmc = [&]() -> absl::StatusOr<TypecheckedModuleWithComments> {
+    if (!typechecked_module.ok()) {
+      return typechecked_module.status();
+    }
+    return TypecheckedModuleWithComments{
+        .tm = std::move(typechecked_module).value(),
+        .comments = Comments::Create(comments),
+    };
+  };
+  auto parse_data = std::make_unique<ParseData>(ParseData{
+      .import_data = std::move(import_data),
+      .module_owner = std::move(module),
+      .tmc = make_tmc(),
+      .contents = std::string(dslx_code),
+      .import_stamps = {},
+      .import_data_reusable = import_data_reusable,
+  });
+  for (const std::filesystem::path& path :
+       parse_data->import_data->GetModulePaths()) {
+    std::optional<FileStamp> stamp = GetFileStamp(path);
+    if (!stamp.has_value()) {
+      parse_data->import_data_reusable = false;
+      break;
+    }
+    parse_data->import_stamps.emplace(path.string(), *stamp);
   }
+  insert_value = std::move(parse_data);
 
   const absl::Duration duration = absl::Now() - start;
+  XLS_VLOG(1) << "Analyzing " << file_uri << " took " << duration
+              << (reused_imports ? " (reused imports)" : "");
   if (duration > absl::Milliseconds(200)) {
     LspLog() << "Parsing " << file_uri << " took " << duration << "\n";
   }
@@ -202,7 +299,7 @@ LanguageServerAdapter::ProvideImportLinks(std::string_view uri) const {
     const Module& module = parsed->module();
     for (const auto& [_, import_node] : module.GetImportByName()) {
       const ImportTokens tok(import_node->subject());
-      absl::StatusOr<ModuleInfo*> info = parsed->import_data.Get(tok);
+      absl::StatusOr<ModuleInfo*> info = parsed->import_data->Get(tok);
       if (!info.ok()) {
         continue;
       }
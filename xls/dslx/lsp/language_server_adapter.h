@@ -15,9 +15,11 @@
 #ifndef XLS_DSLX_LSP_LANGUAGE_SERVER_ADAPTER_H_
 #define XLS_DSLX_LSP_LANGUAGE_SERVER_ADAPTER_H_
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -45,12 +47,21 @@ inline std::ostream& LspLog() { return std::cerr; }
 // serializing entity).
 class LanguageServerAdapter {
  public:
+  // `import_threads` is the number of threads used to parse the imports of a
+  // buffer ahead of typechecking it (see ImportData::set_import_threads()).
   LanguageServerAdapter(std::string_view stdlib,
-                        const std::vector<std::filesystem::path>& dslx_paths);
+                        const std::vector<std::filesystem::path>& dslx_paths,
+                        int64_t import_threads = 1);
 
-  // Note: this is parsing is triggered for every keystroke. Fine for now.
+  // Parses and typechecks the given contents of the buffer for `file_uri`.
   // Successful and unsuccessful parses are memoized so that their status
   // and can be queried.
+  //
+  // To keep up with keystroke-rate updates, modules imported by the buffer
+  // are typechecked once and reused across updates for as long as none of
+  // the imported files change on disk; updates that do not change the buffer
+  // contents are no-ops.
+  //
   // Implementation note: since we currently do not react to buffer closed
   // events in the buffer change listener, we keep track of every file ever
   // opened and never delete.
@@ -91,12 +102,31 @@ class LanguageServerAdapter {
     Comments comments;
   };
 
+  // Size and modification time of a file at the time it was imported.
+  struct FileStamp {
+    std::filesystem::file_time_type last_write_time;
+    std::uintmax_t size;
+
+    bool operator==(const FileStamp& other) const {
+      return last_write_time == other.last_write_time && size == other.size;
+    }
+  };
+
   // Everything relevant for a parsed editor buffer.
   // Note, each buffer independently currently keeps track of its import data.
   // This could maybe be considered to be put in a single place.
   struct ParseData {
-    ImportData import_data;
+    // The import data outlives updates of the buffer (see Update()), so the
+    // buffer's module is owned here rather than by the import data.
+    std::unique_ptr<ImportData> import_data;
+    std::unique_ptr<Module> module_owner;
     absl::StatusOr<TypecheckedModuleWithComments> tmc;
+    // The buffer contents this data was computed from.
+    std::string contents;
+    // Stamps of all files in `import_data`'s import cache.
+    absl::flat_hash_map<std::string, FileStamp> import_stamps;
+    // Whether `import_data` may be reused for the next version of the buffer.
+    bool import_data_reusable = false;
 
     bool ok() const { return tmc.ok(); }
     absl::Status status() const { return tmc.status(); }
@@ -115,8 +145,16 @@ class LanguageServerAdapter {
     }
   };
 
+  static std::optional<FileStamp> GetFileStamp(
+      const std::filesystem::path& path);
+
+  // Returns whether none of the files imported by `parsed` changed since they
+  // were imported.
+  static bool ImportsUpToDate(const ParseData& parsed);
+
   const std::string stdlib_;
   const std::vector<std::filesystem::path> dslx_paths_;
+  const int64_t import_threads_;
   absl::flat_hash_map<std::string, std::unique_ptr<ParseData>> uri_parse_data_;
 };
 
@@ -14,16 +14,22 @@
 
 #include "xls/dslx/lsp/language_server_adapter.h"
 
+#include <cstdint>
+#include <filesystem>  // NOLINT
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "external/verible/common/lsp/lsp-protocol.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 
@@ -193,5 +199,101 @@ fn messy() {
 )");
 }
 
+TEST(LanguageServerAdapterTest, RepeatedUpdatesReuseImports) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(temp_dir.path() / "lib.x",
+                                "pub fn id(x: u32) -> u32 { x }\n"));
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath,
+                                /*dslx_paths=*/{temp_dir.path()});
+  constexpr std::string_view kUri = "memfile://test.x";
+  XLS_ASSERT_OK(
+      adapter.Update(kUri, "import lib;\nfn f() -> u32 { lib::id(u32:1) }"));
+  // Same contents again is a no-op.
+  XLS_ASSERT_OK(
+      adapter.Update(kUri, "import lib;\nfn f() -> u32 { lib::id(u32:1) }"));
+
+  // A type error in the buffer is reported, and the buffer recovers once it is
+  // fixed.
+  EXPECT_THAT(
+      adapter.Update(kUri, "import lib;\nfn f() -> u32 { lib::id(u8:1) }"),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(adapter.GenerateParseDiagnostics(kUri).size(), 1);
+  XLS_ASSERT_OK(adapter.Update(
+      kUri, "import lib;\nfn f() -> u32 { lib::id(u32:1) }\nfn g() {}"));
+  EXPECT_EQ(adapter.GenerateParseDiagnostics(kUri).size(), 0);
+  EXPECT_EQ(adapter.GenerateDocumentSymbols(kUri).size(), 2);
+  EXPECT_EQ(adapter.ProvideImportLinks(kUri).size(), 1);
+}
+
+TEST(LanguageServerAdapterTest, RepeatedUpdatesWithParametricImportedCalls) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  XLS_ASSERT_OK(SetFileContents(
+      temp_dir.path() / "lib.x",
+      "pub fn widen<N: u32, M: u32 = {N * u32:2}>(x: uN[N]) -> uN[M] {\n"
+      "  x as uN[M]\n"
+      "}\n"));
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath,
+                                /*dslx_paths=*/{temp_dir.path()});
+  constexpr std::string_view kUri = "memfile://test.x";
+  // Every update instantiates parametric functions in `lib` and `std`; the
+  // instantiations made for the previous version of the buffer are evicted
+  // along with it.
+  for (int64_t i = 1; i <= 8; ++i) {
+    XLS_ASSERT_OK(adapter.Update(
+        kUri, absl::StrFormat("import lib;\nimport std;\n"
+                              "fn f(x: u%d) -> u%d { lib::widen(x) }\n"
+                              "fn g(x: u%d) -> u%d { std::clog2(x) }\n",
+                              i, 2 * i, i % 3 + 1, i % 3 + 1)));
+    EXPECT_EQ(adapter.GenerateParseDiagnostics(kUri).size(), 0);
+    EXPECT_EQ(adapter.GenerateDocumentSymbols(kUri).size(), 2);
+  }
+}
+
+TEST(LanguageServerAdapterTest, ChangedImportOnDiskIsReanalyzed) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  const std::filesystem::path lib_path = temp_dir.path() / "lib.x";
+  XLS_ASSERT_OK(SetFileContents(lib_path, "pub fn id(x: u32) -> u32 { x }\n"));
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath,
+                                /*dslx_paths=*/{temp_dir.path()});
+  constexpr std::string_view kUri = "memfile://test.x";
+  XLS_ASSERT_OK(
+      adapter.Update(kUri, "import lib;\nfn f() -> u32 { lib::id(u32:1) }"));
+
+  // Change the signature of the imported function; the next update of the
+  // buffer has to see it.
+  XLS_ASSERT_OK(SetFileContents(lib_path,
+                                "pub fn id(x: u8) -> u8 { x }\n"
+                                "pub fn other() {}\n"));
+  EXPECT_THAT(
+      adapter.Update(kUri, "import lib;\nfn f() -> u32 { lib::id(u32:2) }"),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  XLS_ASSERT_OK(
+      adapter.Update(kUri, "import lib;\nfn f() -> u8 { lib::id(u8:2) }"));
+}
+
+// Updates a buffer of `state.range(0)` functions that use the standard library
+// once per iteration, changing one function each time, as when typing in a
+// large file in an editor.
+void BM_UpdateLargeBufferImportingStd(benchmark::State& state) {
+  LanguageServerAdapter adapter(kDefaultDslxStdlibPath, /*dslx_paths=*/{"."});
+  constexpr std::string_view kUri = "memfile://test.x";
+  std::string prefix = "import std;\n";
+  for (int64_t i = 1; i < state.range(0); ++i) {
+    absl::StrAppendFormat(
+        &prefix, "fn f%d(x: u%d) -> u%d { std::clog2(x) + std::popcount(x) }\n",
+        i, i % 64 + 1, i % 64 + 1);
+  }
+  int64_t version = 0;
+  for (auto _ : state) {
+    std::string text = absl::StrFormat(
+        "%sfn g() -> u32 { std::umax(u32:%d, u32:1) }\n", prefix, version++);
+    CHECK_OK(adapter.Update(kUri, text));
+  }
+}
+BENCHMARK(BM_UpdateLargeBufferImportingStd)
+    ->Arg(16)
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace
 }  // namespace xls::dslx
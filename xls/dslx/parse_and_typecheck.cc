@@ -34,15 +34,38 @@
 #include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/frontend/scanner.h"
 #include "xls/dslx/import_data.h"
+#include "xls/dslx/import_routines.h"
 #include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/type_system/typecheck_module.h"
 #include "xls/dslx/warning_collector.h"
 
 namespace xls::dslx {
 
-absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
+// Typechecks `module`, which stays owned by the caller, first parsing its
+// imports concurrently if `import_data` allows more than one import thread.
+static absl::StatusOr<TypecheckedModule> TypecheckModuleWithPrefetch(
+    Module* module, ImportData* import_data) {
+  XLS_RET_CHECK(module != nullptr);
+  XLS_RET_CHECK(import_data != nullptr);
+
+  if (import_data->import_threads() > 1) {
+    XLS_RETURN_IF_ERROR(
+        PrefetchImports(*module, import_data, import_data->import_threads()));
+  }
+
+  WarningCollector warnings(import_data->enabled_warnings());
+  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                       TypecheckModule(module, import_data, &warnings));
+  return TypecheckedModule{module, type_info, std::move(warnings)};
+}
+
+// Parses `text` and typechecks the resulting module. If `module_owner` is
+// given, the parsed module is handed to the caller there (whether or not it
+// typechecks); otherwise it is put into `import_data`.
+static absl::StatusOr<TypecheckedModule> ParseAndTypecheckImpl(
     std::string_view text, std::string_view path, std::string_view module_name,
-    ImportData* import_data, std::vector<CommentData>* comments) {
+    ImportData* import_data, std::vector<CommentData>* comments,
+    std::unique_ptr<Module>* module_owner) {
   XLS_RET_CHECK(import_data != nullptr);
 
   // The outermost import doesn't have a real import statement associated with
@@ -56,7 +79,30 @@ absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
 
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module,
                        ParseModule(text, path, module_name, comments));
-  return TypecheckModule(std::move(module), path, import_data);
+  if (import_data->record_source_texts()) {
+    import_data->SetSourceText(path, std::string(text));
+  }
+  if (module_owner == nullptr) {
+    return TypecheckModule(std::move(module), path, import_data);
+  }
+  *module_owner = std::move(module);
+  return TypecheckModuleWithPrefetch(module_owner->get(), import_data);
+}
+
+absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
+    std::string_view text, std::string_view path, std::string_view module_name,
+    ImportData* import_data, std::vector<CommentData>* comments) {
+  return ParseAndTypecheckImpl(text, path, module_name, import_data, comments,
+                               /*module_owner=*/nullptr);
+}
+
+absl::StatusOr<TypecheckedModule> ParseAndTypecheckOwned(
+    std::string_view text, std::string_view path, std::string_view module_name,
+    ImportData* import_data, std::unique_ptr<Module>* module,
+    std::vector<CommentData>* comments) {
+  XLS_RET_CHECK(module != nullptr);
+  return ParseAndTypecheckImpl(text, path, module_name, import_data, comments,
+                               module);
 }
 
 absl::StatusOr<std::unique_ptr<Module>> ParseModule(
@@ -87,15 +133,14 @@ absl::StatusOr<TypecheckedModule> TypecheckModule(
 
   std::string_view module_name = module->name();
 
-  WarningCollector warnings(import_data->enabled_warnings());
-  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
-                       TypecheckModule(module.get(), import_data, &warnings));
-  TypecheckedModule result{module.get(), type_info, std::move(warnings)};
+  XLS_ASSIGN_OR_RETURN(TypecheckedModule result,
+                       TypecheckModuleWithPrefetch(module.get(), import_data));
   XLS_ASSIGN_OR_RETURN(ImportTokens subject,
                        ImportTokens::FromString(module_name));
   XLS_RETURN_IF_ERROR(import_data
                           ->Put(subject, std::make_unique<ModuleInfo>(
-                                             std::move(module), type_info,
+                                             std::move(module),
+                                             result.type_info,
                                              std::filesystem::path(path)))
                           .status());
   return result;
@@ -45,6 +45,16 @@ absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
     std::string_view text, std::string_view path, std::string_view module_name,
     ImportData* import_data, std::vector<CommentData>* comments = nullptr);
 
+// As ParseAndTypecheck(), but rather than giving ownership of the parsed module
+// to "import_data" (where other modules could import it), hands it to the
+// caller in "module" -- whenever parsing succeeds, even if typechecking fails.
+// This is for modules that are re-parsed and must later be removed with
+// ImportData::EvictModule(), e.g. an editor buffer in the language server.
+absl::StatusOr<TypecheckedModule> ParseAndTypecheckOwned(
+    std::string_view text, std::string_view path, std::string_view module_name,
+    ImportData* import_data, std::unique_ptr<Module>* module,
+    std::vector<CommentData>* comments = nullptr);
+
 // Helper that parses and creates a new module from the given "text".
 //
 // "path" is used for error reporting (`Span`s) and module_name is the name
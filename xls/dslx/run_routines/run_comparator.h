@@ -62,6 +62,11 @@ class RunComparator : public AbstractRunComparator {
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) override;
 
+  absl::StatusOr<FunctionJit*> GetJitFunction(
+      std::string_view ir_name, xls::Function* ir_function) override {
+    return GetOrCompileJitFunction(ir_name, ir_function);
+  }
+
   // Returns the cached or newly-compiled jit function for ir_name.  ir_name has
   // already been mangled (see MangleDslxName) so it should be unique in the
   // program and is used as the cache key.
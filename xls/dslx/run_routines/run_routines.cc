@@ -17,6 +17,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <ctime>
 #include <functional>
@@ -36,10 +37,12 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/bytecode/bytecode.h"
@@ -47,6 +50,7 @@
 #include "xls/dslx/bytecode/bytecode_emitter.h"
 #include "xls/dslx/bytecode/bytecode_interpreter.h"
 #include "xls/dslx/bytecode/bytecode_interpreter_options.h"
+#include "xls/dslx/bytecode/bytecode_optimizer.h"
 #include "xls/dslx/command_line_utils.h"
 #include "xls/dslx/create_import_data.h"
 #include "xls/dslx/error_printer.h"
@@ -70,7 +74,12 @@
 #include "xls/ir/bits.h"
 #include "xls/ir/events.h"
 #include "xls/ir/package.h"
+#include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/jit/function_base_jit.h"
+#include "xls/jit/function_jit.h"
+#include "xls/jit/jit_buffer.h"
+#include "xls/jit/jit_runtime.h"
 #include "xls/passes/optimization_pass_pipeline.h"
 #include "xls/solvers/z3_ir_translator.h"
 #include "re2/re2.h"
@@ -85,14 +94,13 @@ constexpr int kQuickcheckSpaces = 15;
 absl::Status RunTestFunction(ImportData* import_data, TypeInfo* type_info,
                              Module* module, TestFunction* tf,
                              const BytecodeInterpreterOptions& options) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
-  import_data->SetBytecodeCache(std::move(cache));
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<BytecodeFunction> bf,
       BytecodeEmitter::Emit(
           import_data, type_info, tf->fn(), std::nullopt,
           BytecodeEmitterOptions{.format_preference =
                                      options.format_preference()}));
+  XLS_ASSIGN_OR_RETURN(bf, OptimizeBytecodeFunction(std::move(bf)));
   return BytecodeInterpreter::Interpret(import_data, bf.get(), /*args=*/{},
                                         options)
       .status();
@@ -101,9 +109,6 @@ absl::Status RunTestFunction(ImportData* import_data, TypeInfo* type_info,
 absl::Status RunTestProc(ImportData* import_data, TypeInfo* type_info,
                          Module* module, TestProc* tp,
                          const BytecodeInterpreterOptions& options) {
-  auto cache = std::make_unique<BytecodeCache>(import_data);
-  import_data->SetBytecodeCache(std::move(cache));
-
   XLS_ASSIGN_OR_RETURN(TypeInfo * ti,
                        type_info->GetTopLevelProcTypeInfo(tp->proc()));
 
@@ -152,6 +157,40 @@ absl::Status RunTestProc(ImportData* import_data, TypeInfo* type_info,
   return absl::OkStatus();
 }
 
+// A unit test (test function or test proc) in the entry module.
+struct UnitTest {
+  std::string name;
+  ModuleMember* member;
+  Pos start_pos;
+  // Whether the test was excluded by the test filter.
+  bool filtered;
+};
+
+// The result of running a single unit test. Tests may run concurrently, so
+// outcomes are collected and reported afterwards in module order.
+struct UnitTestOutcome {
+  absl::Status status;
+  absl::Time start;
+  absl::Duration duration;
+};
+
+UnitTestOutcome RunUnitTest(ImportData* import_data, TypeInfo* type_info,
+                            Module* module, const UnitTest& test,
+                            const BytecodeInterpreterOptions& options) {
+  UnitTestOutcome outcome;
+  outcome.start = absl::Now();
+  if (std::holds_alternative<TestFunction*>(*test.member)) {
+    outcome.status =
+        RunTestFunction(import_data, type_info, module,
+                        std::get<TestFunction*>(*test.member), options);
+  } else {
+    outcome.status = RunTestProc(import_data, type_info, module,
+                                 std::get<TestProc*>(*test.member), options);
+  }
+  outcome.duration = absl::Now() - outcome.start;
+  return outcome;
+}
+
 }  // namespace
 
 TestResultData::TestResultData(absl::Time start_time,
@@ -219,39 +258,164 @@ static bool TestMatchesFilter(std::string_view test_name,
   return RE2::FullMatch(test_name, *test_filter);
 }
 
-absl::StatusOr<QuickCheckResults> DoQuickCheck(
-    xls::Function* xls_function, std::string_view ir_name,
-    AbstractRunComparator* run_comparator, int64_t seed, int64_t num_tests) {
-  QuickCheckResults results;
-  std::minstd_rand rng_engine(seed);
-
-  for (int i = 0; i < num_tests; i++) {
-    results.arg_sets.push_back(
-        RandomFunctionArguments(xls_function, rng_engine));
-    // TODO(https://github.com/google/xls/issues/506): 2021-10-15
-    // Assertion failures should work out, but we should consciously decide
-    // if/how we want to dump traces when running QuickChecks (always, for
-    // failures, flag-controlled, ...).
-    XLS_ASSIGN_OR_RETURN(xls::Value result,
-                         DropInterpreterEvents(run_comparator->RunIrFunction(
-                             ir_name, xls_function, results.arg_sets.back())));
-
-    // In the case of an implicit token signature we get (token, bool) as the
-    // result of the quickcheck'd function, so we unbox the boolean here.
-    if (result.IsTuple()) {
-      result = result.elements()[1];
-      XLS_RET_CHECK(result.IsBits());
+double QuickCheckResults::SamplesPerSecond() const {
+  double seconds = absl::ToDoubleSeconds(duration);
+  return seconds > 0 ? sample_count / seconds : 0.0;
+}
+
+namespace {
+
+// Number of consecutive quickcheck samples drawn from one random stream and
+// handed to a worker at a time.
+constexpr int64_t kQuickCheckBatchSize = 256;
+
+// Returns the random stream for the given batch of quickcheck samples.
+std::mt19937_64 QuickCheckBatchRng(int64_t seed, int64_t batch) {
+  std::seed_seq seed_seq{
+      static_cast<uint32_t>(seed),
+      static_cast<uint32_t>(static_cast<uint64_t>(seed) >> 32),
+      static_cast<uint32_t>(batch),
+      static_cast<uint32_t>(static_cast<uint64_t>(batch) >> 32)};
+  return std::mt19937_64(seed_seq);
+}
+
+// Runs a JIT-compiled function using argument, result and temporary buffers
+// owned by (and so private to) this object. Arguments are packed straight into
+// the preallocated native buffers, so no per-sample allocation is needed
+// beyond generating the argument values themselves.
+class JitSampleRunner {
+ public:
+  explicit JitSampleRunner(FunctionJit* jit)
+      : jit_(jit),
+        runtime_(jit->runtime()->data_layout()),
+        arg_buffers_(jit->jitted_function_base().CreateInputBuffer()),
+        result_buffers_(jit->jitted_function_base().CreateOutputBuffer()),
+        temp_buffer_(jit->jitted_function_base().CreateTempBuffer()) {
+    for (const xls::Param* param : jit->function()->params()) {
+      param_types_.push_back(param->GetType());
     }
+  }
 
-    results.results.push_back(result);
+  absl::StatusOr<Value> Run(absl::Span<const Value> args) {
+    XLS_RETURN_IF_ERROR(
+        runtime_.PackArgs(args, param_types_, arg_buffers_.pointers()));
+    InterpreterEvents events;
+    jit_->jitted_function_base().RunJittedFunction(
+        arg_buffers_, result_buffers_, temp_buffer_, &events,
+        /*instance_context=*/nullptr, &runtime_, /*continuation_point=*/0);
+    XLS_RETURN_IF_ERROR(InterpreterEventsToStatus(events));
+    return runtime_.UnpackBuffer(
+        result_buffers_.pointers()[0],
+        jit_->function()->return_value()->GetType());
+  }
+
+ private:
+  FunctionJit* jit_;
+  JitRuntime runtime_;
+  std::vector<xls::Type*> param_types_;
+  JitArgumentSet arg_buffers_;
+  JitArgumentSet result_buffers_;
+  JitTempBuffer temp_buffer_;
+};
 
-    if (result.IsAllZeros()) {
-      // We were able to falsify the xls_function (predicate), bail out early
-      // and present this evidence.
-      break;
+}  // namespace
+
+absl::StatusOr<QuickCheckResults> DoQuickCheck(
+    xls::Function* xls_function, std::string_view ir_name,
+    AbstractRunComparator* run_comparator, int64_t seed, int64_t num_tests,
+    int64_t num_threads) {
+  XLS_RET_CHECK_GE(num_threads, 1);
+  absl::Time start = absl::Now();
+
+  using SampleFn =
+      std::function<absl::StatusOr<Value>(absl::Span<const Value> args)>;
+  std::vector<SampleFn> workers;
+  std::vector<std::unique_ptr<JitSampleRunner>> jit_runners;
+  XLS_ASSIGN_OR_RETURN(FunctionJit * jit,
+                       run_comparator->GetJitFunction(ir_name, xls_function));
+  if (jit == nullptr) {
+    // The comparator is not known to be safe to call concurrently.
+    workers.push_back([&](absl::Span<const Value> args) {
+      // TODO(https://github.com/google/xls/issues/506): 2021-10-15
+      // Assertion failures should work out, but we should consciously decide
+      // if/how we want to dump traces when running QuickChecks (always, for
+      // failures, flag-controlled, ...).
+      return DropInterpreterEvents(
+          run_comparator->RunIrFunction(ir_name, xls_function, args));
+    });
+  } else {
+    const int64_t num_batches =
+        (num_tests + kQuickCheckBatchSize - 1) / kQuickCheckBatchSize;
+    const int64_t worker_count =
+        std::max<int64_t>(1, std::min(num_threads, num_batches));
+    for (int64_t i = 0; i < worker_count; ++i) {
+      jit_runners.push_back(std::make_unique<JitSampleRunner>(jit));
+      workers.push_back([runner = jit_runners.back().get()](
+                            absl::Span<const Value> args) {
+        return runner->Run(args);
+      });
     }
   }
 
+  // Lowest-numbered sample that falsified the predicate (or failed to run) so
+  // far. Batches are claimed in increasing order and every sample below this
+  // index is still evaluated, so the final failure is deterministic.
+  std::atomic<int64_t> first_failure = num_tests;
+  // Arguments and status of the sample at `first_failure`; guarded by
+  // `failure_mu`.
+  absl::Mutex failure_mu;
+  std::vector<Value> failure_args;
+  absl::Status failure_status;
+
+  std::atomic<int64_t> next_batch = 0;
+  ParallelFor(workers.size(), workers.size(), [&](int64_t worker) {
+    const SampleFn& run_sample = workers[worker];
+    for (int64_t batch = next_batch++;
+         batch * kQuickCheckBatchSize < first_failure.load();
+         batch = next_batch++) {
+      std::mt19937_64 rng = QuickCheckBatchRng(seed, batch);
+      const int64_t batch_end =
+          std::min(num_tests, (batch + 1) * kQuickCheckBatchSize);
+      for (int64_t i = batch * kQuickCheckBatchSize;
+           i < batch_end && i < first_failure.load(); ++i) {
+        std::vector<Value> args = RandomFunctionArguments(xls_function, rng);
+        absl::StatusOr<Value> result = run_sample(args);
+        // In the case of an implicit token signature we get (token, bool) as
+        // the result of the quickcheck'd function, so we unbox the boolean
+        // here.
+        if (result.ok() && result->IsTuple()) {
+          Value predicate = result->elements()[1];
+          result = std::move(predicate);
+        }
+        if (result.ok() && !result->IsBits()) {
+          result = absl::InternalError(absl::StrFormat(
+              "Quickcheck function `%s` returned non-bits value: %s",
+              xls_function->name(), result->ToString()));
+        }
+        if (result.ok() && !result->IsAllZeros()) {
+          continue;
+        }
+        absl::MutexLock lock(&failure_mu);
+        if (i < first_failure.load()) {
+          first_failure = i;
+          failure_args = std::move(args);
+          failure_status = result.status();
+        }
+        break;
+      }
+    }
+  });
+
+  QuickCheckResults results;
+  results.duration = absl::Now() - start;
+  if (first_failure.load() == num_tests) {
+    results.sample_count = num_tests;
+    return results;
+  }
+  absl::MutexLock lock(&failure_mu);
+  XLS_RETURN_IF_ERROR(failure_status);
+  results.sample_count = first_failure.load() + 1;
+  results.counterexample = std::move(failure_args);
   return results;
 }
 
@@ -288,9 +452,10 @@ static absl::StatusOr<QuickcheckIrFn> FindQuickcheckIrFn(Function* fn,
                       absl::StrJoin(ir_package->GetFunctionNames(), ", ")));
 }
 
-static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
-                                  Package* ir_package, QuickCheck* quickcheck,
-                                  TypeInfo* type_info, int64_t seed) {
+static absl::StatusOr<QuickCheckResults> RunQuickCheck(
+    AbstractRunComparator* run_comparator, Package* ir_package,
+    QuickCheck* quickcheck, TypeInfo* type_info, int64_t seed,
+    int64_t num_threads) {
   // Note: DSLX function.
   Function* fn = quickcheck->f();
 
@@ -300,15 +465,13 @@ static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
   XLS_ASSIGN_OR_RETURN(
       QuickCheckResults qc_results,
       DoQuickCheck(qc_fn.ir_function, qc_fn.ir_name, run_comparator, seed,
-                   quickcheck->GetTestCountOrDefault()));
-  const auto& [arg_sets, results] = qc_results;
-  XLS_ASSIGN_OR_RETURN(Bits last_result, results.back().GetBitsWithStatus());
-  if (!last_result.IsZero()) {
+                   quickcheck->GetTestCountOrDefault(), num_threads));
+  if (!qc_results.counterexample.has_value()) {
     // Did not find a falsifying example.
-    return absl::OkStatus();
+    return qc_results;
   }
 
-  const std::vector<Value>& last_argset = arg_sets.back();
+  const std::vector<Value>& last_argset = *qc_results.counterexample;
   XLS_ASSIGN_OR_RETURN(FunctionType * fn_type,
                        type_info->GetItemAs<FunctionType>(fn));
   const std::vector<std::unique_ptr<Type>>& params = fn_type->params();
@@ -328,7 +491,7 @@ static absl::Status RunQuickCheck(AbstractRunComparator* run_comparator,
   return FailureErrorStatus(
       fn->span(),
       absl::StrFormat("Found falsifying example after %d tests: [%s]",
-                      results.size(), dslx_argset_str));
+                      qc_results.sample_count, dslx_argset_str));
 }
 
 using HandleError = const std::function<void(
@@ -338,8 +501,8 @@ using HandleError = const std::function<void(
 static absl::Status RunQuickChecksIfJitEnabled(
     Module* entry_module, TypeInfo* type_info,
     AbstractRunComparator* run_comparator, Package* ir_package,
-    std::optional<int64_t> seed, const HandleError& handle_error,
-    TestResultData& result) {
+    std::optional<int64_t> seed, int64_t num_threads,
+    const HandleError& handle_error, TestResultData& result) {
   if (run_comparator == nullptr) {
     // TODO(leary): 2024-02-08 Note that this skips /all/ the quickchecks so we
     // don't make an entry for it right now in the test XML.
@@ -360,20 +523,26 @@ static absl::Status RunQuickChecksIfJitEnabled(
     std::cerr << "[ RUN QUICKCHECK        ] " << test_name
               << " count: " << quickcheck->GetTestCountOrDefault() << "\n";
     auto start = absl::Now();
-    absl::Status status =
-        RunQuickCheck(run_comparator, ir_package, quickcheck, type_info, *seed);
+    absl::StatusOr<QuickCheckResults> qc_results =
+        RunQuickCheck(run_comparator, ir_package, quickcheck, type_info, *seed,
+                      num_threads);
     auto end = absl::Now();
     auto duration = end - start;
     const Pos& start_pos = quickcheck->span().start();
-    if (!status.ok()) {
-      handle_error(status, test_name, start_pos, start, duration,
+    if (!qc_results.ok()) {
+      handle_error(qc_results.status(), test_name, start_pos, start, duration,
                    /*is_quickcheck=*/true);
     } else {
       result.AddTestCase(test_xml::TestCase{
           test_name, start_pos.filename(), start_pos.GetHumanLineno(),
           test_xml::RunStatus::kRun, test_xml::RunResult::kCompleted, duration,
           start});
-      std::cerr << "[                    OK ] " << test_name << "\n";
+      std::cerr << absl::StreamFormat(
+                       "[                    OK ] %s (%d samples, %.0f "
+                       "samples/sec)",
+                       test_name, qc_results->sample_count,
+                       qc_results->SamplesPerSecond())
+                << "\n";
     }
   }
   std::cerr << absl::StreamFormat(
@@ -513,6 +682,9 @@ absl::StatusOr<TestResultData> ParseAndTest(
 
   auto import_data = CreateImportData(options.stdlib_path, options.dslx_paths,
                                       options.warnings);
+  import_data.set_import_threads(options.test_threads);
+  // The store keys bytecode on the source of the module and its imports.
+  import_data.set_record_source_texts(options.bytecode_store != nullptr);
 
   absl::StatusOr<TypecheckedModule> tm_or =
       ParseAndTypecheck(program, filename, module_name, &import_data);
@@ -548,6 +720,7 @@ absl::StatusOr<TestResultData> ParseAndTest(
   // If JIT comparisons are "on", we register a post-evaluation hook to compare
   // with the interpreter.
   std::unique_ptr<Package> ir_package;
+  absl::Mutex comparator_mu;
   PostFnEvalHook post_fn_eval_hook;
   if (options.run_comparator != nullptr) {
     absl::StatusOr<std::unique_ptr<Package>> ir_package_or =
@@ -561,12 +734,15 @@ absl::StatusOr<TestResultData> ParseAndTest(
       return ir_package_or.status();
     }
     ir_package = std::move(ir_package_or).value();
-    post_fn_eval_hook = [&ir_package, &import_data, &options](
+    post_fn_eval_hook = [&ir_package, &import_data, &options, &comparator_mu](
                             const Function* f,
                             absl::Span<const InterpValue> args,
                             const ParametricEnv* parametric_env,
                             const InterpValue& got) -> absl::Status {
       XLS_RET_CHECK(f != nullptr);
+      // The comparator (and the JIT state it caches) is shared by all tests,
+      // which may be running concurrently.
+      absl::MutexLock lock(&comparator_mu);
       std::optional<bool> requires_implicit_token =
           import_data.GetRootTypeInfoForNode(f)
               .value()
@@ -578,52 +754,86 @@ absl::StatusOr<TestResultData> ParseAndTest(
     };
   }
 
-  // Run unit tests.
-  for (const std::string& test_name : entry_module->GetTestNames()) {
-    auto test_case_start = absl::Now();
-    ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
-    const Pos start_pos = GetPos(*member);
+  BytecodeInterpreterOptions interpreter_options;
+  interpreter_options.post_fn_eval_hook(post_fn_eval_hook)
+      .trace_hook(InfoLoggingTraceHook)
+      .trace_channels(options.trace_channels)
+      .max_ticks(options.max_ticks)
+      .format_preference(options.format_preference);
 
-    if (!TestMatchesFilter(test_name, options.test_filter)) {
-      auto test_case_end = absl::Now();
+  auto report_outcome = [&](const UnitTest& test,
+                            const UnitTestOutcome& outcome) {
+    if (test.filtered) {
       result.AddTestCase(test_xml::TestCase{
-          test_name, start_pos.filename(), start_pos.GetHumanLineno(),
-          test_xml::RunStatus::kRun, test_xml::RunResult::kFiltered,
-          test_case_end - test_case_start, test_case_start});
-      continue;
+          test.name, test.start_pos.filename(),
+          test.start_pos.GetHumanLineno(), test_xml::RunStatus::kRun,
+          test_xml::RunResult::kFiltered, outcome.duration, outcome.start});
+      return;
     }
 
-    std::cerr << "[ RUN UNITTEST  ] " << test_name << '\n';
-    absl::Status status;
-    BytecodeInterpreterOptions interpreter_options;
-    interpreter_options.post_fn_eval_hook(post_fn_eval_hook)
-        .trace_hook(InfoLoggingTraceHook)
-        .trace_channels(options.trace_channels)
-        .max_ticks(options.max_ticks)
-        .format_preference(options.format_preference);
-    if (std::holds_alternative<TestFunction*>(*member)) {
-      XLS_ASSIGN_OR_RETURN(TestFunction * tf, entry_module->GetTest(test_name));
-      status = RunTestFunction(&import_data, tm_or.value().type_info,
-                               entry_module, tf, interpreter_options);
-    } else {
-      XLS_ASSIGN_OR_RETURN(TestProc * tp, entry_module->GetTestProc(test_name));
-      status = RunTestProc(&import_data, tm_or.value().type_info, entry_module,
-                           tp, interpreter_options);
-    }
-    auto test_case_end = absl::Now();
-
-    if (status.ok()) {
+    if (outcome.status.ok()) {
       // Add to the tracking data.
       result.AddTestCase(test_xml::TestCase{
-          test_name, start_pos.filename(), start_pos.GetHumanLineno(),
-          test_xml::RunStatus::kRun, test_xml::RunResult::kCompleted,
-          test_case_end - test_case_start, test_case_start});
+          test.name, test.start_pos.filename(),
+          test.start_pos.GetHumanLineno(), test_xml::RunStatus::kRun,
+          test_xml::RunResult::kCompleted, outcome.duration, outcome.start});
 
       std::cerr << "[            OK ]" << '\n';
     } else {
-      handle_error(status, test_name, start_pos, test_case_start,
-                   test_case_end - test_case_start,
-                   /*is_quickcheck=*/false);
+      handle_error(outcome.status, test.name, test.start_pos, outcome.start,
+                   outcome.duration, /*is_quickcheck=*/false);
+    }
+  };
+
+  // Run unit tests.
+  std::vector<UnitTest> tests;
+  int64_t tests_to_run = 0;
+  for (const std::string& test_name : entry_module->GetTestNames()) {
+    ModuleMember* member = entry_module->FindMemberWithName(test_name).value();
+    bool filtered = !TestMatchesFilter(test_name, options.test_filter);
+    tests.push_back(UnitTest{test_name, member, GetPos(*member), filtered});
+    if (!filtered) {
+      ++tests_to_run;
+    }
+  }
+
+  TypeInfo* type_info = tm_or.value().type_info;
+  const int64_t thread_count = std::min(options.test_threads, tests_to_run);
+  if (thread_count <= 1) {
+    for (const UnitTest& test : tests) {
+      if (test.filtered) {
+        report_outcome(test, UnitTestOutcome{.start = absl::Now()});
+        continue;
+      }
+      // Each test starts from a fresh bytecode cache.
+      import_data.SetBytecodeCache(std::make_unique<BytecodeCache>(
+          &import_data, options.bytecode_store));
+      std::cerr << "[ RUN UNITTEST  ] " << test.name << '\n';
+      report_outcome(test, RunUnitTest(&import_data, type_info, entry_module,
+                                       test, interpreter_options));
+    }
+  } else {
+    // Each test runs in its own interpreter; the typechecked module and its
+    // type information are only read, and the bytecode cache is shared
+    // (it is internally synchronized). Outcomes are reported afterwards in
+    // module order so the output and test XML are deterministic.
+    import_data.SetBytecodeCache(std::make_unique<BytecodeCache>(
+        &import_data, options.bytecode_store));
+    std::vector<UnitTestOutcome> outcomes(tests.size());
+    const absl::Time start_all = absl::Now();
+    ParallelFor(tests.size(), thread_count, [&](int64_t i) {
+      if (!tests[i].filtered) {
+        outcomes[i] = RunUnitTest(&import_data, type_info, entry_module,
+                                  tests[i], interpreter_options);
+      }
+    });
+    for (int64_t i = 0; i < tests.size(); ++i) {
+      if (tests[i].filtered) {
+        outcomes[i].start = start_all;
+      } else {
+        std::cerr << "[ RUN UNITTEST  ] " << tests[i].name << '\n';
+      }
+      report_outcome(tests[i], outcomes[i]);
     }
   }
 
@@ -637,9 +847,16 @@ absl::StatusOr<TestResultData> ParseAndTest(
   if (!entry_module->GetQuickChecks().empty()) {
     XLS_RETURN_IF_ERROR(RunQuickChecksIfJitEnabled(
         entry_module, tm_or.value().type_info, options.run_comparator,
-        ir_package.get(), options.seed, handle_error, result));
+        ir_package.get(), options.seed, options.test_threads, handle_error,
+        result));
   }
 
+  XLS_VLOG(1) << "Import cache: "
+              << import_data.import_cache_stats().ToString();
+  XLS_VLOG(1) << "Instantiation cache: "
+              << import_data.type_info_owner()
+                     .instantiation_cache_stats()
+                     .ToString();
   result.Finish(
       result.DidAnyFail() ? TestResult::kSomeFailed : TestResult::kAllPassed,
       absl::Now() - start);
@@ -33,6 +33,7 @@
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/dslx/bytecode/bytecode_store.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/interp_value.h"
@@ -47,6 +48,10 @@
 #include "xls/ir/value.h"
 #include "re2/re2.h"
 
+namespace xls {
+class FunctionJit;
+}  // namespace xls
+
 namespace xls::dslx {
 
 // Abstract API used for comparing DSLX-interpreter results to executed IR
@@ -77,6 +82,16 @@ class AbstractRunComparator {
   virtual absl::StatusOr<InterpreterResult<xls::Value>> RunIrFunction(
       std::string_view ir_name, xls::Function* ir_function,
       absl::Span<const xls::Value> ir_args) = 0;
+
+  // Returns the JIT-compiled form of the given IR function if IR functions are
+  // run via the JIT, or nullptr otherwise. The compiled code may be invoked
+  // from several threads at once as long as each thread uses its own
+  // argument/result/temporary buffers; this lets quickchecks fan out across
+  // threads.
+  virtual absl::StatusOr<FunctionJit*> GetJitFunction(
+      std::string_view ir_name, xls::Function* ir_function) {
+    return nullptr;
+  }
 };
 
 // Optional arguments to ParseAndTest (that have sensible defaults).
@@ -92,6 +107,14 @@ class AbstractRunComparator {
 //   warnings_as_errors: Whether warnings should be reported as errors (i.e.
 //    cause the run routine to report failure when a warning is encountered).
 //   warnings: Set of warnings to enable for reporting.
+//   test_threads: Number of worker threads used to run unit tests (test
+//    functions and test procs) concurrently; results are still reported in
+//    module order. The same number of threads is used to locate and parse
+//    the module's imports before typechecking, and to evaluate quickcheck
+//    samples.
+//   bytecode_store: Optional store of serialized bytecode shared by the
+//    bytecode caches created for running tests (and possibly other processes);
+//    see BytecodeCache.
 struct ParseAndTestOptions {
   std::string stdlib_path = xls::kDefaultDslxStdlibPath;
   absl::Span<const std::filesystem::path> dslx_paths;
@@ -105,6 +128,8 @@ struct ParseAndTestOptions {
   WarningKindSet warnings = kDefaultWarningsSet;
   bool trace_channels = false;
   std::optional<int64_t> max_ticks;
+  int64_t test_threads = 1;
+  SharedBytecodeStore* bytecode_store = nullptr;
 };
 
 // As above, but a subset of the options required for the ParseAndProve()
@@ -201,20 +226,32 @@ absl::StatusOr<TestResultData> ParseAndProve(
     const ParseAndProveOptions& options);
 
 struct QuickCheckResults {
-  std::vector<std::vector<Value>> arg_sets;
-  std::vector<Value> results;
+  // Number of samples evaluated; if a counterexample was found this is its
+  // (1-based) sample number.
+  int64_t sample_count = 0;
+  // Arguments of the first sample that falsified the predicate, if any.
+  std::optional<std::vector<Value>> counterexample;
+  absl::Duration duration;
+
+  double SamplesPerSecond() const;
 };
 
-// JIT-compiles the given xls_function and invokes it with num_tests randomly
-// generated arguments -- returns `([argset, ...], [results, ...])` (i.e. in
-// structure-of-array style).
+// JIT-compiles the given xls_function and invokes it with up to num_tests
+// randomly generated arguments.
+//
+// xls_function is a predicate we're trying to find evidence to falsify, so
+// sampling stops at the first example that falsifies the predicate.
 //
-// xls_function is a predicate we're trying to find evidence to falsify, so if
-// this finds an example that falsifies the predicate, we early-return (i.e. the
-// length of the returned vectors may be < 1000).
+// Samples are generated in fixed-size batches, each drawing from its own
+// random stream derived from `seed`, and batches are spread across
+// `num_threads` workers when the comparator runs IR functions on the JIT. The
+// samples evaluated -- and so the counterexample reported, which is always the
+// lowest-numbered falsifying sample -- depend only on `seed`, not on the
+// number of threads.
 absl::StatusOr<QuickCheckResults> DoQuickCheck(
     xls::Function* xls_function, std::string_view ir_name,
-    AbstractRunComparator* run_comparator, int64_t seed, int64_t num_tests);
+    AbstractRunComparator* run_comparator, int64_t seed, int64_t num_tests,
+    int64_t num_threads = 1);
 
 }  // namespace xls::dslx
 
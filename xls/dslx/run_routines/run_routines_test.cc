@@ -25,6 +25,7 @@
 #include "xls/common/file/temp_file.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/run_routines/run_comparator.h"
+#include "xls/dslx/run_routines/test_xml.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
@@ -194,6 +195,64 @@ proc doomed {
               IsTestResult(TestResult::kParseOrTypecheckError, 0, 0, 0));
 }
 
+TEST(RunRoutinesTest, ParallelTestsReportInModuleOrder) {
+  constexpr std::string_view kProgram = R"(
+fn add_one(x: u32) -> u32 { x + u32:1 }
+
+#[test]
+fn test_a() { assert_eq(add_one(u32:1), u32:2) }
+
+#[test]
+fn test_b() { assert_eq(add_one(u32:1), u32:3) }
+
+#[test]
+fn skipped_c() { assert_eq(add_one(u32:2), u32:3) }
+
+#[test_proc]
+proc test_d {
+    terminator: chan<bool> out;
+
+    init { () }
+
+    config(terminator: chan<bool> out) {
+        (terminator,)
+    }
+
+    next(tok: token, state: ()) {
+      let tok = send(tok, terminator, true);
+    }
+}
+
+#[test]
+fn test_e() { assert_eq(add_one(u32:3), u32:4) }
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto temp_file,
+                           TempFile::CreateWithContent(kProgram, "_test.x"));
+  constexpr const char* kModuleName = "test";
+  RE2 test_filter("test_.*");
+  ParseAndTestOptions options;
+  options.test_filter = &test_filter;
+  options.test_threads = 4;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TestResultData result,
+      ParseAndTest(kProgram, kModuleName, std::string(temp_file.path()),
+                   options));
+  EXPECT_THAT(result, IsTestResult(TestResult::kSomeFailed, 5, 1, 1));
+
+  test_xml::TestSuites suites = result.ToXmlSuites(kModuleName);
+  ASSERT_EQ(suites.test_suites.size(), 1);
+  std::vector<std::string> names;
+  std::vector<bool> failed;
+  for (const test_xml::TestCase& test_case :
+       suites.test_suites[0].test_cases) {
+    names.push_back(test_case.name);
+    failed.push_back(test_case.failure.has_value());
+  }
+  EXPECT_THAT(names, testing::ElementsAre("test_a", "test_b", "skipped_c",
+                                          "test_d", "test_e"));
+  EXPECT_THAT(failed, testing::ElementsAre(false, true, false, false, false));
+}
+
 // Verifies that the QuickCheck mechanism can find counter-examples for a simple
 // erroneous function.
 TEST(QuickcheckTest, QuickCheckBits) {
@@ -213,9 +272,11 @@ TEST(QuickcheckTest, QuickCheckBits) {
   XLS_ASSERT_OK_AND_ASSIGN(
       auto quickcheck_info,
       DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests));
-  std::vector<Value> results = quickcheck_info.results;
-  // If a counter-example was found, the last result will be 0.
-  EXPECT_EQ(results.back(), Value(UBits(0, 1)));
+  ASSERT_TRUE(quickcheck_info.counterexample.has_value());
+  const std::vector<Value>& args = *quickcheck_info.counterexample;
+  ASSERT_EQ(args.size(), 1);
+  EXPECT_TRUE(args[0] == Value(UBits(1, 2)) || args[0] == Value(UBits(2, 2)))
+      << args[0];
 }
 
 TEST(QuickcheckTest, QuickCheckArray) {
@@ -237,8 +298,7 @@ TEST(QuickcheckTest, QuickCheckArray) {
   XLS_ASSERT_OK_AND_ASSIGN(
       auto quickcheck_info,
       DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests));
-  std::vector<Value> results = quickcheck_info.results;
-  EXPECT_EQ(results.back(), Value(UBits(0, 1)));
+  EXPECT_TRUE(quickcheck_info.counterexample.has_value());
 }
 
 TEST(QuickcheckTest, QuickCheckTuple) {
@@ -258,12 +318,11 @@ TEST(QuickcheckTest, QuickCheckTuple) {
   XLS_ASSERT_OK_AND_ASSIGN(
       auto quickcheck_info,
       DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests));
-  std::vector<Value> results = quickcheck_info.results;
-  EXPECT_EQ(results.back(), Value(UBits(0, 1)));
+  EXPECT_TRUE(quickcheck_info.counterexample.has_value());
 }
 
-// If the QuickCheck mechanism can't find a falsifying example, we expect
-// the argsets and results vectors to have lengths of 'num_tests'.
+// If the QuickCheck mechanism can't find a falsifying example, we expect all
+// 'num_tests' samples to have been evaluated.
 TEST(QuickcheckTest, NumTests) {
   Package package("always_true");
   std::string ir_text = R"(
@@ -280,14 +339,12 @@ TEST(QuickcheckTest, NumTests) {
       auto quickcheck_info,
       DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests));
 
-  std::vector<std::vector<Value>> argsets = quickcheck_info.arg_sets;
-  std::vector<Value> results = quickcheck_info.results;
-  EXPECT_EQ(argsets.size(), 5050);
-  EXPECT_EQ(results.size(), 5050);
+  EXPECT_EQ(quickcheck_info.sample_count, 5050);
+  EXPECT_FALSE(quickcheck_info.counterexample.has_value());
 }
 
-// Given a constant seed, we expect the same argsets and results vectors from
-// two runs through the QuickCheck mechanism.
+// Given a constant seed, we expect the same counterexample from two runs
+// through the QuickCheck mechanism, regardless of the number of threads used.
 TEST(QuickcheckTest, Seeding) {
   Package package("sometimes_false");
   std::string ir_text = R"(
@@ -307,12 +364,39 @@ TEST(QuickcheckTest, Seeding) {
   XLS_ASSERT_OK_AND_ASSIGN(
       auto quickcheck_info2,
       DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto quickcheck_info3,
+      DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests,
+                   /*num_threads=*/4));
+
+  ASSERT_TRUE(quickcheck_info1.counterexample.has_value());
+  EXPECT_EQ(quickcheck_info1.counterexample, quickcheck_info2.counterexample);
+  EXPECT_EQ(quickcheck_info1.sample_count, quickcheck_info2.sample_count);
+  EXPECT_EQ(quickcheck_info1.counterexample, quickcheck_info3.counterexample);
+  EXPECT_EQ(quickcheck_info1.sample_count, quickcheck_info3.sample_count);
+}
 
-  const auto& [argsets1, results1] = quickcheck_info1;
-  const auto& [argsets2, results2] = quickcheck_info2;
-
-  EXPECT_EQ(argsets1, argsets2);
-  EXPECT_EQ(results1, results2);
+// With many threads (and more batches than workers), an always-true
+// quickcheck still passes. Note that on success the reported sample count is
+// simply `num_tests`; it does not count evaluations.
+TEST(QuickcheckTest, ParallelNumTests) {
+  Package package("always_true");
+  std::string ir_text = R"(
+  fn ret_true(x: bits[32]) -> bits[1] {
+    ret eq_value: bits[1] = eq(x, x)
+  }
+  )";
+  int64_t seed = 0;
+  int64_t num_tests = 100000;
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  RunComparator jit_comparator(CompareMode::kJit);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto quickcheck_info,
+      DoQuickCheck(function, kFakeIrName, &jit_comparator, seed, num_tests,
+                   /*num_threads=*/8));
+  EXPECT_EQ(quickcheck_info.sample_count, num_tests);
+  EXPECT_FALSE(quickcheck_info.counterexample.has_value());
 }
 
 TEST(ParseAndTestTest, DeadlockedProc) {
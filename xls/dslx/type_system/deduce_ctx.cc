@@ -117,8 +117,26 @@ absl::StatusOr<std::unique_ptr<Type>> DeduceCtx::Deduce(const AstNode* node) {
   return result;
 }
 
+Module* DeduceCtx::GetEntryModule() const {
+  const DeduceCtx* ctx = this;
+  while (ctx->parent_ != nullptr) {
+    ctx = ctx->parent_;
+  }
+  return ctx->module();
+}
+
+absl::StatusOr<TypeInfo*> DeduceCtx::NewTypeInfo(Module* module,
+                                                 TypeInfo* parent) {
+  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                       type_info_owner().New(module, parent));
+  if (Module* entry_module = GetEntryModule(); entry_module != module) {
+    type_info_owner().NoteCreatedWhileTypechecking(type_info, entry_module);
+  }
+  return type_info;
+}
+
 TypeInfo* DeduceCtx::AddDerivedTypeInfo() {
-  type_info_ = type_info_owner().New(module(), /*parent=*/type_info_).value();
+  type_info_ = NewTypeInfo(module(), /*parent=*/type_info_).value();
   return type_info_;
 }
 
@@ -189,6 +189,15 @@ class DeduceCtx {
   Module* module() const { return module_; }
   TypeInfo* type_info() const { return type_info_; }
 
+  // Returns the module whose typechecking this context is a part of, i.e. the
+  // module of the outermost context.
+  Module* GetEntryModule() const;
+
+  // Creates a new TypeInfo for `module` with the given parent. If `module` is
+  // not the entry module the type info is attributed to the entry module, so
+  // that it is evicted along with it (see TypeInfoOwner::EvictModule()).
+  absl::StatusOr<TypeInfo*> NewTypeInfo(Module* module, TypeInfo* parent);
+
   // Creates a new TypeInfo that has the current type_info_ as its parent.
   //
   // Returns the new (derived) type info object. This can later be passed to
@@ -14,13 +14,17 @@
 
 #include "xls/dslx/type_system/type_info.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
 #include "absl/meta/type_traits.h"
@@ -104,6 +108,13 @@ absl::Status InvocationData::Add(ParametricEnv caller_env,
   return absl::OkStatus();
 }
 
+void InvocationData::EraseDerivedTypeInfos(
+    const absl::flat_hash_set<const TypeInfo*>& type_infos) {
+  absl::erase_if(env_to_callee_data_, [&](const auto& item) {
+    return type_infos.contains(item.second.derived_type_info);
+  });
+}
+
 absl::Status InvocationData::ValidateEnvForCaller(
     const ParametricEnv& env) const {
   for (const auto& k : env.GetKeySet()) {
@@ -118,6 +129,12 @@ absl::Status InvocationData::ValidateEnvForCaller(
   return absl::OkStatus();
 }
 
+std::string CacheStats::ToString() const {
+  const int64_t total = hits + misses;
+  return absl::StrFormat("%d hits / %d lookups (%.1f%%)", hits, total,
+                         total == 0 ? 0.0 : 100.0 * hits / total);
+}
+
 // -- class TypeInfoOwner
 
 absl::StatusOr<TypeInfo*> TypeInfoOwner::New(Module* module, TypeInfo* parent) {
@@ -149,20 +166,133 @@ absl::StatusOr<TypeInfo*> TypeInfoOwner::GetRootTypeInfo(const Module* module) {
   return it->second;
 }
 
+void TypeInfoOwner::NoteCreatedWhileTypechecking(const TypeInfo* type_info,
+                                                 const Module* module) {
+  CHECK_NE(type_info->module(), module);
+  created_while_typechecking_[type_info] = module;
+}
+
+void TypeInfoOwner::EvictModule(const Module* module) {
+  // Type infos are created after their parents, so a single pass in creation
+  // order finds everything derived from an evicted type info.
+  absl::flat_hash_set<const TypeInfo*> evicted;
+  for (const std::unique_ptr<TypeInfo>& ti : type_infos_) {
+    if (ti->module() == module || GetCreatingModule(ti.get()) == module ||
+        (ti->parent() != nullptr && evicted.contains(ti->parent()))) {
+      evicted.insert(ti.get());
+    }
+  }
+
+  module_to_root_.erase(module);
+  absl::erase_if(instantiations_, [&](const auto& item) {
+    return evicted.contains(item.second);
+  });
+  absl::erase_if(created_while_typechecking_, [&](const auto& item) {
+    return evicted.contains(item.first);
+  });
+  // The remaining modules may have recorded evicted type infos for their own
+  // invocations, e.g. for calls made by an evicted instantiation.
+  for (const auto& [root_module, root] : module_to_root_) {
+    for (auto& [invocation, invocation_data] : root->invocations_) {
+      invocation_data.EraseDerivedTypeInfos(evicted);
+    }
+    absl::erase_if(root->invocations_, [](const auto& item) {
+      return item.second.env_to_callee_data().empty();
+    });
+  }
+
+  auto first_evicted = std::stable_partition(
+      type_infos_.begin(), type_infos_.end(),
+      [&](const std::unique_ptr<TypeInfo>& ti) {
+        return !evicted.contains(ti.get());
+      });
+  // Derived type infos refer to their parents on destruction, and are always
+  // created after them, so destroy in reverse creation order.
+  while (type_infos_.end() != first_evicted) {
+    type_infos_.pop_back();
+  }
+}
+
+const Module* TypeInfoOwner::GetCreatingModule(
+    const TypeInfo* type_info) const {
+  auto it = created_while_typechecking_.find(type_info);
+  return it == created_while_typechecking_.end() ? type_info->module()
+                                                 : it->second;
+}
+
+std::optional<TypeInfo*> TypeInfoOwner::GetInstantiation(
+    const Function* f, const ParametricEnv& env, const Module* entry_module) {
+  const Module* creating_modules[] = {entry_module, f->owner()};
+  for (const Module* creating_module : creating_modules) {
+    auto it = instantiations_.find(std::make_tuple(f, env, creating_module));
+    if (it != instantiations_.end()) {
+      ++instantiation_cache_stats_.hits;
+      return it->second;
+    }
+  }
+  ++instantiation_cache_stats_.misses;
+  return std::nullopt;
+}
+
+void TypeInfoOwner::NoteInstantiation(const Function* f,
+                                      const ParametricEnv& env,
+                                      TypeInfo* type_info) {
+  CHECK_EQ(type_info->module(), f->owner());
+  instantiations_.emplace(
+      std::make_tuple(f, env, GetCreatingModule(type_info)), type_info);
+}
+
 // -- class TypeInfo
 
 void TypeInfo::NoteConstExpr(const AstNode* const_expr, InterpValue value) {
+  if (const_expr->kind() == AstNodeKind::kNameDef) {
+    GetRoot()->const_name_def_generation_.fetch_add(1,
+                                                    std::memory_order_relaxed);
+  }
+  absl::MutexLock lock(&const_exprs_mu_);
   const_exprs_.insert({const_expr, value});
 }
 
+void TypeInfo::NoteNonConstExprResult(const AstNode* node,
+                                      const ParametricEnv& env) {
+  const int64_t generation =
+      GetRoot()->const_name_def_generation_.load(std::memory_order_relaxed);
+  absl::MutexLock lock(&const_exprs_mu_);
+  non_const_exprs_.insert_or_assign(std::make_pair(node, env), generation);
+}
+
+bool TypeInfo::IsCachedNonConstExprResult(const AstNode* node,
+                                          const ParametricEnv& env) const {
+  const int64_t generation =
+      GetRoot()->const_name_def_generation_.load(std::memory_order_relaxed);
+  absl::MutexLock lock(&const_exprs_mu_);
+  auto it = non_const_exprs_.find(std::make_pair(node, env));
+  if (it == non_const_exprs_.end() || it->second != generation) {
+    return false;
+  }
+  non_const_expr_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+std::optional<std::optional<InterpValue>> TypeInfo::FindLocalConstExpr(
+    const AstNode* node) const {
+  absl::ReaderMutexLock lock(&const_exprs_mu_);
+  if (auto it = const_exprs_.find(node); it != const_exprs_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
 absl::StatusOr<InterpValue> TypeInfo::GetConstExpr(
     const AstNode* const_expr) const {
   CHECK_EQ(const_expr->owner(), module_)
       << const_expr->owner()->name() << " vs " << module_->name()
       << " node: " << const_expr->ToString();
 
-  if (auto it = const_exprs_.find(const_expr); it != const_exprs_.end()) {
-    return it->second.value();
+  if (std::optional<std::optional<InterpValue>> local =
+          FindLocalConstExpr(const_expr);
+      local.has_value()) {
+    return local->value();
   }
 
   if (parent_ != nullptr) {
@@ -184,8 +314,10 @@ std::optional<InterpValue> TypeInfo::GetConstExprOption(
       << const_expr->owner()->name() << " vs " << module_->name()
       << " node: " << const_expr->ToString();
 
-  if (auto it = const_exprs_.find(const_expr); it != const_exprs_.end()) {
-    return it->second;
+  if (std::optional<std::optional<InterpValue>> local =
+          FindLocalConstExpr(const_expr);
+      local.has_value()) {
+    return *local;
   }
 
   if (parent_ != nullptr) {
@@ -199,8 +331,10 @@ std::optional<InterpValue> TypeInfo::GetConstExprOption(
 }
 
 bool TypeInfo::IsKnownConstExpr(const AstNode* node) const {
-  if (const_exprs_.contains(node)) {
-    return const_exprs_.at(node).has_value();
+  if (std::optional<std::optional<InterpValue>> local =
+          FindLocalConstExpr(node);
+      local.has_value()) {
+    return local->has_value();
   }
 
   if (parent_ != nullptr) {
@@ -211,8 +345,10 @@ bool TypeInfo::IsKnownConstExpr(const AstNode* node) const {
 }
 
 bool TypeInfo::IsKnownNonConstExpr(const AstNode* node) const {
-  if (const_exprs_.contains(node)) {
-    return !const_exprs_.at(node).has_value();
+  if (std::optional<std::optional<InterpValue>> local =
+          FindLocalConstExpr(node);
+      local.has_value()) {
+    return !local->has_value();
   }
 
   if (parent_ != nullptr) {
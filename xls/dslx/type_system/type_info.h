@@ -17,17 +17,23 @@
 #ifndef XLS_DSLX_TYPE_SYSTEM_TYPE_INFO_H_
 #define XLS_DSLX_TYPE_SYSTEM_TYPE_INFO_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/logging/logging.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/pos.h"
@@ -92,6 +98,11 @@ struct InvocationData {
   // Returns an error if the `caller_env` is invalid
   absl::Status Add(ParametricEnv caller_env, InvocationCalleeData callee_data);
 
+  // Drops the callee data whose derived type information is in `type_infos`,
+  // which are about to be destroyed.
+  void EraseDerivedTypeInfos(
+      const absl::flat_hash_set<const TypeInfo*>& type_infos);
+
   std::string ToString() const;
 
  private:
@@ -115,6 +126,16 @@ struct InvocationData {
   absl::flat_hash_map<ParametricEnv, InvocationCalleeData> env_to_callee_data_;
 };
 
+// Hit/miss counts for a lookup cache, e.g. the parametric instantiations of a
+// TypeInfoOwner or the imported modules of an ImportData.
+struct CacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+
+  // Returns a human readable summary, e.g. "12 hits / 15 lookups (80.0%)".
+  std::string ToString() const;
+};
+
 // Owns "type information" objects created during the type checking process.
 //
 // In the process of type checking we may instantiate "sub type-infos" for
@@ -135,6 +156,48 @@ class TypeInfoOwner {
   // status error if it is not present.
   absl::StatusOr<TypeInfo*> GetRootTypeInfo(const Module* module);
 
+  // Notes that `type_info`, which belongs to another module, was created while
+  // typechecking `module`; e.g. for an invocation in `module` of a parametric
+  // function that `module` imports.
+  void NoteCreatedWhileTypechecking(const TypeInfo* type_info,
+                                    const Module* module);
+
+  // Destroys all type information (root and derived) for the given module, as
+  // well as the type information that was created in other modules while
+  // typechecking it (see NoteCreatedWhileTypechecking()) and everything
+  // derived from that.
+  void EvictModule(const Module* module);
+
+  // Returns the module whose typechecking created `type_info`: the module
+  // noted via NoteCreatedWhileTypechecking(), if any, else its own module.
+  const Module* GetCreatingModule(const TypeInfo* type_info) const;
+
+  // Returns the number of type information objects owned.
+  int64_t size() const { return type_infos_.size(); }
+
+  // Returns the derived type information that was noted (via
+  // NoteInstantiation()) for the body of `f` instantiated with `env`, if any.
+  //
+  // The derived type information of an instantiation only depends on the
+  // callee and its parametric env -- not on the invocation that caused it -- so
+  // every invocation that binds the same env can share it instead of
+  // re-deducing the function body.
+  //
+  // Only instantiations created while typechecking `entry_module` or the module
+  // of `f` itself are returned: those created while typechecking some other
+  // module are evicted along with that module.
+  std::optional<TypeInfo*> GetInstantiation(const Function* f,
+                                            const ParametricEnv& env,
+                                            const Module* entry_module);
+  void NoteInstantiation(const Function* f, const ParametricEnv& env,
+                         TypeInfo* type_info);
+
+  // Counts of GetInstantiation() calls: a "hit" is an instantiation whose body
+  // had already been typechecked with the same parametric env.
+  const CacheStats& instantiation_cache_stats() const {
+    return instantiation_cache_stats_;
+  }
+
  private:
   // Mapping from module to the "root" (or "parentmost") type info -- these have
   // nullptr as their parent. There should only be one of these for any given
@@ -144,6 +207,17 @@ class TypeInfoOwner {
   // Owned type information objects -- TypeInfoOwner is the lifetime owner for
   // these.
   std::vector<std::unique_ptr<TypeInfo>> type_infos_;
+
+  // See NoteCreatedWhileTypechecking().
+  absl::flat_hash_map<const TypeInfo*, const Module*>
+      created_while_typechecking_;
+
+  // See GetInstantiation(). Keyed on the function, its env and the module whose
+  // typechecking created the instantiation.
+  absl::flat_hash_map<
+      std::tuple<const Function*, ParametricEnv, const Module*>, TypeInfo*>
+      instantiations_;
+  CacheStats instantiation_cache_stats_;
 };
 
 class TypeInfo {
@@ -281,6 +355,23 @@ class TypeInfo {
   std::optional<InterpValue> GetConstExprOption(
       const AstNode* const_expr) const;
 
+  // Memo of constexpr evaluations that completed without producing a value, so
+  // that deducing each enclosing expression does not re-walk (and potentially
+  // re-interpret) the same non-constexpr subtrees.
+  //
+  // Whether an expression is constexpr ultimately depends on which name
+  // definitions are constexpr (subexpressions are always deduced before the
+  // expressions that contain them), so entries are dropped whenever a new
+  // constexpr NameDef is noted anywhere in this type info tree. Entries are
+  // only consulted on this type info, never its parents: a node that is not
+  // constexpr in a generic context may well be in a parametric instantiation.
+  void NoteNonConstExprResult(const AstNode* node, const ParametricEnv& env);
+  bool IsCachedNonConstExprResult(const AstNode* node,
+                                  const ParametricEnv& env) const;
+  int64_t non_const_expr_cache_hits() const {
+    return non_const_expr_cache_hits_.load(std::memory_order_relaxed);
+  }
+
   // Retrieves a string that shows the module associated with this type info and
   // which imported modules are present, suitable for debugging.
   std::string GetImportsDebugString() const;
@@ -350,10 +441,32 @@ class TypeInfo {
   // a module.
   absl::flat_hash_map<const AstNode*, std::unique_ptr<Type>> dict_;
 
+  // Returns the constexpr entry for `node` in this type info's own mapping (not
+  // its parents'), or nullopt if there is none.
+  std::optional<std::optional<InterpValue>> FindLocalConstExpr(
+      const AstNode* node) const;
+
   // Node to constexpr-value mapping -- this is also present on "derived" type
   // info as constexprs take on different values in different parametric
   // instantiation contexts.
-  absl::flat_hash_map<const AstNode*, std::optional<InterpValue>> const_exprs_;
+  //
+  // Unlike the other mappings, constexpr values are also noted after
+  // typechecking (e.g. by constexpr evaluation during IR conversion, which may
+  // run on several threads), so this one is guarded by a mutex. Lookups, which
+  // dominate during typechecking, only take it shared.
+  mutable absl::Mutex const_exprs_mu_;
+  absl::flat_hash_map<const AstNode*, std::optional<InterpValue>> const_exprs_
+      ABSL_GUARDED_BY(const_exprs_mu_);
+
+  // Non-constexpr evaluation results, mapped to the value of the root's
+  // `const_name_def_generation_` at the time they were noted.
+  absl::flat_hash_map<std::pair<const AstNode*, ParametricEnv>, int64_t>
+      non_const_exprs_ ABSL_GUARDED_BY(const_exprs_mu_);
+  mutable std::atomic<int64_t> non_const_expr_cache_hits_ = 0;
+
+  // Only meaningful on the root type info: bumped every time a NameDef is noted
+  // as constexpr in any type info of the tree.
+  std::atomic<int64_t> const_name_def_generation_ = 0;
 
   // The following are only present on the root type info.
   absl::flat_hash_map<Import*, ImportedInfo> imports_;
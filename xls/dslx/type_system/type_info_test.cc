@@ -14,14 +14,19 @@
 
 #include "xls/dslx/type_system/type_info.h"
 
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "xls/common/casts.h"
 #include "xls/common/status/matchers.h"
 #include "xls/dslx/create_import_data.h"
@@ -31,10 +36,13 @@
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/dslx/type_system/parametric_env.h"
+#include "xls/dslx/type_system/typecheck_module.h"
+#include "xls/dslx/warning_collector.h"
 
 namespace xls::dslx {
 namespace {
 
+using status_testing::IsOkAndHolds;
 using status_testing::StatusIs;
 using testing::HasSubstr;
 
@@ -87,5 +95,162 @@ fn main() -> u32 {
                                  "present in parametric keys: {}")));
 }
 
+TEST(TypeInfoTest, InvocationsWithSameEnvShareInstantiation) {
+  ImportData import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(TypecheckedModule tm,
+                           ParseAndTypecheck(R"(
+fn p<N: u32>(x: bits[N]) -> bits[N] { x + bits[N]:1 }
+
+fn f() -> u8 { p(u8:1) }
+
+fn g() -> u8 { p(u8:2) + p(u8:3) }
+
+fn h() -> u16 { p(u16:4) }
+)",
+                                             "test.x", "test", &import_data));
+
+  // Two distinct instantiations of `p`, each deduced once.
+  const CacheStats& stats =
+      import_data.type_info_owner().instantiation_cache_stats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 2);
+
+  auto get_body_expr = [&](std::string_view fn_name) {
+    Function* fn = tm.module->GetFunctionByName().at(fn_name);
+    return ToAstNode(fn->body()->statements().at(0)->wrapped());
+  };
+  auto get_invocation = [&](std::string_view fn_name) {
+    return down_cast<const Invocation*>(get_body_expr(fn_name));
+  };
+  const Binop* g_add = down_cast<const Binop*>(get_body_expr("g"));
+  const Invocation* g_lhs = down_cast<const Invocation*>(g_add->lhs());
+  const Invocation* g_rhs = down_cast<const Invocation*>(g_add->rhs());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * f_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(get_invocation("f"),
+                                                 ParametricEnv()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * g_lhs_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(g_lhs, ParametricEnv()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * g_rhs_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(g_rhs, ParametricEnv()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * h_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(get_invocation("h"),
+                                                 ParametricEnv()));
+  EXPECT_EQ(f_ti, g_lhs_ti);
+  EXPECT_EQ(f_ti, g_rhs_ti);
+  EXPECT_NE(f_ti, h_ti);
+}
+
+TEST(TypeInfoTest, InstantiationSharedByParametricCallersIsNotDerivedFromThem) {
+  ImportData import_data = CreateImportDataForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(TypecheckedModule tm,
+                           ParseAndTypecheck(R"(
+fn p<N: u32>(x: bits[N]) -> bits[N] { x + bits[N]:1 }
+
+fn a<A: u32>(x: bits[A]) -> bits[A] { p(x) }
+
+fn b<B: u32>(x: bits[B]) -> bits[B] { p(x) }
+
+fn main() -> u8 { a(u8:1) + b(u8:2) }
+)",
+                                             "test.x", "test", &import_data));
+
+  auto get_body_expr = [&](std::string_view fn_name) {
+    Function* fn = tm.module->GetFunctionByName().at(fn_name);
+    return ToAstNode(fn->body()->statements().at(0)->wrapped());
+  };
+  auto get_body_invocation = [&](std::string_view fn_name) {
+    return down_cast<const Invocation*>(get_body_expr(fn_name));
+  };
+  const Binop* main_add = down_cast<const Binop*>(get_body_expr("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * a_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(
+          down_cast<const Invocation*>(main_add->lhs()), ParametricEnv()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * b_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(
+          down_cast<const Invocation*>(main_add->rhs()), ParametricEnv()));
+
+  const InterpValue u8_width = InterpValue::MakeU32(8);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * p_from_a_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(
+          get_body_invocation("a"),
+          ParametricEnv(absl::flat_hash_map<std::string, InterpValue>{
+              {"A", u8_width}})));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypeInfo * p_from_b_ti,
+      tm.type_info->GetInvocationTypeInfoOrError(
+          get_body_invocation("b"),
+          ParametricEnv(absl::flat_hash_map<std::string, InterpValue>{
+              {"B", u8_width}})));
+  EXPECT_EQ(p_from_a_ti, p_from_b_ti);
+
+  // The shared instantiation leads back to the module's root type info without
+  // passing through the type info of either caller's instantiation.
+  for (TypeInfo* ti = p_from_a_ti->parent(); ti != tm.type_info;
+       ti = ti->parent()) {
+    ASSERT_NE(ti, nullptr);
+    EXPECT_NE(ti, a_ti);
+    EXPECT_NE(ti, b_ti);
+  }
+  Function* p = tm.module->GetFunctionByName().at("p");
+  EXPECT_THAT(
+      p_from_a_ti->GetConstExpr(p->parametric_bindings().at(0)->name_def()),
+      IsOkAndHolds(u8_width));
+}
+
+TEST(TypeInfoTest, EvictModuleEvictsInstantiationsInImportedModules) {
+  ImportData import_data = CreateImportDataForTest();
+  constexpr std::string_view kProgram = R"(
+import std;
+
+fn f(x: u8) -> u8 { std::clog2(x) }
+
+fn g(x: u16) -> u16 { std::clog2(x) + std::clog2(x) }
+)";
+  // Typechecking the same module over and over (as the language server does
+  // for an edited buffer) must not accumulate type information in `std`.
+  std::optional<int64_t> type_info_count;
+  for (int64_t i = 0; i < 3; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Module> module,
+                             ParseModule(kProgram, "test.x", "test"));
+    WarningCollector warnings(import_data.enabled_warnings());
+    XLS_ASSERT_OK(
+        TypecheckModule(module.get(), &import_data, &warnings).status());
+    XLS_ASSERT_OK(import_data.EvictModule(module.get()));
+    if (type_info_count.has_value()) {
+      EXPECT_EQ(import_data.type_info_owner().size(), *type_info_count);
+    }
+    type_info_count = import_data.type_info_owner().size();
+  }
+}
+
+// Typechecks a module with `state.range(0)` functions that all call the same
+// apfloat instantiations.
+void BM_TypecheckApFloatUser(benchmark::State& state) {
+  std::string program = "import apfloat;\n";
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    absl::StrAppendFormat(&program, R"(
+fn f%d(x: apfloat::APFloat<u32:8, u32:23>, y: apfloat::APFloat<u32:8, u32:23>)
+    -> apfloat::APFloat<u32:8, u32:23> {
+  apfloat::add(apfloat::mul(x, y), y)
+}
+)",
+                          i);
+  }
+  for (auto _ : state) {
+    ImportData import_data = CreateImportDataForTest();
+    XLS_ASSERT_OK(
+        ParseAndTypecheck(program, "test.x", "test", &import_data).status());
+  }
+}
+BENCHMARK(BM_TypecheckApFloatUser)->Range(1, 64);
+
 }  // namespace
 }  // namespace xls::dslx
@@ -31,10 +31,12 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "xls/common/casts.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/proto_adaptor_utils.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/dslx/channel_direction.h"
+#include "xls/dslx/dslx_builtins.h"
 #include "xls/dslx/frontend/ast.h"
 #include "xls/dslx/frontend/ast_node.h"
 #include "xls/dslx/frontend/pos.h"
@@ -43,6 +45,7 @@
 #include "xls/dslx/type_system/parametric_expression.h"
 #include "xls/dslx/type_system/type.h"
 #include "xls/dslx/type_system/type_info.pb.h"
+#include "xls/ir/bits.h"
 
 namespace xls::dslx {
 namespace {
@@ -196,17 +199,44 @@ std::string U8sToString(absl::Span<const uint8_t> bs) {
   return std::string(reinterpret_cast<const char*>(bs.data()), bs.size());
 }
 
+void ToProto(bool is_signed, const Bits& bits, BitsValueProto* bvp) {
+  bvp->set_is_signed(is_signed);
+  bvp->set_bit_count(static_cast<int32_t>(bits.bit_count()));
+  // Bits::ToBytes is in little-endian format. The proto stores data in
+  // big-endian.
+  std::vector<uint8_t> bytes = bits.ToBytes();
+  std::reverse(bytes.begin(), bytes.end());
+  *bvp->mutable_data() = U8sToString(bytes);
+}
+
+absl::StatusOr<EnumDefProto> ToProto(const EnumDef& enum_def);
+
 absl::StatusOr<InterpValueProto> ToProto(const InterpValue& v) {
   InterpValueProto proto;
   if (v.IsBits()) {
-    BitsValueProto* bvp = proto.mutable_bits();
-    bvp->set_is_signed(v.IsSBits());
-    bvp->set_bit_count(static_cast<int32_t>(v.GetBitCount().value()));
-    // Bits::ToBytes is in little-endian format. The proto stores data in
-    // big-endian.
-    std::vector<uint8_t> bytes = v.GetBitsOrDie().ToBytes();
-    std::reverse(bytes.begin(), bytes.end());
-    *bvp->mutable_data() = U8sToString(bytes);
+    ToProto(v.IsSBits(), v.GetBitsOrDie(), proto.mutable_bits());
+  } else if (v.IsTuple() || v.IsArray()) {
+    InterpValueSequenceProto* seq =
+        v.IsTuple() ? proto.mutable_tuple() : proto.mutable_array();
+    for (const InterpValue& element : v.GetValuesOrDie()) {
+      XLS_ASSIGN_OR_RETURN(*seq->add_elements(), ToProto(element));
+    }
+  } else if (v.IsEnum()) {
+    InterpValue::EnumData enum_data = v.GetEnumData().value();
+    EnumValueProto* evp = proto.mutable_enum_value();
+    XLS_ASSIGN_OR_RETURN(*evp->mutable_enum_def(), ToProto(*enum_data.def));
+    ToProto(enum_data.is_signed, enum_data.value, evp->mutable_bits());
+  } else if (v.IsFunction()) {
+    const InterpValue::FnData& fn_data = v.GetFunctionOrDie();
+    if (std::holds_alternative<Builtin>(fn_data)) {
+      proto.mutable_function()->set_builtin(
+          BuiltinToString(std::get<Builtin>(fn_data)));
+    } else {
+      *proto.mutable_function()->mutable_user_fn_span() =
+          ToProto(std::get<InterpValue::UserFnData>(fn_data).function->span());
+    }
+  } else if (v.IsToken()) {
+    proto.set_token(true);
   } else {
     return absl::UnimplementedError(
         "TypeInfoProto: convert InterpValue to proto: " + v.ToString());
@@ -440,18 +470,21 @@ absl::Span<const uint8_t> ToU8Span(const std::string& s) {
                                    s.size());
 }
 
+Bits FromProto(const BitsValueProto& bvp) {
+  std::vector<uint8_t> bytes;
+  for (uint8_t i8 : ToU8Span(bvp.data())) {
+    bytes.push_back(i8);
+  }
+  // Bits::FromBytes expects data in little-endian format.
+  std::reverse(bytes.begin(), bytes.end());
+  return Bits::FromBytes(bytes, bvp.bit_count());
+}
+
 absl::StatusOr<InterpValue> FromProto(const InterpValueProto& ivp) {
   switch (ivp.value_oneof_case()) {
     case InterpValueProto::ValueOneofCase::kBits: {
-      std::vector<uint8_t> bytes;
-      for (uint8_t i8 : ToU8Span(ivp.bits().data())) {
-        bytes.push_back(i8);
-      }
-      // Bits::FromBytes expects data in little-endian format.
-      std::reverse(bytes.begin(), bytes.end());
-      return InterpValue::MakeBits(
-          ivp.bits().is_signed(),
-          Bits::FromBytes(bytes, ivp.bits().bit_count()));
+      return InterpValue::MakeBits(ivp.bits().is_signed(),
+                                   FromProto(ivp.bits()));
     }
     default:
       break;
@@ -724,6 +757,75 @@ absl::StatusOr<AstNodeKind> FromProto(AstNodeKindProto p) {
 
 }  // namespace
 
+SpanProto SpanToProto(const Span& span) { return ToProto(span); }
+
+Span SpanFromProto(const SpanProto& proto) { return FromProto(proto); }
+
+absl::StatusOr<InterpValueProto> InterpValueToProto(const InterpValue& v) {
+  return ToProto(v);
+}
+
+absl::StatusOr<InterpValue> InterpValueFromProto(
+    const InterpValueProto& proto, const ImportData& import_data) {
+  switch (proto.value_oneof_case()) {
+    case InterpValueProto::ValueOneofCase::kTuple:
+    case InterpValueProto::ValueOneofCase::kArray: {
+      bool is_tuple =
+          proto.value_oneof_case() == InterpValueProto::ValueOneofCase::kTuple;
+      const InterpValueSequenceProto& seq =
+          is_tuple ? proto.tuple() : proto.array();
+      std::vector<InterpValue> elements;
+      elements.reserve(seq.elements_size());
+      for (const InterpValueProto& element : seq.elements()) {
+        XLS_ASSIGN_OR_RETURN(InterpValue value,
+                             InterpValueFromProto(element, import_data));
+        elements.push_back(std::move(value));
+      }
+      if (is_tuple) {
+        return InterpValue::MakeTuple(std::move(elements));
+      }
+      return InterpValue::MakeArray(std::move(elements));
+    }
+    case InterpValueProto::ValueOneofCase::kEnumValue: {
+      const EnumValueProto& evp = proto.enum_value();
+      XLS_ASSIGN_OR_RETURN(
+          const EnumDef* enum_def,
+          import_data.FindEnumDef(FromProto(evp.enum_def().span())));
+      return InterpValue::MakeEnum(FromProto(evp.bits()),
+                                   evp.bits().is_signed(), enum_def);
+    }
+    case InterpValueProto::ValueOneofCase::kFunction: {
+      const FunctionValueProto& fvp = proto.function();
+      if (fvp.has_builtin()) {
+        XLS_ASSIGN_OR_RETURN(Builtin builtin,
+                             BuiltinFromString(fvp.builtin()));
+        return InterpValue::MakeFunction(builtin);
+      }
+      XLS_ASSIGN_OR_RETURN(
+          const AstNode* node,
+          import_data.FindNode(AstNodeKind::kFunction,
+                               FromProto(fvp.user_fn_span())));
+      // The interpreter does not mutate the functions it refers to, but
+      // UserFnData holds non-const pointers.
+      Function* f = const_cast<Function*>(down_cast<const Function*>(node));
+      return InterpValue::MakeFunction(InterpValue::UserFnData{f->owner(), f});
+    }
+    case InterpValueProto::ValueOneofCase::kToken:
+      return InterpValue::MakeToken();
+    default:
+      return FromProto(proto);
+  }
+}
+
+absl::StatusOr<TypeProto> TypeToProto(const Type& type) {
+  return ToProto(type);
+}
+
+absl::StatusOr<std::unique_ptr<Type>> TypeFromProto(
+    const TypeProto& proto, const ImportData& import_data) {
+  return FromProto(proto, import_data);
+}
+
 absl::StatusOr<std::string> ToHumanString(const AstNodeTypeInfoProto& antip,
                                           const ImportData& import_data) {
   XLS_ASSIGN_OR_RETURN(std::string type_str,
@@ -15,10 +15,14 @@
 #ifndef XLS_DSLX_TYPE_SYSTEM_TYPE_INFO_TO_PROTO_H_
 #define XLS_DSLX_TYPE_SYSTEM_TYPE_INFO_TO_PROTO_H_
 
+#include <memory>
 #include <string>
 
 #include "absl/status/statusor.h"
+#include "xls/dslx/frontend/pos.h"
 #include "xls/dslx/import_data.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/type_system/type.h"
 #include "xls/dslx/type_system/type_info.h"
 #include "xls/dslx/type_system/type_info.pb.h"
 
@@ -37,6 +41,22 @@ absl::StatusOr<std::string> ToHumanString(const AstNodeTypeInfoProto& antip,
 absl::StatusOr<std::string> ToHumanString(const TypeInfoProto& tip,
                                           const ImportData& import_data);
 
+// Conversions for the building blocks of the above, for use by other
+// serialized artifacts (e.g., bytecode). AST nodes referred to by the protos
+// (e.g., enum and struct definitions) are looked up in `import_data` by span,
+// so the corresponding modules must already be present there.
+SpanProto SpanToProto(const Span& span);
+Span SpanFromProto(const SpanProto& proto);
+
+// Supports bits, tuple, array, enum, function and token values.
+absl::StatusOr<InterpValueProto> InterpValueToProto(const InterpValue& v);
+absl::StatusOr<InterpValue> InterpValueFromProto(const InterpValueProto& proto,
+                                                 const ImportData& import_data);
+
+absl::StatusOr<TypeProto> TypeToProto(const Type& type);
+absl::StatusOr<std::unique_ptr<Type>> TypeFromProto(
+    const TypeProto& proto, const ImportData& import_data);
+
 }  // namespace xls::dslx
 
 #endif  // XLS_DSLX_TYPE_SYSTEM_TYPE_INFO_TO_PROTO_H_
@@ -78,7 +78,7 @@ static absl::StatusOr<std::unique_ptr<DeduceCtx>> GetImportedDeduceCtx(
 
   XLS_ASSIGN_OR_RETURN(
       TypeInfo * imported_type_info,
-      ctx->type_info_owner().New(imported->module, imported->type_info));
+      ctx->NewTypeInfo(imported->module, imported->type_info));
   std::unique_ptr<DeduceCtx> imported_ctx =
       ctx->MakeCtx(imported_type_info, imported->module);
   imported_ctx->AddFnStackEntry(FnStackEntry::MakeTop(imported->module));
@@ -86,6 +86,22 @@ static absl::StatusOr<std::unique_ptr<DeduceCtx>> GetImportedDeduceCtx(
   return imported_ctx;
 }
 
+// Returns a context for instantiating a function of the module of `ctx` whose
+// type info is the module's root type info. The caller must derive a type info
+// (see DeduceCtx::AddDerivedTypeInfo()) before recording anything in it. The
+// function stack is kept so that recursion is still detected.
+static absl::StatusOr<std::unique_ptr<DeduceCtx>> GetRootDeduceCtx(
+    DeduceCtx* ctx) {
+  XLS_ASSIGN_OR_RETURN(TypeInfo * root_type_info,
+                       ctx->type_info_owner().GetRootTypeInfo(ctx->module()));
+  std::unique_ptr<DeduceCtx> root_ctx =
+      ctx->MakeCtx(root_type_info, ctx->module());
+  for (const FnStackEntry& entry : ctx->fn_stack()) {
+    root_ctx->AddFnStackEntry(entry);
+  }
+  return root_ctx;
+}
+
 static absl::Status TypecheckIsAcceptableWideningCast(DeduceCtx* ctx,
                                                       const Invocation* node) {
   // Use type_info rather than ctx->Deduce as this Invocation's nodes have
@@ -389,6 +405,24 @@ absl::StatusOr<TypeAndParametricEnv> TypecheckInvocation(
     ctx = imported_ctx_holder.get();
   }
 
+  // The body of a (non-proc) function instantiation only depends on the
+  // callee's parametric env, so if some other invocation already caused the
+  // same instantiation we share its derived type info instead of deducing the
+  // body again. Procs are excluded: every proc instantiation needs its own
+  // constexpr data for its members (see below).
+  const bool memoizable =
+      !callee_fn.proc().has_value() && constexpr_env.empty();
+
+  // A shared instantiation must not see the type info of the particular caller
+  // that happened to cause it, so when the caller is itself a parametric
+  // instantiation in the same module, the callee's body is deduced under the
+  // module's root type info instead, as for calls into an imported module. The
+  // signature is still instantiated in the caller's context, so that nothing
+  // is allocated when the instantiation turns out to be memoized.
+  const bool instantiate_at_root = memoizable &&
+                                   imported_ctx_holder == nullptr &&
+                                   ctx->type_info()->parent() != nullptr;
+
   XLS_ASSIGN_OR_RETURN(std::vector<std::unique_ptr<Type>> param_types,
                        TypecheckFunctionParams(callee_fn, ctx));
 
@@ -428,6 +462,26 @@ absl::StatusOr<TypeAndParametricEnv> TypecheckInvocation(
   parent_ctx->type_info()->SetItem(invocation->callee(), instantiated_ft);
   ctx->type_info()->SetItem(callee_fn.name_def(), instantiated_ft);
 
+  if (memoizable) {
+    std::optional<TypeInfo*> instantiation =
+        ctx->type_info_owner().GetInstantiation(
+            &callee_fn, callee_tab.parametric_env, ctx->GetEntryModule());
+    if (instantiation.has_value()) {
+      XLS_VLOG(5) << "Reusing instantiation of `" << callee_fn.identifier()
+                  << "` with env " << callee_tab.parametric_env
+                  << " for invocation: `" << invocation->ToString() << "`";
+      XLS_RETURN_IF_ERROR(parent_ctx->type_info()->AddInvocationTypeInfo(
+          *invocation, caller, caller_parametric_env,
+          callee_tab.parametric_env, instantiation.value()));
+      return callee_tab;
+    }
+  }
+
+  if (instantiate_at_root) {
+    XLS_ASSIGN_OR_RETURN(imported_ctx_holder, GetRootDeduceCtx(ctx));
+    ctx = imported_ctx_holder.get();
+  }
+
   // We need to deduce fn body, so we're going to call Deduce, which means we'll
   // need a new stack entry w/the new symbolic bindings.
   TypeInfo* const original_ti = parent_ctx->type_info();
@@ -435,6 +489,12 @@ absl::StatusOr<TypeAndParametricEnv> TypecheckInvocation(
       callee_fn, callee_tab.parametric_env, invocation,
       callee_fn.proc().has_value() ? WithinProc::kYes : WithinProc::kNo));
   TypeInfo* const derived_type_info = ctx->AddDerivedTypeInfo();
+  if (instantiate_at_root) {
+    // The signature was recorded in the caller's type info, which the root
+    // derived one cannot see.
+    ctx->type_info()->SetItem(callee_fn.name_def(), instantiated_ft);
+    XLS_RETURN_IF_ERROR(TypecheckFunctionParams(callee_fn, ctx).status());
+  }
 
   // We execute this function if we're parametric or a proc. In either case, we
   // want to create a new TypeInfo. The reason for the former is obvious. The
@@ -531,6 +591,10 @@ absl::StatusOr<TypeAndParametricEnv> TypecheckInvocation(
 
   XLS_RETURN_IF_ERROR(ctx->PopDerivedTypeInfo(derived_type_info));
   ctx->PopFnStackEntry();
+  if (memoizable) {
+    ctx->type_info_owner().NoteInstantiation(
+        &callee_fn, callee_tab.parametric_env, derived_type_info);
+  }
 
   // Implementation note: though we could have all functions have
   // NoteRequiresImplicitToken() be false unless otherwise noted, this helps
@@ -48,6 +48,10 @@ DelayManager::DelayManager(FunctionBase *function,
       indices_to_critical_operand_(
           function_->node_count(),
           std::vector<Node *>(function_->node_count(), nullptr)),
+      row_versions_(function_->node_count(), 0),
+      column_versions_(function_->node_count(), 0),
+      row_evaluation_times_(function_->node_count(), -1),
+      column_evaluation_times_(function_->node_count(), -1),
       name_(delay_estimator.name()) {
   // Get the mapping between function node and their index. Also, estimate the
   // delay of each node.
@@ -91,15 +95,27 @@ absl::Status DelayManager::SetCriticalPathDelay(Node *from, Node *to,
   }
   int64_t from_index = node_to_index_.at(from);
   int64_t to_index = node_to_index_.at(to);
-  int64_t &current_delay = indices_to_delay_[from_index][to_index];
+  int64_t current_delay = indices_to_delay_[from_index][to_index];
   if (!if_shorter || current_delay > delay) {
     if (!if_exist || current_delay != -1) {
-      current_delay = delay;
+      SetDelay(from_index, to_index, delay);
     }
   }
   return absl::OkStatus();
 }
 
+void DelayManager::SetDelay(int64_t from_index, int64_t to_index,
+                            int64_t delay) {
+  int64_t &current_delay = indices_to_delay_[from_index][to_index];
+  if (current_delay == delay) {
+    return;
+  }
+  current_delay = delay;
+  ++version_;
+  row_versions_[from_index] = version_;
+  column_versions_[to_index] = version_;
+}
+
 absl::StatusOr<std::vector<Node *>> DelayManager::GetFullCriticalPath(
     Node *from, Node *to) const {
   int64_t from_index = node_to_index_.at(from);
@@ -124,6 +140,17 @@ void DelayManager::PropagateDelays() {
   // Traverse the function in a reversed topological order.
   for (Node *node : ReverseTopoSort(function_)) {
     int64_t node_index = node_to_index_[node];
+    // The delays from `node` only depend on the delays from `node` and its
+    // users; skip it if none of them have changed since it was last evaluated.
+    int64_t evaluation_time = row_evaluation_times_[node_index];
+    if (row_versions_[node_index] <= evaluation_time &&
+        std::all_of(node->users().begin(), node->users().end(),
+                    [&](Node *user) {
+                      return row_versions_[node_to_index_[user]] <=
+                             evaluation_time;
+                    })) {
+      continue;
+    }
     int64_t node_delay = indices_to_delay_[node_index][node_index];
     std::vector<int64_t> new_delays(function_->node_count(), -1);
 
@@ -145,17 +172,30 @@ void DelayManager::PropagateDelays() {
     // Update the original delay if the newly calculated delay is smaller.
     for (int64_t i = 0; i < function_->node_count(); ++i) {
       if (new_delays[i] != -1) {
-        int64_t &current_delay = indices_to_delay_[node_index][i];
+        int64_t current_delay = indices_to_delay_[node_index][i];
         if (current_delay >= new_delays[i] || current_delay == -1) {
-          current_delay = new_delays[i];
+          SetDelay(node_index, i, new_delays[i]);
         }
       }
     }
+    row_evaluation_times_[node_index] = version_;
   }
 
   // Traverse the function in a topological order.
   for (Node *node : TopoSort(function_)) {
     int64_t node_index = node_to_index_[node];
+    // The delays to `node` only depend on the delays to `node` and its
+    // operands; skip it if none of them have changed since it was last
+    // evaluated.
+    int64_t evaluation_time = column_evaluation_times_[node_index];
+    if (column_versions_[node_index] <= evaluation_time &&
+        std::all_of(node->operands().begin(), node->operands().end(),
+                    [&](Node *operand) {
+                      return column_versions_[node_to_index_[operand]] <=
+                             evaluation_time;
+                    })) {
+      continue;
+    }
     int64_t node_delay = indices_to_delay_[node_index][node_index];
     std::vector<int64_t> new_delays(function_->node_count(), -1);
     std::vector<Node *> new_critical_operands(function_->node_count(), nullptr);
@@ -179,14 +219,15 @@ void DelayManager::PropagateDelays() {
     // Update the original delay if the newly calculated delay is smaller.
     for (int64_t i = 0; i < function_->node_count(); ++i) {
       if (new_delays[i] != -1) {
-        int64_t &current_delay = indices_to_delay_[i][node_index];
+        int64_t current_delay = indices_to_delay_[i][node_index];
         if (current_delay >= new_delays[i] || current_delay == -1) {
-          current_delay = new_delays[i];
+          SetDelay(i, node_index, new_delays[i]);
           indices_to_critical_operand_[i][node_index] =
               new_critical_operands[i];
         }
       }
     }
+    column_evaluation_times_[node_index] = version_;
   }
 }
 
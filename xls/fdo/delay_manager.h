@@ -101,6 +101,10 @@ class DelayManager {
   // topological order once. Note that this method is not optimal - it cannot
   // find the best combination of partial paths as Floyd–Warshall but it's
   // complexity is in O(n^2).
+  //
+  // The propagation is incremental: a node is only re-evaluated if the delays
+  // it is computed from have changed since it was last evaluated, so after a
+  // few local updates only the cones of the updated paths are visited.
   void PropagateDelays();
 
   // Get all the paths whose delay is longer than the given delay threshold.
@@ -133,6 +137,10 @@ class DelayManager {
   static float GetZeroScore(Node *from, Node *to) { return 0.0; }
   static bool GetFalse(Node *from, Node *to) { return false; }
 
+  // Sets the delay between the nodes with the given indices, recording the
+  // change in the row and column versions if the delay differs.
+  void SetDelay(int64_t from_index, int64_t to_index, int64_t delay);
+
   FunctionBase *function_;
 
   // A mapping from a node to its index in the function.
@@ -150,6 +158,17 @@ class DelayManager {
   // critical operand of the target node.
   std::vector<std::vector<Node *>> indices_to_critical_operand_;
 
+  // Bookkeeping for incremental propagation. `version_` is a logical clock
+  // which is advanced on every change of a delay. The row (column) version of a
+  // node is the time of the last change of a delay from (to) the node, and the
+  // row (column) evaluation time is the time at which the reversed (forward)
+  // propagation pass last computed the delays from (to) the node.
+  int64_t version_ = 0;
+  std::vector<int64_t> row_versions_;
+  std::vector<int64_t> column_versions_;
+  std::vector<int64_t> row_evaluation_times_;
+  std::vector<int64_t> column_evaluation_times_;
+
   // Name of the delay estimator.
   const std::string name_;
 };
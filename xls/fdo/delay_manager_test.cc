@@ -19,9 +19,16 @@
 #include <string>
 #include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/random/distributions.h"
+#include "absl/random/random.h"
+#include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/function.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/ir_test_base.h"
@@ -31,6 +38,8 @@
 namespace xls {
 namespace {
 
+using status_testing::IsOkAndHolds;
+
 class DelayManagerTest : public IrTestBase {};
 
 // Smoke test.
@@ -176,5 +185,89 @@ fn main(i0: bits[3], i1: bits[3]) -> bits[3] {
   EXPECT_EQ(new_udiv3_i0_delay, -1);
 }
 
+TEST_F(DelayManagerTest, RepeatedPropagation) {
+  std::string ir_text = R"(
+package p
+
+fn main(x: bits[8]) -> bits[8] {
+  add.1: bits[8] = add(x, x)
+  neg.2: bits[8] = neg(add.1)
+  not.3: bits[8] = not(neg.2)
+  ret neg.4: bits[8] = neg(not.3)
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(ir_text));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, package->GetFunction("main"));
+  Node *x = FindNode("x", function);
+  Node *add1 = FindNode("add.1", function);
+  Node *neg2 = FindNode("neg.2", function);
+  Node *not3 = FindNode("not.3", function);
+  Node *neg4 = FindNode("neg.4", function);
+
+  DelayManager dm(function, TestDelayEstimator());
+  EXPECT_THAT(dm.GetCriticalPathDelay(x, neg4), IsOkAndHolds(4));
+
+  // Shortening a path in the middle of the chain shortens every path through
+  // it, in both the reversed and the forward propagation pass.
+  XLS_EXPECT_OK(dm.SetCriticalPathDelay(neg2, not3, 1));
+  dm.PropagateDelays();
+  EXPECT_THAT(dm.GetCriticalPathDelay(add1, not3), IsOkAndHolds(2));
+  EXPECT_THAT(dm.GetCriticalPathDelay(x, not3), IsOkAndHolds(2));
+  EXPECT_THAT(dm.GetCriticalPathDelay(neg2, neg4), IsOkAndHolds(2));
+  EXPECT_THAT(dm.GetCriticalPathDelay(x, neg4), IsOkAndHolds(3));
+  EXPECT_THAT(dm.GetCriticalPathDelay(add1, neg2), IsOkAndHolds(2));
+
+  // Propagating again without any updates changes nothing.
+  dm.PropagateDelays();
+  EXPECT_THAT(dm.GetCriticalPathDelay(x, neg4), IsOkAndHolds(3));
+  EXPECT_THAT(dm.GetCriticalPathDelay(add1, neg2), IsOkAndHolds(2));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Node *> critical_path,
+                           dm.GetFullCriticalPath(x, neg4));
+  EXPECT_EQ(critical_path, std::vector<Node *>({x, add1, neg2, not3, neg4}));
+
+  // A second update is propagated through its own cone while the result of
+  // the first is kept.
+  XLS_EXPECT_OK(dm.SetCriticalPathDelay(x, add1, 0));
+  dm.PropagateDelays();
+  EXPECT_THAT(dm.GetCriticalPathDelay(x, add1), IsOkAndHolds(0));
+  EXPECT_THAT(dm.GetCriticalPathDelay(x, neg2), IsOkAndHolds(1));
+  EXPECT_THAT(dm.GetCriticalPathDelay(add1, neg4), IsOkAndHolds(3));
+  EXPECT_THAT(dm.GetCriticalPathDelay(neg2, neg4), IsOkAndHolds(2));
+}
+
+// Models the delay updates of iterative SDC scheduling: each iteration
+// shortens the delay of a few paths and re-propagates the delays. Args: tree
+// depth, paths updated per iteration.
+void BM_IterativeDelayUpdates(benchmark::State &state) {
+  Package p("balanced_tree_pkg");
+  absl::StatusOr<Function *> f = benchmark_support::GenerateBalancedTree(
+      &p, /*depth=*/state.range(0), /*fan_out=*/2,
+      benchmark_support::strategy::BinaryAdd(),
+      benchmark_support::strategy::DistinctLiteral());
+  CHECK_OK(f.status());
+  std::vector<Node *> nodes((*f)->nodes().begin(), (*f)->nodes().end());
+  TestDelayEstimator delay_estimator;
+  DelayManager dm(*f, delay_estimator);
+  absl::BitGen bit_gen;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(1); ++i) {
+      Node *from = nodes[absl::Uniform<size_t>(bit_gen, 0, nodes.size())];
+      if (from->users().empty()) {
+        continue;
+      }
+      Node *to = *from->users().begin();
+      absl::StatusOr<int64_t> delay = dm.GetCriticalPathDelay(from, to);
+      CHECK_OK(delay.status());
+      CHECK_OK(dm.SetCriticalPathDelay(from, to,
+                                       std::max<int64_t>(*delay - 1, 0)));
+    }
+    dm.PropagateDelays();
+  }
+  state.counters["nodes"] = (*f)->node_count();
+}
+
+BENCHMARK(BM_IterativeDelayUpdates)->ArgsProduct({{6, 8, 10}, {1, 16}});
+
 }  // namespace
 }  // namespace xls
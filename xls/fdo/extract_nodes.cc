@@ -15,15 +15,18 @@
 #include "xls/fdo/extract_nodes.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "xls/codegen/block_conversion.h"
 #include "xls/codegen/block_generator.h"
 #include "xls/codegen/codegen_options.h"
@@ -42,11 +45,22 @@
 
 namespace xls {
 
-absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
-    const absl::flat_hash_set<Node*>& nodes,
-    std::string_view top_module_name,
-    bool flop_inputs_outputs, bool return_all_liveouts) {
+namespace {
+
+// A function holding a copy of a set of extracted nodes, along with the
+// temporary package which owns its types.
+struct ExtractedFunction {
+  std::unique_ptr<Package> package;
+  std::unique_ptr<Function> function;
+};
 
+// Copies the given set of nodes into a new function in a new package. Operands
+// from outside the set become parameters, and the live-outs of the set are
+// gathered into the return value. Returns std::nullopt if the set contains
+// nothing but token-typed nodes.
+absl::StatusOr<std::optional<ExtractedFunction>> ExtractNodesIntoFunction(
+    const absl::flat_hash_set<Node*>& nodes, std::string_view top_module_name,
+    bool return_all_liveouts) {
   XLS_RET_CHECK(!nodes.empty());
   FunctionBase* f = (*nodes.begin())->function_base();
   XLS_RET_CHECK(std::all_of(nodes.begin(), nodes.end(), [&](Node* node) {
@@ -84,8 +98,7 @@ absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
   // If the list is empty now, that's because the fragment had
   //   nothing except token ops; just return no value
   if (topo_sorted_nodes.empty()) {
-    std::optional<std::string> no_value;
-    return no_value;
+    return std::nullopt;
   }
 
   // Here, we create a temporary package for holding the temporary function. The
@@ -164,6 +177,23 @@ absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
       XLS_RETURN_IF_ERROR(tmp_f->set_return_value(return_tuple));
     }
   }
+  return ExtractedFunction{.package = std::move(tmp_package),
+                           .function = std::move(tmp_f)};
+}
+
+}  // namespace
+
+absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
+    const absl::flat_hash_set<Node*>& nodes,
+    std::string_view top_module_name,
+    bool flop_inputs_outputs, bool return_all_liveouts) {
+  XLS_ASSIGN_OR_RETURN(
+      std::optional<ExtractedFunction> extracted,
+      ExtractNodesIntoFunction(nodes, top_module_name, return_all_liveouts));
+  if (!extracted.has_value()) {
+    return std::nullopt;
+  }
+  Function* tmp_f = extracted->function.get();
 
   // With the temporary function, we convert it to a combinational block. If
   // flop_inputs_outputs is set, we insert registers to the inputs and outputs.
@@ -173,7 +203,7 @@ absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
     options.entry(top_module_name);
     XLS_ASSIGN_OR_RETURN(
         verilog::CodegenPassUnit unit,
-        verilog::FunctionToCombinationalBlock(tmp_f.get(), options));
+        verilog::FunctionToCombinationalBlock(tmp_f, options));
     XLS_RET_CHECK_NE(unit.top_block, nullptr);
     tmp_block = unit.top_block;
   } else {
@@ -192,10 +222,10 @@ absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
         .flop_inputs(true)
         .flop_outputs(true);
 
-    PipelineSchedule schedule(tmp_f.get(), cycle_map, 1);
+    PipelineSchedule schedule(tmp_f, cycle_map, 1);
     XLS_ASSIGN_OR_RETURN(
         verilog::CodegenPassUnit unit,
-        verilog::FunctionBaseToPipelinedBlock(schedule, options, tmp_f.get()));
+        verilog::FunctionBaseToPipelinedBlock(schedule, options, tmp_f));
     XLS_RET_CHECK_NE(unit.top_block, nullptr);
     tmp_block = unit.top_block;
   }
@@ -207,4 +237,25 @@ absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
   return verilog_text;
 }
 
+absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetCanonicalKey(
+    const absl::flat_hash_set<Node*>& nodes, bool return_all_liveouts) {
+  XLS_ASSIGN_OR_RETURN(std::optional<ExtractedFunction> extracted,
+                       ExtractNodesIntoFunction(nodes, "canonical",
+                                                return_all_liveouts));
+  if (!extracted.has_value()) {
+    return std::nullopt;
+  }
+  // Node ids are already canonical as the nodes were created in a fixed order
+  // in a fresh package, so only the names and locations carried over
+  // from the source function need to be erased.
+  int64_t param_count = 0;
+  int64_t node_count = 0;
+  for (Node* node : TopoSort(extracted->function.get())) {
+    node->SetName(node->Is<Param>() ? absl::StrCat("p", param_count++)
+                                    : absl::StrCat("n", node_count++));
+    node->SetLoc(SourceInfo());
+  }
+  return extracted->function->DumpIr();
+}
+
 }  // namespace xls
@@ -15,6 +15,7 @@
 #ifndef XLS_FDO_EXTRACT_NODES_H_
 #define XLS_FDO_EXTRACT_NODES_H_
 
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -30,6 +31,17 @@ absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetVerilog(
     const absl::flat_hash_set<Node*>& nodes, std::string_view top_module_name,
     bool flop_inputs_outputs = false, bool return_all_liveouts = false);
 
+// Returns a textual key for the given set of nodes which is independent of the
+// names, ids and source locations of the nodes. Node sets which would be
+// extracted into structurally identical modules, e.g. the same subgraph taken
+// from different functions or packages, map to the same key provided their
+// nodes are visited in the same topological order. The key is suitable for
+// caching the results of synthesizing the extracted module. Returns
+// std::nullopt if the set has nothing to extract (see
+// ExtractNodesAndGetVerilog).
+absl::StatusOr<std::optional<std::string>> ExtractNodesAndGetCanonicalKey(
+    const absl::flat_hash_set<Node*>& nodes, bool return_all_liveouts = false);
+
 }  // namespace xls
 
 #endif  // XLS_FDO_EXTRACT_NODES_H_
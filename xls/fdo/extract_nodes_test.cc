@@ -16,18 +16,25 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/function.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
 
 namespace xls {
 namespace {
 
+using ::testing::HasSubstr;
+using ::testing::Not;
+
 class ExtractNodesTest : public IrTestBase {};
 
 TEST_F(ExtractNodesTest, SimpleExtraction) {
@@ -176,5 +183,58 @@ endmodule
             expected_all_liveouts_verilog_text);
 }
 
+TEST_F(ExtractNodesTest, CanonicalKeyIgnoresNamesAndIds) {
+  auto get_key = [&](std::string_view ir_text)
+      -> absl::StatusOr<std::optional<std::string>> {
+    XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
+    XLS_ASSIGN_OR_RETURN(Function * function, package->GetFunction("main"));
+    absl::flat_hash_set<Node*> nodes;
+    for (Node* node : function->nodes()) {
+      if (!node->Is<Param>() && node != function->return_value()) {
+        nodes.insert(node);
+      }
+    }
+    return ExtractNodesAndGetCanonicalKey(nodes);
+  };
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::optional<std::string> key, get_key(R"(
+package p
+
+fn main(i0: bits[3], i1: bits[3]) -> bits[3] {
+  add.1: bits[3] = add(i0, i1)
+  literal.2: bits[3] = literal(value=1)
+  sub.3: bits[3] = sub(add.1, literal.2)
+  ret or.4: bits[3] = or(sub.3, add.1)
+}
+)"));
+  ASSERT_TRUE(key.has_value());
+  EXPECT_THAT(*key, Not(HasSubstr("add.1")));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::optional<std::string> renamed_key, get_key(R"(
+package q
+
+fn main(x: bits[3], y: bits[3]) -> bits[3] {
+  sum: bits[3] = add(x, y, id=7)
+  one: bits[3] = literal(value=1, id=8)
+  diff: bits[3] = sub(sum, one, id=9)
+  ret result: bits[3] = or(diff, sum, id=10)
+}
+)"));
+  EXPECT_EQ(key, renamed_key);
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::optional<std::string> other_literal_key,
+                           get_key(R"(
+package r
+
+fn main(i0: bits[3], i1: bits[3]) -> bits[3] {
+  add.1: bits[3] = add(i0, i1)
+  literal.2: bits[3] = literal(value=2)
+  sub.3: bits[3] = sub(add.1, literal.2)
+  ret or.4: bits[3] = or(sub.3, add.1)
+}
+)"));
+  EXPECT_NE(key, other_literal_key);
+}
+
 }  // namespace
 }  // namespace xls
@@ -14,46 +14,58 @@
 
 #include "xls/fdo/synthesizer.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/thread.h"
 #include "xls/fdo/extract_nodes.h"
+#include "xls/fdo/synthesis_delay_cache.pb.h"
+#include "xls/ir/function_base.h"
 #include "xls/ir/node.h"
+#include "xls/ir/topo_sort.h"
 #include "xls/synthesis/synthesis.pb.h"
 
 namespace xls {
 namespace synthesis {
 
+Synthesizer::Synthesizer(std::string_view name, int64_t max_concurrency)
+    : name_(name),
+      max_concurrency_(max_concurrency > 0 ? max_concurrency
+                                           : AvailableCPUs()) {}
+
 absl::StatusOr<std::vector<int64_t>>
 Synthesizer::SynthesizeNodesConcurrentlyAndGetDelays(
     absl::Span<const absl::flat_hash_set<Node *>> nodes_list) const {
-  // Launches multi-threading delay estimation.
-  std::vector<absl::StatusOr<int64_t>> results;
-  std::vector<std::unique_ptr<Thread>> threads;
-  results.reserve(nodes_list.size());
-  absl::StatusOr<int64_t> init_val = 0;
-  for (const absl::flat_hash_set<Node *> &nodes : nodes_list) {
-    results.push_back(init_val);
-    absl::StatusOr<int64_t> &dest = results.back();
-    // TODO(hanchenye): 2023-08-14 Use a thread pool structure that we can
-    // schedule on.
-    threads.push_back(std::make_unique<Thread>(
-        [&]() { dest = SynthesizeNodesAndGetDelay(nodes); }));
-  }
+  // Launches multi-threading delay estimation. Each worker repeatedly claims
+  // the next unsynthesized set of nodes, so no more than max_concurrency()
+  // synthesis runs are in flight however many sets there are.
+  std::vector<absl::StatusOr<int64_t>> results(nodes_list.size(), int64_t{0});
+  ParallelFor(nodes_list.size(), max_concurrency_, [&](int64_t i) {
+    results[i] = SynthesizeNodesAndGetDelay(nodes_list[i]);
+  });
 
   // Records the estimated delays.
-  for (auto &t : threads) {
-    t->Join();
-  }
   std::vector<int64_t> delay_list;
   delay_list.reserve(results.size());
   for (absl::StatusOr<int64_t> result : results) {
@@ -90,5 +102,160 @@ absl::StatusOr<int64_t> YosysSynthesizer::SynthesizeNodesAndGetDelay(
   return nodes_delay;
 }
 
+absl::StatusOr<int64_t> FakeSynthesizer::SynthesizeVerilogAndGetDelay(
+    std::string_view verilog_text, std::string_view top_module_name) const {
+  return absl::UnimplementedError(
+      "The fake synthesizer cannot synthesize Verilog text");
+}
+
+absl::StatusOr<int64_t> FakeSynthesizer::SynthesizeNodesAndGetDelay(
+    const absl::flat_hash_set<Node *> &nodes) const {
+  XLS_RET_CHECK(!nodes.empty());
+  FunctionBase *f = (*nodes.begin())->function_base();
+  absl::flat_hash_map<Node *, int64_t> arrival_times;
+  int64_t critical_path_delay = 0;
+  for (Node *node : TopoSort(f)) {
+    if (!nodes.contains(node)) {
+      continue;
+    }
+    int64_t operand_arrival_time = 0;
+    for (Node *operand : node->operands()) {
+      auto it = arrival_times.find(operand);
+      if (it != arrival_times.end()) {
+        operand_arrival_time = std::max(operand_arrival_time, it->second);
+      }
+    }
+    XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                         delay_estimator_.GetOperationDelayInPs(node));
+    int64_t arrival_time = operand_arrival_time + node_delay;
+    arrival_times[node] = arrival_time;
+    critical_path_delay = std::max(critical_path_delay, arrival_time);
+  }
+  if (synthesis_latency_ > absl::ZeroDuration()) {
+    absl::SleepFor(synthesis_latency_);
+  }
+  ++synthesis_count_;
+  return critical_path_delay;
+}
+
+absl::StatusOr<std::unique_ptr<CachingSynthesizer>> CachingSynthesizer::Create(
+    std::unique_ptr<Synthesizer> synthesizer,
+    std::optional<std::filesystem::path> cache_path) {
+  SynthesisDelayCacheProto cache_proto;
+  if (cache_path.has_value() && FileExists(*cache_path).ok()) {
+    // The cache only saves time, so a corrupt or unreadable one is replaced
+    // rather than failing the run.
+    if (absl::Status status = ParseProtobinFile(*cache_path, &cache_proto);
+        !status.ok()) {
+      XLS_LOG(WARNING) << "Ignoring unreadable synthesis cache " << *cache_path
+                       << ": " << status;
+      cache_proto.Clear();
+    }
+  }
+  std::string configuration = synthesizer->GetConfigurationKey();
+  auto caching_synthesizer = absl::WrapUnique(
+      new CachingSynthesizer(std::move(synthesizer), std::move(cache_path)));
+  absl::MutexLock lock(&caching_synthesizer->mutex_);
+  for (const SynthesisDelayCacheEntryProto &entry : cache_proto.entries()) {
+    if (entry.configuration() == configuration) {
+      caching_synthesizer->delays_[entry.nodes()] = entry.delay_ps();
+    }
+  }
+  XLS_VLOG(1) << "Loaded " << caching_synthesizer->delays_.size()
+              << " cached delays for synthesizer " << configuration;
+  caching_synthesizer->cache_proto_ = std::move(cache_proto);
+  return caching_synthesizer;
+}
+
+CachingSynthesizer::~CachingSynthesizer() {
+  if (absl::Status status = Flush(); !status.ok()) {
+    XLS_LOG(WARNING) << "Could not write synthesis cache " << *cache_path_
+                     << ": " << status;
+  }
+}
+
+absl::Status CachingSynthesizer::Flush() {
+  absl::MutexLock lock(&mutex_);
+  if (!cache_path_.has_value() || !dirty_) {
+    return absl::OkStatus();
+  }
+  XLS_RETURN_IF_ERROR(SetProtobinFileAtomically(*cache_path_, cache_proto_));
+  dirty_ = false;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<int64_t> CachingSynthesizer::SynthesizeVerilogAndGetDelay(
+    std::string_view verilog_text, std::string_view top_module_name) const {
+  return synthesizer_->SynthesizeVerilogAndGetDelay(verilog_text,
+                                                     top_module_name);
+}
+
+absl::StatusOr<int64_t> CachingSynthesizer::SynthesizeNodesAndGetDelay(
+    const absl::flat_hash_set<Node *> &nodes) const {
+  XLS_ASSIGN_OR_RETURN(std::vector<int64_t> delays,
+                       SynthesizeNodesConcurrentlyAndGetDelays({nodes}));
+  return delays.front();
+}
+
+absl::StatusOr<std::vector<int64_t>>
+CachingSynthesizer::SynthesizeNodesConcurrentlyAndGetDelays(
+    absl::Span<const absl::flat_hash_set<Node *>> nodes_list) const {
+  // Node sets with nothing to extract (see ExtractNodesAndGetVerilog) have no
+  // key; like the synthesizers themselves, report zero delay for them.
+  std::vector<std::optional<std::string>> keys;
+  keys.reserve(nodes_list.size());
+  for (const absl::flat_hash_set<Node *> &nodes : nodes_list) {
+    XLS_ASSIGN_OR_RETURN(std::optional<std::string> key,
+                         ExtractNodesAndGetCanonicalKey(nodes));
+    keys.push_back(std::move(key));
+  }
+
+  // Collects the node sets which miss in the cache, synthesizing each distinct
+  // key only once.
+  std::vector<absl::flat_hash_set<Node *>> misses;
+  std::vector<const std::string *> miss_keys;
+  {
+    absl::MutexLock lock(&mutex_);
+    absl::flat_hash_set<std::string_view> pending;
+    for (int64_t i = 0; i < nodes_list.size(); ++i) {
+      if (!keys[i].has_value()) {
+        continue;
+      }
+      if (delays_.contains(*keys[i])) {
+        ++hit_count_;
+      } else if (pending.insert(*keys[i]).second) {
+        ++miss_count_;
+        misses.push_back(nodes_list[i]);
+        miss_keys.push_back(&*keys[i]);
+      }
+    }
+  }
+
+  // The lock is not held while synthesizing so that other callers can still
+  // be answered from the cache.
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<int64_t> miss_delays,
+      synthesizer_->SynthesizeNodesConcurrentlyAndGetDelays(misses));
+
+  absl::MutexLock lock(&mutex_);
+  if (!misses.empty()) {
+    std::string configuration = synthesizer_->GetConfigurationKey();
+    for (int64_t i = 0; i < misses.size(); ++i) {
+      delays_[*miss_keys[i]] = miss_delays[i];
+      SynthesisDelayCacheEntryProto *entry = cache_proto_.add_entries();
+      entry->set_configuration(configuration);
+      entry->set_nodes(*miss_keys[i]);
+      entry->set_delay_ps(miss_delays[i]);
+    }
+    dirty_ = true;
+  }
+  std::vector<int64_t> delay_list;
+  delay_list.reserve(nodes_list.size());
+  for (const std::optional<std::string> &key : keys) {
+    delay_list.push_back(key.has_value() ? delays_.at(*key) : 0);
+  }
+  return delay_list;
+}
+
 }  // namespace synthesis
 }  // namespace xls
@@ -15,14 +15,26 @@
 #ifndef XLS_FDO_SYNTHESIZER_H_
 #define XLS_FDO_SYNTHESIZER_H_
 
+#include <atomic>
 #include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/fdo/synthesis_delay_cache.pb.h"
 #include "xls/ir/node.h"
 #include "xls/synthesis/yosys/yosys_synthesis_service.h"
 
@@ -32,10 +44,20 @@ namespace synthesis {
 // An abstract class of a synthesis service.
 class Synthesizer {
  public:
-  explicit Synthesizer(std::string_view name) : name_(name) {}
+  // "max_concurrency" bounds the number of syntheses run at once by
+  // SynthesizeNodesConcurrentlyAndGetDelays. If zero, one synthesis is run per
+  // available CPU.
+  explicit Synthesizer(std::string_view name, int64_t max_concurrency = 0);
   virtual ~Synthesizer() = default;
 
   const std::string &name() const { return name_; }
+  int64_t max_concurrency() const { return max_concurrency_; }
+
+  // Returns a string identifying this synthesizer and all of its settings which
+  // affect the reported delays (e.g., tools, cell libraries and target
+  // frequency). Two synthesizers with the same key must report the same delay
+  // for the same module; this is what allows delays to be cached across runs.
+  virtual std::string GetConfigurationKey() const { return name_; }
 
   // Synthesizes the given Verilog module with a synthesis tool and return its
   // overall delay.
@@ -51,14 +73,17 @@ class Synthesizer {
       const absl::flat_hash_set<Node *> &nodes) const = 0;
 
   // Launches "SynthesizeNodesAndGetDelay" concurrently for each set of nodes
-  // listed in "nodes_list" and get their delays.
-  absl::StatusOr<std::vector<int64_t>> SynthesizeNodesConcurrentlyAndGetDelays(
+  // listed in "nodes_list" and get their delays. At most max_concurrency()
+  // syntheses are in flight at any time.
+  virtual absl::StatusOr<std::vector<int64_t>>
+  SynthesizeNodesConcurrentlyAndGetDelays(
       absl::Span<const absl::flat_hash_set<Node *>> nodes_list) const;
 
  private:
   // Records the name of the concreate synthesizer, e.g., yosys, for management
   // and debugging purpose.
   std::string name_;
+  int64_t max_concurrency_;
 };
 
 // A derived Synthesizer class for Yosys-OpenSTA-based synthesis and static
@@ -70,12 +95,20 @@ class YosysSynthesizer : public Synthesizer {
  public:
   explicit YosysSynthesizer(std::string_view yosys_path,
                             std::string_view sta_path,
-                            std::string_view synthesis_libraries)
-      : Synthesizer("yosys"),
+                            std::string_view synthesis_libraries,
+                            int64_t max_concurrency = 0)
+      : Synthesizer("yosys", max_concurrency),
         service_(yosys_path, /*nextpnr_path=*/"", /*synthesis_target=*/"",
                  sta_path, synthesis_libraries, synthesis_libraries,
                  /*save_temps=*/false, /*return_netlist=*/false,
-                 /*synthesis_only=*/false) {}
+                 /*synthesis_only=*/false),
+        configuration_key_(absl::StrCat("yosys:", yosys_path, ":", sta_path,
+                                        ":", synthesis_libraries, ":",
+                                        kFrequencyHz)) {}
+
+  std::string GetConfigurationKey() const override {
+    return configuration_key_;
+  }
 
   absl::StatusOr<int64_t> SynthesizeVerilogAndGetDelay(
       std::string_view verilog_text,
@@ -86,6 +119,118 @@ class YosysSynthesizer : public Synthesizer {
 
  private:
   YosysSynthesisServiceImpl service_;
+  std::string configuration_key_;
+};
+
+// A Synthesizer which runs no external tools, so that the feedback-driven
+// optimization loop can be tested and benchmarked anywhere. The delay of a set
+// of nodes is the critical-path delay through the set according to the given
+// delay estimator. Each synthesis optionally sleeps for "synthesis_latency" to
+// mimic the runtime of a real synthesis flow.
+class FakeSynthesizer : public Synthesizer {
+ public:
+  explicit FakeSynthesizer(
+      const DelayEstimator &delay_estimator,
+      absl::Duration synthesis_latency = absl::ZeroDuration(),
+      int64_t max_concurrency = 0)
+      : Synthesizer("fake", max_concurrency),
+        delay_estimator_(delay_estimator),
+        synthesis_latency_(synthesis_latency) {}
+
+  std::string GetConfigurationKey() const override {
+    return absl::StrCat("fake:", delay_estimator_.name());
+  }
+
+  // Verilog text can't be timed without a synthesis tool; always returns an
+  // Unimplemented error.
+  absl::StatusOr<int64_t> SynthesizeVerilogAndGetDelay(
+      std::string_view verilog_text,
+      std::string_view top_module_name) const override;
+
+  absl::StatusOr<int64_t> SynthesizeNodesAndGetDelay(
+      const absl::flat_hash_set<Node *> &nodes) const override;
+
+  // Returns the number of node sets synthesized so far.
+  int64_t synthesis_count() const { return synthesis_count_.load(); }
+
+ private:
+  const DelayEstimator &delay_estimator_;
+  absl::Duration synthesis_latency_;
+  mutable std::atomic<int64_t> synthesis_count_ = 0;
+};
+
+// Caches the delays reported by an underlying synthesizer. This class is safe
+// for concurrent access.
+//
+// Node sets are keyed by their canonical form (see
+// ExtractNodesAndGetCanonicalKey) together with the configuration key of the
+// underlying synthesizer, so a subgraph is synthesized only once even if it is
+// extracted again in a later iteration or from another design. Identical node
+// sets within one batch are also synthesized only once. If a cache path is
+// given, previously recorded delays are loaded from it on creation and newly
+// recorded delays are written back to it by Flush or on destruction.
+class CachingSynthesizer : public Synthesizer {
+ public:
+  static absl::StatusOr<std::unique_ptr<CachingSynthesizer>> Create(
+      std::unique_ptr<Synthesizer> synthesizer,
+      std::optional<std::filesystem::path> cache_path = std::nullopt);
+
+  // Flushes the cache, logging rather than returning any error.
+  ~CachingSynthesizer() override;
+
+  // Writes the cache to the cache path, if there is one and delays were
+  // recorded since the last flush. The file is replaced atomically, so
+  // concurrent readers never see a partially written cache.
+  absl::Status Flush();
+
+  std::string GetConfigurationKey() const override {
+    return synthesizer_->GetConfigurationKey();
+  }
+
+  // Verilog text is passed through to the underlying synthesizer uncached.
+  absl::StatusOr<int64_t> SynthesizeVerilogAndGetDelay(
+      std::string_view verilog_text,
+      std::string_view top_module_name) const override;
+
+  absl::StatusOr<int64_t> SynthesizeNodesAndGetDelay(
+      const absl::flat_hash_set<Node *> &nodes) const override;
+
+  absl::StatusOr<std::vector<int64_t>> SynthesizeNodesConcurrentlyAndGetDelays(
+      absl::Span<const absl::flat_hash_set<Node *>> nodes_list) const override;
+
+  // Returns the number of node sets answered from the cache and the number
+  // passed on to the underlying synthesizer, respectively.
+  int64_t hit_count() const {
+    absl::MutexLock lock(&mutex_);
+    return hit_count_;
+  }
+  int64_t miss_count() const {
+    absl::MutexLock lock(&mutex_);
+    return miss_count_;
+  }
+
+ private:
+  CachingSynthesizer(std::unique_ptr<Synthesizer> synthesizer,
+                     std::optional<std::filesystem::path> cache_path)
+      : Synthesizer(synthesizer->name(), synthesizer->max_concurrency()),
+        synthesizer_(std::move(synthesizer)),
+        cache_path_(std::move(cache_path)) {}
+
+  std::unique_ptr<Synthesizer> synthesizer_;
+  std::optional<std::filesystem::path> cache_path_;
+
+  mutable absl::Mutex mutex_;
+  // Delays of the underlying synthesizer's configuration, keyed by canonical
+  // node set.
+  mutable absl::flat_hash_map<std::string, int64_t> delays_
+      ABSL_GUARDED_BY(mutex_);
+  // All entries of the persistent cache, including those recorded with other
+  // configurations, which are preserved when the cache is written back.
+  mutable SynthesisDelayCacheProto cache_proto_ ABSL_GUARDED_BY(mutex_);
+  // Whether cache_proto_ has entries which have not been flushed yet.
+  mutable bool dirty_ ABSL_GUARDED_BY(mutex_) = false;
+  mutable int64_t hit_count_ ABSL_GUARDED_BY(mutex_) = 0;
+  mutable int64_t miss_count_ ABSL_GUARDED_BY(mutex_) = 0;
 };
 
 }  // namespace synthesis
@@ -0,0 +1,307 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fdo/synthesizer.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/fdo/synthesis_delay_cache.pb.h"
+#include "xls/ir/benchmark_support.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/package.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/run_pipeline_schedule.h"
+#include "xls/scheduling/scheduling_options.h"
+
+namespace xls {
+namespace synthesis {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using ::testing::ElementsAre;
+
+class SynthesizerTest : public IrTestBase {};
+
+constexpr std::string_view kIrText = R"(
+package p
+
+fn main(i0: bits[3], i1: bits[3]) -> bits[3] {
+  add.1: bits[3] = add(i0, i1)
+  sub.2: bits[3] = sub(add.1, i1)
+  ret or.3: bits[3] = or(sub.2, add.1)
+}
+)";
+
+// The same graph as kIrText with different names and ids.
+constexpr std::string_view kRenamedIrText = R"(
+package q
+
+fn other(x: bits[3], y: bits[3]) -> bits[3] {
+  sum: bits[3] = add(x, y, id=10)
+  diff: bits[3] = sub(sum, y, id=20)
+  ret result: bits[3] = or(diff, sum, id=30)
+}
+)";
+
+TEST_F(SynthesizerTest, FakeSynthesizerReportsCriticalPath) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("main"));
+  TestDelayEstimator delay_estimator(/*base_delay=*/10);
+  FakeSynthesizer synthesizer(delay_estimator);
+
+  EXPECT_THAT(synthesizer.SynthesizeNodesAndGetDelay(
+                  {FindNode("add.1", f), FindNode("sub.2", f),
+                   FindNode("or.3", f)}),
+              IsOkAndHolds(30));
+  EXPECT_THAT(synthesizer.SynthesizeNodesAndGetDelay(
+                  {FindNode("add.1", f), FindNode("or.3", f)}),
+              IsOkAndHolds(20));
+  EXPECT_THAT(synthesizer.SynthesizeNodesAndGetDelay({FindNode("sub.2", f)}),
+              IsOkAndHolds(10));
+  EXPECT_EQ(synthesizer.synthesis_count(), 3);
+  EXPECT_THAT(synthesizer.SynthesizeVerilogAndGetDelay("", "top"),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST_F(SynthesizerTest, BoundedConcurrencyReturnsDelaysInOrder) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("main"));
+  TestDelayEstimator delay_estimator(/*base_delay=*/10);
+  FakeSynthesizer synthesizer(delay_estimator, absl::ZeroDuration(),
+                              /*max_concurrency=*/2);
+  EXPECT_EQ(synthesizer.max_concurrency(), 2);
+
+  std::vector<absl::flat_hash_set<Node*>> nodes_list;
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 8; ++i) {
+    nodes_list.push_back({FindNode("or.3", f)});
+    expected.push_back(10);
+    nodes_list.push_back({FindNode("add.1", f), FindNode("sub.2", f)});
+    expected.push_back(20);
+  }
+  EXPECT_THAT(synthesizer.SynthesizeNodesConcurrentlyAndGetDelays(nodes_list),
+              IsOkAndHolds(expected));
+  EXPECT_EQ(synthesizer.synthesis_count(), 16);
+}
+
+TEST_F(SynthesizerTest, CachingSynthesizerReusesStructurallyEqualNodes) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto other_package,
+                           Parser::ParsePackage(kRenamedIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * other,
+                           other_package->GetFunction("other"));
+
+  TestDelayEstimator delay_estimator(/*base_delay=*/10);
+  auto fake = std::make_unique<FakeSynthesizer>(delay_estimator);
+  FakeSynthesizer* fake_ptr = fake.get();
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CachingSynthesizer> synthesizer,
+                           CachingSynthesizer::Create(std::move(fake)));
+  EXPECT_EQ(synthesizer->GetConfigurationKey(), "fake:test");
+
+  // Duplicates within a batch are synthesized once.
+  std::vector<absl::flat_hash_set<Node*>> nodes_list = {
+      {FindNode("add.1", f), FindNode("sub.2", f)},
+      {FindNode("or.3", f)},
+      {FindNode("add.1", f), FindNode("sub.2", f)},
+  };
+  EXPECT_THAT(synthesizer->SynthesizeNodesConcurrentlyAndGetDelays(nodes_list),
+              IsOkAndHolds(ElementsAre(20, 10, 20)));
+  EXPECT_EQ(fake_ptr->synthesis_count(), 2);
+  EXPECT_EQ(synthesizer->miss_count(), 2);
+  EXPECT_EQ(synthesizer->hit_count(), 0);
+
+  // The same subgraph taken from another package hits in the cache.
+  EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay(
+                  {FindNode("sum", other), FindNode("diff", other)}),
+              IsOkAndHolds(20));
+  EXPECT_EQ(fake_ptr->synthesis_count(), 2);
+  EXPECT_EQ(synthesizer->hit_count(), 1);
+
+  // A different subgraph does not.
+  EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay(
+                  {FindNode("diff", other), FindNode("result", other)}),
+              IsOkAndHolds(20));
+  EXPECT_EQ(fake_ptr->synthesis_count(), 3);
+  EXPECT_EQ(synthesizer->miss_count(), 3);
+}
+
+TEST_F(SynthesizerTest, CachingSynthesizerPersistsDelays) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path cache_path = temp_dir.path() / "delays.pb";
+  absl::flat_hash_set<Node*> nodes = {FindNode("add.1", f),
+                                      FindNode("sub.2", f)};
+
+  TestDelayEstimator delay_estimator(/*base_delay=*/10);
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CachingSynthesizer> synthesizer,
+        CachingSynthesizer::Create(
+            std::make_unique<FakeSynthesizer>(delay_estimator), cache_path));
+    EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay(nodes),
+                IsOkAndHolds(20));
+    EXPECT_EQ(synthesizer->miss_count(), 1);
+  }
+
+  // A new synthesizer with the same configuration reads the delay back.
+  {
+    auto fake = std::make_unique<FakeSynthesizer>(delay_estimator);
+    FakeSynthesizer* fake_ptr = fake.get();
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CachingSynthesizer> synthesizer,
+        CachingSynthesizer::Create(std::move(fake), cache_path));
+    EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay(nodes),
+                IsOkAndHolds(20));
+    EXPECT_EQ(synthesizer->hit_count(), 1);
+    EXPECT_EQ(fake_ptr->synthesis_count(), 0);
+  }
+
+  // One with a different configuration doesn't, but keeps the other entries.
+  DecoratingDelayEstimator other_delay_estimator(
+      "other", delay_estimator,
+      [](Node* node, int64_t delay) { return delay; });
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CachingSynthesizer> synthesizer,
+        CachingSynthesizer::Create(
+            std::make_unique<FakeSynthesizer>(other_delay_estimator),
+            cache_path));
+    EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay(nodes),
+                IsOkAndHolds(20));
+    EXPECT_EQ(synthesizer->miss_count(), 1);
+  }
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CachingSynthesizer> synthesizer,
+        CachingSynthesizer::Create(
+            std::make_unique<FakeSynthesizer>(delay_estimator), cache_path));
+    EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay(nodes),
+                IsOkAndHolds(20));
+    EXPECT_EQ(synthesizer->hit_count(), 1);
+  }
+}
+
+TEST_F(SynthesizerTest, CachingSynthesizerWritesCacheOnFlush) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function* f, package->GetFunction("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path cache_path = temp_dir.path() / "delays.pb";
+
+  TestDelayEstimator delay_estimator(/*base_delay=*/10);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CachingSynthesizer> synthesizer,
+      CachingSynthesizer::Create(
+          std::make_unique<FakeSynthesizer>(delay_estimator), cache_path));
+  XLS_ASSERT_OK(
+      synthesizer->SynthesizeNodesAndGetDelay({FindNode("add.1", f)}).status());
+  XLS_ASSERT_OK(
+      synthesizer->SynthesizeNodesAndGetDelay({FindNode("sub.2", f)}).status());
+  EXPECT_FALSE(FileExists(cache_path).ok());
+
+  XLS_ASSERT_OK(synthesizer->Flush());
+  SynthesisDelayCacheProto cache;
+  XLS_ASSERT_OK(ParseProtobinFile(cache_path, &cache));
+  EXPECT_EQ(cache.entries_size(), 2);
+}
+
+TEST_F(SynthesizerTest, CachingSynthesizerIgnoresUnreadableCache) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(Function* f, package->GetFunction("main"));
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  std::filesystem::path cache_path = temp_dir.path() / "delays.pb";
+  XLS_ASSERT_OK(SetFileContents(cache_path, "not a protobuf"));
+
+  TestDelayEstimator delay_estimator(/*base_delay=*/10);
+  {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<CachingSynthesizer> synthesizer,
+        CachingSynthesizer::Create(
+            std::make_unique<FakeSynthesizer>(delay_estimator), cache_path));
+    EXPECT_THAT(synthesizer->SynthesizeNodesAndGetDelay({FindNode("add.1", f)}),
+                IsOkAndHolds(10));
+    EXPECT_EQ(synthesizer->miss_count(), 1);
+  }
+
+  // The unreadable cache was replaced on destruction.
+  SynthesisDelayCacheProto cache;
+  XLS_ASSERT_OK(ParseProtobinFile(cache_path, &cache));
+  EXPECT_EQ(cache.entries_size(), 1);
+}
+
+// Runs feedback-driven scheduling of a balanced adder tree end to end with the
+// fake synthesizer standing in for Yosys/OpenSTA. Each synthesis takes 1ms to
+// mimic a (very fast) synthesis tool. Args: tree depth, whether a warm
+// CachingSynthesizer is used.
+void BM_FdoScheduleWithFakeSynthesizer(benchmark::State& state) {
+  Package p("balanced_tree_pkg");
+  absl::StatusOr<Function*> f = benchmark_support::GenerateBalancedTree(
+      &p, state.range(0), /*fan_out=*/2,
+      benchmark_support::strategy::BinaryAdd(),
+      benchmark_support::strategy::DistinctLiteral());
+  CHECK_OK(f.status());
+  TestDelayEstimator delay_estimator(/*base_delay=*/100);
+  SchedulingOptions options = SchedulingOptions()
+                                  .clock_period_ps(250)
+                                  .use_fdo(true)
+                                  .fdo_iteration_number(5)
+                                  .fdo_delay_driven_path_number(4)
+                                  .fdo_fanout_driven_path_number(2);
+
+  auto fake = std::make_unique<FakeSynthesizer>(delay_estimator,
+                                                absl::Milliseconds(1));
+  FakeSynthesizer* fake_ptr = fake.get();
+  std::unique_ptr<Synthesizer> synthesizer = std::move(fake);
+  if (state.range(1) != 0) {
+    absl::StatusOr<std::unique_ptr<CachingSynthesizer>> caching =
+        CachingSynthesizer::Create(std::move(synthesizer));
+    CHECK_OK(caching.status());
+    synthesizer = *std::move(caching);
+  }
+  for (auto _ : state) {
+    absl::StatusOr<PipelineSchedule> schedule =
+        RunPipelineSchedule(*f, delay_estimator, options, synthesizer.get());
+    CHECK_OK(schedule.status());
+    benchmark::DoNotOptimize(schedule);
+  }
+  state.counters["syntheses"] = benchmark::Counter(
+      fake_ptr->synthesis_count(), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_FdoScheduleWithFakeSynthesizer)->ArgsProduct({{6, 8}, {0, 1}});
+
+}  // namespace
+}  // namespace synthesis
+}  // namespace xls
@@ -30,7 +30,8 @@ namespace xls {
 namespace sched {
 
 std::pair<std::vector<Node*>, std::vector<Node*>> MinCostFunctionPartition(
-    FunctionBase* f, absl::Span<Node* const> partitionable_nodes) {
+    FunctionBase* f, absl::Span<Node* const> partitionable_nodes,
+    min_cut::MaxFlowAlgorithm max_flow_algorithm) {
   if (VLOG_IS_ON(4)) {
     XLS_VLOG(4) << "Computing min-cut of function " << f->name()
                 << ", partitionable nodes:";
@@ -165,7 +166,7 @@ std::pair<std::vector<Node*>, std::vector<Node*>> MinCostFunctionPartition(
   }
 
   min_cut::GraphCut graph_cut =
-      min_cut::MinCutBetweenNodes(graph, source, sink);
+      min_cut::MinCutBetweenNodes(graph, source, sink, max_flow_algorithm);
 
   // Map the mincut graph partition back to the XLS graph.
   std::pair<std::vector<Node*>, std::vector<Node*>> partitions;
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "absl/types/span.h"
+#include "xls/data_structures/min_cut.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
 
@@ -53,8 +54,13 @@ namespace sched {
 //
 // Returns the two partitions as a std::pair. The first element is the
 // predecessor partition of the dicut (partition A in the example above).
+//
+// `max_flow_algorithm` selects the algorithm used to find the underlying min
+// cut; all algorithms give the same partition.
 std::pair<std::vector<Node*>, std::vector<Node*>> MinCostFunctionPartition(
-    FunctionBase* f, absl::Span<Node* const> partitionable_nodes);
+    FunctionBase* f, absl::Span<Node* const> partitionable_nodes,
+    min_cut::MaxFlowAlgorithm max_flow_algorithm =
+        min_cut::MaxFlowAlgorithm::kDinic);
 
 }  // namespace sched
 }  // namespace xls
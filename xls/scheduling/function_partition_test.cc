@@ -21,9 +21,13 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
 #include "xls/common/status/matchers.h"
+#include "xls/data_structures/min_cut.h"
 #include "xls/examples/sample_packages.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/topo_sort.h"
@@ -203,6 +207,15 @@ TEST_F(FunctionPartitionTest, BenchmarkTest) {
       EXPECT_EQ(partition.first.size() + partition.second.size(),
                 nodes_to_partition.size());
 
+      // The push-relabel engine must find a partition of the same cost.
+      auto push_relabel_partition =
+          MinCostFunctionPartition(f, nodes_to_partition,
+                                   min_cut::MaxFlowAlgorithm::kPushRelabel);
+      EXPECT_EQ(PartitionCost(push_relabel_partition.first,
+                              push_relabel_partition.second),
+                PartitionCost(partition.first, partition.second))
+          << benchmark_name;
+
       // No params should be in the second partition.
       EXPECT_TRUE(std::all_of(partition.second.begin(), partition.second.end(),
                               [](Node* n) { return !n->Is<Param>(); }));
@@ -248,6 +261,35 @@ TEST_F(FunctionPartitionTest, BenchmarkTest) {
   }
 }
 
+// Partitions the middle half of the topological sort of a graph of fully
+// connected layers. Args: layer width, layer depth, max-flow algorithm.
+void BM_PartitionFullyConnectedLayers(benchmark::State& state) {
+  Package p("fully_connected_pkg");
+  benchmark_support::strategy::DistinctLiteral literals;
+  benchmark_support::strategy::CaseSelect selects(literals);
+  absl::StatusOr<Function*> f =
+      benchmark_support::GenerateFullyConnectedLayerGraph(
+          &p, /*depth=*/state.range(1), /*width=*/state.range(0), selects,
+          literals);
+  CHECK_OK(f.status());
+  std::vector<Node*> topo_sort = TopoSort(*f);
+  absl::Span<Node* const> nodes_to_partition = absl::MakeConstSpan(
+      topo_sort).subspan(topo_sort.size() / 4, topo_sort.size() / 2);
+  auto algorithm = static_cast<min_cut::MaxFlowAlgorithm>(state.range(2));
+  for (auto _ : state) {
+    auto partition = MinCostFunctionPartition(*f, nodes_to_partition, algorithm);
+    benchmark::DoNotOptimize(partition);
+  }
+  state.counters["nodes"] = (*f)->node_count();
+}
+
+BENCHMARK(BM_PartitionFullyConnectedLayers)
+    ->ArgsProduct(
+        {{4, 16},
+         {16, 64},
+         {static_cast<int64_t>(min_cut::MaxFlowAlgorithm::kDinic),
+          static_cast<int64_t>(min_cut::MaxFlowAlgorithm::kPushRelabel)}});
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
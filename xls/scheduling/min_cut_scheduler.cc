@@ -49,6 +49,7 @@ namespace {
 // 'cycle + 1'.
 absl::Status SplitAfterCycle(FunctionBase* f, int64_t cycle,
                              const DelayEstimator& delay_estimator,
+                             min_cut::MaxFlowAlgorithm max_flow_algorithm,
                              sched::ScheduleBounds* bounds) {
   XLS_VLOG(3) << "Splitting after cycle " << cycle;
 
@@ -62,7 +63,8 @@ absl::Status SplitAfterCycle(FunctionBase* f, int64_t cycle,
   }
 
   std::pair<std::vector<Node*>, std::vector<Node*>> partitions =
-      sched::MinCostFunctionPartition(f, partitionable_nodes);
+      sched::MinCostFunctionPartition(f, partitionable_nodes,
+                                      max_flow_algorithm);
 
   // Tighten bounds based on the cut.
   for (Node* node : partitions.first) {
@@ -147,7 +149,8 @@ std::vector<std::vector<int64_t>> GetMinCutCycleOrders(int64_t length) {
 absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
     FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
     const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
-    absl::Span<const SchedulingConstraint> constraints) {
+    absl::Span<const SchedulingConstraint> constraints,
+    min_cut::MaxFlowAlgorithm max_flow_algorithm) {
   XLS_VLOG(3) << "MinCutScheduler()";
   XLS_VLOG(3) << "  pipeline stages = " << pipeline_stages;
   XLS_VLOG_LINES(4, f->DumpIr());
@@ -208,7 +211,8 @@ absl::StatusOr<ScheduleCycleMap> MinCutScheduler(
     // node will have a range of exactly one cycle.
     for (int64_t cycle : cut_order) {
       XLS_RETURN_IF_ERROR(
-          SplitAfterCycle(f, cycle, delay_estimator, &trial_bounds));
+          SplitAfterCycle(f, cycle, delay_estimator, max_flow_algorithm,
+                          &trial_bounds));
       XLS_RETURN_IF_ERROR(trial_bounds.PropagateLowerBounds());
       XLS_RETURN_IF_ERROR(trial_bounds.PropagateUpperBounds());
     }
@@ -34,11 +34,16 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/casts.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/data_structures/graph_coloring.h"
@@ -55,7 +60,10 @@
 #include "xls/ir/topo_sort.h"
 #include "xls/ir/value.h"
 #include "xls/ir/value_utils.h"
+#include "xls/passes/bdd_function.h"
+#include "xls/passes/bdd_query_engine.h"
 #include "xls/passes/post_dominator_analysis.h"
+#include "xls/passes/query_engine.h"
 #include "xls/passes/token_provenance_analysis.h"
 #include "xls/scheduling/scheduling_options.h"
 #include "xls/scheduling/scheduling_pass.h"
@@ -104,6 +112,79 @@ Z3_lbool RunSolver(Z3_context c, Z3_ast asserted) {
   return satisfiable;
 }
 
+// A query for whether `a AND b` is satisfiable; if `a == b`, this is whether
+// `a` can be true at all.
+struct SolverQuery {
+  Node* a;
+  Node* b;
+  // Whether to run the solver without a resource limit.
+  bool unlimited;
+};
+
+Z3_lbool RunQuery(solvers::z3::IrTranslator* translator,
+                  const SolverQuery& query, int64_t z3_rlimit) {
+  Z3_context ctx = translator->ctx();
+  Z3_ast asserted = translator->GetTranslation(query.a);
+  if (query.b != query.a) {
+    asserted =
+        Z3_mk_bvand(ctx, asserted, translator->GetTranslation(query.b));
+  }
+  translator->SetRlimit(query.unlimited ? 0 : z3_rlimit);
+  return RunSolver(ctx, solvers::z3::BitVectorToBoolean(ctx, asserted));
+}
+
+// Runs solver queries against a function, spread over a number of threads.
+// Z3 contexts must not be shared between threads, so each thread has its own
+// translation of the function, which is created on first use and reused by
+// later batches of queries.
+class SolverPool {
+ public:
+  SolverPool(FunctionBase* f, int64_t z3_rlimit, int64_t threads)
+      : f_(f),
+        z3_rlimit_(z3_rlimit),
+        translators_(std::max(threads, int64_t{1})) {}
+
+  absl::StatusOr<std::vector<Z3_lbool>> Run(
+      absl::Span<const SolverQuery> queries) {
+    std::vector<Z3_lbool> results(queries.size(), Z3_L_UNDEF);
+    if (queries.empty()) {
+      return results;
+    }
+    std::vector<absl::Status> statuses(translators_.size());
+    ParallelForWithWorker(
+        queries.size(), translators_.size(), [&](int64_t worker, int64_t i) {
+          if (!statuses[worker].ok()) {
+            return;
+          }
+          statuses[worker] = RunQueryOnWorker(worker, queries[i], &results[i]);
+        });
+    for (absl::Status& status : statuses) {
+      XLS_RETURN_IF_ERROR(status);
+    }
+    return results;
+  }
+
+ private:
+  // Runs `query` with the `worker`th translator, translating the function for
+  // that worker on first use.
+  absl::Status RunQueryOnWorker(int64_t worker, const SolverQuery& query,
+                                Z3_lbool* result) {
+    if (translators_[worker] == nullptr) {
+      XLS_ASSIGN_OR_RETURN(translators_[worker],
+                           solvers::z3::IrTranslator::CreateAndTranslate(
+                               f_, /*allow_unsupported=*/true));
+    }
+    solvers::z3::IrTranslator* translator = translators_[worker].get();
+    solvers::z3::ScopedErrorHandler seh(translator->ctx());
+    *result = RunQuery(translator, query, z3_rlimit_);
+    return seh.status();
+  }
+
+  FunctionBase* f_;
+  int64_t z3_rlimit_;
+  std::vector<std::unique_ptr<solvers::z3::IrTranslator>> translators_;
+};
+
 // Returns a list of all predicates in a deterministic order, paired with their
 // index in the list.
 std::vector<std::pair<Node*, int64_t>> PredicateNodes(Predicates* p,
@@ -804,7 +885,7 @@ struct PredicateSet {
 
 using NodeSet = absl::btree_set<Node*, Node::NodeIdLessThan>;
 template <typename T>
-using NodeMap = absl::btree_map<Node*, T, Node::NodeIdLessThan>;
+using NodeIdMap = absl::btree_map<Node*, T, Node::NodeIdLessThan>;
 
 absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f) {
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<PostDominatorAnalysis> pda,
@@ -818,7 +899,7 @@ absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f) {
   // First, take each select and add to the `PredicateSet` of all nodes
   // that are postdominated by one of its cases a predicate of the form
   // `selector == case_number`.
-  NodeMap<PredicateSet> predicate_sets;
+  NodeIdMap<PredicateSet> predicate_sets;
   for (Node* node : TopoSort(f)) {
     if (node->Is<Select>()) {
       Select* select = node->As<Select>();
@@ -891,7 +972,7 @@ absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f) {
   // Fourth, we create a mapping from selector to the value of the selector
   // to set of nodes that contain that selector-value pair, which will be used
   // later in creating mutual exclusion edges.
-  NodeMap<absl::btree_map<Bits, NodeSet, BitsLT>> selector_to_value_to_preds;
+  NodeIdMap<absl::btree_map<Bits, NodeSet, BitsLT>> selector_to_value_to_preds;
 
   // Fifth, we AND together all the select predicates that apply to a given node
   // and then AND that with the current predicate of that node via the call to
@@ -937,27 +1018,149 @@ absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f) {
   return absl::OkStatus();
 }
 
+std::optional<int64_t> MutualExclusionProofCache::GetConeId(Node* node) {
+  // Any traversal order works, as long as it depends only on the structure of
+  // the cone; this is a preorder DFS visiting operands in order.
+  std::string key;
+  absl::flat_hash_set<Node*> visited;
+  std::vector<Node*> worklist = {node};
+  while (!worklist.empty()) {
+    Node* n = worklist.back();
+    worklist.pop_back();
+    if (!visited.insert(n).second) {
+      continue;
+    }
+    if (n->OpIn({Op::kInvoke, Op::kMap, Op::kCountedFor,
+                 Op::kDynamicCountedFor})) {
+      return std::nullopt;
+    }
+    absl::StrAppend(&key, n->ToString(), "\n");
+    for (Node* operand : n->operands()) {
+      worklist.push_back(operand);
+    }
+  }
+
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = cone_ids_.try_emplace(std::move(key), next_cone_id_);
+  if (inserted) {
+    ++next_cone_id_;
+    int64_t cone_id = it->second;
+    ClearIfFull();
+    return cone_id;
+  }
+  return it->second;
+}
+
+void MutualExclusionProofCache::ClearIfFull() {
+  if (cone_ids_.size() > max_size_ || results_.size() > max_size_) {
+    XLS_VLOG(2) << "Mutual exclusion proof cache is full; clearing it";
+    cone_ids_.clear();
+    results_.clear();
+  }
+}
+
+std::optional<bool> MutualExclusionProofCache::Lookup(int64_t cone_a,
+                                                      int64_t cone_b) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = results_.find(std::minmax(cone_a, cone_b));
+  if (it == results_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void MutualExclusionProofCache::Insert(int64_t cone_a, int64_t cone_b,
+                                       bool satisfiable) {
+  absl::MutexLock lock(&mutex_);
+  results_[std::minmax(cone_a, cone_b)] = satisfiable;
+  ClearIfFull();
+}
+
+int64_t MutualExclusionProofCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return results_.size();
+}
+
 absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
-                                    int64_t z3_rlimit) {
+                                    int64_t z3_rlimit, int64_t threads,
+                                    MutualExclusionProofCache* cache,
+                                    MutualExclusionStats* stats) {
   if (f->IsBlock()) {
     return absl::OkStatus();
   }
 
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<solvers::z3::IrTranslator> translator,
-                       solvers::z3::IrTranslator::CreateAndTranslate(f, true));
+  MutualExclusionStats local_stats;
+  if (stats == nullptr) {
+    stats = &local_stats;
+  }
 
-  Z3_context ctx = translator->ctx();
+  std::vector<std::pair<Node*, int64_t>> predicate_nodes = PredicateNodes(p, f);
 
-  solvers::z3::ScopedErrorHandler seh(ctx);
+  // Cheap BDD analysis settles many queries (e.g., comparisons of the same
+  // selector against different constants) without calling the solver.
+  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit, IsCheapForBdds);
+  XLS_RETURN_IF_ERROR(query_engine.Populate(f).status());
+
+  // Predicates whose cones can't be cached have no entry.
+  absl::flat_hash_map<Node*, int64_t> cone_ids;
+  if (cache != nullptr) {
+    for (const auto& [node, index] : predicate_nodes) {
+      if (std::optional<int64_t> cone_id = cache->GetConeId(node)) {
+        cone_ids[node] = *cone_id;
+      }
+    }
+  }
+  auto lookup = [&](Node* a, Node* b) -> std::optional<bool> {
+    if (!cone_ids.contains(a) || !cone_ids.contains(b)) {
+      return std::nullopt;
+    }
+    std::optional<bool> satisfiable =
+        cache->Lookup(cone_ids.at(a), cone_ids.at(b));
+    if (satisfiable.has_value()) {
+      ++stats->cache_hits;
+    }
+    return satisfiable;
+  };
 
-  std::vector<std::pair<Node*, int64_t>> predicate_nodes = PredicateNodes(p, f);
+  SolverPool solvers(f, z3_rlimit, threads);
+  auto run_queries = [&](absl::Span<const SolverQuery> queries)
+      -> absl::StatusOr<std::vector<Z3_lbool>> {
+    absl::Time start = absl::Now();
+    XLS_ASSIGN_OR_RETURN(std::vector<Z3_lbool> results, solvers.Run(queries));
+    stats->solver_time += absl::Now() - start;
+    stats->solver_queries += queries.size();
+    for (int64_t i = 0; i < queries.size(); ++i) {
+      if (results[i] == Z3_L_UNDEF) {
+        ++stats->solver_unknown;
+      } else if (cone_ids.contains(queries[i].a) &&
+                 cone_ids.contains(queries[i].b)) {
+        cache->Insert(cone_ids.at(queries[i].a), cone_ids.at(queries[i].b),
+                      results[i] == Z3_L_TRUE);
+      }
+    }
+    return results;
+  };
 
-  // Determine for each predicate whether it is always false using Z3.
+  // Determine for each predicate whether it is always false.
   // Dead nodes are mutually exclusive with all other nodes, so this can reduce
   // the runtime by doing only a linear amount of Z3 calls to remove
   // quadratically many Z3 calls.
+  std::vector<Node*> always_false;
+  std::vector<SolverQuery> queries;
   for (const auto& [node, index] : predicate_nodes) {
-    Z3_ast translated = translator->GetTranslation(node);
+    ++stats->queries;
+    if (query_engine.IsTracked(node) && query_engine.IsAllZeros(node)) {
+      ++stats->bdd_resolved;
+      always_false.push_back(node);
+      continue;
+    }
+    if (std::optional<bool> satisfiable = lookup(node, node);
+        satisfiable.has_value()) {
+      if (!*satisfiable) {
+        always_false.push_back(node);
+      }
+      continue;
+    }
     // Check whether it's possible for `node` to need to be proven mutually
     // exclusive with some other node in order for channel operations to be
     // legal; if so, we remove the rlimit on the prover.
@@ -969,15 +1172,22 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
                     << node->GetName()
                     << " as mutual exclusion is required for compilation.";
     }
-    translator->SetRlimit(z3_rlimit);
-    if (RunSolver(ctx, solvers::z3::BitVectorToBoolean(ctx, translated)) ==
-        Z3_L_FALSE) {
-      XLS_VLOG(3) << "Proved that " << node << " is always false";
-      // A constant false node is mutually exclusive with all other nodes.
-      for (const auto& [other, other_index] : predicate_nodes) {
-        if (index != other_index) {
-          XLS_RETURN_IF_ERROR(p->MarkMutuallyExclusive(node, other));
-        }
+    queries.push_back({.a = node, .b = node, .unlimited = false});
+  }
+  {
+    XLS_ASSIGN_OR_RETURN(std::vector<Z3_lbool> results, run_queries(queries));
+    for (int64_t i = 0; i < queries.size(); ++i) {
+      if (results[i] == Z3_L_FALSE) {
+        always_false.push_back(queries[i].a);
+      }
+    }
+  }
+  for (Node* node : always_false) {
+    XLS_VLOG(3) << "Proved that " << node << " is always false";
+    // A constant false node is mutually exclusive with all other nodes.
+    for (const auto& [other, other_index] : predicate_nodes) {
+      if (other != node) {
+        XLS_RETURN_IF_ERROR(p->MarkMutuallyExclusive(node, other));
       }
     }
   }
@@ -989,6 +1199,21 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
   int64_t known_false = 0;
   int64_t known_true = 0;
   int64_t unknown = 0;
+  auto record = [&](Node* node_a, Node* node_b,
+                    std::optional<bool> satisfiable) -> absl::Status {
+    if (!satisfiable.has_value()) {
+      unknown += 1;
+      XLS_VLOG(3) << "Z3 ran out of time checking mutual exclusion of "
+                  << node_a->GetName() << " and " << node_b->GetName();
+      return absl::OkStatus();
+    }
+    if (*satisfiable) {
+      known_false += 1;
+      return p->MarkNotMutuallyExclusive(node_a, node_b);
+    }
+    known_true += 1;
+    return p->MarkMutuallyExclusive(node_a, node_b);
+  };
 
   absl::flat_hash_map<Node*, absl::flat_hash_set<Op>> ops_for_pred;
   for (const auto& [node, index] : predicate_nodes) {
@@ -1009,6 +1234,7 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
     }
   }
 
+  queries.clear();
   for (const auto& [node_a, index_a] : predicate_nodes) {
     XLS_ASSIGN_OR_RETURN(
         absl::flat_hash_set<Channel*> channels_a,
@@ -1029,14 +1255,30 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
         continue;
       }
 
-      Z3_ast z3_a = translator->GetTranslation(node_a);
-      Z3_ast z3_b = translator->GetTranslation(node_b);
+      ++stats->queries;
+      if (query_engine.IsTracked(node_a) && query_engine.IsTracked(node_b)) {
+        TreeBitLocation bit_a(node_a, 0);
+        TreeBitLocation bit_b(node_b, 0);
+        if (query_engine.AtMostOneTrue({bit_a, bit_b})) {
+          ++stats->bdd_resolved;
+          XLS_RETURN_IF_ERROR(record(node_a, node_b, false));
+          continue;
+        }
+        if (query_engine.IsOne(bit_a) && query_engine.IsOne(bit_b)) {
+          ++stats->bdd_resolved;
+          XLS_RETURN_IF_ERROR(record(node_a, node_b, true));
+          continue;
+        }
+      }
+      if (std::optional<bool> satisfiable = lookup(node_a, node_b);
+          satisfiable.has_value()) {
+        XLS_RETURN_IF_ERROR(record(node_a, node_b, satisfiable));
+        continue;
+      }
 
       // We try to find out if `a ∧ b` is satisfiable, which is true iff
       // `a NAND b` is not valid.
-      Z3_ast a_and_b =
-          solvers::z3::BitVectorToBoolean(ctx, Z3_mk_bvand(ctx, z3_a, z3_b));
-
+      //
       // Check whether `a` and `b` must be proven mutually exclusive in order
       // for channel operations to be legal; if so, we remove the rlimit on the
       // prover.
@@ -1046,34 +1288,30 @@ absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
       bool required_for_compilation = absl::c_any_of(
           channels_a,
           [&](Channel* channel) { return channels_b.contains(channel); });
-      translator->SetRlimit(required_for_compilation ? 0 : z3_rlimit);
       if (required_for_compilation) {
         XLS_LOG(INFO) << "Removing Z3's rlimit for mutual exclusion between "
                       << node_a->GetName() << " and " << node_b->GetName()
                       << " as mutual exclusion is required for compilation.";
       }
-      Z3_lbool satisfiable = RunSolver(ctx, a_and_b);
-
-      if (satisfiable == Z3_L_FALSE) {
-        known_true += 1;
-        XLS_RETURN_IF_ERROR(p->MarkMutuallyExclusive(node_a, node_b));
-      } else if (satisfiable == Z3_L_TRUE) {
-        known_false += 1;
-        XLS_RETURN_IF_ERROR(p->MarkNotMutuallyExclusive(node_a, node_b));
-      } else {
-        unknown += 1;
-        XLS_VLOG(3) << "Z3 ran out of time checking mutual exclusion of "
-                    << node_a->GetName() << " and " << node_b->GetName();
-      }
+      queries.push_back({.a = node_a,
+                         .b = node_b,
+                         .unlimited = required_for_compilation});
     }
   }
 
+  XLS_ASSIGN_OR_RETURN(std::vector<Z3_lbool> results, run_queries(queries));
+  for (int64_t i = 0; i < queries.size(); ++i) {
+    std::optional<bool> satisfiable;
+    if (results[i] != Z3_L_UNDEF) {
+      satisfiable = results[i] == Z3_L_TRUE;
+    }
+    XLS_RETURN_IF_ERROR(record(queries[i].a, queries[i].b, satisfiable));
+  }
+
   XLS_VLOG(3) << "known_false = " << known_false;
   XLS_VLOG(3) << "known_true  = " << known_true;
   XLS_VLOG(3) << "unknown     = " << unknown;
 
-  XLS_RETURN_IF_ERROR(seh.status());
-
   return absl::OkStatus();
 }
 
@@ -1098,7 +1336,16 @@ absl::StatusOr<bool> MutualExclusionPass::RunOnFunctionBaseInternal(
 
   Predicates p;
   XLS_RETURN_IF_ERROR(AddSendReceivePredicates(&p, f));
-  XLS_RETURN_IF_ERROR(ComputeMutualExclusion(&p, f, z3_rlimit));
+  MutualExclusionStats stats;
+  XLS_RETURN_IF_ERROR(ComputeMutualExclusion(
+      &p, f, z3_rlimit, options.scheduling_options.scheduling_threads(),
+      &cache_, &stats));
+  XLS_VLOG(2) << absl::StreamFormat(
+      "Mutual exclusion for %s: %d queries, %d resolved by BDD, %d cache "
+      "hits, %d solver queries (%d inconclusive) in %s",
+      f->name(), stats.queries, stats.bdd_resolved, stats.cache_hits,
+      stats.solver_queries, stats.solver_unknown,
+      absl::FormatDuration(stats.solver_time));
   XLS_ASSIGN_OR_RETURN(std::vector<absl::flat_hash_set<Node*>> merge_classes,
                        ComputeMergeClasses(&p, f, scm));
 
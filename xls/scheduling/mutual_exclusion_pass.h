@@ -15,11 +15,21 @@
 #ifndef XLS_SCHEDULING_MUTUAL_EXCLUSION_PASS_H_
 #define XLS_SCHEDULING_MUTUAL_EXCLUSION_PASS_H_
 
+#include <cstdint>
 #include <optional>
+#include <string>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/scheduling/scheduling_pass.h"
 
@@ -99,13 +109,90 @@ absl::StatusOr<Node*> AddPredicate(Predicates* p, Node* node, Node* pred);
 // another pass.
 absl::Status AddSelectPredicates(Predicates* p, FunctionBase* f);
 
+// Caches the results of the satisfiability queries made by
+// `ComputeMutualExclusion`, so that they need not be re-proven when the pass
+// runs again on a function whose predicates are (partly) unchanged, e.g. in a
+// later iteration of a fixed-point pass pipeline.
+//
+// Queries are keyed by the full text of the cones of the predicates involved:
+// the ID, op, type, operands and payload (literal values, slice bounds, etc.)
+// of every node the predicate depends on. The key holds no pointers, so a cache
+// outliving a package can't confuse it with a later package allocated at the
+// same address; and since a cone's text determines the function it computes,
+// hits across packages are sound. Cones which call other functions are not
+// cached, as their text does not include the callee. Only conclusive results
+// are cached; these do not depend on the solver's resource limit.
+//
+// The cache holds at most `max_size` cones and results; it is emptied when
+// either limit is reached.
+class MutualExclusionProofCache {
+ public:
+  static constexpr int64_t kDefaultMaxSize = int64_t{1} << 16;
+
+  explicit MutualExclusionProofCache(int64_t max_size = kDefaultMaxSize)
+      : max_size_(max_size) {}
+
+  // Returns an identifier for the cone of `node`; two nodes have the same
+  // identifier iff their cones have the same text. Returns nullopt if the cone
+  // can't be cached. Identifiers are never reused, even after the cache is
+  // emptied.
+  std::optional<int64_t> GetConeId(Node* node);
+
+  // Returns whether `a AND b` is known to be satisfiable, given the cone IDs
+  // of `a` and `b`. Querying `(a, a)` gives whether `a` can be true.
+  std::optional<bool> Lookup(int64_t cone_a, int64_t cone_b) const;
+
+  // Records whether `a AND b` is satisfiable, given the cone IDs of `a` and
+  // `b`.
+  void Insert(int64_t cone_a, int64_t cone_b, bool satisfiable);
+
+  int64_t size() const;
+
+ private:
+  void ClearIfFull() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const int64_t max_size_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, int64_t> cone_ids_ ABSL_GUARDED_BY(mutex_);
+  int64_t next_cone_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<std::pair<int64_t, int64_t>, bool> results_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Counts of the queries made by `ComputeMutualExclusion`, and how each was
+// resolved.
+struct MutualExclusionStats {
+  // Predicates checked for being always false, and pairs of predicates checked
+  // for mutual exclusion.
+  int64_t queries = 0;
+  // Queries resolved by BDD analysis, without calling the SMT solver.
+  int64_t bdd_resolved = 0;
+  // Queries resolved by a `MutualExclusionProofCache`.
+  int64_t cache_hits = 0;
+  // Queries sent to the SMT solver, and how many of those were inconclusive.
+  int64_t solver_queries = 0;
+  int64_t solver_unknown = 0;
+  // Wall-clock time spent in the SMT solver, including translation of the
+  // function for each solver thread.
+  absl::Duration solver_time;
+};
+
 // Use an SMT solver to populate the given `Predicates*` with information about
 // whether nodes are used in a mutually exclusive way.
-absl::Status ComputeMutualExclusion(Predicates* p, FunctionBase* f,
-                                    int64_t z3_rlimit);
+//
+// Pairs which can be decided by BDD analysis are resolved without the solver,
+// as are pairs found in `cache` (if given), which is updated with every
+// conclusive result. The remaining queries are split among `threads` solvers,
+// each with its own Z3 context. If `stats` is given, it is updated with counts
+// of the queries made.
+absl::Status ComputeMutualExclusion(
+    Predicates* p, FunctionBase* f, int64_t z3_rlimit, int64_t threads = 1,
+    MutualExclusionProofCache* cache = nullptr,
+    MutualExclusionStats* stats = nullptr);
 
 // Pass which merges together nodes that are determined to be mutually exclusive
-// via SMT solver analysis.
+// via SMT solver analysis. Proofs are cached across runs of the same pass
+// object, and are spread over `scheduling_threads` solvers.
 class MutualExclusionPass : public SchedulingOptimizationFunctionBasePass {
  public:
   MutualExclusionPass()
@@ -119,6 +206,9 @@ class MutualExclusionPass : public SchedulingOptimizationFunctionBasePass {
       FunctionBase* f, SchedulingUnit* unit,
       const SchedulingPassOptions& options,
       SchedulingPassResults* results) const override;
+
+ private:
+  mutable MutualExclusionProofCache cache_;
 };
 
 }  // namespace xls
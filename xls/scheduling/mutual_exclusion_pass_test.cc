@@ -121,6 +121,38 @@ absl::StatusOr<Proc*> CreateTwoParallelSendsProc(Package* p,
   return pb.Build(pb.AfterAll({send0, send1}), {not_st});
 }
 
+// Like `CreateTwoParallelSendsProc`, but the predicates compare two different
+// (though equal) products, so BDD analysis cannot show that they are mutually
+// exclusive and the SMT solver is needed. The products are compared with 3 and
+// `other_value` respectively, so the predicates are mutually exclusive unless
+// `other_value` is 3.
+absl::StatusOr<Proc*> CreateTwoParallelSendsWithOpaquePredicatesProc(
+    Package* p, std::string_view name, Channel* channel,
+    int64_t other_value = 6) {
+  ProcBuilder pb(name, "__token", p);
+  BValue st = pb.StateElement("__state", Value(UBits(0, 8)));
+  BValue lit3 = pb.Literal(UBits(3, 8));
+  BValue pred0 = pb.Eq(pb.UMul(st, lit3), pb.Literal(UBits(3, 8)));
+  BValue pred1 = pb.Eq(pb.UMul(lit3, st), pb.Literal(UBits(other_value, 8)));
+  BValue lit50 = pb.Literal(UBits(50, 32));
+  BValue lit60 = pb.Literal(UBits(60, 32));
+  BValue send0 = pb.SendIf(channel, pb.GetTokenParam(), pred0, lit50);
+  BValue send1 = pb.SendIf(channel, pb.GetTokenParam(), pred1, lit60);
+  return pb.Build(pb.AfterAll({send0, send1}),
+                  {pb.Add(st, pb.Literal(UBits(1, 8)))});
+}
+
+// Sets the predicate of every send in `f` to the send's own predicate.
+absl::Status AddSendPredicates(Predicates* p, FunctionBase* f) {
+  for (Node* node : f->nodes()) {
+    if (node->Is<Send>() && node->As<Send>()->predicate().has_value()) {
+      XLS_RETURN_IF_ERROR(
+          AddPredicate(p, node, *node->As<Send>()->predicate()).status());
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<Node*> FindOp(FunctionBase* f, Op op) {
   Node* result = nullptr;
   for (Node* node : f->nodes()) {
@@ -184,14 +216,135 @@ TEST_F(MutualExclusionPassTest,
           /*initial_values=*/{}, /*fifo_config=*/std::nullopt,
           /*flow_control=*/FlowControl::kReadyValid,
           /*strictness=*/ChannelStrictness::kArbitraryStaticOrder));
-  XLS_ASSERT_OK_AND_ASSIGN(
-      Proc * proc, CreateTwoParallelSendsProc(p.get(), "main", test_channel));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           CreateTwoParallelSendsWithOpaquePredicatesProc(
+                               p.get(), "main", test_channel));
   EXPECT_THAT(RunMutualExclusionPass(
                   proc, SchedulingOptions().mutual_exclusion_z3_rlimit(1)),
               IsOkAndHolds(false));
   EXPECT_EQ(NumberOfOp(proc, Op::kSend), 2);
 }
 
+TEST_F(MutualExclusionPassTest, TwoParallelSendsWithOpaquePredicates) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * test_channel,
+      p->CreateStreamingChannel("test_channel", ChannelOps::kSendOnly,
+                                p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           CreateTwoParallelSendsWithOpaquePredicatesProc(
+                               p.get(), "main", test_channel));
+  EXPECT_THAT(
+      RunMutualExclusionPass(proc, SchedulingOptions().scheduling_threads(4)),
+      IsOkAndHolds(true));
+  EXPECT_EQ(NumberOfOp(proc, Op::kSend), 1);
+  XLS_EXPECT_OK(VerifyProc(proc, true));
+}
+
+TEST_F(MutualExclusionPassTest, EasyPairsAreResolvedWithoutSolver) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * test_channel,
+      p->CreateStreamingChannel("test_channel", ChannelOps::kSendOnly,
+                                p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Proc * proc, CreateTwoParallelSendsProc(p.get(), "main", test_channel));
+  Predicates preds;
+  XLS_ASSERT_OK(AddSendPredicates(&preds, proc));
+  MutualExclusionStats stats;
+  XLS_ASSERT_OK(ComputeMutualExclusion(&preds, proc, /*z3_rlimit=*/5000,
+                                       /*threads=*/1, /*cache=*/nullptr,
+                                       &stats));
+  Node* st = proc->GetStateParam(0);
+  XLS_ASSERT_OK_AND_ASSIGN(Node * not_st, FindOp(proc, Op::kNot));
+  EXPECT_EQ(preds.QueryMutuallyExclusive(st, not_st), true);
+  // `__state` and `not(__state)` are each checked for being always false, and
+  // then together; only the latter is trivial.
+  EXPECT_EQ(stats.queries, 3);
+  EXPECT_EQ(stats.bdd_resolved, 1);
+  EXPECT_EQ(stats.solver_queries, 2);
+}
+
+TEST_F(MutualExclusionPassTest, ProofsAreCached) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * test_channel,
+      p->CreateStreamingChannel("test_channel", ChannelOps::kSendOnly,
+                                p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           CreateTwoParallelSendsWithOpaquePredicatesProc(
+                               p.get(), "main", test_channel));
+  MutualExclusionProofCache cache;
+  for (int64_t threads : {1, 2}) {
+    Predicates preds;
+    XLS_ASSERT_OK(AddSendPredicates(&preds, proc));
+    MutualExclusionStats stats;
+    XLS_ASSERT_OK(ComputeMutualExclusion(&preds, proc, /*z3_rlimit=*/0,
+                                         threads, &cache, &stats));
+    XLS_ASSERT_OK_AND_ASSIGN(Node * send, FindOp(proc, Op::kSend));
+    Node* pred = preds.GetPredicate(send).value();
+    EXPECT_THAT(preds.MutualExclusionNeighbors(pred),
+                ::testing::Contains(::testing::Pair(::testing::_, true)));
+    EXPECT_EQ(stats.queries, 3);
+    if (threads == 1) {
+      EXPECT_EQ(stats.solver_queries, 3);
+      EXPECT_EQ(stats.cache_hits, 0);
+    } else {
+      // Nothing has changed, so everything is found in the cache.
+      EXPECT_EQ(stats.solver_queries, 0);
+      EXPECT_EQ(stats.cache_hits, 3);
+    }
+  }
+  EXPECT_EQ(cache.size(), 3);
+}
+
+TEST_F(MutualExclusionPassTest, ProofCacheIsBounded) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * test_channel,
+      p->CreateStreamingChannel("test_channel", ChannelOps::kSendOnly,
+                                p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc,
+                           CreateTwoParallelSendsWithOpaquePredicatesProc(
+                               p.get(), "main", test_channel));
+  MutualExclusionProofCache cache(/*max_size=*/2);
+  Predicates preds;
+  XLS_ASSERT_OK(AddSendPredicates(&preds, proc));
+  XLS_ASSERT_OK(ComputeMutualExclusion(&preds, proc, /*z3_rlimit=*/0,
+                                       /*threads=*/1, &cache));
+  EXPECT_LE(cache.size(), 2);
+  XLS_ASSERT_OK_AND_ASSIGN(Node * send, FindOp(proc, Op::kSend));
+  Node* pred = preds.GetPredicate(send).value();
+  EXPECT_THAT(preds.MutualExclusionNeighbors(pred),
+              ::testing::Contains(::testing::Pair(::testing::_, true)));
+}
+
+TEST_F(MutualExclusionPassTest, OnePassObjectOnTwoPackages) {
+  MutualExclusionPass pass;
+  // Returns the number of sends left after running `pass` on a fresh package.
+  // The packages get the same node IDs, and may even get the same address.
+  auto run = [&](int64_t other_value) -> absl::StatusOr<int64_t> {
+    auto p = CreatePackage();
+    XLS_ASSIGN_OR_RETURN(
+        Channel * test_channel,
+        p->CreateStreamingChannel("test_channel", ChannelOps::kSendOnly,
+                                  p->GetBitsType(32)));
+    XLS_ASSIGN_OR_RETURN(Proc * proc,
+                         CreateTwoParallelSendsWithOpaquePredicatesProc(
+                             p.get(), "main", test_channel, other_value));
+    SchedulingUnit unit = SchedulingUnit::CreateForWholePackage(p.get());
+    SchedulingPassResults results;
+    XLS_RETURN_IF_ERROR(
+        pass.Run(&unit, SchedulingPassOptions(), &results).status());
+    return NumberOfOp(proc, Op::kSend);
+  };
+  EXPECT_THAT(run(/*other_value=*/6), IsOkAndHolds(1));
+  // The second package differs only in a literal, which makes the predicates
+  // overlap; the proof for the first package must not be reused.
+  EXPECT_THAT(run(/*other_value=*/3), IsOkAndHolds(2));
+  EXPECT_THAT(run(/*other_value=*/6), IsOkAndHolds(1));
+}
+
 TEST_F(MutualExclusionPassTest, ThreeParallelSends) {
   XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> p, ParsePackage(R"(
      package test_module
@@ -0,0 +1,333 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/partitioned_sdc_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/topo_sort.h"
+#include "xls/scheduling/function_partition.h"
+#include "xls/scheduling/schedule_bounds.h"
+#include "xls/scheduling/scheduling_options.h"
+#include "ortools/math_opt/cpp/math_opt.h"
+
+namespace xls {
+
+namespace {
+
+namespace math_opt = ::operations_research::math_opt;
+
+using DelayMap = absl::flat_hash_map<Node*, int64_t>;
+
+void PartitionRecursively(FunctionBase* f, std::vector<Node*> nodes,
+                          int64_t max_partition_size,
+                          std::vector<std::vector<Node*>>& partitions) {
+  if (nodes.size() <= max_partition_size) {
+    partitions.push_back(std::move(nodes));
+    return;
+  }
+
+  // Only the middle half of the nodes is partitionable, which keeps the split
+  // reasonably balanced; the min-cut would otherwise happily cut just below
+  // the parameters or just above the return value. Any contiguous range of a
+  // topological sort is convex, as MinCostFunctionPartition requires.
+  const int64_t quarter = nodes.size() / 4;
+  const int64_t band_end = nodes.size() - quarter;
+  auto [band_before, band_after] = sched::MinCostFunctionPartition(
+      f, absl::MakeConstSpan(nodes).subspan(quarter, band_end - quarter));
+  absl::flat_hash_set<Node*> after(band_after.begin(), band_after.end());
+
+  // Iterate in the original order so both halves stay topologically sorted.
+  std::vector<Node*> first;
+  std::vector<Node*> second;
+  for (int64_t i = 0; i < nodes.size(); ++i) {
+    bool is_after = i >= band_end || (i >= quarter && after.contains(nodes[i]));
+    (is_after ? second : first).push_back(nodes[i]);
+  }
+  if (first.empty() || second.empty()) {
+    // Only possible for tiny ranges, where the band is everything.
+    first.assign(nodes.begin(), nodes.begin() + nodes.size() / 2);
+    second.assign(nodes.begin() + nodes.size() / 2, nodes.end());
+  }
+  nodes.clear();
+  PartitionRecursively(f, std::move(first), max_partition_size, partitions);
+  PartitionRecursively(f, std::move(second), max_partition_size, partitions);
+}
+
+absl::StatusOr<DelayMap> ComputeNodeDelays(
+    FunctionBase* f, const DelayEstimator& delay_estimator) {
+  DelayMap result;
+  result.reserve(f->node_count());
+  for (Node* node : f->nodes()) {
+    XLS_ASSIGN_OR_RETURN(result[node],
+                         delay_estimator.GetOperationDelayInPs(node));
+  }
+  return result;
+}
+
+// Solves the SDC problem restricted to `window`, a convex set of nodes in
+// topological order, and fixes the window's nodes in `bounds` to the solution.
+// Nodes before the window must already be fixed in `bounds`; nodes after it are
+// free. Returns a ResourceExhaustedError if there is no feasible schedule for
+// the window, or if fixing it leaves the rest of the function infeasible.
+absl::Status ScheduleWindow(FunctionBase* f, absl::Span<Node* const> window,
+                            int64_t last_stage, int64_t clock_period_ps,
+                            const DelayMap& delay_map,
+                            sched::ScheduleBounds& bounds) {
+  absl::flat_hash_set<Node*> in_window(window.begin(), window.end());
+
+  math_opt::Model model(absl::StrCat("partitioned_sdc_model:", f->name()));
+  absl::flat_hash_map<Node*, math_opt::Variable> cycle_var;
+  absl::flat_hash_map<Node*, math_opt::Variable> lifetime_var;
+  cycle_var.reserve(window.size());
+  lifetime_var.reserve(window.size());
+  for (Node* node : window) {
+    cycle_var.emplace(node, model.AddContinuousVariable(
+                                static_cast<double>(bounds.lb(node)),
+                                static_cast<double>(bounds.ub(node)),
+                                node->GetName()));
+    lifetime_var.emplace(
+        node, model.AddContinuousVariable(
+                  0.0, std::numeric_limits<double>::infinity(),
+                  absl::StrFormat("lifetime_%s", node->GetName())));
+  }
+
+  math_opt::LinearExpression objective;
+  for (Node* node : window) {
+    math_opt::Variable cycle = cycle_var.at(node);
+    math_opt::Variable lifetime = lifetime_var.at(node);
+    for (Node* user : node->users()) {
+      if (in_window.contains(user)) {
+        // Causal and lifetime constraints, as in the flat problem.
+        model.AddLinearConstraint(cycle_var.at(user) - cycle >= 0.0);
+        model.AddLinearConstraint(lifetime + cycle - cycle_var.at(user) >=
+                                  0.0);
+      } else {
+        // Users in later partitions are not scheduled yet; assume they land at
+        // their earliest possible cycle.
+        model.AddLinearConstraint(lifetime + cycle >=
+                                  static_cast<double>(bounds.lb(user)));
+      }
+    }
+    if (f->IsFunction() && f->HasImplicitUse(node)) {
+      model.AddLinearConstraint(lifetime + cycle >=
+                                static_cast<double>(last_stage));
+    }
+    objective += 1024 *
+                 static_cast<double>(node->GetType()->GetFlatBitCount()) *
+                 lifetime;
+    objective += cycle;
+  }
+
+  // Values flowing in from earlier partitions are live from their (fixed)
+  // cycle until their last use in the window.
+  absl::flat_hash_map<Node*, math_opt::Variable> boundary_lifetime_var;
+  for (Node* node : window) {
+    for (Node* operand : node->operands()) {
+      if (in_window.contains(operand)) {
+        continue;
+      }
+      auto it = boundary_lifetime_var.find(operand);
+      if (it == boundary_lifetime_var.end()) {
+        it = boundary_lifetime_var
+                 .emplace(operand,
+                          model.AddContinuousVariable(
+                              0.0, std::numeric_limits<double>::infinity(),
+                              absl::StrFormat("lifetime_%s",
+                                              operand->GetName())))
+                 .first;
+        objective +=
+            1024 * static_cast<double>(operand->GetType()->GetFlatBitCount()) *
+            it->second;
+      }
+      model.AddLinearConstraint(it->second - cycle_var.at(node) >=
+                                -static_cast<double>(bounds.lb(operand)));
+    }
+  }
+  model.Minimize(objective);
+
+  // Timing constraints for combinational paths within the window; see
+  // ComputeCombinationalDelayConstraints in sdc_scheduler.cc. Paths entering
+  // the window from fixed nodes are accounted for by the propagated lower
+  // bounds: such a path can only stay within one cycle if all of its window
+  // nodes sit at their lower bounds, which is what lower-bound propagation
+  // checks.
+  absl::flat_hash_map<Node*, absl::flat_hash_map<Node*, int64_t>>
+      distances_to_node;
+  distances_to_node.reserve(window.size());
+  int64_t timing_constraints = 0;
+  for (Node* node : window) {
+    const int64_t node_delay = delay_map.at(node);
+    absl::flat_hash_map<Node*, int64_t>& distances = distances_to_node[node];
+    distances[node] = node_delay;
+    for (Node* operand : node->operands()) {
+      if (!in_window.contains(operand)) {
+        continue;
+      }
+      for (auto [a, operand_distance] : distances_to_node.at(operand)) {
+        int64_t& distance = distances[a];
+        distance = std::max(distance, operand_distance + node_delay);
+      }
+    }
+    for (auto [a, distance] : distances) {
+      if (distance > clock_period_ps &&
+          distance - node_delay <= clock_period_ps) {
+        model.AddLinearConstraint(cycle_var.at(node) - cycle_var.at(a) >= 1.0);
+        ++timing_constraints;
+      }
+    }
+  }
+  distances_to_node.clear();
+  XLS_VLOG(4) << absl::StreamFormat(
+      "Partition of %d nodes: %d boundary values, %d timing constraints",
+      window.size(), boundary_lifetime_var.size(), timing_constraints);
+
+  XLS_ASSIGN_OR_RETURN(math_opt::SolveResult result,
+                       math_opt::Solve(model, math_opt::SolverType::kGlop));
+  if (result.termination.reason != math_opt::TerminationReason::kOptimal) {
+    return absl::ResourceExhaustedError(absl::StrCat(
+        "No schedule for partition of ", window.size(),
+        " nodes; solver terminated with ",
+        math_opt::EnumToString(result.termination.reason)));
+  }
+
+  for (Node* node : window) {
+    double cycle = result.variable_values().at(cycle_var.at(node));
+    if (std::fabs(cycle - std::round(cycle)) > 0.001) {
+      return absl::InternalError(
+          "The scheduling result is expected to be integer");
+    }
+    XLS_RETURN_IF_ERROR(bounds.TightenNodeLb(node, std::round(cycle)));
+    XLS_RETURN_IF_ERROR(bounds.TightenNodeUb(node, std::round(cycle)));
+  }
+  XLS_RETURN_IF_ERROR(bounds.PropagateLowerBounds());
+  XLS_RETURN_IF_ERROR(bounds.PropagateUpperBounds());
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+std::vector<std::vector<Node*>> PartitionForScheduling(
+    FunctionBase* f, absl::Span<Node* const> topo_sort,
+    int64_t max_partition_size) {
+  std::vector<std::vector<Node*>> partitions;
+  PartitionRecursively(
+      f, std::vector<Node*>(topo_sort.begin(), topo_sort.end()),
+      std::max(max_partition_size, int64_t{1}), partitions);
+  return partitions;
+}
+
+absl::StatusOr<ScheduleCycleMap> PartitionedSDCScheduler(
+    FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
+    const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
+    absl::Span<const SchedulingConstraint> constraints,
+    int64_t max_partition_size) {
+  XLS_VLOG(3) << "PartitionedSDCScheduler()";
+  XLS_VLOG(3) << "  pipeline stages = " << pipeline_stages
+              << ", max partition size = " << max_partition_size;
+  XLS_RET_CHECK_GT(max_partition_size, 0);
+
+  if (!f->IsFunction()) {
+    return absl::UnimplementedError(
+        "Partitioned SDC scheduling only supports functions.");
+  }
+  for (Node* node : f->nodes()) {
+    if (node->Is<MinDelay>()) {
+      return absl::UnimplementedError(
+          "Partitioned SDC scheduling doesn't support min_delay nodes.");
+    }
+  }
+  for (const SchedulingConstraint& constraint : constraints) {
+    if (const auto* in_cycle =
+            std::get_if<NodeInCycleConstraint>(&constraint)) {
+      XLS_RETURN_IF_ERROR(
+          bounds->TightenNodeLb(in_cycle->GetNode(), in_cycle->GetCycle()));
+      XLS_RETURN_IF_ERROR(
+          bounds->TightenNodeUb(in_cycle->GetNode(), in_cycle->GetCycle()));
+      XLS_RETURN_IF_ERROR(bounds->PropagateLowerBounds());
+      XLS_RETURN_IF_ERROR(bounds->PropagateUpperBounds());
+    } else if (std::holds_alternative<DifferenceConstraint>(constraint)) {
+      return absl::UnimplementedError(
+          "Partitioned SDC scheduling doesn't support difference "
+          "constraints.");
+    }
+    // The remaining constraints only involve channels and state, which
+    // functions don't have.
+  }
+
+  XLS_ASSIGN_OR_RETURN(DelayMap delay_map,
+                       ComputeNodeDelays(f, delay_estimator));
+  std::vector<std::vector<Node*>> partitions =
+      PartitionForScheduling(f, TopoSort(f), max_partition_size);
+  XLS_VLOG(3) << "  partitions = " << partitions.size();
+
+  int64_t begin = 0;
+  while (begin < partitions.size()) {
+    int64_t end = begin + 1;
+    while (true) {
+      std::vector<Node*> window;
+      for (int64_t i = begin; i < end; ++i) {
+        window.insert(window.end(), partitions[i].begin(),
+                      partitions[i].end());
+      }
+      sched::ScheduleBounds trial_bounds = *bounds;
+      absl::Status status =
+          ScheduleWindow(f, window, pipeline_stages - 1, clock_period_ps,
+                         delay_map, trial_bounds);
+      if (status.ok()) {
+        *bounds = std::move(trial_bounds);
+        break;
+      }
+      if (!absl::IsResourceExhausted(status) || end == partitions.size()) {
+        return status;
+      }
+      // Earlier decisions in this window left later nodes without a feasible
+      // cycle; give the LP more of the function to look at.
+      XLS_VLOG(3) << absl::StreamFormat(
+          "  partitions [%d, %d) infeasible (%s); widening window", begin, end,
+          status.message());
+      end = std::min(begin + 2 * (end - begin), int64_t(partitions.size()));
+    }
+    begin = end;
+  }
+
+  ScheduleCycleMap cycle_map;
+  for (Node* node : f->nodes()) {
+    XLS_RET_CHECK_EQ(bounds->lb(node), bounds->ub(node)) << node->GetName();
+    cycle_map[node] = bounds->lb(node);
+  }
+  return cycle_map;
+}
+
+}  // namespace xls
@@ -0,0 +1,72 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SCHEDULING_PARTITIONED_SDC_SCHEDULER_H_
+#define XLS_SCHEDULING_PARTITIONED_SDC_SCHEDULER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/scheduling/schedule_bounds.h"
+#include "xls/scheduling/scheduling_options.h"
+
+namespace xls {
+
+// Schedules the given function into a pipeline with the given clock period by
+// solving a sequence of small SDC problems rather than one over the whole
+// function, trading some register-count optimality for memory and solve time
+// which scale with `max_partition_size` rather than with the size of `f`.
+//
+// The nodes of `f` are split into partitions of at most `max_partition_size`
+// nodes (see `PartitionForScheduling`), which are scheduled in topological
+// order. Each partition's LP has the same def-use, timing and register-count
+// objective as the flat SDC problem, restricted to the partition; nodes of
+// earlier partitions are already fixed, and their influence (data dependencies
+// and combinational paths crossing the boundary) enters through `bounds`,
+// which are re-propagated after each partition is fixed. If fixing a partition
+// leaves the remaining problem infeasible, it is re-solved together with the
+// following partitions, doubling the window each time.
+//
+// `bounds` must hold tightened ASAP/ALAP bounds for `f`; on success every node
+// has a single-cycle range.
+//
+// Only functions are supported, with no constraints beyond those which are
+// vacuous for functions and `NodeInCycleConstraint`s.
+absl::StatusOr<ScheduleCycleMap> PartitionedSDCScheduler(
+    FunctionBase* f, int64_t pipeline_stages, int64_t clock_period_ps,
+    const DelayEstimator& delay_estimator, sched::ScheduleBounds* bounds,
+    absl::Span<const SchedulingConstraint> constraints,
+    int64_t max_partition_size);
+
+// Splits `topo_sort` (a topological sort of `f`) into partitions of at most
+// `max_partition_size` nodes, each in topological order. There are no edges
+// from a node in a later partition to a node in an earlier one, and every
+// partition is convex: any path between two of its nodes stays within it.
+//
+// Partitions are found by recursive bisection. Each split takes the first and
+// last quarters of the nodes as fixed to either side and places the cut
+// through the middle half at the minimum register cost, using
+// `sched::MinCostFunctionPartition`. Exposed for testing.
+std::vector<std::vector<Node*>> PartitionForScheduling(
+    FunctionBase* f, absl::Span<Node* const> topo_sort,
+    int64_t max_partition_size);
+
+}  // namespace xls
+
+#endif  // XLS_SCHEDULING_PARTITIONED_SDC_SCHEDULER_H_
@@ -0,0 +1,190 @@
+// Copyright 2024 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/partitioned_sdc_scheduler.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/benchmark_support.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/topo_sort.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/run_pipeline_schedule.h"
+#include "xls/scheduling/schedule_bounds.h"
+#include "xls/scheduling/scheduling_options.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class PartitionedSDCSchedulerTest : public IrTestBase {};
+
+absl::StatusOr<Function*> BalancedTree(Package* p, int64_t depth) {
+  return benchmark_support::GenerateBalancedTree(
+      p, depth, /*fan_out=*/2, benchmark_support::strategy::BinaryAdd(),
+      benchmark_support::strategy::DistinctLiteral());
+}
+
+TEST_F(PartitionedSDCSchedulerTest, PartitionsAreSmallOrderedAndComplete) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/6));
+  std::vector<Node*> topo_sort = TopoSort(f);
+
+  std::vector<std::vector<Node*>> partitions =
+      PartitionForScheduling(f, topo_sort, /*max_partition_size=*/16);
+  EXPECT_GT(partitions.size(), 1);
+
+  absl::flat_hash_map<Node*, int64_t> partition_of;
+  for (int64_t i = 0; i < partitions.size(); ++i) {
+    EXPECT_LE(partitions[i].size(), 16);
+    EXPECT_FALSE(partitions[i].empty());
+    for (Node* node : partitions[i]) {
+      EXPECT_TRUE(partition_of.insert({node, i}).second);
+    }
+  }
+  EXPECT_EQ(partition_of.size(), f->node_count());
+
+  for (Node* node : f->nodes()) {
+    for (Node* operand : node->operands()) {
+      EXPECT_LE(partition_of.at(operand), partition_of.at(node))
+          << operand->GetName() << " -> " << node->GetName();
+    }
+  }
+}
+
+TEST_F(PartitionedSDCSchedulerTest, SmallFunctionIsOnePartition) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/3));
+  std::vector<Node*> topo_sort = TopoSort(f);
+  std::vector<std::vector<Node*>> partitions =
+      PartitionForScheduling(f, topo_sort, f->node_count());
+  ASSERT_EQ(partitions.size(), 1);
+  EXPECT_EQ(partitions[0], topo_sort);
+}
+
+TEST_F(PartitionedSDCSchedulerTest, ScheduleIsValid) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/6));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      RunPipelineSchedule(f, TestDelayEstimator(),
+                          SchedulingOptions()
+                              .clock_period_ps(2)
+                              .sdc_partition_size(16)));
+  XLS_EXPECT_OK(schedule.Verify());
+  XLS_EXPECT_OK(schedule.VerifyTiming(/*clock_period_ps=*/2,
+                                      TestDelayEstimator()));
+  // The adder tree is six adds deep, so three stages at two adds per stage.
+  EXPECT_EQ(schedule.length(), 3);
+}
+
+TEST_F(PartitionedSDCSchedulerTest, FixedPipelineLength) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/5));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      RunPipelineSchedule(f, TestDelayEstimator(),
+                          SchedulingOptions()
+                              .clock_period_ps(2)
+                              .pipeline_stages(5)
+                              .sdc_partition_size(8)));
+  XLS_EXPECT_OK(schedule.Verify());
+  XLS_EXPECT_OK(schedule.VerifyTiming(/*clock_period_ps=*/2,
+                                      TestDelayEstimator()));
+  EXPECT_EQ(schedule.length(), 5);
+}
+
+TEST_F(PartitionedSDCSchedulerTest, MatchesFlatScheduleWithOnePartition) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/5));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule flat,
+      RunPipelineSchedule(f, TestDelayEstimator(),
+                          SchedulingOptions().clock_period_ps(2)));
+
+  TestDelayEstimator delay_estimator;
+  sched::ScheduleBounds bounds(f, TopoSort(f), /*clock_period_ps=*/2,
+                               delay_estimator);
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+  for (Node* node : f->nodes()) {
+    XLS_ASSERT_OK(bounds.TightenNodeUb(node, bounds.max_lower_bound()));
+  }
+  XLS_ASSERT_OK(bounds.PropagateUpperBounds());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ScheduleCycleMap cycle_map,
+      PartitionedSDCScheduler(f, flat.length(), /*clock_period_ps=*/2,
+                              delay_estimator, &bounds,
+                              /*constraints=*/{}, f->node_count()));
+  PipelineSchedule partitioned(f, cycle_map, flat.length());
+  XLS_EXPECT_OK(partitioned.Verify());
+  EXPECT_EQ(partitioned.CountFinalInteriorPipelineRegisters(),
+            flat.CountFinalInteriorPipelineRegisters());
+}
+
+TEST_F(PartitionedSDCSchedulerTest, RequiresClockPeriod) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/4));
+
+  EXPECT_THAT(RunPipelineSchedule(
+                  f, TestDelayEstimator(),
+                  SchedulingOptions().pipeline_stages(3).sdc_partition_size(4)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("requires --clock_period_ps")));
+}
+
+// Schedules a balanced adder tree with and without partitioning, reporting the
+// number of pipeline registers so the quality loss can be compared alongside
+// the time. Args: tree depth, partition size (0 for the flat scheduler).
+void BM_PartitionedBalancedTree(benchmark::State& state) {
+  Package p("balanced_tree_pkg");
+  absl::StatusOr<Function*> f = BalancedTree(&p, state.range(0));
+  CHECK_OK(f.status());
+  TestDelayEstimator delay_estimator(/*base_delay=*/100);
+  SchedulingOptions options = SchedulingOptions()
+                                  .clock_period_ps(250)
+                                  .sdc_partition_size(state.range(1));
+  int64_t registers = 0;
+  for (auto _ : state) {
+    absl::StatusOr<PipelineSchedule> schedule =
+        RunPipelineSchedule(*f, delay_estimator, options);
+    CHECK_OK(schedule.status());
+    registers = schedule->CountFinalInteriorPipelineRegisters();
+    benchmark::DoNotOptimize(schedule);
+  }
+  state.counters["nodes"] = (*f)->node_count();
+  state.counters["registers"] = registers;
+}
+
+BENCHMARK(BM_PartitionedBalancedTree)
+    ->ArgsProduct({{8, 10, 12}, {0, 256, 1024}});
+
+}  // namespace
+}  // namespace xls
@@ -178,6 +178,39 @@ bool PipelineSchedule::IsLiveOutOfCycle(Node* node, int64_t c) const {
   return false;
 }
 
+std::vector<std::vector<Node*>> PipelineSchedule::GetLiveOutNodesByCycle()
+    const {
+  std::vector<std::vector<Node*>> live_out(length());
+  Function* as_func = dynamic_cast<Function*>(function_base_);
+  for (Node* node : function_base_->nodes()) {
+    // A node is live out of every cycle from its own cycle up to (but not
+    // including) the cycle of its last user, and, if it is the return value,
+    // out of every cycle but the last.
+    int64_t node_cycle = cycle(node);
+    int64_t end_cycle = node_cycle;
+    if (as_func != nullptr && node == as_func->return_value()) {
+      end_cycle = length() - 1;
+    }
+    for (Node* user : node->users()) {
+      if (user->Is<Next>()) {
+        Next* user_next = user->As<Next>();
+        if (user_next->predicate() != node && user_next->value() != node) {
+          // As in IsLiveOutOfCycle, the Next node only uses this Param node to
+          // target the state register; it doesn't need the value itself.
+          CHECK_EQ(user_next->param(), node);
+          continue;
+        }
+      }
+      end_cycle = std::max(end_cycle, cycle(user));
+    }
+    end_cycle = std::min(end_cycle, length() - 1);
+    for (int64_t c = node_cycle; c < end_cycle; ++c) {
+      live_out[c].push_back(node);
+    }
+  }
+  return live_out;
+}
+
 std::vector<Node*> PipelineSchedule::GetLiveOutOfCycle(int64_t c) const {
   std::vector<Node*> live_out;
 
@@ -80,6 +80,13 @@ class PipelineSchedule {
   // Returns true if the given node is live out of the given cycle.
   bool IsLiveOutOfCycle(Node* node, int64_t c) const;
 
+  // Returns the nodes which are live out of each cycle (see IsLiveOutOfCycle),
+  // indexed by cycle. The nodes of each cycle are in the order of
+  // function_base()->nodes(). Unlike calling IsLiveOutOfCycle for every node
+  // and cycle, this takes time linear in the size of the graph plus the size
+  // of the result.
+  std::vector<std::vector<Node*>> GetLiveOutNodesByCycle() const;
+
   // Returns the number of stages in the pipeline. Use 'length' instead of
   // 'size' as 'size' is ambiguous in this context (number of resources? number
   // of nodes? number of cycles?). Note that codegen may add flops to the input
@@ -23,7 +23,9 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -33,8 +35,10 @@
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/delay_model/delay_estimators.h"
 #include "xls/fdo/delay_manager.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/channel_ops.h"
+#include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_matcher.h"
 #include "xls/ir/ir_test_base.h"
@@ -442,6 +446,33 @@ TEST_F(PipelineScheduleTest, JustPipelineLengthGiven) {
   EXPECT_THAT(scheduled_ops(5), UnorderedElementsAre(Op::kNeg));
 }
 
+TEST_F(PipelineScheduleTest, JustPipelineLengthGivenWithSchedulingThreads) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * func,
+      benchmark_support::GenerateBalancedTree(
+          p.get(), /*depth=*/6, /*fan_out=*/2,
+          benchmark_support::strategy::BinaryAdd(),
+          benchmark_support::strategy::DistinctLiteral()));
+  // Six dependent adds of 100ps each; the minimum clock period for four
+  // stages is 200ps (two adds per stage).
+  TestDelayEstimator delay_estimator(/*base_delay=*/100);
+
+  for (int64_t threads : {1, 2, 3, 8}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        PipelineSchedule schedule,
+        RunPipelineSchedule(
+            func, delay_estimator,
+            SchedulingOptions().pipeline_stages(4).scheduling_threads(
+                threads)));
+    EXPECT_EQ(schedule.length(), 4);
+    XLS_EXPECT_OK(schedule.VerifyTiming(200, delay_estimator))
+        << "threads: " << threads;
+    EXPECT_FALSE(schedule.VerifyTiming(199, delay_estimator).ok())
+        << "threads: " << threads;
+  }
+}
+
 TEST_F(PipelineScheduleTest, LongPipelineLength) {
   // Generate an absurdly long pipeline schedule. Most stages are empty, but it
   // should not crash.
@@ -699,6 +730,57 @@ TEST_F(PipelineScheduleTest, MultistateProcSchedule) {
   EXPECT_EQ(schedule.cycle(send.node()), 2);
 }
 
+TEST_F(PipelineScheduleTest, LiveOutNodesByCycleMatchesIsLiveOutOfCycle) {
+  auto expect_consistent = [](const PipelineSchedule& schedule) {
+    std::vector<std::vector<Node*>> live_out =
+        schedule.GetLiveOutNodesByCycle();
+    ASSERT_EQ(live_out.size(), schedule.length());
+    for (int64_t c = 0; c < schedule.length(); ++c) {
+      std::vector<Node*> expected;
+      for (Node* node : schedule.function_base()->nodes()) {
+        if (schedule.IsLiveOutOfCycle(node, c)) {
+          expected.push_back(node);
+        }
+      }
+      EXPECT_EQ(live_out[c], expected) << "cycle " << c;
+    }
+  };
+
+  Package p("p");
+  FunctionBuilder fb(TestName(), &p);
+  BValue x = fb.Param("x", p.GetBitsType(32));
+  BValue y = fb.Param("y", p.GetBitsType(32));
+  BValue sum = fb.Add(x, y);
+  BValue chain = fb.Negate(fb.Not(fb.Negate(sum)));
+  fb.Tuple({fb.Add(chain, x), sum});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule func_schedule,
+      RunPipelineSchedule(func, TestDelayEstimator(),
+                          SchedulingOptions().clock_period_ps(1)));
+  ASSERT_GT(func_schedule.length(), 2);
+  expect_consistent(func_schedule);
+
+  Type* u16 = p.GetBitsType(16);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * in_ch,
+      p.CreateStreamingChannel("in", ChannelOps::kReceiveOnly, u16));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out_ch,
+      p.CreateStreamingChannel("out", ChannelOps::kSendOnly, u16));
+  TokenlessProcBuilder pb("the_proc", "tkn", &p);
+  BValue st = pb.StateElement("st", Value(UBits(0, 16)));
+  BValue rcv = pb.Receive(in_ch);
+  BValue out = pb.Negate(pb.Not(pb.Negate(rcv)));
+  pb.Send(out_ch, pb.Add(out, st));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, pb.Build({pb.Add(st, rcv)}));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule proc_schedule,
+      RunPipelineSchedule(proc, TestDelayEstimator(),
+                          SchedulingOptions().clock_period_ps(1)));
+  expect_consistent(proc_schedule);
+}
+
 TEST_F(PipelineScheduleTest, ProcWithConditionalReceive) {
   // Test a proc with a conditional receive.
   Package p("p");
@@ -1765,5 +1847,49 @@ TEST_F(PipelineScheduleTest,
   EXPECT_THAT(p->GetFunctionBases(), Each(CyclesMatch(schedules, clone)));
 }
 
+// Schedules `f` into a fixed number of stages without a clock period, so the
+// time is dominated by the search for the minimum clock period.
+void BenchmarkMinClockPeriodSearch(Function* f, int64_t scheduling_threads,
+                                   benchmark::State& state) {
+  TestDelayEstimator delay_estimator(/*base_delay=*/100);
+  SchedulingOptions options = SchedulingOptions()
+                                  .pipeline_stages(4)
+                                  .scheduling_threads(scheduling_threads);
+  for (auto _ : state) {
+    absl::StatusOr<PipelineSchedule> schedule =
+        RunPipelineSchedule(f, delay_estimator, options);
+    CHECK_OK(schedule.status());
+    benchmark::DoNotOptimize(schedule);
+  }
+}
+
+// Args: tree depth, scheduling threads.
+void BM_MinClockPeriodBalancedTree(benchmark::State& state) {
+  VerifiedPackage p("balanced_tree_pkg");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f, benchmark_support::GenerateBalancedTree(
+                        &p, /*depth=*/state.range(0), /*fan_out=*/2,
+                        benchmark_support::strategy::BinaryAdd(),
+                        benchmark_support::strategy::DistinctLiteral()));
+  BenchmarkMinClockPeriodSearch(f, state.range(1), state);
+}
+
+// Args: layer count, scheduling threads.
+void BM_MinClockPeriodDense(benchmark::State& state) {
+  VerifiedPackage p("dense_pkg");
+  benchmark_support::strategy::DistinctLiteral selector;
+  benchmark_support::strategy::CaseSelect csts(selector);
+  benchmark_support::strategy::DistinctLiteral leaf;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f, benchmark_support::GenerateFullyConnectedLayerGraph(
+                        &p, /*depth=*/state.range(0), /*width=*/8, csts, leaf));
+  BenchmarkMinClockPeriodSearch(f, state.range(1), state);
+}
+
+BENCHMARK(BM_MinClockPeriodBalancedTree)
+    ->RangeMultiplier(2)
+    ->RangePair(4, 8, 1, 8);
+BENCHMARK(BM_MinClockPeriodDense)->RangeMultiplier(2)->RangePair(4, 32, 1, 8);
+
 }  // namespace
 }  // namespace xls
@@ -36,6 +36,7 @@
 #include "absl/types/span.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/parallel_for.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/data_structures/binary_search.h"
@@ -49,6 +50,7 @@
 #include "xls/ir/op.h"
 #include "xls/ir/topo_sort.h"
 #include "xls/scheduling/min_cut_scheduler.h"
+#include "xls/scheduling/partitioned_sdc_scheduler.h"
 #include "xls/scheduling/pipeline_schedule.h"
 #include "xls/scheduling/schedule_bounds.h"
 #include "xls/scheduling/scheduling_options.h"
@@ -179,10 +181,13 @@ absl::StatusOr<int64_t> ComputeCriticalPath(
 // schedule the function into a pipeline with the given number of stages. If
 // `target_clock_period_ps` is specified, will not try to check lower clock
 // periods than this.
+//
+// With `scheduling_threads` > 1, each round of the search checks up to that
+// many candidate periods concurrently, each on its own clone of `scheduler`.
 absl::StatusOr<int64_t> FindMinimumClockPeriod(
     FunctionBase* f, std::optional<int64_t> pipeline_stages,
     const DelayEstimator& delay_estimator, SDCScheduler& scheduler,
-    SchedulingFailureBehavior failure_behavior,
+    SchedulingFailureBehavior failure_behavior, int64_t scheduling_threads,
     std::optional<int64_t> target_clock_period_ps = std::nullopt) {
   XLS_VLOG(4) << "FindMinimumClockPeriod()";
   XLS_VLOG(4) << "  pipeline stages = "
@@ -228,16 +233,56 @@ absl::StatusOr<int64_t> FindMinimumClockPeriod(
   // Don't waste time explaining infeasibility for the failing points in the
   // search.
   failure_behavior.explain_infeasibility = false;
-  int64_t min_clk_period_ps = BinarySearchMinTrue(
-      optimistic_clk_period_ps, pessimistic_clk_period_ps,
-      [&](int64_t clk_period_ps) {
-        return scheduler
-            .Schedule(pipeline_stages, clk_period_ps,
-                      failure_behavior,
-                      /*check_feasibility=*/true)
-            .ok();
-      },
-      BinarySearchAssumptions::kEndKnownTrue);
+  const int64_t parallelism = std::min(
+      scheduling_threads, pessimistic_clk_period_ps - optimistic_clk_period_ps);
+  int64_t min_clk_period_ps;
+  if (parallelism <= 1) {
+    min_clk_period_ps = BinarySearchMinTrue(
+        optimistic_clk_period_ps, pessimistic_clk_period_ps,
+        [&](int64_t clk_period_ps) {
+          return scheduler
+              .Schedule(pipeline_stages, clk_period_ps,
+                        failure_behavior,
+                        /*check_feasibility=*/true)
+              .ok();
+        },
+        BinarySearchAssumptions::kEndKnownTrue);
+  } else {
+    // The schedulers' LP models are independent, so each can be re-solved on
+    // its own thread; they share only the (read-only) function and its
+    // critical-path distances.
+    std::vector<std::unique_ptr<SDCScheduler>> clones;
+    std::vector<SDCScheduler*> schedulers = {&scheduler};
+    for (int64_t i = 1; i < parallelism; ++i) {
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<SDCScheduler> clone,
+                           scheduler.Clone());
+      schedulers.push_back(clone.get());
+      clones.push_back(std::move(clone));
+    }
+    XLS_VLOG(4) << absl::StreamFormat("Checking %d clock periods per round",
+                                      parallelism);
+    XLS_ASSIGN_OR_RETURN(
+        min_clk_period_ps,
+        KArySearchMinTrueWithStatus(
+            optimistic_clk_period_ps, pessimistic_clk_period_ps, parallelism,
+            [&](absl::Span<const int64_t> clk_periods_ps)
+                -> absl::StatusOr<std::vector<bool>> {
+              // Not std::vector<bool>, whose elements share words and so can't
+              // be written concurrently.
+              std::vector<char> feasible(clk_periods_ps.size(), false);
+              ParallelFor(
+                  clk_periods_ps.size(), clk_periods_ps.size(), [&](int64_t i) {
+                    feasible[i] =
+                        schedulers[i]
+                            ->Schedule(pipeline_stages, clk_periods_ps[i],
+                                       failure_behavior,
+                                       /*check_feasibility=*/true)
+                            .ok();
+                  });
+              return std::vector<bool>(feasible.begin(), feasible.end());
+            },
+            BinarySearchAssumptions::kEndKnownTrue));
+  }
   XLS_VLOG(4) << "minimum clock period = " << min_clk_period_ps;
 
   return min_clk_period_ps;
@@ -346,11 +391,23 @@ absl::StatusOr<PipelineSchedule> RunPipelineSchedule(
     f->SetInitiationInterval(*options.worst_case_throughput());
   }
 
+  // Very large functions can be scheduled one partition at a time, rather than
+  // as a single SDC problem.
+  const bool partitioned = options.strategy() == SchedulingStrategy::SDC &&
+                           !options.use_fdo() && f->IsFunction() &&
+                           options.sdc_partition_size() > 0 &&
+                           f->node_count() > options.sdc_partition_size();
+  if (partitioned && !options.clock_period_ps().has_value()) {
+    return absl::InvalidArgumentError(
+        "Partitioned SDC scheduling (--sdc_partition_size) requires "
+        "--clock_period_ps to be specified.");
+  }
+
   std::unique_ptr<SDCScheduler> sdc_scheduler;
   if (!options.clock_period_ps().has_value() ||
       (options.minimize_worst_case_throughput().value_or(false) &&
        f->IsProc() && f->GetInitiationInterval().value_or(1) <= 0) ||
-      options.strategy() == SchedulingStrategy::SDC) {
+      (options.strategy() == SchedulingStrategy::SDC && !partitioned)) {
     // We currently use the SDC scheduler to determine the minimum clock period
     // (if not specified) and worst-case throughput (if minimization is
     // requested), even if we're not using it for the final schedule.
@@ -384,7 +441,8 @@ absl::StatusOr<PipelineSchedule> RunPipelineSchedule(
     XLS_ASSIGN_OR_RETURN(
         clock_period_ps,
         FindMinimumClockPeriod(f, options.pipeline_stages(), input_delay_added,
-                               *sdc_scheduler, options.failure_behavior()));
+                               *sdc_scheduler, options.failure_behavior(),
+                               options.scheduling_threads()));
 
     if (options.period_relaxation_percent().has_value()) {
       int64_t relaxation_percent = options.period_relaxation_percent().value();
@@ -409,7 +467,7 @@ absl::StatusOr<PipelineSchedule> RunPipelineSchedule(
   }
 
   ScheduleCycleMap cycle_map;
-  if (options.strategy() == SchedulingStrategy::SDC) {
+  if (options.strategy() == SchedulingStrategy::SDC && !partitioned) {
     // Enable iterative SDC scheduling when use_fdo is true
     if (options.use_fdo()) {
       if (!options.clock_period_ps().has_value()) {
@@ -470,7 +528,8 @@ absl::StatusOr<PipelineSchedule> RunPipelineSchedule(
           int64_t target_clock_period_ps = clock_period_ps + 1;
           absl::StatusOr<int64_t> min_clock_period_ps = FindMinimumClockPeriod(
               f, options.pipeline_stages(), input_delay_added, *sdc_scheduler,
-              options.failure_behavior(), target_clock_period_ps);
+              options.failure_behavior(), options.scheduling_threads(),
+              target_clock_period_ps);
           if (min_clock_period_ps.ok()) {
             // Just increasing the clock period suffices.
             return absl::InvalidArgumentError(absl::StrFormat(
@@ -530,6 +589,16 @@ absl::StatusOr<PipelineSchedule> RunPipelineSchedule(
       return schedule_cycle_map.status();
     }
     cycle_map = *std::move(schedule_cycle_map);
+  } else if (partitioned) {
+    sched::ScheduleBounds bounds(f, TopoSort(f), clock_period_ps,
+                                 input_delay_added);
+    XLS_RETURN_IF_ERROR(TightenBounds(bounds, f, options.pipeline_stages()));
+    XLS_ASSIGN_OR_RETURN(
+        cycle_map,
+        PartitionedSDCScheduler(
+            f, options.pipeline_stages().value_or(bounds.max_lower_bound() + 1),
+            clock_period_ps, input_delay_added, &bounds, options.constraints(),
+            options.sdc_partition_size()));
   } else {
     // Run an initial ASAP/ALAP scheduling pass, which we'll refine with the
     // chosen scheduler.
@@ -538,12 +607,13 @@ absl::StatusOr<PipelineSchedule> RunPipelineSchedule(
     XLS_RETURN_IF_ERROR(TightenBounds(bounds, f, options.pipeline_stages()));
 
     if (options.strategy() == SchedulingStrategy::MIN_CUT) {
-      XLS_ASSIGN_OR_RETURN(cycle_map,
-                           MinCutScheduler(f,
-                                           options.pipeline_stages().value_or(
-                                               bounds.max_lower_bound() + 1),
-                                           clock_period_ps, input_delay_added,
-                                           &bounds, options.constraints()));
+      XLS_ASSIGN_OR_RETURN(
+          cycle_map,
+          MinCutScheduler(
+              f,
+              options.pipeline_stages().value_or(bounds.max_lower_bound() + 1),
+              clock_period_ps, input_delay_added, &bounds,
+              options.constraints(), options.min_cut_max_flow_algorithm()));
     } else if (options.strategy() == SchedulingStrategy::RANDOM) {
       std::mt19937_64 gen(options.seed().value_or(0));
 
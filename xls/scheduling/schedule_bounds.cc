@@ -15,6 +15,7 @@
 #include "xls/scheduling/schedule_bounds.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <string>
 #include <utility>
@@ -50,8 +51,16 @@ ScheduleBounds::ScheduleBounds(FunctionBase* f, std::vector<Node*> topo_sort,
 void ScheduleBounds::Reset() {
   max_lower_bound_ = 0;
   min_upper_bound_ = 0;
-  for (Node* node : topo_sort_) {
+  propagated_lbs_.assign(topo_sort_.size(), PropagatedBound{0, 0});
+  propagated_ubs_.assign(topo_sort_.size(), PropagatedBound{0, 0});
+  lb_dirty_.clear();
+  ub_dirty_.clear();
+  for (int64_t i = 0; i < topo_sort_.size(); ++i) {
+    Node* node = topo_sort_[i];
     bounds_[node] = {0, std::numeric_limits<int64_t>::max()};
+    topo_index_[node] = i;
+    lb_dirty_.insert(i);
+    ub_dirty_.insert(i);
     max_lower_bound_ = 0;
     min_upper_bound_ = std::numeric_limits<int64_t>::max();
   }
@@ -72,14 +81,16 @@ std::string ScheduleBounds::ToString() const {
 
 absl::Status ScheduleBounds::PropagateLowerBounds() {
   XLS_VLOG(4) << "PropagateLowerBounds()";
-  // The delay in picoseconds from the beginning of a cycle to the start of the
-  // node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
-
-  // Compute the lower bound of each node based on the lower bounds of the
-  // operands of the node.
-  for (Node* node : topo_sort_) {
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
+  // Compute the lower bound of each dirty node based on the lower bounds of the
+  // operands of the node. Dirty nodes are visited in topological order so each
+  // is visited at most once; a node dirties its users only if its propagated
+  // lower bound changes.
+  while (!lb_dirty_.empty()) {
+    int64_t index = *lb_dirty_.begin();
+    Node* node = topo_sort_[index];
+    // The delay in picoseconds from the beginning of a cycle to the start of
+    // the node.
+    int64_t node_in_cycle_delay = 0;
     XLS_VLOG(4) << absl::StreamFormat("  %s : original lb=%d", node->GetName(),
                                       lb(node));
     for (Node* operand : node->operands()) {
@@ -87,6 +98,8 @@ absl::Status ScheduleBounds::PropagateLowerBounds() {
       if (operand_lb < lb(node)) {
         continue;
       }
+      int64_t operand_in_cycle_delay =
+          propagated_lbs_[topo_index_.at(operand)].in_cycle_delay;
       XLS_ASSIGN_OR_RETURN(int64_t operand_delay,
                            delay_estimator_->GetOperationDelayInPs(operand));
       if (operand_lb > lb(node)) {
@@ -94,11 +107,11 @@ absl::Status ScheduleBounds::PropagateLowerBounds() {
             "    tightened lb to %d because of operand %s", operand_lb,
             operand->GetName());
         XLS_RETURN_IF_ERROR(TightenNodeLb(node, operand_lb));
-        node_in_cycle_delay = in_cycle_delay.at(operand) + operand_delay;
+        node_in_cycle_delay = operand_in_cycle_delay + operand_delay;
         continue;
       }
-      node_in_cycle_delay = std::max(
-          node_in_cycle_delay, in_cycle_delay.at(operand) + operand_delay);
+      node_in_cycle_delay = std::max(node_in_cycle_delay,
+                                     operand_in_cycle_delay + operand_delay);
     }
     XLS_ASSIGN_OR_RETURN(int64_t node_delay,
                          delay_estimator_->GetOperationDelayInPs(node));
@@ -114,20 +127,31 @@ absl::Status ScheduleBounds::PropagateLowerBounds() {
       XLS_RETURN_IF_ERROR(TightenNodeLb(node, lb(node) + 1));
       node_in_cycle_delay = 0;
     }
+    // Tightening the lower bound above re-marks the node as dirty.
+    lb_dirty_.erase(index);
+
+    PropagatedBound propagated{lb(node), node_in_cycle_delay};
+    if (propagated_lbs_[index] != propagated) {
+      propagated_lbs_[index] = propagated;
+      for (Node* user : node->users()) {
+        lb_dirty_.insert(topo_index_.at(user));
+      }
+    }
   }
   return absl::OkStatus();
 }
 
 absl::Status ScheduleBounds::PropagateUpperBounds() {
   XLS_VLOG(4) << "PropagateUpperBounds()";
-  // The delay in picoseconds from the end of a cycle to the end of the node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
-
-  // Compute the upper bound of each node based on the upper bounds of the
-  // users of the node.
-  for (auto it = topo_sort_.rbegin(); it != topo_sort_.rend(); ++it) {
-    Node* node = *it;
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
+  // Compute the upper bound of each dirty node based on the upper bounds of the
+  // users of the node. Dirty nodes are visited in reverse topological order so
+  // each is visited at most once; a node dirties its operands only if its
+  // propagated upper bound changes.
+  while (!ub_dirty_.empty()) {
+    int64_t index = *ub_dirty_.begin();
+    Node* node = topo_sort_[index];
+    // The delay in picoseconds from the end of a cycle to the end of the node.
+    int64_t node_in_cycle_delay = 0;
     XLS_VLOG(4) << absl::StreamFormat("  %s : original ub=%d", node->GetName(),
                                       ub(node));
     for (Node* user : node->users()) {
@@ -136,6 +160,8 @@ absl::Status ScheduleBounds::PropagateUpperBounds() {
           user_ub > ub(node)) {
         continue;
       }
+      int64_t user_in_cycle_delay =
+          propagated_ubs_[topo_index_.at(user)].in_cycle_delay;
       XLS_ASSIGN_OR_RETURN(int64_t user_delay,
                            delay_estimator_->GetOperationDelayInPs(user));
       if (user_ub < ub(node)) {
@@ -143,11 +169,11 @@ absl::Status ScheduleBounds::PropagateUpperBounds() {
             "    tightened ub to %d because of user %s", user_ub,
             user->GetName());
         XLS_RETURN_IF_ERROR(TightenNodeUb(node, user_ub));
-        node_in_cycle_delay = in_cycle_delay.at(user) + user_delay;
+        node_in_cycle_delay = user_in_cycle_delay + user_delay;
         continue;
       }
       node_in_cycle_delay =
-          std::max(node_in_cycle_delay, in_cycle_delay.at(user) + user_delay);
+          std::max(node_in_cycle_delay, user_in_cycle_delay + user_delay);
     }
     XLS_ASSIGN_OR_RETURN(int64_t node_delay,
                          delay_estimator_->GetOperationDelayInPs(node));
@@ -163,6 +189,16 @@ absl::Status ScheduleBounds::PropagateUpperBounds() {
       XLS_RETURN_IF_ERROR(TightenNodeUb(node, ub(node) - 1));
       node_in_cycle_delay = 0;
     }
+    // Tightening the upper bound above re-marks the node as dirty.
+    ub_dirty_.erase(index);
+
+    PropagatedBound propagated{ub(node), node_in_cycle_delay};
+    if (propagated_ubs_[index] != propagated) {
+      propagated_ubs_[index] = propagated;
+      for (Node* operand : node->operands()) {
+        ub_dirty_.insert(topo_index_.at(operand));
+      }
+    }
   }
   return absl::OkStatus();
 }
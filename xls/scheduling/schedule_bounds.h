@@ -17,11 +17,13 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -86,7 +88,11 @@ class ScheduleBounds {
           absl::StrFormat("Unable to tighten the lower bound of node %s to %d.",
                           node->GetName(), value));
     }
-    bounds_.at(node).first = std::max(bounds_.at(node).first, value);
+    std::pair<int64_t, int64_t>& node_bounds = bounds_.at(node);
+    if (value > node_bounds.first) {
+      node_bounds.first = value;
+      lb_dirty_.insert(topo_index_.at(node));
+    }
     max_lower_bound_ = std::max(max_lower_bound_, value);
     return absl::OkStatus();
   }
@@ -100,7 +106,11 @@ class ScheduleBounds {
           absl::StrFormat("Unable to tighten the upper bound of node %s to %d.",
                           node->GetName(), value));
     }
-    bounds_.at(node).second = std::min(bounds_.at(node).second, value);
+    std::pair<int64_t, int64_t>& node_bounds = bounds_.at(node);
+    if (value < node_bounds.second) {
+      node_bounds.second = value;
+      ub_dirty_.insert(topo_index_.at(node));
+    }
     min_upper_bound_ = std::min(min_upper_bound_, value);
     return absl::OkStatus();
   }
@@ -117,13 +127,33 @@ class ScheduleBounds {
   // throughout the graph. This method only tightens bounds (increases lower
   // bounds and decreases upper bounds). Returns an error if propagation results
   // in infeasible bounds (lower bound is greater than upper bound for a node).
+  //
+  // Propagation is incremental: only the nodes whose bound was tightened since
+  // the last propagation and the transitive users (operands) whose bounds are
+  // affected by them are visited.
   absl::Status PropagateLowerBounds();
   absl::Status PropagateUpperBounds();
 
  private:
+  // The result of the last propagation through a node: its bound and the
+  // delay within the cycle of its bound. For lower bounds this is the delay
+  // from the start of the cycle to the start of the node; for upper bounds it
+  // is the delay from the end of the node to the end of the cycle.
+  struct PropagatedBound {
+    int64_t bound;
+    int64_t in_cycle_delay;
+
+    bool operator==(const PropagatedBound& other) const {
+      return bound == other.bound && in_cycle_delay == other.in_cycle_delay;
+    }
+  };
+
   // A topological sort of the nodes in the function.
   std::vector<Node*> topo_sort_;
 
+  // The index of each node in `topo_sort_`.
+  absl::flat_hash_map<Node*, int64_t> topo_index_;
+
   int64_t clock_period_ps_;
   const DelayEstimator* delay_estimator_;
 
@@ -132,6 +162,16 @@ class ScheduleBounds {
 
   int64_t max_lower_bound_;
   int64_t min_upper_bound_;
+
+  // The lower/upper bound propagated through each node, indexed by position in
+  // the topological sort.
+  std::vector<PropagatedBound> propagated_lbs_;
+  std::vector<PropagatedBound> propagated_ubs_;
+
+  // The positions in the topological sort of the nodes which must be visited
+  // by the next lower/upper bound propagation, in the order they are visited.
+  absl::btree_set<int64_t> lb_dirty_;
+  absl::btree_set<int64_t, std::greater<int64_t>> ub_dirty_;
 };
 
 }  // namespace sched
@@ -14,15 +14,22 @@
 
 #include "xls/scheduling/schedule_bounds.h"
 
+#include <cstdint>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/matchers.h"
 #include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
+#include "xls/ir/topo_sort.h"
 
 namespace xls {
 namespace sched {
@@ -163,6 +170,93 @@ TEST_F(ScheduleBoundsTest, SimpleExpressionTightenBounds) {
   EXPECT_EQ(bounds.lb(result.node()), 23);
 }
 
+absl::StatusOr<Function*> BalancedTree(Package* p, int64_t depth) {
+  return benchmark_support::GenerateBalancedTree(
+      p, depth, /*fan_out=*/2, benchmark_support::strategy::BinaryAdd(),
+      benchmark_support::strategy::DistinctLiteral());
+}
+
+TEST_F(ScheduleBoundsTest, IncrementalPropagationMatchesSinglePropagation) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BalancedTree(p.get(), /*depth=*/6));
+  std::vector<Node*> topo_sort = TopoSort(f);
+
+  // Tighten the bounds of a sample of nodes one at a time, propagating after
+  // each, and compare against tightening them all and propagating once.
+  ScheduleBounds incremental(f, topo_sort, /*clock_period_ps=*/3,
+                             delay_estimator_);
+  XLS_ASSERT_OK(incremental.PropagateLowerBounds());
+  const int64_t upper_bound = incremental.max_lower_bound() + 32;
+  for (Node* node : f->nodes()) {
+    XLS_ASSERT_OK(incremental.TightenNodeUb(node, upper_bound));
+  }
+  XLS_ASSERT_OK(incremental.PropagateUpperBounds());
+
+  std::vector<std::pair<Node*, int64_t>> lb_tightenings;
+  std::vector<std::pair<Node*, int64_t>> ub_tightenings;
+  for (int64_t i = 0; i < topo_sort.size(); i += 7) {
+    Node* node = topo_sort[i];
+    if (incremental.lb(node) < incremental.ub(node)) {
+      lb_tightenings.push_back({node, incremental.lb(node) + 1});
+      XLS_ASSERT_OK(incremental.TightenNodeLb(node, incremental.lb(node) + 1));
+      XLS_ASSERT_OK(incremental.PropagateLowerBounds());
+    }
+    Node* mirror = topo_sort[topo_sort.size() - 1 - i];
+    if (incremental.lb(mirror) < incremental.ub(mirror)) {
+      ub_tightenings.push_back({mirror, incremental.ub(mirror) - 1});
+      XLS_ASSERT_OK(
+          incremental.TightenNodeUb(mirror, incremental.ub(mirror) - 1));
+      XLS_ASSERT_OK(incremental.PropagateUpperBounds());
+    }
+  }
+  EXPECT_FALSE(lb_tightenings.empty());
+  EXPECT_FALSE(ub_tightenings.empty());
+
+  ScheduleBounds single(f, topo_sort, /*clock_period_ps=*/3, delay_estimator_);
+  for (Node* node : f->nodes()) {
+    XLS_ASSERT_OK(single.TightenNodeUb(node, upper_bound));
+  }
+  for (const auto& [node, lb] : lb_tightenings) {
+    XLS_ASSERT_OK(single.TightenNodeLb(node, lb));
+  }
+  for (const auto& [node, ub] : ub_tightenings) {
+    XLS_ASSERT_OK(single.TightenNodeUb(node, ub));
+  }
+  XLS_ASSERT_OK(single.PropagateLowerBounds());
+  XLS_ASSERT_OK(single.PropagateUpperBounds());
+
+  for (Node* node : f->nodes()) {
+    EXPECT_EQ(incremental.bounds(node), single.bounds(node)) << node->GetName();
+  }
+}
+
+// Tightens the lower bound of one node at a time to its upper bound and
+// re-propagates, as the min-cut scheduler does when splitting the function at
+// each cycle boundary. Args: tree depth.
+void BM_TightenAndPropagate(benchmark::State& state) {
+  Package p("balanced_tree_pkg");
+  absl::StatusOr<Function*> f = BalancedTree(&p, state.range(0));
+  CHECK_OK(f.status());
+  TestDelayEstimator delay_estimator;
+  absl::StatusOr<ScheduleBounds> asap_alap =
+      ScheduleBounds::ComputeAsapAndAlapBounds(*f, /*clock_period_ps=*/4,
+                                               delay_estimator);
+  CHECK_OK(asap_alap.status());
+  std::vector<Node*> topo_sort = TopoSort(*f);
+  for (auto _ : state) {
+    ScheduleBounds bounds = *asap_alap;
+    for (int64_t i = 0; i < topo_sort.size(); i += 64) {
+      Node* node = topo_sort[i];
+      CHECK_OK(bounds.TightenNodeLb(node, bounds.ub(node)));
+      CHECK_OK(bounds.PropagateLowerBounds());
+    }
+    benchmark::DoNotOptimize(bounds);
+  }
+  state.counters["nodes"] = (*f)->node_count();
+}
+
+BENCHMARK(BM_TightenAndPropagate)->DenseRange(8, 12, 2);
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
@@ -26,6 +26,7 @@
 #include "absl/log/check.h"
 #include "absl/types/span.h"
 #include "xls/common/logging/logging.h"
+#include "xls/data_structures/min_cut.h"
 #include "xls/ir/node.h"
 #include "xls/tools/scheduling_options_flags.pb.h"
 
@@ -233,6 +234,9 @@ class SchedulingOptions {
       : strategy_(strategy),
         minimize_clock_on_failure_(true),
         minimize_worst_case_throughput_(false),
+        scheduling_threads_(1),
+        sdc_partition_size_(0),
+        min_cut_max_flow_algorithm_(min_cut::MaxFlowAlgorithm::kDinic),
         constraints_({
             BackedgeConstraint(),
             SendThenRecvConstraint(/*minimum_latency=*/1),
@@ -244,6 +248,7 @@ class SchedulingOptions {
         fdo_refinement_stochastic_ratio_(1.0),
         fdo_path_evaluate_strategy_(PathEvaluateStrategy::WINDOW),
         fdo_synthesizer_name_("yosys"),
+        fdo_synthesis_threads_(0),
         schedule_all_procs_(false) {}
 
   // Returns the scheduling strategy.
@@ -302,6 +307,38 @@ class SchedulingOptions {
     return minimize_clock_on_failure_;
   }
 
+  // Sets/gets the number of threads used to search for the minimum feasible
+  // clock period, where each thread checks a different candidate period, and
+  // to prove mutual exclusion of predicates, where each thread runs its own
+  // SMT solver.
+  SchedulingOptions& scheduling_threads(int64_t value) {
+    scheduling_threads_ = value;
+    return *this;
+  }
+  int64_t scheduling_threads() const { return scheduling_threads_; }
+
+  // Sets/gets the maximum number of nodes in each SDC problem. If positive,
+  // functions with more nodes than this are scheduled by solving a sequence of
+  // SDC problems over partitions of the function rather than one problem over
+  // the whole function; if zero, every function is scheduled as a whole.
+  SchedulingOptions& sdc_partition_size(int64_t value) {
+    sdc_partition_size_ = value;
+    return *this;
+  }
+  int64_t sdc_partition_size() const { return sdc_partition_size_; }
+
+  // Sets/gets the max-flow algorithm used to compute the cuts of the MIN_CUT
+  // scheduling strategy. All algorithms produce the same schedule; push-relabel
+  // is considerably faster on large functions.
+  SchedulingOptions& min_cut_max_flow_algorithm(
+      min_cut::MaxFlowAlgorithm value) {
+    min_cut_max_flow_algorithm_ = value;
+    return *this;
+  }
+  min_cut::MaxFlowAlgorithm min_cut_max_flow_algorithm() const {
+    return min_cut_max_flow_algorithm_;
+  }
+
   // Sets/gets whether to find the fastest feasible worst-case throughput if the
   // user has not specified a worst-case throughput bound.
   SchedulingOptions& minimize_worst_case_throughput(bool value) {
@@ -451,7 +488,8 @@ class SchedulingOptions {
     return fdo_path_evaluate_strategy_;
   }
 
-  // Only support yosys for now.
+  // Supports yosys, and fake, which times subgraphs with the delay model
+  // instead of running any external tools.
   SchedulingOptions& fdo_synthesizer_name(std::string_view value) {
     fdo_synthesizer_name_ = value;
     return *this;
@@ -481,6 +519,24 @@ class SchedulingOptions {
     return fdo_synthesis_libraries_;
   }
 
+  // Maximum number of subgraphs synthesized at once in each FDO iteration. If
+  // zero, uses one per available CPU.
+  SchedulingOptions& fdo_synthesis_threads(int64_t value) {
+    fdo_synthesis_threads_ = value;
+    return *this;
+  }
+  int64_t fdo_synthesis_threads() const { return fdo_synthesis_threads_; }
+
+  // File in which the delays of synthesized subgraphs are cached across runs.
+  // If empty, delays are only cached for the lifetime of the synthesizer.
+  SchedulingOptions& fdo_synthesis_cache_path(std::string_view value) {
+    fdo_synthesis_cache_path_ = value;
+    return *this;
+  }
+  std::string fdo_synthesis_cache_path() const {
+    return fdo_synthesis_cache_path_;
+  }
+
   SchedulingOptions& schedule_all_procs(bool value) {
     schedule_all_procs_ = value;
     return *this;
@@ -496,6 +552,9 @@ class SchedulingOptions {
   std::optional<int64_t> period_relaxation_percent_;
   bool minimize_clock_on_failure_;
   bool minimize_worst_case_throughput_;
+  int64_t scheduling_threads_;
+  int64_t sdc_partition_size_;
+  min_cut::MaxFlowAlgorithm min_cut_max_flow_algorithm_;
   std::optional<int64_t> worst_case_throughput_;
   std::optional<int64_t> additional_input_delay_ps_;
   std::optional<int64_t> ffi_fallback_delay_ps_;
@@ -514,6 +573,8 @@ class SchedulingOptions {
   std::string fdo_yosys_path_;
   std::string fdo_sta_path_;
   std::string fdo_synthesis_libraries_;
+  int64_t fdo_synthesis_threads_;
+  std::string fdo_synthesis_cache_path_;
   bool schedule_all_procs_;
 };
 
@@ -188,17 +188,29 @@ ComputeCombinationalDelayConstraints(
 SDCSchedulingModel::SDCSchedulingModel(FunctionBase* func,
                                        const DelayMap& delay_map,
                                        std::string_view model_name)
+    : SDCSchedulingModel(func, delay_map, /*distances_to_node=*/nullptr,
+                         model_name) {}
+
+SDCSchedulingModel::SDCSchedulingModel(
+    FunctionBase* func, const DelayMap& delay_map,
+    std::shared_ptr<const DistanceMap> distances_to_node,
+    std::string_view model_name)
     : func_(func),
       topo_sort_(TopoSort(func_)),
       model_(model_name),
       delay_map_(delay_map),
+      distances_to_node_(std::move(distances_to_node)),
       last_stage_(model_.AddContinuousVariable(0.0, kInfinity, "last_stage")),
       cycle_at_sinknode_(model_.AddContinuousVariable(-kInfinity, kInfinity,
                                                       "cycle_at_sinknode")) {
   // when subclassed for Iterative SDC, delay_map_ and distances_to_node_
   // are not used.
-  if (!delay_map_.empty()) {
-    distances_to_node_ = ComputeDistancesToNodes(func_, topo_sort_, delay_map_);
+  if (distances_to_node_ == nullptr) {
+    distances_to_node_ =
+        delay_map_.empty()
+            ? std::make_shared<const DistanceMap>()
+            : std::make_shared<const DistanceMap>(
+                  ComputeDistancesToNodes(func_, topo_sort_, delay_map_));
   }
 
   for (Node* node : topo_sort_) {
@@ -529,7 +541,7 @@ void SDCSchedulingModel::SetClockPeriod(int64_t clock_period_ps) {
   absl::flat_hash_map<Node*, std::vector<Node*>> prev_delay_constraints =
       std::move(delay_constraints_);
   delay_constraints_ = ComputeCombinationalDelayConstraints(
-      func_, topo_sort_, clock_period_ps, distances_to_node_, delay_map_);
+      func_, topo_sort_, clock_period_ps, *distances_to_node_, delay_map_);
 
   for (Node* source : topo_sort_) {
     if (!prev_delay_constraints.empty()) {
@@ -922,6 +934,22 @@ SDCScheduler::SDCScheduler(FunctionBase* f, DelayMap delay_map)
       delay_map_(std::move(delay_map)),
       model_(f, delay_map_, absl::StrCat("sdc_model:", f->name())) {}
 
+SDCScheduler::SDCScheduler(
+    FunctionBase* f, DelayMap delay_map,
+    std::shared_ptr<const SDCSchedulingModel::DistanceMap> distances_to_node)
+    : f_(f),
+      delay_map_(std::move(delay_map)),
+      model_(f, delay_map_, std::move(distances_to_node),
+             absl::StrCat("sdc_model:", f->name())) {}
+
+absl::StatusOr<std::unique_ptr<SDCScheduler>> SDCScheduler::Clone() const {
+  std::unique_ptr<SDCScheduler> clone(
+      new SDCScheduler(f_, delay_map_, model_.distances_to_node()));
+  XLS_RETURN_IF_ERROR(clone->Initialize());
+  XLS_RETURN_IF_ERROR(clone->AddConstraints(constraints_));
+  return std::move(clone);
+}
+
 absl::Status SDCScheduler::Initialize() {
   XLS_ASSIGN_OR_RETURN(
       solver_, math_opt::IncrementalSolver::New(&model_.UnderlyingModel(),
@@ -956,6 +984,7 @@ absl::Status SDCScheduler::AddConstraints(
     absl::Span<const SchedulingConstraint> constraints) {
   for (const SchedulingConstraint& constraint : constraints) {
     XLS_RETURN_IF_ERROR(model_.AddSchedulingConstraint(constraint));
+    constraints_.push_back(constraint);
   }
   return absl::OkStatus();
 }
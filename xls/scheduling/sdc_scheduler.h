@@ -46,9 +46,29 @@ class SDCSchedulingModel {
   static constexpr double kInfinity = std::numeric_limits<double>::infinity();
 
  public:
+  // Critical-path distances between all pairs of nodes; see
+  // `distances_to_node()`.
+  using DistanceMap =
+      absl::flat_hash_map<Node*, absl::flat_hash_map<Node*, int64_t>>;
+
+  SDCSchedulingModel(FunctionBase* func, const DelayMap& delay_map,
+                     std::string_view model_name = "");
+
+  // As above, but reuses `distances_to_node` (which must have been computed
+  // for `func` and `delay_map`) rather than recomputing it. Computing the
+  // distances is quadratic in the size of `func`, so models which are built
+  // repeatedly for the same function should share them.
   SDCSchedulingModel(FunctionBase* func, const DelayMap& delay_map,
+                     std::shared_ptr<const DistanceMap> distances_to_node,
                      std::string_view model_name = "");
 
+  // Returns the critical-path distances between all pairs of nodes; if there
+  // is a path from `x` to `y`, `(*distances_to_node())[y][x]` is the length of
+  // the critical path. Empty if the model was built without a delay map.
+  const std::shared_ptr<const DistanceMap>& distances_to_node() const {
+    return distances_to_node_;
+  }
+
   absl::Status AddDefUseConstraints(Node* node, std::optional<Node*> user);
   absl::Status AddCausalConstraint(Node* node, std::optional<Node*> user);
   absl::Status AddLifetimeConstraint(Node* node, std::optional<Node*> user);
@@ -153,10 +173,10 @@ class SDCSchedulingModel {
   const DelayMap& delay_map_;
 
   // Stores the critical-path distances between all pairs of Nodes; if there is
-  // a path from `x` to `y`, `distances_to_node_[y][x]` is the length of the
-  // critical path.
-  absl::flat_hash_map<Node*, absl::flat_hash_map<Node*, int64_t>>
-      distances_to_node_;
+  // a path from `x` to `y`, `(*distances_to_node_)[y][x]` is the length of the
+  // critical path. Never null, and immutable so it can be shared between
+  // models of the same function.
+  std::shared_ptr<const DistanceMap> distances_to_node_;
 
   operations_research::math_opt::Variable last_stage_;
   std::optional<operations_research::math_opt::Variable> last_stage_slack_;
@@ -217,6 +237,12 @@ class SDCScheduler {
   absl::Status AddConstraints(
       absl::Span<const SchedulingConstraint> constraints);
 
+  // Returns a new scheduler for the same function with the same constraints
+  // but an independent LP model and solver, so that the original and the clone
+  // may `Schedule` concurrently. The node delays and critical-path distances
+  // are shared rather than recomputed.
+  absl::StatusOr<std::unique_ptr<SDCScheduler>> Clone() const;
+
   // Schedule to minimize the total pipeline registers using SDC scheduling
   // the constraint matrix is totally unimodular, this ILP problem can be solved
   // by LP.
@@ -248,6 +274,9 @@ class SDCScheduler {
 
  private:
   SDCScheduler(FunctionBase* f, DelayMap delay_map);
+  SDCScheduler(
+      FunctionBase* f, DelayMap delay_map,
+      std::shared_ptr<const SDCSchedulingModel::DistanceMap> distances_to_node);
   absl::Status Initialize();
 
   absl::Status BuildError(
@@ -256,6 +285,7 @@ class SDCScheduler {
 
   FunctionBase* f_;
   DelayMap delay_map_;
+  std::vector<SchedulingConstraint> constraints_;
 
   SDCSchedulingModel model_;
   std::unique_ptr<operations_research::math_opt::IncrementalSolver> solver_;
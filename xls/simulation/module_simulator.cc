@@ -24,6 +24,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -37,8 +38,13 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/interpreter/block_evaluator.h"
 #include "xls/ir/bits.h"
+#include "xls/ir/block.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/ir/value_utils.h"
 #include "xls/simulation/module_testbench.h"
 #include "xls/simulation/module_testbench_thread.h"
 #include "xls/tools/eval_utils.h"
@@ -269,6 +275,243 @@ absl::StatusOr<std::vector<std::unique_ptr<Bits>>> CaptureOutputChannel(
   return outputs;
 }
 
+// The number of cycles for which a block is held in reset before simulation,
+// matching the reset sequence of ModuleTestbench.
+constexpr int64_t kBlockResetCycles = 5;
+
+// Drives the ports of a block cycle by cycle through a BlockContinuation. Like
+// the signals driven by a testbench, inputs hold their value across cycles
+// until set again. Inputs which have not been set, or have been set to X, are
+// driven with zeros.
+class BlockSimulation {
+ public:
+  static absl::StatusOr<BlockSimulation> Create(
+      Block* block, const BlockEvaluator& evaluator) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<BlockContinuation> continuation,
+                         evaluator.NewContinuation(block));
+    BlockSimulation simulation(std::move(continuation));
+    for (InputPort* port : block->GetInputPorts()) {
+      simulation.input_types_[port->GetName()] = port->GetType();
+      simulation.inputs_[port->GetName()] = ZeroOfType(port->GetType());
+    }
+    return simulation;
+  }
+
+  absl::Status Set(std::string_view port_name, const Bits& bits) {
+    XLS_ASSIGN_OR_RETURN(Type * type, GetInputType(port_name));
+    XLS_ASSIGN_OR_RETURN(inputs_[port_name], UnflattenBitsToValue(bits, type));
+    return absl::OkStatus();
+  }
+  absl::Status SetX(std::string_view port_name) {
+    XLS_ASSIGN_OR_RETURN(Type * type, GetInputType(port_name));
+    inputs_[port_name] = ZeroOfType(type);
+    return absl::OkStatus();
+  }
+  absl::Status Set(std::string_view port_name, const BitsOrX& value) {
+    if (std::holds_alternative<IsX>(value)) {
+      return SetX(port_name);
+    }
+    return Set(port_name, std::get<Bits>(value));
+  }
+
+  // Evaluates the block for one cycle with the currently driven inputs and
+  // clocks its registers.
+  absl::Status RunCycle() {
+    XLS_RETURN_IF_ERROR(continuation_->RunOneCycle(inputs_));
+    ++cycle_;
+    return absl::OkStatus();
+  }
+
+  // Returns the value of the given port in the last cycle run: the driven value
+  // for input ports and the value computed by the block for output ports.
+  absl::StatusOr<Bits> Get(std::string_view port_name) {
+    if (auto it = inputs_.find(port_name); it != inputs_.end()) {
+      return FlattenValueToBits(it->second);
+    }
+    const absl::flat_hash_map<std::string, Value>& outputs =
+        continuation_->output_ports();
+    auto it = outputs.find(port_name);
+    if (it == outputs.end()) {
+      return absl::NotFoundError(
+          absl::StrFormat("Block has no port named `%s`", port_name));
+    }
+    return FlattenValueToBits(it->second);
+  }
+
+  // Returns whether the given single-bit port is asserted in the last cycle
+  // run.
+  absl::StatusOr<bool> IsAsserted(std::string_view port_name) {
+    XLS_ASSIGN_OR_RETURN(Bits bits, Get(port_name));
+    XLS_RET_CHECK_EQ(bits.bit_count(), 1) << port_name;
+    return bits.IsOne();
+  }
+
+  // Returns an error if the given port does not have the given value in the
+  // last cycle run.
+  absl::Status ExpectEq(std::string_view port_name, uint64_t expected) {
+    XLS_ASSIGN_OR_RETURN(Bits actual, Get(port_name));
+    if (actual != UBits(expected, actual.bit_count())) {
+      return absl::FailedPreconditionError(absl::StrFormat(
+          "cycle %d: expected %s to have value: %d, actual: %v", cycle_ - 1,
+          port_name, expected, actual));
+    }
+    return absl::OkStatus();
+  }
+
+  // Holds the block in reset, then deasserts reset, as the reset controller of
+  // ModuleTestbench does.
+  absl::Status Reset(const ResetProto& reset) {
+    XLS_RETURN_IF_ERROR(
+        Set(reset.name(), UBits(reset.active_low() ? 0 : 1, 1)));
+    for (int64_t i = 0; i < kBlockResetCycles; ++i) {
+      XLS_RETURN_IF_ERROR(RunCycle());
+    }
+    return Set(reset.name(), UBits(reset.active_low() ? 1 : 0, 1));
+  }
+
+ private:
+  explicit BlockSimulation(std::unique_ptr<BlockContinuation> continuation)
+      : continuation_(std::move(continuation)) {}
+
+  absl::StatusOr<Type*> GetInputType(std::string_view port_name) const {
+    auto it = input_types_.find(port_name);
+    if (it == input_types_.end()) {
+      return absl::NotFoundError(
+          absl::StrFormat("Block has no input port named `%s`", port_name));
+    }
+    return it->second;
+  }
+
+  std::unique_ptr<BlockContinuation> continuation_;
+  absl::flat_hash_map<std::string, Type*> input_types_;
+  absl::flat_hash_map<std::string, Value> inputs_;
+  int64_t cycle_ = 0;
+};
+
+// A step of a testbench thread driving block inputs: sets the given inputs,
+// then holds them for `cycles` cycles or, if `wait_for` is given, until the end
+// of a cycle in which that signal is asserted.
+struct DriveStep {
+  std::vector<std::pair<std::string, BitsOrX>> sets;
+  int64_t cycles = 0;
+  std::optional<std::string> wait_for;
+};
+
+// Executes a sequence of DriveSteps, the equivalent of the testbench thread
+// which DriveInputChannel or CaptureOutputChannel create. As in the testbench,
+// a step which holds for no cycles takes no time, so the inputs it sets are
+// overridden by the following step.
+class DriveStepRunner {
+ public:
+  explicit DriveStepRunner(std::vector<DriveStep> steps)
+      : steps_(std::move(steps)) {}
+
+  // Applies the inputs of all steps which start in the current cycle.
+  absl::Status StartCycle(BlockSimulation& simulation) {
+    while (!holding() && next_step_ < steps_.size()) {
+      const DriveStep& step = steps_[next_step_];
+      for (const auto& [port_name, value] : step.sets) {
+        XLS_RETURN_IF_ERROR(simulation.Set(port_name, value));
+      }
+      remaining_cycles_ = step.cycles;
+      waiting_ = step.wait_for.has_value();
+      ++next_step_;
+    }
+    return absl::OkStatus();
+  }
+
+  // Advances the current step at the end of a cycle.
+  absl::Status EndCycle(BlockSimulation& simulation) {
+    if (remaining_cycles_ > 0) {
+      --remaining_cycles_;
+    } else if (waiting_) {
+      XLS_ASSIGN_OR_RETURN(
+          bool asserted,
+          simulation.IsAsserted(*steps_[next_step_ - 1].wait_for));
+      waiting_ = !asserted;
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  bool holding() const { return remaining_cycles_ > 0 || waiting_; }
+
+  std::vector<DriveStep> steps_;
+  int64_t next_step_ = 0;
+  int64_t remaining_cycles_ = 0;
+  bool waiting_ = false;
+};
+
+// Returns the steps driving the given inputs onto a channel. Mirrors
+// DriveInputChannel.
+absl::StatusOr<std::vector<DriveStep>> InputChannelDriveSteps(
+    absl::Span<const Bits> inputs, const ChannelProto& channel_proto,
+    absl::Span<const ValidHoldoff> valid_holdoffs) {
+  const std::string& data_port_name = channel_proto.data_port_name();
+  std::vector<DriveStep> steps;
+  for (int64_t input_number = 0; input_number < inputs.size(); ++input_number) {
+    if (!valid_holdoffs.empty()) {
+      XLS_RET_CHECK(channel_proto.has_valid_port_name()) << absl::StreamFormat(
+          "Valid hold-off specified for channel without a valid signal: "
+          "`%s`",
+          channel_proto.name());
+      const ValidHoldoff& valid_holdoff = valid_holdoffs[input_number];
+      std::pair<std::string, BitsOrX> deassert_valid = {
+          channel_proto.valid_port_name(), UBits(0, 1)};
+      if (valid_holdoff.driven_values.empty()) {
+        steps.push_back(DriveStep{
+            .sets = {deassert_valid, {data_port_name, IsX()}},
+            .cycles = valid_holdoff.cycles});
+      } else {
+        for (const BitsOrX& bits_or_x : valid_holdoff.driven_values) {
+          steps.push_back(
+              DriveStep{.sets = {deassert_valid, {data_port_name, bits_or_x}},
+                        .cycles = 1});
+        }
+      }
+    }
+    DriveStep step{.sets = {{data_port_name, inputs[input_number]}}};
+    if (channel_proto.has_valid_port_name()) {
+      step.sets.push_back({channel_proto.valid_port_name(), UBits(1, 1)});
+    }
+    if (channel_proto.has_ready_port_name()) {
+      step.wait_for = channel_proto.ready_port_name();
+    }
+    steps.push_back(std::move(step));
+  }
+  DriveStep last_step{.sets = {{data_port_name, IsX()}}};
+  if (channel_proto.has_valid_port_name()) {
+    last_step.sets.push_back({channel_proto.valid_port_name(), UBits(0, 1)});
+  }
+  steps.push_back(std::move(last_step));
+  return steps;
+}
+
+// Returns the steps driving the ready signal of an output channel with the
+// given holdoffs. Mirrors CaptureOutputChannel.
+std::vector<DriveStep> OutputChannelReadySteps(
+    std::string_view ready_port_name,
+    absl::Span<const int64_t> ready_holdoffs) {
+  std::vector<DriveStep> steps;
+  int64_t assertion_length = 1;
+  for (int64_t holdoff : ready_holdoffs) {
+    if (holdoff == 0) {
+      ++assertion_length;
+    } else {
+      steps.push_back(
+          DriveStep{.sets = {{std::string{ready_port_name}, UBits(1, 1)}},
+                    .cycles = assertion_length});
+      steps.push_back(
+          DriveStep{.sets = {{std::string{ready_port_name}, UBits(0, 1)}},
+                    .cycles = holdoff});
+      assertion_length = 1;
+    }
+  }
+  steps.push_back(
+      DriveStep{.sets = {{std::string{ready_port_name}, UBits(1, 1)}}});
+  return steps;
+}
+
 }  // namespace
 
 std::vector<DutInput> ModuleSimulator::DeassertControlSignals() const {
@@ -282,6 +525,11 @@ std::vector<DutInput> ModuleSimulator::DeassertControlSignals() const {
           DutInput{.port_name = pipeline_control.valid().input_name(),
                    .initial_value = UBits(0, 1)});
     }
+    if (pipeline_control.has_manual()) {
+      dut_inputs.push_back(DutInput{
+          .port_name = pipeline_control.manual().input_name(),
+          .initial_value = UBits(0, signature_.proto().pipeline().latency())});
+    }
   }
   return dut_inputs;
 }
@@ -334,6 +582,10 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
     return absl::InvalidArgumentError("Expected clock in signature");
   }
 
+  if (block_ != nullptr) {
+    return RunBatchedOnBlock(inputs);
+  }
+
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<ModuleTestbench> tb,
                        ModuleTestbench::CreateFromVerilogText(
                            verilog_text_, file_type_, signature_, simulator_,
@@ -488,6 +740,113 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
   return outputs;
 }
 
+absl::StatusOr<std::vector<ModuleSimulator::BitsMap>>
+ModuleSimulator::RunBatchedOnBlock(absl::Span<const BitsMap> inputs) const {
+  XLS_ASSIGN_OR_RETURN(BlockSimulation simulation,
+                       BlockSimulation::Create(block_, *block_evaluator_));
+  if (signature_.proto().has_reset()) {
+    XLS_RETURN_IF_ERROR(simulation.Reset(signature_.proto().reset()));
+  }
+
+  auto drive_data = [&](int64_t index) -> absl::Status {
+    for (const PortProto& input : signature_.data_inputs()) {
+      XLS_RETURN_IF_ERROR(
+          simulation.Set(input.name(), inputs[index].at(input.name())));
+    }
+    return absl::OkStatus();
+  };
+  auto clear_data = [&]() -> absl::Status {
+    for (const PortProto& input : signature_.data_inputs()) {
+      XLS_RETURN_IF_ERROR(simulation.SetX(input.name()));
+    }
+    return absl::OkStatus();
+  };
+  std::vector<BitsMap> outputs(inputs.size());
+  auto capture_outputs = [&](int64_t index) -> absl::Status {
+    for (const PortProto& output : signature_.data_outputs()) {
+      XLS_ASSIGN_OR_RETURN(outputs[index][output.name()],
+                           simulation.Get(output.name()));
+    }
+    return absl::OkStatus();
+  };
+
+  // The cycles driven below follow the testbench built by RunBatched.
+  if (signature_.proto().has_fixed_latency()) {
+    const int64_t latency = signature_.proto().fixed_latency().latency();
+    for (int64_t i = 0; i < inputs.size(); ++i) {
+      XLS_RETURN_IF_ERROR(drive_data(i));
+      for (int64_t cycle = 0; cycle <= latency; ++cycle) {
+        XLS_RETURN_IF_ERROR(simulation.RunCycle());
+      }
+      XLS_RETURN_IF_ERROR(capture_outputs(i));
+      // Hold the inputs for one more cycle while the output is read.
+      XLS_RETURN_IF_ERROR(simulation.RunCycle());
+    }
+  } else if (signature_.proto().has_pipeline()) {
+    const int64_t latency = signature_.proto().pipeline().latency();
+    std::optional<std::string> input_valid;
+    std::optional<std::string> output_valid;
+    if (signature_.proto().pipeline().has_pipeline_control()) {
+      const PipelineControl& pipeline_control =
+          signature_.proto().pipeline().pipeline_control();
+      if (pipeline_control.has_manual()) {
+        XLS_RETURN_IF_ERROR(simulation.Set(
+            pipeline_control.manual().input_name(), Bits::AllOnes(latency)));
+      }
+      if (pipeline_control.has_valid()) {
+        input_valid = pipeline_control.valid().input_name();
+        if (pipeline_control.valid().has_output_name()) {
+          output_valid = pipeline_control.valid().output_name();
+        }
+      }
+    }
+
+    // Input i is driven in cycle i and its outputs are captured in cycle
+    // i + latency. The final cycle checks that the deasserted valid has
+    // propagated through the pipeline.
+    const int64_t input_count = inputs.size();
+    const int64_t last_cycle = input_count + latency;
+    for (int64_t cycle = 0; cycle <= last_cycle; ++cycle) {
+      if (cycle < input_count) {
+        XLS_RETURN_IF_ERROR(drive_data(cycle));
+        if (input_valid.has_value()) {
+          XLS_RETURN_IF_ERROR(simulation.Set(*input_valid, UBits(1, 1)));
+        }
+      } else if (cycle == input_count) {
+        XLS_RETURN_IF_ERROR(clear_data());
+        if (input_valid.has_value()) {
+          XLS_RETURN_IF_ERROR(simulation.Set(*input_valid, UBits(0, 1)));
+        }
+      }
+      XLS_RETURN_IF_ERROR(simulation.RunCycle());
+
+      if (cycle == last_cycle) {
+        if (output_valid.has_value()) {
+          XLS_RETURN_IF_ERROR(simulation.ExpectEq(*output_valid, 0));
+        }
+      } else if (cycle >= latency) {
+        if (output_valid.has_value()) {
+          XLS_RETURN_IF_ERROR(simulation.ExpectEq(*output_valid, 1));
+        }
+        XLS_RETURN_IF_ERROR(capture_outputs(cycle - latency));
+      } else if (cycle < input_count && output_valid.has_value() &&
+                 signature_.proto().has_reset()) {
+        XLS_RETURN_IF_ERROR(simulation.ExpectEq(*output_valid, 0));
+      }
+    }
+  } else if (signature_.proto().has_combinational()) {
+    for (int64_t i = 0; i < inputs.size(); ++i) {
+      XLS_RETURN_IF_ERROR(drive_data(i));
+      XLS_RETURN_IF_ERROR(simulation.RunCycle());
+      XLS_RETURN_IF_ERROR(capture_outputs(i));
+    }
+  } else {
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported interface: ", signature_.proto().interface_oneof_case()));
+  }
+  return outputs;
+}
+
 absl::StatusOr<Value> ModuleSimulator::RunFunction(
     const absl::flat_hash_map<std::string, Value>& inputs) const {
   absl::flat_hash_map<std::string, Value> input_map(inputs.begin(),
@@ -523,6 +882,10 @@ absl::StatusOr<std::string> ModuleSimulator::GenerateProcTestbenchVerilog(
     const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
     const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
     std::optional<ReadyValidHoldoffs> holdoffs) const {
+  if (block_ != nullptr) {
+    return absl::FailedPreconditionError(
+        "No Verilog testbench is generated when simulating a block");
+  }
   XLS_ASSIGN_OR_RETURN(
       ProcTestbench proc_tb,
       CreateProcTestbench(channel_inputs, output_channel_counts,
@@ -530,30 +893,10 @@ absl::StatusOr<std::string> ModuleSimulator::GenerateProcTestbenchVerilog(
   return proc_tb.testbench->GenerateVerilog();
 }
 
-absl::StatusOr<ModuleSimulator::ProcTestbench>
-ModuleSimulator::CreateProcTestbench(
+absl::Status ModuleSimulator::ValidateProcInputs(
     const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
     const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
-    std::optional<ReadyValidHoldoffs> holdoffs) const {
-  XLS_VLOG(1) << "Generating testbench for Verilog module with signature:\n"
-              << signature_.ToString();
-  if (VLOG_IS_ON(1)) {
-    absl::flat_hash_map<std::string, std::vector<Value>> channel_inputs_values;
-    for (const auto& [channel_name, channel_values] : channel_inputs) {
-      XLS_ASSIGN_OR_RETURN(ChannelProto channel_proto,
-                           signature_.GetInputChannelProtoByName(channel_name));
-      XLS_ASSIGN_OR_RETURN(
-          PortProto data_port,
-          signature_.GetInputPortProtoByName(channel_proto.data_port_name()));
-      XLS_ASSIGN_OR_RETURN(
-          channel_inputs_values[channel_name],
-          BitsListToValueList(channel_values, data_port.type()));
-    }
-    XLS_VLOG(1) << "Input channel values:\n";
-    XLS_VLOG(1) << ChannelValuesToString(channel_inputs_values);
-  }
-  XLS_VLOG(2) << "Verilog:\n" << verilog_text_;
-
+    const std::optional<ReadyValidHoldoffs>& holdoffs) const {
   for (const auto& [channel_name, channel_values] : channel_inputs) {
     XLS_RETURN_IF_ERROR(
         signature_.ValidateChannelBitsInputs(channel_name, channel_values));
@@ -584,6 +927,35 @@ ModuleSimulator::CreateProcTestbench(
       !signature_.proto().has_combinational()) {
     return absl::InvalidArgumentError("Expected clock in signature");
   }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<ModuleSimulator::ProcTestbench>
+ModuleSimulator::CreateProcTestbench(
+    const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
+    const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
+    std::optional<ReadyValidHoldoffs> holdoffs) const {
+  XLS_VLOG(1) << "Generating testbench for Verilog module with signature:\n"
+              << signature_.ToString();
+  if (VLOG_IS_ON(1)) {
+    absl::flat_hash_map<std::string, std::vector<Value>> channel_inputs_values;
+    for (const auto& [channel_name, channel_values] : channel_inputs) {
+      XLS_ASSIGN_OR_RETURN(ChannelProto channel_proto,
+                           signature_.GetInputChannelProtoByName(channel_name));
+      XLS_ASSIGN_OR_RETURN(
+          PortProto data_port,
+          signature_.GetInputPortProtoByName(channel_proto.data_port_name()));
+      XLS_ASSIGN_OR_RETURN(
+          channel_inputs_values[channel_name],
+          BitsListToValueList(channel_values, data_port.type()));
+    }
+    XLS_VLOG(1) << "Input channel values:\n";
+    XLS_VLOG(1) << ChannelValuesToString(channel_inputs_values);
+  }
+  XLS_VLOG(2) << "Verilog:\n" << verilog_text_;
+
+  XLS_RETURN_IF_ERROR(
+      ValidateProcInputs(channel_inputs, output_channel_counts, holdoffs));
 
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<ModuleTestbench> tb,
                        ModuleTestbench::CreateFromVerilogText(
@@ -635,18 +1007,26 @@ ModuleSimulator::RunInputSeriesProc(
     const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
     const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
     std::optional<ReadyValidHoldoffs> holdoffs) const {
-  XLS_ASSIGN_OR_RETURN(
-      ProcTestbench proc_tb,
-      CreateProcTestbench(channel_inputs, output_channel_counts,
-                          std::move(holdoffs)));
-  XLS_RETURN_IF_ERROR(proc_tb.testbench->Run());
-
   absl::flat_hash_map<std::string, std::vector<Bits>> outputs;
-  for (const ChannelProto& channel_proto : signature_.GetOutputChannels()) {
-    std::string_view channel_name = channel_proto.name();
-    outputs[channel_name] = std::vector<Bits>();
-    for (std::unique_ptr<Bits>& bits : proc_tb.outputs.at(channel_name)) {
-      outputs[channel_name].push_back(std::move(*bits));
+  if (block_ != nullptr) {
+    XLS_RETURN_IF_ERROR(
+        ValidateProcInputs(channel_inputs, output_channel_counts, holdoffs));
+    XLS_ASSIGN_OR_RETURN(outputs,
+                         RunInputSeriesProcOnBlock(
+                             channel_inputs, output_channel_counts, holdoffs));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        ProcTestbench proc_tb,
+        CreateProcTestbench(channel_inputs, output_channel_counts,
+                            std::move(holdoffs)));
+    XLS_RETURN_IF_ERROR(proc_tb.testbench->Run());
+
+    for (const ChannelProto& channel_proto : signature_.GetOutputChannels()) {
+      std::string_view channel_name = channel_proto.name();
+      outputs[channel_name] = std::vector<Bits>();
+      for (std::unique_ptr<Bits>& bits : proc_tb.outputs.at(channel_name)) {
+        outputs[channel_name].push_back(std::move(*bits));
+      }
     }
   }
 
@@ -669,6 +1049,109 @@ ModuleSimulator::RunInputSeriesProc(
   return outputs;
 }
 
+absl::StatusOr<absl::flat_hash_map<std::string, std::vector<Bits>>>
+ModuleSimulator::RunInputSeriesProcOnBlock(
+    const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
+    const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
+    const std::optional<ReadyValidHoldoffs>& holdoffs) const {
+  XLS_ASSIGN_OR_RETURN(BlockSimulation simulation,
+                       BlockSimulation::Create(block_, *block_evaluator_));
+  if (signature_.proto().has_reset()) {
+    XLS_RETURN_IF_ERROR(simulation.Reset(signature_.proto().reset()));
+  }
+
+  // One runner for each thread of the testbench built by CreateProcTestbench
+  // which drives inputs of the block.
+  std::vector<DriveStepRunner> runners;
+  for (const ChannelProto& channel_proto : signature_.GetInputChannels()) {
+    std::string_view channel_name = channel_proto.name();
+    auto inputs_it = channel_inputs.find(channel_name);
+    if (inputs_it == channel_inputs.end()) {
+      return absl::NotFoundError(absl::StrFormat(
+          "Channel '%s' not found in channel inputs map.", channel_name));
+    }
+    absl::Span<const ValidHoldoff> valid_holdoffs;
+    if (holdoffs.has_value() &&
+        holdoffs->valid_holdoffs.contains(channel_name)) {
+      valid_holdoffs = holdoffs->valid_holdoffs.at(channel_name);
+    }
+    XLS_ASSIGN_OR_RETURN(
+        std::vector<DriveStep> steps,
+        InputChannelDriveSteps(inputs_it->second, channel_proto,
+                               valid_holdoffs));
+    runners.emplace_back(std::move(steps));
+  }
+
+  struct OutputCapture {
+    std::string data_port_name;
+    std::vector<std::string> flow_control_signals;
+    int64_t count;
+    std::vector<Bits> values;
+  };
+  std::vector<OutputCapture> captures;
+  for (const ChannelProto& channel_proto : signature_.GetOutputChannels()) {
+    std::string_view channel_name = channel_proto.name();
+    OutputCapture& capture = captures.emplace_back(OutputCapture{
+        .data_port_name = channel_proto.data_port_name(),
+        .count = output_channel_counts.at(channel_name)});
+    if (channel_proto.has_valid_port_name()) {
+      capture.flow_control_signals.push_back(channel_proto.valid_port_name());
+    }
+    if (channel_proto.has_ready_port_name()) {
+      capture.flow_control_signals.push_back(channel_proto.ready_port_name());
+      absl::Span<const int64_t> ready_holdoffs;
+      if (holdoffs.has_value() &&
+          holdoffs->ready_holdoffs.contains(channel_name)) {
+        ready_holdoffs = holdoffs->ready_holdoffs.at(channel_name);
+      }
+      runners.emplace_back(OutputChannelReadySteps(
+          channel_proto.ready_port_name(), ready_holdoffs));
+    }
+  }
+
+  auto all_captured = [&]() {
+    return absl::c_all_of(captures, [](const OutputCapture& capture) {
+      return capture.values.size() >= capture.count;
+    });
+  };
+  for (int64_t cycle = 0; !all_captured(); ++cycle) {
+    if (cycle >= kDefaultSimulationCycleLimit) {
+      return absl::DeadlineExceededError(
+          absl::StrFormat("Simulation exceeded maximum length of %d cycles.",
+                          kDefaultSimulationCycleLimit));
+    }
+    for (DriveStepRunner& runner : runners) {
+      XLS_RETURN_IF_ERROR(runner.StartCycle(simulation));
+    }
+    XLS_RETURN_IF_ERROR(simulation.RunCycle());
+    for (OutputCapture& capture : captures) {
+      if (capture.values.size() >= capture.count) {
+        continue;
+      }
+      bool transfer = true;
+      for (const std::string& signal : capture.flow_control_signals) {
+        XLS_ASSIGN_OR_RETURN(bool asserted, simulation.IsAsserted(signal));
+        transfer = transfer && asserted;
+      }
+      if (transfer) {
+        XLS_ASSIGN_OR_RETURN(Bits data, simulation.Get(capture.data_port_name));
+        capture.values.push_back(std::move(data));
+      }
+    }
+    for (DriveStepRunner& runner : runners) {
+      XLS_RETURN_IF_ERROR(runner.EndCycle(simulation));
+    }
+  }
+
+  absl::flat_hash_map<std::string, std::vector<Bits>> outputs;
+  int64_t capture_index = 0;
+  for (const ChannelProto& channel_proto : signature_.GetOutputChannels()) {
+    outputs[channel_proto.name()] =
+        std::move(captures[capture_index++].values);
+  }
+  return outputs;
+}
+
 absl::StatusOr<absl::flat_hash_map<std::string, std::vector<Value>>>
 ModuleSimulator::RunInputSeriesProc(
     const absl::flat_hash_map<std::string, std::vector<Value>>& channel_inputs,
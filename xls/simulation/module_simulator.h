@@ -15,6 +15,7 @@
 #ifndef XLS_SIMULATION_MODULE_SIMULATOR_H_
 #define XLS_SIMULATION_MODULE_SIMULATOR_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,9 +23,13 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/vast.h"
+#include "xls/interpreter/block_evaluator.h"
+#include "xls/ir/block.h"
 #include "xls/ir/value.h"
 #include "xls/simulation/module_testbench.h"
 #include "xls/simulation/verilog_simulator.h"
@@ -71,7 +76,9 @@ struct ReadyValidHoldoffs {
 };
 
 // Abstraction for simulating a module described by a SignatureProto using a
-// testbench run under the Verilog simulator.
+// testbench run under the Verilog simulator. Alternatively, the block from
+// which the module was generated can be evaluated in process (e.g., with the
+// block JIT), driven cycle by cycle with the same testbench semantics.
 class ModuleSimulator {
  public:
   // Type alias for passing named Bits value to and from module simulation.
@@ -91,6 +98,21 @@ class ModuleSimulator {
         simulator_(simulator),
         includes_(includes) {}
 
+  // Constructor for a simulator which evaluates `block` with `evaluator`
+  // rather than running a Verilog simulator. `block` must be the block from
+  // which the module described by `signature` was generated, and must outlive
+  // the simulator. Its ports are driven and sampled as the testbench would
+  // drive and sample the ports of the module, including reset, except that X
+  // values are driven as zeros and expectations of X are not checked. This is
+  // much faster than Verilog simulation and needs no external simulator.
+  ModuleSimulator(const ModuleSignature& signature, Block* block,
+                  const BlockEvaluator* evaluator)
+      : signature_(signature),
+        file_type_(FileType::kVerilog),
+        simulator_(nullptr),
+        block_(block),
+        block_evaluator_(evaluator) {}
+
   // Simulates the module with the given inputs as Bits types. Returns a
   // map containing the outputs by port name.
   absl::StatusOr<BitsMap> RunFunction(const BitsMap& inputs) const;
@@ -130,7 +152,7 @@ class ModuleSimulator {
   absl::StatusOr<Value> RunFunction(absl::Span<const Value> inputs) const;
 
   // Returns the (System)Verilog testbench for testing the module with the given
-  // inputs and expected outputs counts.
+  // inputs and expected outputs counts. Not supported when simulating a block.
   absl::StatusOr<std::string> GenerateProcTestbenchVerilog(
       const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
       const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
@@ -153,11 +175,31 @@ class ModuleSimulator {
       const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
       std::optional<ReadyValidHoldoffs> holdoffs) const;
 
+  // Checks the arguments of RunInputSeriesProc against the signature.
+  absl::Status ValidateProcInputs(
+      const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
+      const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
+      const std::optional<ReadyValidHoldoffs>& holdoffs) const;
+
+  // Implementations of RunBatched and RunInputSeriesProc which evaluate
+  // `block_` instead of running a Verilog simulator.
+  absl::StatusOr<std::vector<BitsMap>> RunBatchedOnBlock(
+      absl::Span<const BitsMap> inputs) const;
+  absl::StatusOr<absl::flat_hash_map<std::string, std::vector<Bits>>>
+  RunInputSeriesProcOnBlock(
+      const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
+      const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
+      const std::optional<ReadyValidHoldoffs>& holdoffs) const;
+
   ModuleSignature signature_;
   std::string verilog_text_;
   FileType file_type_;
   const VerilogSimulator* simulator_;
   absl::Span<const VerilogInclude> includes_;
+
+  // Set when simulating a block rather than Verilog text.
+  Block* block_ = nullptr;
+  const BlockEvaluator* block_evaluator_ = nullptr;
 };
 
 }  // namespace verilog
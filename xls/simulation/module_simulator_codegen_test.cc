@@ -12,31 +12,44 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/block_generator.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/combinational_generator.h"
 #include "xls/codegen/module_signature.h"
+#include "xls/codegen/module_signature.pb.h"
 #include "xls/codegen/pipeline_generator.h"
 #include "xls/codegen/signature_generator.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/delay_model/delay_estimators.h"
 #include "xls/ir/bits.h"
+#include "xls/ir/block.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/block_jit.h"
 #include "xls/scheduling/pipeline_schedule.h"
 #include "xls/scheduling/run_pipeline_schedule.h"
 #include "xls/scheduling/scheduling_options.h"
 #include "xls/simulation/module_simulator.h"
+#include "xls/simulation/verilog_simulators.h"
 #include "xls/simulation/verilog_test_base.h"
 
 namespace xls {
@@ -50,9 +63,50 @@ using ::testing::HasSubstr;
 // A test for ModuleSimulator which uses generated Verilog.
 class ModuleSimulatorCodegenTest : public VerilogTestBase {
  protected:
+  // Runs `inputs` through `block` with the block JIT and through the Verilog
+  // generated from it with the Verilog simulator, and checks that both produce
+  // `expected`.
+  void ExpectBlockJitMatchesVerilog(
+      const ModuleSignature& signature, std::string_view verilog_text,
+      Block* block, const std::vector<ModuleSimulator::BitsMap>& inputs,
+      const std::vector<ModuleSimulator::BitsMap>& expected) {
+    ModuleSimulator jit_simulator(signature, block,
+                                  &kStreamingJitBlockEvaluator);
+    EXPECT_THAT(jit_simulator.RunBatched(inputs), IsOkAndHolds(expected));
+    ModuleSimulator verilog_simulator =
+        NewModuleSimulator(verilog_text, signature);
+    EXPECT_THAT(verilog_simulator.RunBatched(inputs), IsOkAndHolds(expected));
+  }
+
   const DelayEstimator* delay_estimator_ = GetDelayEstimator("unit").value();
 };
 
+// Builds a two stage pipeline computing `x + y` by hand. Codegen emits neither
+// manual pipeline control nor fixed latency interfaces, so blocks with those
+// interfaces are built directly. If `load_enable` is given, each stage's
+// registers are loaded only when the corresponding bit of that input is set.
+absl::StatusOr<Block*> BuildAddPipelineBlock(
+    Package* package, std::optional<std::string_view> load_enable) {
+  BlockBuilder bb("add_pipeline", package);
+  XLS_RETURN_IF_ERROR(bb.AddClockPort("clk"));
+  Type* u32 = package->GetBitsType(32);
+  BValue x = bb.InputPort("x", u32);
+  BValue y = bb.InputPort("y", u32);
+  std::optional<BValue> p0_load_enable;
+  std::optional<BValue> p1_load_enable;
+  if (load_enable.has_value()) {
+    BValue le = bb.InputPort(*load_enable, package->GetBitsType(2));
+    p0_load_enable = bb.BitSlice(le, /*start=*/0, /*width=*/1);
+    p1_load_enable = bb.BitSlice(le, /*start=*/1, /*width=*/1);
+  }
+  BValue p0_x = bb.InsertRegister("p0_x", x, p0_load_enable);
+  BValue p0_y = bb.InsertRegister("p0_y", y, p0_load_enable);
+  BValue p1_sum =
+      bb.InsertRegister("p1_sum", bb.Add(p0_x, p0_y), p1_load_enable);
+  bb.OutputPort("out", p1_sum);
+  return bb.Build();
+}
+
 TEST_P(ModuleSimulatorCodegenTest, PassThroughPipeline) {
   Package package(TestName());
   FunctionBuilder fb("pass_through", &package);
@@ -570,11 +624,307 @@ TEST_P(ModuleSimulatorCodegenTest, ProcEmptyTuple) {
               "Input value 'input' is wrong type. Expected '()', got '(())'")));
 }
 
+TEST_P(ModuleSimulatorCodegenTest, BlockJitMatchesVerilogForPipeline) {
+  Package package(TestName());
+  FunctionBuilder fb("x_times_y_plus_z", &package);
+  Type* u32 = package.GetBitsType(32);
+  BValue x = fb.Param("x", u32);
+  BValue y = fb.Param("y", u32);
+  BValue z = fb.Param("z", u32);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func,
+                           fb.BuildWithReturnValue(fb.UMul(x, y) + z));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      RunPipelineSchedule(func, *delay_estimator_,
+                          SchedulingOptions().pipeline_stages(3)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleGeneratorResult result,
+      ToPipelineModuleText(
+          schedule, func,
+          BuildPipelineOptions().use_system_verilog(UseSystemVerilog())));
+  ASSERT_FALSE(result.signature.proto().pipeline().has_pipeline_control());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           package.GetBlock(result.signature.module_name()));
+
+  std::vector<ModuleSimulator::BitsMap> inputs;
+  std::vector<ModuleSimulator::BitsMap> expected;
+  for (int64_t i = 0; i < 5; ++i) {
+    inputs.push_back(
+        {{"x", UBits(i, 32)}, {"y", UBits(i + 3, 32)}, {"z", UBits(7, 32)}});
+    expected.push_back({{"out", UBits(i * (i + 3) + 7, 32)}});
+  }
+  ExpectBlockJitMatchesVerilog(result.signature, result.verilog_text, block,
+                               inputs, expected);
+}
+
+TEST_P(ModuleSimulatorCodegenTest, BlockJitMatchesVerilogForPipelineWithValid) {
+  Package package(TestName());
+  FunctionBuilder fb("x_plus_y_plus_z_plus_x", &package);
+  Type* u32 = package.GetBitsType(32);
+  auto x = fb.Param("x", u32);
+  auto y = fb.Param("y", u32);
+  auto z = fb.Param("z", u32);
+  auto out = x + y + z + x;
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, fb.BuildWithReturnValue(out));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      RunPipelineSchedule(func, *delay_estimator_,
+                          SchedulingOptions().pipeline_stages(3)));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleGeneratorResult result,
+      ToPipelineModuleText(schedule, func,
+                           BuildPipelineOptions()
+                               .valid_control("valid_in", "valid_out")
+                               .reset("rst", /*asynchronous=*/false,
+                                      /*active_low=*/true,
+                                      /*reset_data_path=*/false)
+                               .use_system_verilog(UseSystemVerilog())));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           package.GetBlock(result.signature.module_name()));
+
+  std::vector<ModuleSimulator::BitsMap> inputs;
+  std::vector<ModuleSimulator::BitsMap> expected;
+  for (int64_t i = 0; i < 7; ++i) {
+    inputs.push_back(
+        {{"x", UBits(i, 32)}, {"y", UBits(100 * i, 32)}, {"z", UBits(5, 32)}});
+    expected.push_back({{"out", UBits(102 * i + 5, 32)}});
+  }
+  ExpectBlockJitMatchesVerilog(result.signature, result.verilog_text, block,
+                               inputs, expected);
+}
+
+TEST_P(ModuleSimulatorCodegenTest,
+       BlockJitMatchesVerilogForPipelineWithManualControl) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           BuildAddPipelineBlock(&package, "load_enable"));
+  CodegenOptions options;
+  options.use_system_verilog(UseSystemVerilog());
+  options.clock_name("clk");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string verilog,
+                           GenerateVerilog(block, options));
+  PipelineControl pipeline_control;
+  pipeline_control.mutable_manual()->set_input_name("load_enable");
+  ModuleSignatureBuilder builder(block->name());
+  builder.WithClock("clk")
+      .AddDataInputAsBits("x", 32)
+      .AddDataInputAsBits("y", 32)
+      .AddDataOutputAsBits("out", 32)
+      .WithPipelineInterface(/*latency=*/2, /*initiation_interval=*/1,
+                             pipeline_control);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, builder.Build());
+
+  std::vector<ModuleSimulator::BitsMap> inputs;
+  std::vector<ModuleSimulator::BitsMap> expected;
+  for (int64_t i = 0; i < 4; ++i) {
+    inputs.push_back({{"x", UBits(i, 32)}, {"y", UBits(10 * i, 32)}});
+    expected.push_back({{"out", UBits(11 * i, 32)}});
+  }
+  ExpectBlockJitMatchesVerilog(signature, verilog, block, inputs, expected);
+}
+
+TEST_P(ModuleSimulatorCodegenTest, BlockJitMatchesVerilogForFixedLatency) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Block * block,
+      BuildAddPipelineBlock(&package, /*load_enable=*/std::nullopt));
+  CodegenOptions options;
+  options.use_system_verilog(UseSystemVerilog());
+  options.clock_name("clk");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string verilog,
+                           GenerateVerilog(block, options));
+  ModuleSignatureBuilder builder(block->name());
+  builder.WithClock("clk")
+      .AddDataInputAsBits("x", 32)
+      .AddDataInputAsBits("y", 32)
+      .AddDataOutputAsBits("out", 32)
+      .WithFixedLatencyInterface(/*latency=*/2);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, builder.Build());
+
+  std::vector<ModuleSimulator::BitsMap> inputs;
+  std::vector<ModuleSimulator::BitsMap> expected;
+  for (int64_t i = 0; i < 4; ++i) {
+    inputs.push_back({{"x", UBits(i + 1, 32)}, {"y", UBits(20 * i, 32)}});
+    expected.push_back({{"out", UBits(21 * i + 1, 32)}});
+  }
+  ExpectBlockJitMatchesVerilog(signature, verilog, block, inputs, expected);
+}
+
+TEST_P(ModuleSimulatorCodegenTest, BlockJitMatchesVerilogForCombinational) {
+  Package package(TestName());
+  FunctionBuilder fb("x_minus_y", &package);
+  Type* u16 = package.GetBitsType(16);
+  BValue x = fb.Param("x", u16);
+  BValue y = fb.Param("y", u16);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func,
+                           fb.BuildWithReturnValue(fb.Subtract(x, y)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleGeneratorResult result,
+      GenerateCombinationalModule(func, codegen_options()));
+  ASSERT_TRUE(result.signature.proto().has_combinational());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           package.GetBlock(result.signature.module_name()));
+
+  std::vector<ModuleSimulator::BitsMap> inputs;
+  std::vector<ModuleSimulator::BitsMap> expected;
+  for (int64_t i = 0; i < 4; ++i) {
+    inputs.push_back({{"x", UBits(100 + i, 16)}, {"y", UBits(3 * i, 16)}});
+    expected.push_back({{"out", UBits(100 - 2 * i, 16)}});
+  }
+  ExpectBlockJitMatchesVerilog(result.signature, result.verilog_text, block,
+                               inputs, expected);
+}
+
+TEST_P(ModuleSimulatorCodegenTest, BlockJitMatchesVerilogForProcWithHoldoffs) {
+  Package package(TestName());
+  Type* u32 = package.GetBitsType(32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * in,
+      package.CreateStreamingChannel("in", ChannelOps::kReceiveOnly, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out,
+      package.CreateStreamingChannel("out", ChannelOps::kSendOnly, u32));
+  TokenlessProcBuilder pb("accumulate", "tkn", &package);
+  BValue sum = pb.StateElement("sum", Value(UBits(0, 32)));
+  BValue next_sum = pb.Add(sum, pb.Receive(in));
+  pb.Send(out, next_sum);
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, pb.Build({next_sum}));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      RunPipelineSchedule(proc, *delay_estimator_,
+                          SchedulingOptions().pipeline_stages(1)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleGeneratorResult result,
+      ToPipelineModuleText(schedule, proc,
+                           BuildPipelineOptions()
+                               .reset("rst", /*asynchronous=*/false,
+                                      /*active_low=*/false,
+                                      /*reset_data_path=*/true)
+                               .use_system_verilog(UseSystemVerilog())));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block,
+                           package.GetBlock(result.signature.module_name()));
+
+  absl::flat_hash_map<std::string, std::vector<Bits>> inputs = {
+      {"in", {UBits(1, 32), UBits(2, 32), UBits(3, 32), UBits(4, 32)}}};
+  absl::flat_hash_map<std::string, int64_t> output_channel_counts = {
+      {"out", 4}};
+  absl::flat_hash_map<std::string, std::vector<Bits>> expected = {
+      {"out", {UBits(1, 32), UBits(3, 32), UBits(6, 32), UBits(10, 32)}}};
+  ReadyValidHoldoffs holdoffs;
+  holdoffs.valid_holdoffs["in"] = {
+      ValidHoldoff{.cycles = 2},
+      ValidHoldoff{.cycles = 0},
+      ValidHoldoff{.cycles = 3,
+                   .driven_values = {IsX(), UBits(42, 32), IsX()}},
+      ValidHoldoff{.cycles = 1}};
+  holdoffs.ready_holdoffs["out"] = {1, 0, 3, 0, 0, 2};
+
+  ModuleSimulator jit_simulator(result.signature, block,
+                                &kStreamingJitBlockEvaluator);
+  ModuleSimulator verilog_simulator =
+      NewModuleSimulator(result.verilog_text, result.signature);
+  for (const std::optional<ReadyValidHoldoffs>& maybe_holdoffs :
+       {std::optional<ReadyValidHoldoffs>(), std::optional(holdoffs)}) {
+    EXPECT_THAT(jit_simulator.RunInputSeriesProc(inputs, output_channel_counts,
+                                                 maybe_holdoffs),
+                IsOkAndHolds(expected));
+    EXPECT_THAT(verilog_simulator.RunInputSeriesProc(
+                    inputs, output_channel_counts, maybe_holdoffs),
+                IsOkAndHolds(expected));
+  }
+
+  // Reading more outputs than the proc produces runs into the cycle limit.
+  EXPECT_THAT(jit_simulator.RunInputSeriesProc(inputs, {{"out", 5}}),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+}
+
 INSTANTIATE_TEST_SUITE_P(ModuleSimulatorCodegenTestInstantiation,
                          ModuleSimulatorCodegenTest,
                          testing::ValuesIn(kDefaultSimulationTargets),
                          ParameterizedTestName<ModuleSimulatorCodegenTest>);
 
+// A pipelined function with a valid signal together with the block it was
+// generated from, for comparing simulation backends.
+struct PipelinedDesign {
+  std::unique_ptr<Package> package;
+  ModuleGeneratorResult result;
+  Block* block;
+};
+
+PipelinedDesign CreatePipelinedDesign() {
+  auto package = std::make_unique<Package>("benchmark");
+  FunctionBuilder fb("mul_add", package.get());
+  Type* u32 = package->GetBitsType(32);
+  BValue x = fb.Param("x", u32);
+  BValue y = fb.Param("y", u32);
+  BValue z = fb.Param("z", u32);
+  BValue out = fb.Add(fb.UMul(x, y), fb.UMul(fb.Add(x, z), fb.Subtract(y, z)));
+  Function* func = fb.BuildWithReturnValue(out).value();
+  const DelayEstimator* delay_estimator = GetDelayEstimator("unit").value();
+  PipelineSchedule schedule =
+      RunPipelineSchedule(func, *delay_estimator,
+                          SchedulingOptions().pipeline_stages(4))
+          .value();
+  ModuleGeneratorResult result =
+      ToPipelineModuleText(schedule, func,
+                           BuildPipelineOptions()
+                               .valid_control("valid_in", "valid_out")
+                               .reset("rst", /*asynchronous=*/false,
+                                      /*active_low=*/false,
+                                      /*reset_data_path=*/false)
+                               .use_system_verilog(false))
+          .value();
+  Block* block = package->GetBlock(result.signature.module_name()).value();
+  return PipelinedDesign{.package = std::move(package),
+                         .result = std::move(result),
+                         .block = block};
+}
+
+std::vector<absl::flat_hash_map<std::string, Bits>> CreateBatch(
+    int64_t batch_size) {
+  std::vector<absl::flat_hash_map<std::string, Bits>> inputs;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    inputs.push_back({{"x", UBits(i, 32)},
+                      {"y", UBits(3 * i + 1, 32)},
+                      {"z", UBits(7 * i + 2, 32)}});
+  }
+  return inputs;
+}
+
+// Compare with BM_RunBatchedIverilog for the speed of the block JIT relative to
+// Verilog simulation.
+void BM_RunBatchedBlockJit(benchmark::State& state) {
+  PipelinedDesign design = CreatePipelinedDesign();
+  ModuleSimulator simulator(design.result.signature, design.block,
+                            &kStreamingJitBlockEvaluator);
+  std::vector<absl::flat_hash_map<std::string, Bits>> inputs =
+      CreateBatch(state.range(0));
+  for (auto _ : state) {
+    CHECK_OK(simulator.RunBatched(inputs).status());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RunBatchedBlockJit)->Arg(16)->Arg(1024);
+
+void BM_RunBatchedIverilog(benchmark::State& state) {
+  PipelinedDesign design = CreatePipelinedDesign();
+  ModuleSimulator simulator(design.result.signature,
+                            design.result.verilog_text, FileType::kVerilog,
+                            GetVerilogSimulator("iverilog").value());
+  std::vector<absl::flat_hash_map<std::string, Bits>> inputs =
+      CreateBatch(state.range(0));
+  for (auto _ : state) {
+    CHECK_OK(simulator.RunBatched(inputs).status());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RunBatchedIverilog)->Arg(16)->Arg(1024);
+
 }  // namespace
 }  // namespace verilog
 }  // namespace xls
@@ -762,33 +762,52 @@ static std::string GetPipePathMacroName(std::string_view stream_name) {
   return absl::StrFormat("__%s_PIPE_PATH", absl::AsciiStrToUpper(stream_name));
 }
 
-absl::StatusOr<const TestbenchStream*> ModuleTestbench::CreateInputStream(
-    std::string_view name, int64_t width) {
+absl::Status ModuleTestbench::CheckNewStream(
+    std::string_view name, const TestbenchStreamOptions& options) const {
   if (stream_names_.contains(name)) {
     return absl::InvalidArgumentError(
         absl::StrFormat("Already a I/O stream named `%s`", name));
   }
+  if (options.pipe_capacity.has_value()) {
+    if (options.format != TestbenchStreamFormat::kBinary) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Pipe capacity of stream `%s` can only be set for binary streams",
+          name));
+    }
+    if (*options.pipe_capacity <= 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Pipe capacity of stream `%s` must be positive: %d",
+                          name, *options.pipe_capacity));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<const TestbenchStream*> ModuleTestbench::CreateInputStream(
+    std::string_view name, int64_t width,
+    const TestbenchStreamOptions& options) {
+  XLS_RETURN_IF_ERROR(CheckNewStream(name, options));
   stream_names_.insert(std::string{name});
   streams_.push_back(absl::WrapUnique(
       new TestbenchStream{.name = std::string{name},
                           .direction = TestbenchStreamDirection::kInput,
                           .path_macro_name = GetPipePathMacroName(name),
-                          .width = width}));
+                          .width = width,
+                          .options = options}));
   return streams_.back().get();
 }
 
 absl::StatusOr<const TestbenchStream*> ModuleTestbench::CreateOutputStream(
-    std::string_view name, int64_t width) {
-  if (stream_names_.contains(name)) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("Already a I/O stream named `%s`", name));
-  }
+    std::string_view name, int64_t width,
+    const TestbenchStreamOptions& options) {
+  XLS_RETURN_IF_ERROR(CheckNewStream(name, options));
   stream_names_.insert(std::string{name});
   streams_.push_back(absl::WrapUnique(
       new TestbenchStream{.name = std::string{name},
                           .direction = TestbenchStreamDirection::kOutput,
                           .path_macro_name = GetPipePathMacroName(name),
-                          .width = width}));
+                          .width = width,
+                          .options = options}));
   return streams_.back().get();
 }
 
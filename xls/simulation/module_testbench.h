@@ -132,10 +132,14 @@ class ModuleTestbench {
   // Allocate streams for reading and writing values to the testbench. The
   // returned pointer can be passed to SequentialBlock::ReadFromStreamAndSet or
   // EndOfCycleEvent::CaptureAndWriteToStream to connect into the simulation.
+  // `options` selects the encoding of values on the stream and the buffering
+  // between the host and the simulator.
   absl::StatusOr<const TestbenchStream*> CreateInputStream(
-      std::string_view name, int64_t width);
+      std::string_view name, int64_t width,
+      const TestbenchStreamOptions& options = TestbenchStreamOptions());
   absl::StatusOr<const TestbenchStream*> CreateOutputStream(
-      std::string_view name, int64_t width);
+      std::string_view name, int64_t width,
+      const TestbenchStreamOptions& options = TestbenchStreamOptions());
 
  private:
   ModuleTestbench(std::string_view verilog_text, FileType file_type,
@@ -158,6 +162,10 @@ class ModuleTestbench {
 
   std::vector<std::string> GatherExpectedTraces() const;
 
+  // Checks that a stream named `name` can be created with the given options.
+  absl::Status CheckNewStream(std::string_view name,
+                              const TestbenchStreamOptions& options) const;
+
   std::string verilog_text_;
   FileType file_type_;
   const VerilogSimulator* simulator_;
@@ -22,7 +22,9 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -36,6 +38,7 @@
 #include "xls/simulation/testbench_signal_capture.h"
 #include "xls/simulation/testbench_stream.h"
 #include "xls/simulation/verilog_simulator.h"
+#include "xls/simulation/verilog_simulators.h"
 #include "xls/simulation/verilog_test_base.h"
 
 namespace xls {
@@ -1191,10 +1194,186 @@ TEST_P(ModuleTestbenchTest, StreamingIoMultipleInputOutput) {
   XLS_ASSERT_OK(tb->RunWithStreamingIo(producer_map, consumer_map));
 }
 
+TEST_P(ModuleTestbenchTest, StreamingIoBinary) {
+  constexpr int64_t kInputCount = 1000;
+  // Not a multiple of the byte or word size of the binary frames.
+  constexpr int64_t kWidth = 77;
+
+  VerilogFile f = NewVerilogFile();
+  Module* m = MakeTwoStageIdentityPipeline(&f, kWidth);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModuleTestbench> tb,
+      ModuleTestbench::CreateFromVastModule(
+          m, GetSimulator(), "clk", /*reset=*/std::nullopt,
+          /*includes=*/{}, /*simulation_cycle_limit=*/kInputCount + 10));
+
+  TestbenchStreamOptions options{.format = TestbenchStreamFormat::kBinary,
+                                 .pipe_capacity = 4096};
+  XLS_ASSERT_OK_AND_ASSIGN(const TestbenchStream* input_stream,
+                           tb->CreateInputStream("my_input", kWidth, options));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      const TestbenchStream* output_stream,
+      tb->CreateOutputStream("my_output", kWidth, options));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleTestbenchThread * input_thread,
+      tb->CreateThreadDrivingAllInputs("input", /*initial_value=*/ZeroOrX::kX));
+  {
+    SequentialBlock& seq = input_thread->MainBlock();
+    SequentialBlock& loop = seq.Repeat(kInputCount);
+    loop.ReadFromStreamAndSet("in", input_stream).NextCycle();
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleTestbenchThread * output_thread,
+                           tb->CreateThread("output",
+                                            /*dut_inputs=*/{}));
+  {
+    SequentialBlock& seq = output_thread->MainBlock();
+    seq.NextCycle().NextCycle();
+    SequentialBlock& loop = seq.Repeat(kInputCount);
+    loop.AtEndOfCycle().CaptureAndWriteToStream("out", output_stream);
+  }
+
+  // Set bits at both ends of the value to exercise the byte ordering.
+  auto make_value = [&](int64_t i) {
+    return bits_ops::Or(
+        bits_ops::ShiftLeftLogical(UBits(i, kWidth), kWidth - 16),
+        UBits(i, kWidth));
+  };
+  int64_t in_count = 0;
+  auto producer = [&]() -> std::optional<Bits> {
+    if (in_count == kInputCount) {
+      return std::nullopt;
+    }
+    return make_value(in_count++);
+  };
+  int64_t out_count = 0;
+  auto consumer = [&](const Bits& bits) -> absl::Status {
+    EXPECT_EQ(bits, make_value(out_count++));
+    return absl::OkStatus();
+  };
+
+  XLS_ASSERT_OK(tb->RunWithStreamingIo({{input_stream->name, producer}},
+                                       {{output_stream->name, consumer}}));
+  EXPECT_EQ(out_count, kInputCount);
+}
+
+TEST_P(ModuleTestbenchTest, StreamingIoBinaryProducesX) {
+  constexpr int64_t kInputCount = 10;
+
+  VerilogFile f = NewVerilogFile();
+  Module* m = MakeTwoStageIdentityPipeline(&f, 32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModuleTestbench> tb,
+      ModuleTestbench::CreateFromVastModule(
+          m, GetSimulator(), "clk", /*reset=*/std::nullopt,
+          /*includes=*/{}, /*simulation_cycle_limit=*/kInputCount + 10));
+
+  XLS_ASSERT_OK(
+      tb->CreateThread("input driver",
+                       /*dut_inputs=*/{DutInput{.port_name = "in",
+                                                .initial_value = IsX()}})
+          .status());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      const TestbenchStream* output_stream,
+      tb->CreateOutputStream(
+          "my_output", 32,
+          TestbenchStreamOptions{.format = TestbenchStreamFormat::kBinary}));
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleTestbenchThread * output_thread,
+                           tb->CreateThread("output",
+                                            /*dut_inputs=*/{}));
+  {
+    SequentialBlock& seq = output_thread->MainBlock();
+    seq.NextCycle().NextCycle();
+    SequentialBlock& loop = seq.Repeat(kInputCount);
+    loop.AtEndOfCycle().CaptureAndWriteToStream("out", output_stream);
+  }
+
+  auto consumer = [&](const Bits& bits) -> absl::Status {
+    EXPECT_FALSE(true) << "The consumer function should not be called because "
+                          "all values are X";
+    return absl::OkStatus();
+  };
+
+  EXPECT_THAT(tb->RunWithStreamingIo({}, {{output_stream->name, consumer}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Stream `my_output` produced an X value")));
+}
+
+TEST_P(ModuleTestbenchTest, StreamingIoPipeCapacityRequiresBinary) {
+  VerilogFile f = NewVerilogFile();
+  Module* m = MakeTwoStageIdentityPipeline(&f, 32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ModuleTestbench> tb,
+      ModuleTestbench::CreateFromVastModule(m, GetSimulator(), "clk"));
+
+  EXPECT_THAT(
+      tb->CreateInputStream(
+          "my_input", 32, TestbenchStreamOptions{.pipe_capacity = 4096}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("can only be set for binary streams")));
+  EXPECT_THAT(
+      tb->CreateOutputStream(
+          "my_output", 32,
+          TestbenchStreamOptions{.format = TestbenchStreamFormat::kBinary,
+                                 .pipe_capacity = 0}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("must be positive")));
+}
+
 INSTANTIATE_TEST_SUITE_P(ModuleTestbenchTestInstantiation, ModuleTestbenchTest,
                          testing::ValuesIn(kDefaultSimulationTargets),
                          ParameterizedTestName<ModuleTestbenchTest>);
 
+// Streams `state.range(1)`-bit values through a pass-through module using the
+// stream format given by `state.range(0)`. Compares the throughput of the text
+// and binary stream formats.
+void BM_StreamingIo(benchmark::State& state) {
+  constexpr int64_t kInputCount = 10000;
+  const TestbenchStreamFormat format =
+      static_cast<TestbenchStreamFormat>(state.range(0));
+  const int64_t width = state.range(1);
+
+  VerilogFile f(FileType::kVerilog);
+  Module* m = f.AddModule("test_module", SourceInfo());
+  m->AddInput("clk", f.ScalarType(SourceInfo()), SourceInfo());
+  LogicRef* in =
+      m->AddInput("in", f.BitVectorType(width, SourceInfo()), SourceInfo());
+  LogicRef* out =
+      m->AddOutput("out", f.BitVectorType(width, SourceInfo()), SourceInfo());
+  m->Add<ContinuousAssignment>(SourceInfo(), out, in);
+
+  std::unique_ptr<ModuleTestbench> tb =
+      ModuleTestbench::CreateFromVastModule(
+          m, GetVerilogSimulator("iverilog").value(), "clk",
+          /*reset=*/std::nullopt, /*includes=*/{},
+          /*simulation_cycle_limit=*/kInputCount + 10)
+          .value();
+  TestbenchStreamOptions options{.format = format};
+  const TestbenchStream* input_stream =
+      tb->CreateInputStream("my_input", width, options).value();
+  const TestbenchStream* output_stream =
+      tb->CreateOutputStream("my_output", width, options).value();
+  ModuleTestbenchThread* thread =
+      tb->CreateThreadDrivingAllInputs("main", /*initial_value=*/ZeroOrX::kX)
+          .value();
+  SequentialBlock& loop = thread->MainBlock().Repeat(kInputCount);
+  loop.ReadFromStreamAndSet("in", input_stream);
+  loop.AtEndOfCycle().CaptureAndWriteToStream("out", output_stream);
+
+  for (auto _ : state) {
+    SequentialProducer producer(width, kInputCount);
+    SequentialConsumer consumer;
+    CHECK_OK(tb->RunWithStreamingIo({{input_stream->name, producer}},
+                                    {{output_stream->name, consumer}}));
+  }
+  state.SetItemsProcessed(state.iterations() * kInputCount);
+}
+BENCHMARK(BM_StreamingIo)
+    ->ArgsProduct({{static_cast<int64_t>(TestbenchStreamFormat::kText),
+                    static_cast<int64_t>(TestbenchStreamFormat::kBinary)},
+                   {32, 1024}});
+
 }  // namespace
 }  // namespace verilog
 }  // namespace xls
@@ -21,7 +21,6 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
-#include "absl/log/check.h"
 #include "xls/codegen/module_signature.h"
 
 namespace xls {
@@ -66,9 +65,11 @@ TestbenchMetadata::TestbenchMetadata(const ModuleSignature& signature) {
       if (!valid.output_name().empty()) {
         add_output_port(valid.output_name(), 1);
       }
-    } else {
-      CHECK(!signature.proto().pipeline().pipeline_control().has_manual())
-          << "Manual register control not supported";
+    } else if (signature.proto().pipeline().pipeline_control().has_manual()) {
+      // Add the load-enable input which has one bit per pipeline stage.
+      add_input_port(
+          signature.proto().pipeline().pipeline_control().manual().input_name(),
+          signature.proto().pipeline().latency());
     }
   }
 }
@@ -14,12 +14,18 @@
 
 #include "xls/simulation/testbench_stream.h"
 
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
 #include <filesystem>  // NOLINT
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -29,9 +35,13 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "xls/codegen/vast.h"
+#include "xls/common/file/file_descriptor.h"
 #include "xls/common/file/named_pipe.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/error_code_to_status.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/thread.h"
 #include "xls/ir/bits.h"
@@ -42,6 +52,60 @@
 
 namespace xls {
 namespace verilog {
+namespace {
+
+// Number of 32-bit words holding a value of the given width in a binary frame.
+int64_t BinaryWordCount(int64_t width) {
+  return std::max(CeilOfRatio(width, int64_t{32}), int64_t{1});
+}
+
+void AppendLittleEndianWord(uint32_t word, std::vector<uint8_t>* bytes) {
+  for (int64_t i = 0; i < 4; ++i) {
+    bytes->push_back(static_cast<uint8_t>(word >> (8 * i)));
+  }
+}
+
+uint32_t LittleEndianWordAt(absl::Span<const uint8_t> bytes, int64_t index) {
+  uint32_t word = 0;
+  for (int64_t i = 0; i < 4; ++i) {
+    word |= uint32_t{bytes[4 * index + i]} << (8 * i);
+  }
+  return word;
+}
+
+// Opens the named pipe underlying a binary stream and applies the pipe
+// capacity option.
+absl::StatusOr<FileStream> OpenBinaryStream(
+    const TestbenchStream& stream, const std::filesystem::path& path) {
+  XLS_ASSIGN_OR_RETURN(
+      FileStream file,
+      FileStream::Open(path,
+                       stream.direction == TestbenchStreamDirection::kInput
+                           ? "wb"
+                           : "rb"));
+  if (stream.options.pipe_capacity.has_value()) {
+#ifdef F_SETPIPE_SZ
+    if (fcntl(fileno(file.get()), F_SETPIPE_SZ,
+              static_cast<int>(*stream.options.pipe_capacity)) < 0) {
+      xabsl::StatusBuilder builder = ErrnoToStatus(errno);
+      builder << absl::StrFormat(
+          "Unable to set capacity of pipe for stream `%s` to %d bytes",
+          stream.name, *stream.options.pipe_capacity);
+      return std::move(builder);
+    }
+#else
+    return absl::UnimplementedError(
+        "Setting the pipe capacity of streams is not supported on this "
+        "platform");
+#endif
+    // Without buffering on the host side the pipe is the only buffer between
+    // the host and the simulator.
+    setvbuf(file.get(), nullptr, _IONBF, 0);
+  }
+  return std::move(file);
+}
+
+}  // namespace
 
 /* static */ VastStreamEmitter VastStreamEmitter::Create(
     const TestbenchStream& stream, Module* m) {
@@ -56,6 +120,15 @@ namespace verilog {
   emitter.error_string_ = m->AddReg(
       absl::StrFormat("__%s_error_str", stream.name),
       m->file()->BitVectorType(kStringSize * 8, SourceInfo()), SourceInfo());
+  if (stream.options.format == TestbenchStreamFormat::kBinary &&
+      stream.direction == TestbenchStreamDirection::kInput) {
+    // One word for the length prefix plus the payload words.
+    emitter.frame_ = m->AddReg(
+        absl::StrFormat("__%s_frame", stream.name),
+        m->file()->BitVectorType(32 * (BinaryWordCount(stream.width) + 1),
+                                 SourceInfo()),
+        SourceInfo());
+  }
   return emitter;
 }
 
@@ -100,6 +173,10 @@ void VastStreamEmitter::EmitOpen(StatementBlock* block) const {
 }
 
 void VastStreamEmitter::EmitRead(StatementBlock* block, LogicRef* lhs) const {
+  if (stream_.options.format == TestbenchStreamFormat::kBinary) {
+    EmitBinaryRead(block, lhs);
+    return;
+  }
   // Emit code:
   //
   //   cnt = $fscanf(fd, "%x\n", lhs);
@@ -113,21 +190,64 @@ void VastStreamEmitter::EmitRead(StatementBlock* block, LogicRef* lhs) const {
           file_descriptor_,
           block->file()->Make<QuotedString>(SourceInfo(), R"(%x\n)"), lhs});
   block->Add<BlockingAssignment>(SourceInfo(), count_, call);
-  Conditional* conditional = block->Add<Conditional>(
-      SourceInfo(),
+  EmitFailIf(
+      block,
       block->file()->Equals(
-          count_, block->file()->PlainLiteral(0, SourceInfo()), SourceInfo()));
-  conditional->consequent()->Add<Display>(
-      SourceInfo(),
-      std::vector<Expression*>{block->file()->Make<QuotedString>(
-          SourceInfo(),
-          absl::StrFormat("FAILED: $fscanf of file for stream `%s` failed.",
-                          stream_.name))});
-  conditional->consequent()->Add<Finish>(SourceInfo());
+          count_, block->file()->PlainLiteral(0, SourceInfo()), SourceInfo()),
+      absl::StrFormat("FAILED: $fscanf of file for stream `%s` failed.",
+                      stream_.name));
+}
+
+void VastStreamEmitter::EmitBinaryRead(StatementBlock* block,
+                                       LogicRef* lhs) const {
+  // $fread fills the frame register starting at its most significant byte so
+  // the little-endian words of the frame are byte reversed in the register.
+  // Emit code:
+  //
+  //   cnt = $fread(frame, fd);
+  //   if (cnt != <frame bytes> || frame[<top word>] != <swapped word count>)
+  //   begin
+  //     $display("FAILED: ...");
+  //     $finish;
+  //   end
+  //   lhs = {frame[7:0], frame[15:8], ...};
+  VerilogFile* file = block->file();
+  const int64_t word_count = BinaryWordCount(stream_.width);
+  const int64_t frame_bytes = 4 * (word_count + 1);
+  SystemFunctionCall* call = file->Make<SystemFunctionCall>(
+      SourceInfo(), "fread",
+      std::vector<Expression*>{frame_, file_descriptor_});
+  block->Add<BlockingAssignment>(SourceInfo(), count_, call);
+  uint32_t swapped_word_count = 0;
+  for (int64_t i = 0; i < 4; ++i) {
+    swapped_word_count |= ((word_count >> (8 * i)) & 0xff) << (8 * (3 - i));
+  }
+  Expression* bad_count = file->NotEquals(
+      count_, file->PlainLiteral(frame_bytes, SourceInfo()), SourceInfo());
+  Expression* bad_length = file->NotEquals(
+      file->Slice(frame_, 32 * word_count + 31, 32 * word_count, SourceInfo()),
+      file->Literal(swapped_word_count, 32, SourceInfo()), SourceInfo());
+  EmitFailIf(block, file->LogicalOr(bad_count, bad_length, SourceInfo()),
+             absl::StrFormat("FAILED: $fread of frame for stream `%s` failed.",
+                             stream_.name));
+
+  // The value's bytes from most to least significant. Value byte `i` is frame
+  // payload byte `i` which is held in register byte `4 * word_count - 1 - i`.
+  std::vector<Expression*> bytes;
+  for (int64_t i = CeilOfRatio(stream_.width, int64_t{8}) - 1; i >= 0; --i) {
+    int64_t lo = 8 * (4 * word_count - 1 - i);
+    bytes.push_back(file->Slice(frame_, lo + 7, lo, SourceInfo()));
+  }
+  block->Add<BlockingAssignment>(SourceInfo(), lhs,
+                                 file->Concat(bytes, SourceInfo()));
 }
 
 void VastStreamEmitter::EmitWrite(StatementBlock* block,
                                   Expression* value) const {
+  if (stream_.options.format == TestbenchStreamFormat::kBinary) {
+    EmitBinaryWrite(block, value);
+    return;
+  }
   // Emit code:
   //
   //   $fwriteh(fd, <value>);
@@ -141,6 +261,32 @@ void VastStreamEmitter::EmitWrite(StatementBlock* block,
           block->file()->Make<QuotedString>(SourceInfo(), R"(\n)")});
 }
 
+void VastStreamEmitter::EmitBinaryWrite(StatementBlock* block,
+                                        Expression* value) const {
+  // `%u` writes the length prefix as a single word and `%z` writes an
+  // (aval, bval) pair of words for each 32-bit chunk of the value. Emit code:
+  //
+  //   $fwrite(fd, "%u%z", 32'h<payload word count>, <value>);
+  block->Add<SystemTaskCall>(
+      SourceInfo(), "fwrite",
+      std::vector<Expression*>{
+          file_descriptor_,
+          block->file()->Make<QuotedString>(SourceInfo(), "%u%z"),
+          block->file()->Literal(2 * BinaryWordCount(stream_.width), 32,
+                                 SourceInfo()),
+          value});
+}
+
+void VastStreamEmitter::EmitFailIf(StatementBlock* block,
+                                   Expression* condition,
+                                   std::string_view message) const {
+  Conditional* conditional = block->Add<Conditional>(SourceInfo(), condition);
+  conditional->consequent()->Add<Display>(
+      SourceInfo(), std::vector<Expression*>{block->file()->Make<QuotedString>(
+                        SourceInfo(), message)});
+  conditional->consequent()->Add<Finish>(SourceInfo());
+}
+
 void VastStreamEmitter::EmitClose(StatementBlock* block) const {
   block->Add<SystemTaskCall>(SourceInfo(), "fclose",
                              std::vector<Expression*>{file_descriptor_});
@@ -160,35 +306,10 @@ void TestbenchStreamThread::RunInputStream(
   thread_ = absl::WrapUnique(new Thread([this, producer]() {
     XLS_VLOG(1) << absl::StrFormat("Thread for stream `%s` started",
                                    stream_.name);
-    absl::StatusOr<FileLineWriter> writer =
-        FileLineWriter::Create(named_pipe_.path());
-    if (!writer.ok()) {
-      XLS_LOG(ERROR) << absl::StrFormat(
-          "FileLineWriter creation failed for stream `%s`: %s", stream_.name,
-          writer.status().message());
-      MaybeSetError(writer.status());
-      return;
-    }
-    while (true) {
-      std::optional<Bits> bits = producer();
-      if (!bits.has_value()) {
-        XLS_VLOG(1) << absl::StrFormat(
-            "Producer returned std::nullopt for stream `%s`", stream_.name);
-        break;
-      }
-      XLS_VLOG(1) << absl::StrFormat(
-          "Value produced for stream `%s` : %s", stream_.name,
-          BitsToString(*bits, FormatPreference::kHex));
-      CHECK_EQ(bits->bit_count(), stream_.width);
-      absl::Status write_status =
-          writer->WriteLine(BitsToString(*bits, FormatPreference::kPlainHex));
-      if (!write_status.ok()) {
-        XLS_VLOG(1) << absl::StrFormat(
-            "Writing value to stream `%s` failed: %s", stream_.name,
-            write_status.message());
-        MaybeSetError(write_status);
-        break;
-      }
+    if (stream_.options.format == TestbenchStreamFormat::kBinary) {
+      WriteBinaryStream(producer);
+    } else {
+      WriteTextStream(producer);
     }
   }));
 }
@@ -199,64 +320,214 @@ void TestbenchStreamThread::RunOutputStream(
   thread_ = absl::WrapUnique(new Thread([this, consumer]() {
     XLS_VLOG(1) << absl::StrFormat("Thread for stream `%s` started",
                                    stream_.name);
-    absl::StatusOr<FileLineReader> reader =
-        FileLineReader::Create(named_pipe_.path());
-    if (!reader.ok()) {
+    if (stream_.options.format == TestbenchStreamFormat::kBinary) {
+      ReadBinaryStream(consumer);
+    } else {
+      ReadTextStream(consumer);
+    }
+  }));
+}
+
+void TestbenchStreamThread::WriteTextStream(Producer producer) {
+  absl::StatusOr<FileLineWriter> writer =
+      FileLineWriter::Create(named_pipe_.path());
+  if (!writer.ok()) {
+    XLS_LOG(ERROR) << absl::StrFormat(
+        "FileLineWriter creation failed for stream `%s`: %s", stream_.name,
+        writer.status().message());
+    MaybeSetError(writer.status());
+    return;
+  }
+  while (true) {
+    std::optional<Bits> bits = producer();
+    if (!bits.has_value()) {
+      XLS_VLOG(1) << absl::StrFormat(
+          "Producer returned std::nullopt for stream `%s`", stream_.name);
+      break;
+    }
+    XLS_VLOG(1) << absl::StrFormat(
+        "Value produced for stream `%s` : %s", stream_.name,
+        BitsToString(*bits, FormatPreference::kHex));
+    CHECK_EQ(bits->bit_count(), stream_.width);
+    absl::Status write_status =
+        writer->WriteLine(BitsToString(*bits, FormatPreference::kPlainHex));
+    if (!write_status.ok()) {
+      XLS_VLOG(1) << absl::StrFormat(
+          "Writing value to stream `%s` failed: %s", stream_.name,
+          write_status.message());
+      MaybeSetError(write_status);
+      break;
+    }
+  }
+}
+
+void TestbenchStreamThread::WriteBinaryStream(Producer producer) {
+  absl::StatusOr<FileStream> file =
+      OpenBinaryStream(stream_, named_pipe_.path());
+  if (!file.ok()) {
+    XLS_LOG(ERROR) << absl::StrFormat("Opening stream `%s` failed: %s",
+                                      stream_.name, file.status().message());
+    MaybeSetError(file.status());
+    return;
+  }
+  const int64_t word_count = BinaryWordCount(stream_.width);
+  std::vector<uint8_t> frame;
+  frame.reserve(4 * (word_count + 1));
+  while (true) {
+    std::optional<Bits> bits = producer();
+    if (!bits.has_value()) {
+      XLS_VLOG(1) << absl::StrFormat(
+          "Producer returned std::nullopt for stream `%s`", stream_.name);
+      break;
+    }
+    XLS_VLOG(1) << absl::StrFormat(
+        "Value produced for stream `%s` : %s", stream_.name,
+        BitsToString(*bits, FormatPreference::kHex));
+    CHECK_EQ(bits->bit_count(), stream_.width);
+    // The little-endian bytes of the value are the payload words least
+    // significant word first once padded out to a whole number of words.
+    frame.clear();
+    AppendLittleEndianWord(word_count, &frame);
+    std::vector<uint8_t> value_bytes = bits->ToBytes();
+    frame.insert(frame.end(), value_bytes.begin(), value_bytes.end());
+    frame.resize(4 * (word_count + 1), 0);
+    if (fwrite(frame.data(), frame.size(), 1, file->get()) != 1) {
+      absl::Status write_status = absl::InternalError(absl::StrFormat(
+          "Writing value to stream `%s` failed", stream_.name));
+      XLS_VLOG(1) << write_status.message();
+      MaybeSetError(write_status);
+      break;
+    }
+  }
+}
+
+void TestbenchStreamThread::ReadTextStream(Consumer consumer) {
+  absl::StatusOr<FileLineReader> reader =
+      FileLineReader::Create(named_pipe_.path());
+  if (!reader.ok()) {
+    XLS_LOG(ERROR) << absl::StrFormat(
+        "FileLineReader creation failed for stream `%s`: %s", stream_.name,
+        reader.status().message());
+    MaybeSetError(reader.status());
+    return;
+  }
+  while (true) {
+    absl::StatusOr<std::optional<std::string>> line = reader->ReadLine();
+    if (!line.ok()) {
+      XLS_LOG(ERROR) << absl::StrFormat("Error reading from stream `%s`: %s",
+                                      stream_.name, line.status().message());
+      MaybeSetError(line.status());
+      break;
+    }
+    if (!line->has_value()) {
+      // The other end of the pipe has been closed.
+      XLS_VLOG(1) << absl::StrFormat(
+          "Line reader for stream `%s` returned std::nullopt. Pipe has been "
+          "closed.",
+          stream_.name);
+      break;
+    }
+    XLS_VLOG(1) << absl::StrFormat("Read from stream `%s`: %s", stream_.name,
+                                   line->value());
+    // TODO(meheff): 2023/11/8 Support capturing X values.
+    if (absl::StrContains(line->value(), "x") ||
+        absl::StrContains(line->value(), "X")) {
+      XLS_LOG(ERROR) << absl::StrFormat("Stream `%s` produced an X value",
+                                        stream_.name);
+      MaybeSetError(absl::InvalidArgumentError(
+          absl::StrFormat("Stream `%s` produced an X value: %s", stream_.name,
+                          line->value())));
+      continue;
+    }
+    absl::StatusOr<Bits> value = ParseUnsignedNumberWithoutPrefix(
+        line->value(), FormatPreference::kHex,
+        /*bit_count=*/stream_.width);
+    if (!value.ok()) {
       XLS_LOG(ERROR) << absl::StrFormat(
-          "FileLineReader creation failed for stream `%s`: %s", stream_.name,
-          reader.status().message());
-      MaybeSetError(reader.status());
-      return;
+          "Unabled to convert value from stream `%s` into Bits: %s",
+          stream_.name, status_.message());
+      MaybeSetError(value.status());
+      continue;
     }
-    while (true) {
-      absl::StatusOr<std::optional<std::string>> line = reader->ReadLine();
-      if (!line.ok()) {
-        XLS_LOG(ERROR) << absl::StrFormat("Error reading from stream `%s`: %s",
-                                          stream_.name,
-                                          line.status().message());
-        MaybeSetError(line.status());
-        break;
-      }
-      if (!line->has_value()) {
-        // The other end of the pipe has been closed.
-        XLS_VLOG(1) << absl::StrFormat(
-            "Line reader for stream `%s` returned std::nullopt. Pipe has been "
-            "closed.",
-            stream_.name);
-        break;
-      }
-      XLS_VLOG(1) << absl::StrFormat("Read from stream `%s`: %s", stream_.name,
-                                     line->value());
-      // TODO(meheff): 2023/11/8 Support capturing X values.
-      if (absl::StrContains(line->value(), "x") ||
-          absl::StrContains(line->value(), "X")) {
-        XLS_LOG(ERROR) << absl::StrFormat("Stream `%s` produced an X value",
-                                          stream_.name);
-        MaybeSetError(absl::InvalidArgumentError(
-            absl::StrFormat("Stream `%s` produced an X value: %s", stream_.name,
-                            line->value())));
-        continue;
-      }
-      absl::StatusOr<Bits> value = ParseUnsignedNumberWithoutPrefix(
-          line->value(), FormatPreference::kHex,
-          /*bit_count=*/stream_.width);
-      if (!value.ok()) {
-        XLS_LOG(ERROR) << absl::StrFormat(
-            "Unabled to convert value from stream `%s` into Bits: %s",
-            stream_.name, status_.message());
-        MaybeSetError(value.status());
-        continue;
-      }
-      absl::Status result = consumer(*value);
-      if (!result.ok()) {
-        XLS_VLOG(1) << absl::StrFormat(
-            "Consumer for stream `%s` returned an error: %s", stream_.name,
-            result.message());
-        MaybeSetError(result);
-        continue;
+    absl::Status result = consumer(*value);
+    if (!result.ok()) {
+      XLS_VLOG(1) << absl::StrFormat(
+          "Consumer for stream `%s` returned an error: %s", stream_.name,
+          result.message());
+      MaybeSetError(result);
+      continue;
+    }
+  }
+}
+
+void TestbenchStreamThread::ReadBinaryStream(Consumer consumer) {
+  absl::StatusOr<FileStream> file =
+      OpenBinaryStream(stream_, named_pipe_.path());
+  if (!file.ok()) {
+    XLS_LOG(ERROR) << absl::StrFormat("Opening stream `%s` failed: %s",
+                                      stream_.name, file.status().message());
+    MaybeSetError(file.status());
+    return;
+  }
+  const int64_t word_count = BinaryWordCount(stream_.width);
+  // Each 32-bit chunk of the value is written as an (aval, bval) pair.
+  const int64_t payload_word_count = 2 * word_count;
+  std::vector<uint8_t> payload(4 * payload_word_count);
+  std::vector<uint8_t> value_bytes(4 * word_count);
+  while (true) {
+    uint8_t header[4];
+    size_t header_bytes = fread(header, 1, sizeof(header), file->get());
+    if (header_bytes == 0 && feof(file->get())) {
+      // The other end of the pipe has been closed.
+      XLS_VLOG(1) << absl::StrFormat(
+          "Reached end of stream `%s`. Pipe has been closed.", stream_.name);
+      break;
+    }
+    if (header_bytes != sizeof(header) ||
+        LittleEndianWordAt(header, 0) != payload_word_count) {
+      absl::Status status = absl::DataLossError(absl::StrFormat(
+          "Stream `%s` produced a malformed frame header", stream_.name));
+      XLS_LOG(ERROR) << status.message();
+      MaybeSetError(status);
+      break;
+    }
+    if (fread(payload.data(), payload.size(), 1, file->get()) != 1) {
+      absl::Status status = absl::DataLossError(absl::StrFormat(
+          "Stream `%s` ended in the middle of a frame", stream_.name));
+      XLS_LOG(ERROR) << status.message();
+      MaybeSetError(status);
+      break;
+    }
+    bool has_x = false;
+    for (int64_t i = 0; i < word_count; ++i) {
+      if (LittleEndianWordAt(payload, 2 * i + 1) != 0) {
+        has_x = true;
       }
+      std::copy_n(payload.begin() + 8 * i, 4, value_bytes.begin() + 4 * i);
     }
-  }));
+    if (has_x) {
+      XLS_LOG(ERROR) << absl::StrFormat("Stream `%s` produced an X value",
+                                        stream_.name);
+      MaybeSetError(absl::InvalidArgumentError(
+          absl::StrFormat("Stream `%s` produced an X value", stream_.name)));
+      continue;
+    }
+    Bits value = Bits::FromBytes(
+        absl::MakeConstSpan(value_bytes)
+            .first(CeilOfRatio(stream_.width, int64_t{8})),
+        stream_.width);
+    XLS_VLOG(1) << absl::StrFormat(
+        "Read from stream `%s`: %s", stream_.name,
+        BitsToString(value, FormatPreference::kHex));
+    absl::Status result = consumer(value);
+    if (!result.ok()) {
+      XLS_VLOG(1) << absl::StrFormat(
+          "Consumer for stream `%s` returned an error: %s", stream_.name,
+          result.message());
+      MaybeSetError(result);
+      continue;
+    }
+  }
 }
 
 absl::Status TestbenchStreamThread::Join() {
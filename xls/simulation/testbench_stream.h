@@ -20,6 +20,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "absl/functional/function_ref.h"
@@ -37,6 +38,35 @@ namespace verilog {
 // flowing from the testbench.
 enum class TestbenchStreamDirection : int8_t { kInput, kOutput };
 
+// The encoding of values transferred over a stream.
+enum class TestbenchStreamFormat : int8_t {
+  // One value per line as hexadecimal text. The testbench reads values with
+  // $fscanf and writes them with $fwriteh.
+  kText,
+
+  // Length-prefixed frames of 32-bit little-endian words. Each frame starts
+  // with a word holding the number of payload words which follow. Input
+  // payloads hold the value with the least significant word first. Output
+  // payloads are written by the testbench with the `%z` format and hold an
+  // (aval, bval) word pair for each 32-bit chunk of the value (least
+  // significant chunk first) so that X bits can be detected. Avoids formatting
+  // and parsing text which dominates the cost of streaming wide values.
+  kBinary,
+};
+
+// Options controlling how values are transferred over a stream.
+struct TestbenchStreamOptions {
+  TestbenchStreamFormat format = TestbenchStreamFormat::kText;
+
+  // Capacity in bytes of the named pipe underlying the stream (rounded up by
+  // the kernel to a power-of-two number of pages). Only supported for binary
+  // streams. When set, the host side of the stream is unbuffered so a producer
+  // blocks once this many bytes are in flight to the simulator and the
+  // simulator blocks once this many bytes are waiting for the consumer. If not
+  // set, the default pipe capacity and stdio buffering are used.
+  std::optional<int64_t> pipe_capacity;
+};
+
 // An abstraction representing a stream for communicating with Verilog
 // testbench.
 struct TestbenchStream {
@@ -50,6 +80,8 @@ struct TestbenchStream {
 
   // The width of the data to read/write to the testbench.
   int64_t width;
+
+  TestbenchStreamOptions options;
 };
 
 // Class for emitting VAST code for reading and writing values to streams.
@@ -74,11 +106,24 @@ class VastStreamEmitter {
 
   const TestbenchStream& stream_;
 
+  // Emit code for reading/writing a value in the binary stream format.
+  void EmitBinaryRead(StatementBlock* block, LogicRef* lhs) const;
+  void EmitBinaryWrite(StatementBlock* block, Expression* value) const;
+
+  // Emit code which displays a failure message and ends the simulation if
+  // `condition` is true.
+  void EmitFailIf(StatementBlock* block, Expression* condition,
+                  std::string_view message) const;
+
   // References to declared variables.
   LogicRef* file_descriptor_;
   LogicRef* count_;
   LogicRef* errno_;
   LogicRef* error_string_;
+
+  // Buffer holding a whole frame read from a binary input stream. Null for
+  // other streams.
+  LogicRef* frame_ = nullptr;
 };
 
 // A wrapper around a thread which read/writes data via a stream to/from a
@@ -121,6 +166,12 @@ class TestbenchStreamThread {
   // an error code.
   void MaybeSetError(const absl::Status& status);
 
+  // Thread bodies for streams in the text and binary formats.
+  void WriteTextStream(Producer producer);
+  void WriteBinaryStream(Producer producer);
+  void ReadTextStream(Consumer consumer);
+  void ReadBinaryStream(Consumer consumer);
+
   const TestbenchStream& stream_;
   NamedPipe named_pipe_;
   std::unique_ptr<Thread> thread_;
@@ -42,6 +42,7 @@
 #include "xls/ir/block.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
+#include "xls/passes/pass_base.h"
 #include "xls/scheduling/pipeline_schedule.h"
 #include "xls/scheduling/run_pipeline_schedule.h"
 #include "xls/scheduling/scheduling_options.h"
@@ -61,6 +62,9 @@ Usage:
 
 ABSL_FLAG(bool, measure_codegen_timing, true,
           "Measure timing of codegen (including scheduling).");
+ABSL_FLAG(bool, print_codegen_pass_timing, false,
+          "Print the time taken by each pass of the codegen pass pipeline. "
+          "Only used for pipelined codegen with --measure_codegen_timing.");
 
 namespace xls {
 namespace {
@@ -102,12 +106,30 @@ absl::Status PrintPipelinedCodegenInfo(
     FunctionBase* f, const PipelineSchedule& schedule,
     const verilog::CodegenOptions& codegen_options) {
   absl::Time start = absl::Now();
+  verilog::PipelineGeneratorTiming timing;
   XLS_ASSIGN_OR_RETURN(
       verilog::ModuleGeneratorResult codegen_result,
-      verilog::ToPipelineModuleText(schedule, f, codegen_options));
+      verilog::ToPipelineModuleText(schedule, f, codegen_options,
+                                    /*delay_estimator=*/nullptr, &timing));
   absl::Duration total_time = absl::Now() - start;
   std::cout << absl::StreamFormat("Codegen time: %dms\n",
                                   total_time / absl::Milliseconds(1));
+  std::cout << absl::StreamFormat(
+      "Block conversion time: %dms\n",
+      timing.block_conversion / absl::Milliseconds(1));
+  std::cout << absl::StreamFormat(
+      "Codegen pass pipeline time: %dms\n",
+      timing.pass_pipeline / absl::Milliseconds(1));
+  if (absl::GetFlag(FLAGS_print_codegen_pass_timing)) {
+    for (const PassInvocation& invocation : timing.pass_invocations) {
+      std::cout << absl::StreamFormat(
+          "  %s: %dms\n", invocation.pass_name,
+          invocation.run_duration / absl::Milliseconds(1));
+    }
+  }
+  std::cout << absl::StreamFormat(
+      "Verilog generation time: %dms\n",
+      timing.verilog_generation / absl::Milliseconds(1));
 
   return absl::OkStatus();
 }
@@ -113,8 +113,29 @@ class CodeGenMainTest(test_base.TestCase):
     self.assertIn('Max reg-to-output delay: 2ps', output)
     self.assertIn('Lines of Verilog: 7', output)
     self.assertIn('Codegen time:', output)
+    self.assertIn('Block conversion time:', output)
+    self.assertIn('Codegen pass pipeline time:', output)
+    self.assertIn('Verilog generation time:', output)
     self.assertIn('Scheduling time:', output)
 
+  def test_simple_block_codegen_pass_timing(self):
+    opt_ir_file = self.create_tempfile(content=OPT_IR)
+    block_ir_file = self.create_tempfile(content=BLOCK_IR)
+    verilog_file = self.create_tempfile(content=SIMPLE_VERILOG)
+    output = subprocess.check_output([
+        BENCHMARK_CODEGEN_MAIN_PATH,
+        '--delay_model=unit',
+        '--clock_period_ps=10',
+        '--print_codegen_pass_timing',
+        opt_ir_file.full_path,
+        block_ir_file.full_path,
+        verilog_file.full_path,
+    ]).decode('utf-8')
+
+    self.assertIn('Codegen pass pipeline time:', output)
+    # Each pass of the pipeline is listed, e.g., signature generation.
+    self.assertRegex(output, r'\n  signature_generation: \d+ms\n')
+
   def test_simple_block_no_delay_model(self):
     opt_ir_file = self.create_tempfile(content=OPT_IR)
     block_ir_file = self.create_tempfile(content=BLOCK_IR)
@@ -146,6 +167,7 @@ class CodeGenMainTest(test_base.TestCase):
         '--generator=combinational',
     ]).decode('utf-8')
     self.assertIn('Codegen time:', output)
+    self.assertNotIn('Block conversion time:', output)
     self.assertNotIn('Scheduling time:', output)
     self.assertIn('Flop count: 0', output)
     self.assertIn('Has feedthrough path: true', output)
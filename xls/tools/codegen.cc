@@ -14,6 +14,8 @@
 
 #include "xls/tools/codegen.h"
 
+#include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <optional>
 #include <string>
@@ -26,7 +28,10 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/time.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/combinational_generator.h"
@@ -34,6 +39,8 @@
 #include "xls/codegen/op_override_impls.h"
 #include "xls/codegen/pipeline_generator.h"
 #include "xls/codegen/ram_configuration.h"
+#include "xls/common/file/content_digest.h"
+#include "xls/common/file/filesystem.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -48,9 +55,11 @@
 #include "xls/scheduling/scheduling_options.h"
 #include "xls/scheduling/scheduling_pass.h"
 #include "xls/scheduling/scheduling_pass_pipeline.h"
+#include "xls/tools/codegen_cache.pb.h"
 #include "xls/tools/codegen_flags.pb.h"
 #include "xls/tools/scheduling_options_flags.h"
 #include "xls/tools/scheduling_options_flags.pb.h"
+#include "google/protobuf/util/message_differencer.h"
 
 namespace xls {
 namespace {
@@ -121,6 +130,95 @@ absl::StatusOr<PipelineScheduleOrGroup> RunSchedulingPipeline(
   return schedule_itr->second;
 }
 
+// Bump whenever scheduling or codegen changes in a way that makes previously
+// cached results stale.
+constexpr std::string_view kCodegenCacheVersion = "1";
+
+// Appends `data` to `key_material` such that no two sequences of appended
+// strings produce the same material.
+void AppendKeyMaterial(std::string_view data, std::string* key_material) {
+  absl::StrAppend(key_material, data.size(), ":", data);
+}
+
+std::filesystem::path CodegenCacheEntryPath(
+    const std::filesystem::path& directory, std::string_view key) {
+  return directory / absl::StrFormat("%s.codegen.pb", key);
+}
+
+std::optional<CodegenCacheEntryProto> ReadCodegenCacheEntry(
+    const std::filesystem::path& path, std::string_view key) {
+  if (!FileExists(path).ok()) {
+    return std::nullopt;
+  }
+  CodegenCacheEntryProto entry;
+  if (absl::Status status = ParseProtobinFile(path, &entry); !status.ok()) {
+    XLS_LOG(WARNING) << "Ignoring unreadable codegen cache entry " << path
+                     << ": " << status;
+    return std::nullopt;
+  }
+  if (entry.key() != key) {
+    XLS_LOG(WARNING) << "Ignoring codegen cache entry " << path
+                     << " stored under a different key: " << entry.key();
+    return std::nullopt;
+  }
+  return entry;
+}
+
+// Failing to store an entry only costs the next run a recompute, so errors are
+// logged rather than returned.
+void WriteCodegenCacheEntry(const std::filesystem::path& path,
+                            const CodegenCacheEntryProto& entry) {
+  if (absl::Status status = RecursivelyCreateDir(path.parent_path());
+      !status.ok()) {
+    XLS_LOG(WARNING) << "Could not create codegen cache directory: " << status;
+    return;
+  }
+  // Concurrent codegen runs sharing the cache must never see a partial entry.
+  if (absl::Status status = SetProtobinFileAtomically(path, entry);
+      !status.ok()) {
+    XLS_LOG(WARNING) << "Could not write codegen cache entry " << path << ": "
+                     << status;
+  }
+}
+
+CodegenCacheEntryProto ToCodegenCacheEntry(std::string_view key,
+                                           const CodegenResult& result,
+                                           std::string package_ir) {
+  CodegenCacheEntryProto entry;
+  entry.set_key(key);
+  const verilog::ModuleGeneratorResult& module_result =
+      result.module_generator_result;
+  entry.set_verilog_text(module_result.verilog_text);
+  *entry.mutable_verilog_line_map() = module_result.verilog_line_map;
+  *entry.mutable_signature() = module_result.signature.proto();
+  if (result.package_pipeline_schedules_proto.has_value()) {
+    *entry.mutable_package_pipeline_schedules() =
+        *result.package_pipeline_schedules_proto;
+  }
+  entry.set_package_ir(std::move(package_ir));
+  return entry;
+}
+
+absl::StatusOr<CodegenResult> FromCodegenCacheEntry(
+    CodegenCacheEntryProto entry) {
+  XLS_ASSIGN_OR_RETURN(verilog::ModuleSignature signature,
+                       verilog::ModuleSignature::FromProto(entry.signature()));
+  CodegenResult result{
+      .module_generator_result =
+          verilog::ModuleGeneratorResult{
+              .verilog_text = std::move(*entry.mutable_verilog_text()),
+              .verilog_line_map = std::move(*entry.mutable_verilog_line_map()),
+              .signature = std::move(signature),
+          },
+      .cached_package_ir = std::move(*entry.mutable_package_ir()),
+  };
+  if (entry.has_package_pipeline_schedules()) {
+    result.package_pipeline_schedules_proto =
+        std::move(*entry.mutable_package_pipeline_schedules());
+  }
+  return result;
+}
+
 }  // namespace
 
 absl::StatusOr<verilog::CodegenOptions> CodegenOptionsFromProto(
@@ -197,6 +295,10 @@ absl::StatusOr<verilog::CodegenOptions> CodegenOptionsFromProto(
   }
   options.ram_configurations(ram_configurations);
 
+  if (p.has_emit_threads()) {
+    options.emit_threads(p.emit_threads());
+  }
+
   options.gate_recvs(p.gate_recvs());
   options.array_index_bounds_checking(p.array_index_bounds_checking());
   switch (p.register_merge_strategy()) {
@@ -227,13 +329,17 @@ absl::StatusOr<PipelineScheduleOrGroup> Schedule(
   if (scheduling_time != nullptr) {
     stopwatch.emplace();
   }
-  synthesis::Synthesizer* synthesizer = nullptr;
+  // Owned here so that the synthesizer (and with it any synthesis cache) is
+  // flushed once scheduling is done.
+  std::unique_ptr<synthesis::Synthesizer> synthesizer;
   if (scheduling_options.use_fdo() &&
       !scheduling_options.fdo_synthesizer_name().empty()) {
-    XLS_ASSIGN_OR_RETURN(synthesizer, SetUpSynthesizer(scheduling_options));
+    XLS_ASSIGN_OR_RETURN(synthesis::Synthesizer * raw_synthesizer,
+                         SetUpSynthesizer(scheduling_options));
+    synthesizer.reset(raw_synthesizer);
   }
   absl::StatusOr<PipelineScheduleOrGroup> result = RunSchedulingPipeline(
-      *p->GetTop(), scheduling_options, delay_estimator, synthesizer);
+      *p->GetTop(), scheduling_options, delay_estimator, synthesizer.get());
   if (scheduling_time != nullptr) {
     *scheduling_time = stopwatch->GetElapsedTime();
   }
@@ -372,4 +478,125 @@ absl::StatusOr<CodegenResult> ScheduleAndCodegen(
       timing_report ? &timing_report->codegen_time : nullptr);
 }
 
+absl::StatusOr<std::string> CodegenCacheKey(
+    Package* p,
+    const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
+    const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model) {
+  if (!codegen_flags_proto.top().empty()) {
+    XLS_RETURN_IF_ERROR(p->SetTopByName(codegen_flags_proto.top()));
+  }
+  SchedulingOptionsFlagsProto scheduling_options =
+      scheduling_options_flags_proto;
+  scheduling_options.clear_scheduling_threads();
+  scheduling_options.clear_fdo_synthesis_threads();
+  scheduling_options.clear_fdo_synthesis_cache_path();
+
+  // The synthesis tools and libraries used by FDO are keyed by their contents
+  // rather than their paths, so rebuilding a tool or editing a library in place
+  // invalidates the cached schedule.
+  std::vector<std::string> fdo_input_digests;
+  if (scheduling_options.use_fdo()) {
+    std::vector<std::string> fdo_inputs = {scheduling_options.fdo_yosys_path(),
+                                           scheduling_options.fdo_sta_path()};
+    for (std::string_view library :
+         absl::StrSplit(scheduling_options.fdo_synthesis_libraries(),
+                        absl::ByAnyChar(" \t"), absl::SkipEmpty())) {
+      fdo_inputs.push_back(std::string(library));
+    }
+    for (const std::string& input : fdo_inputs) {
+      if (input.empty()) {
+        fdo_input_digests.push_back("");
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(
+          std::string digest, GetFileSha256Hex(input),
+          _ << "hashing FDO input for the codegen cache key");
+      fdo_input_digests.push_back(std::move(digest));
+    }
+    scheduling_options.clear_fdo_yosys_path();
+    scheduling_options.clear_fdo_sta_path();
+    scheduling_options.clear_fdo_synthesis_libraries();
+  }
+
+  // The number of emission threads does not affect the generated text.
+  CodegenFlagsProto codegen_flags = codegen_flags_proto;
+  codegen_flags.clear_emit_threads();
+
+  // Neither flags proto has map fields, so their serialization is
+  // deterministic.
+  std::string key_material;
+  AppendKeyMaterial(kCodegenCacheVersion, &key_material);
+  AppendKeyMaterial(p->DumpIr(), &key_material);
+  AppendKeyMaterial(scheduling_options.SerializeAsString(), &key_material);
+  AppendKeyMaterial(codegen_flags.SerializeAsString(), &key_material);
+  AppendKeyMaterial(with_delay_model ? "delay_model" : "", &key_material);
+  for (const std::string& digest : fdo_input_digests) {
+    AppendKeyMaterial(digest, &key_material);
+  }
+  return Sha256Hex(key_material);
+}
+
+absl::StatusOr<CodegenResult> ScheduleAndCodegenWithCache(
+    Package* p,
+    const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
+    const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model,
+    const CodegenCacheOptions& cache_options, TimingReport* timing_report,
+    bool* cache_hit) {
+  XLS_ASSIGN_OR_RETURN(
+      std::string key,
+      CodegenCacheKey(p, scheduling_options_flags_proto, codegen_flags_proto,
+                      with_delay_model));
+  std::filesystem::path entry_path =
+      CodegenCacheEntryPath(cache_options.directory, key);
+  std::optional<CodegenCacheEntryProto> cached =
+      ReadCodegenCacheEntry(entry_path, key);
+  if (cache_hit != nullptr) {
+    *cache_hit = cached.has_value();
+  }
+  if (cached.has_value() && !cache_options.verify_hits) {
+    XLS_LOG(INFO) << "Codegen cache hit: " << entry_path;
+    return FromCodegenCacheEntry(*std::move(cached));
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      CodegenResult result,
+      ScheduleAndCodegen(p, scheduling_options_flags_proto, codegen_flags_proto,
+                         with_delay_model, timing_report));
+  CodegenCacheEntryProto entry = ToCodegenCacheEntry(key, result, p->DumpIr());
+  if (!cached.has_value()) {
+    XLS_LOG(INFO) << "Codegen cache miss, storing " << entry_path;
+    WriteCodegenCacheEntry(entry_path, entry);
+    return result;
+  }
+
+  XLS_LOG(INFO) << "Codegen cache hit, verifying " << entry_path;
+  // Name the differing fields rather than printing them: the Verilog and IR
+  // texts can be huge.
+  using ::google::protobuf::util::MessageDifferencer;
+  std::vector<std::string_view> differences;
+  if (cached->verilog_text() != entry.verilog_text()) {
+    differences.push_back("verilog_text");
+  }
+  if (!MessageDifferencer::Equals(cached->verilog_line_map(),
+                                  entry.verilog_line_map())) {
+    differences.push_back("verilog_line_map");
+  }
+  if (!MessageDifferencer::Equals(cached->signature(), entry.signature())) {
+    differences.push_back("signature");
+  }
+  if (!MessageDifferencer::Equals(cached->package_pipeline_schedules(),
+                                  entry.package_pipeline_schedules())) {
+    differences.push_back("package_pipeline_schedules");
+  }
+  if (cached->package_ir() != entry.package_ir()) {
+    differences.push_back("package_ir");
+  }
+  if (!differences.empty()) {
+    return absl::InternalError(absl::StrFormat(
+        "Codegen cache entry %s differs from the recomputed result in: %s",
+        entry_path.string(), absl::StrJoin(differences, ", ")));
+  }
+  return result;
+}
+
 }  // namespace xls
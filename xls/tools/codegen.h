@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <filesystem>  // NOLINT
 #include <optional>
+#include <string>
 #include <variant>
 
 #include "absl/status/statusor.h"
@@ -44,6 +46,10 @@ struct CodegenResult {
   verilog::ModuleGeneratorResult module_generator_result;
   std::optional<PackagePipelineSchedulesProto>
       package_pipeline_schedules_proto = std::nullopt;
+  // Set when the result was taken from the codegen cache: the IR the package
+  // would have after scheduling and codegen. The package itself is left as it
+  // was given in that case.
+  std::optional<std::string> cached_package_ir = std::nullopt;
 };
 
 absl::StatusOr<CodegenResult> CodegenPipeline(
@@ -72,6 +78,39 @@ absl::StatusOr<CodegenResult> ScheduleAndCodegen(
     TimingReport* timing_report = nullptr,
     PipelineScheduleOrGroup* schedules = nullptr);
 
+// Returns a key identifying the result of ScheduleAndCodegen for the given
+// arguments: a digest of the package IR, the scheduling options (including the
+// delay model) and the codegen options. When FDO is enabled, the synthesis
+// tools and libraries contribute their contents rather than their paths.
+// Options which only affect how fast the result is computed, such as thread
+// counts, do not contribute. Sets the top of the package as ScheduleAndCodegen
+// would.
+absl::StatusOr<std::string> CodegenCacheKey(
+    Package* p,
+    const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
+    const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model);
+
+struct CodegenCacheOptions {
+  // Directory holding the cache entries, one file per key. Created if it does
+  // not exist.
+  std::filesystem::path directory;
+
+  // Whether to recompute the result on a hit and fail if it differs from the
+  // cached one.
+  bool verify_hits = false;
+};
+
+// Like ScheduleAndCodegen, but reuses the result stored in the codegen cache
+// under CodegenCacheKey if there is one, skipping scheduling and codegen
+// entirely. Otherwise the result is computed and stored in the cache. Whether
+// the result came from the cache is returned in `cache_hit` if non-null.
+absl::StatusOr<CodegenResult> ScheduleAndCodegenWithCache(
+    Package* p,
+    const SchedulingOptionsFlagsProto& scheduling_options_flags_proto,
+    const CodegenFlagsProto& codegen_flags_proto, bool with_delay_model,
+    const CodegenCacheOptions& cache_options,
+    TimingReport* timing_report = nullptr, bool* cache_hit = nullptr);
+
 }  // namespace xls
 
 #endif  // XLS_TOOLS_CODEGEN_H_
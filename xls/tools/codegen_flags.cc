@@ -138,6 +138,9 @@ ABSL_FLAG(bool, array_index_bounds_checking, true,
 ABSL_FLAG(int64_t, max_trace_verbosity, 0,
           "Maximum verbosity for traces. Traces with higher verbosity are "
           "stripped from codegen output. 0 by default.");
+ABSL_FLAG(int64_t, emit_threads, 1,
+          "Number of threads used to emit the text of the modules in the "
+          "output Verilog file.");
 ABSL_FLAG(std::string, codegen_options_proto, "",
           "Path to a protobuf containing all codegen args.");
 ABSL_FLAG(std::optional<std::string>, codegen_options_used_textproto_file,
@@ -247,6 +250,7 @@ static absl::StatusOr<bool> SetOptionsFromFlags(CodegenFlagsProto &proto) {
   POPULATE_FLAG(streaming_channel_valid_suffix);
   POPULATE_FLAG(streaming_channel_ready_suffix);
   POPULATE_REPEATED_FLAG(ram_configurations);
+  POPULATE_FLAG(emit_threads);
 
   // Optimizations
   POPULATE_FLAG(gate_recvs);
@@ -56,6 +56,17 @@ Emit a feed-forward pipelined module:
        IR_FILE
 )";
 
+ABSL_FLAG(std::string, codegen_cache_dir, "",
+          "If specified, a directory in which the results of scheduling and "
+          "codegen are cached, keyed by the IR, the scheduling options "
+          "(including the delay model) and the codegen options. When a result "
+          "is found, scheduling and codegen are skipped. The directory may be "
+          "shared between concurrent invocations, and should be cleared when "
+          "the XLS toolchain changes.");
+ABSL_FLAG(bool, codegen_cache_verify, false,
+          "If true, results found in --codegen_cache_dir are recomputed and "
+          "it is an error if they differ from the cached ones.");
+
 namespace xls {
 namespace {
 
@@ -83,18 +94,35 @@ absl::Status RealMain(std::string_view ir_path) {
   XLS_ASSIGN_OR_RETURN(
       bool delay_model_flag_passed,
       IsDelayModelSpecifiedViaFlag(scheduling_options_flags_proto));
-  XLS_ASSIGN_OR_RETURN(
-      CodegenResult r,
-      ScheduleAndCodegen(p.get(), scheduling_options_flags_proto,
-                         codegen_flags_proto, delay_model_flag_passed));
+  CodegenResult r;
+  const std::string& cache_dir = absl::GetFlag(FLAGS_codegen_cache_dir);
+  if (cache_dir.empty()) {
+    XLS_ASSIGN_OR_RETURN(
+        r, ScheduleAndCodegen(p.get(), scheduling_options_flags_proto,
+                              codegen_flags_proto, delay_model_flag_passed));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        r, ScheduleAndCodegenWithCache(
+               p.get(), scheduling_options_flags_proto, codegen_flags_proto,
+               delay_model_flag_passed,
+               CodegenCacheOptions{
+                   .directory = cache_dir,
+                   .verify_hits = absl::GetFlag(FLAGS_codegen_cache_verify),
+               }));
+  }
   verilog::ModuleGeneratorResult result = r.module_generator_result;
   std::optional<PackagePipelineSchedulesProto> schedule =
       r.package_pipeline_schedules_proto;
+  // On a cache hit the package was not scheduled or converted to blocks, so
+  // its IR after codegen comes from the cache instead.
+  auto package_ir = [&]() -> std::string {
+    return r.cached_package_ir.has_value() ? *r.cached_package_ir
+                                           : main()->package()->DumpIr();
+  };
 
   if (!absl::GetFlag(FLAGS_output_schedule_ir_path).empty()) {
-    XLS_RETURN_IF_ERROR(
-        SetFileContents(absl::GetFlag(FLAGS_output_schedule_ir_path),
-                        main()->package()->DumpIr()));
+    XLS_RETURN_IF_ERROR(SetFileContents(
+        absl::GetFlag(FLAGS_output_schedule_ir_path), package_ir()));
   }
 
   if (!absl::GetFlag(FLAGS_output_schedule_path).empty()) {
@@ -108,11 +136,11 @@ absl::Status RealMain(std::string_view ir_path) {
   }
 
   if (!absl::GetFlag(FLAGS_output_block_ir_path).empty()) {
-    QCHECK_GE(p->blocks().size(), 1)
+    QCHECK(r.cached_package_ir.has_value() || !p->blocks().empty())
         << "There should be at least one block in the package after generating "
            "module text.";
     XLS_RETURN_IF_ERROR(SetFileContents(
-        absl::GetFlag(FLAGS_output_block_ir_path), p->DumpIr()));
+        absl::GetFlag(FLAGS_output_block_ir_path), package_ir()));
   }
 
   if (!absl::GetFlag(FLAGS_output_signature_path).empty()) {
@@ -546,5 +546,67 @@ class CodeGenMainTest(parameterized.TestCase):
       merge = blk.read()
     self.assertNotEqual(no_merge, merge)
 
+  def test_codegen_cache(self):
+    ir_file = self.create_tempfile(content=NOT_ADD_IR)
+    cache_dir = self.create_tempdir().full_path
+
+    def run_codegen(*extra_args):
+      outputs = {
+          name: test_base.create_named_output_text_file(name)
+          for name in ('verilog', 'signature', 'schedule', 'block_ir')
+      }
+      result = subprocess.run(
+          [
+              CODEGEN_MAIN_PATH,
+              '--generator=pipeline',
+              '--delay_model=unit',
+              '--alsologtostderr',
+              '--codegen_cache_dir=' + cache_dir,
+              '--output_verilog_path=' + outputs['verilog'],
+              '--output_signature_path=' + outputs['signature'],
+              '--output_schedule_path=' + outputs['schedule'],
+              '--output_block_ir_path=' + outputs['block_ir'],
+              ir_file.full_path,
+          ]
+          + list(extra_args),
+          check=True,
+          stderr=subprocess.PIPE,
+          encoding='utf-8',
+      )
+      contents = {}
+      for name, path in outputs.items():
+        with open(path, 'r') as f:
+          contents[name] = f.read()
+      return contents, result.stderr
+
+    miss, stderr = run_codegen('--pipeline_stages=2')
+    self.assertIn('Codegen cache miss', stderr)
+    self.assertLen(os.listdir(cache_dir), 1)
+
+    hit, stderr = run_codegen('--pipeline_stages=2')
+    self.assertIn('Codegen cache hit', stderr)
+    self.assertEqual(hit, miss)
+
+    verified, stderr = run_codegen(
+        '--pipeline_stages=2', '--codegen_cache_verify'
+    )
+    self.assertIn('Codegen cache hit, verifying', stderr)
+    self.assertEqual(verified, miss)
+
+    # Different options produce a different entry.
+    _, stderr = run_codegen('--pipeline_stages=3')
+    self.assertIn('Codegen cache miss', stderr)
+    self.assertLen(os.listdir(cache_dir), 2)
+
+    # Unreadable entries are recomputed and replaced.
+    for entry in os.listdir(cache_dir):
+      with open(os.path.join(cache_dir, entry), 'wb') as f:
+        f.write(b'garbage')
+    recomputed, stderr = run_codegen('--pipeline_stages=2')
+    self.assertIn('Ignoring unreadable codegen cache entry', stderr)
+    self.assertEqual(recomputed, miss)
+    _, stderr = run_codegen('--pipeline_stages=2')
+    self.assertIn('Codegen cache hit', stderr)
+
 if __name__ == '__main__':
   absltest.main()
@@ -15,9 +15,12 @@
 #include "xls/tools/scheduling_options_flags.h"
 
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -27,10 +30,12 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
+#include "absl/time/time.h"
 #include "google/protobuf/text_format.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/delay_model/delay_estimators.h"
 #include "xls/fdo/synthesizer.h"
@@ -64,6 +69,21 @@ ABSL_FLAG(
     "If true, when `--clock_period_ps` is given but is infeasible for "
     "scheduling, search for & report the shortest feasible clock period. "
     "Otherwise, just reports whether increasing the clock period can help.");
+ABSL_FLAG(int64_t, scheduling_threads, 1,
+          "Number of threads to use when searching for the minimum clock "
+          "period (i.e., when `--clock_period_ps` is not given, or is "
+          "infeasible and `--minimize_clock_on_failure` is set). Each thread "
+          "checks a different candidate period on its own copy of the "
+          "scheduling problem. Also used for the SMT solver queries of the "
+          "mutual exclusion pass. If zero, uses one thread per available "
+          "CPU.");
+ABSL_FLAG(int64_t, sdc_partition_size, 0,
+          "If positive, functions with more nodes than this are scheduled with "
+          "the SDC strategy by solving a sequence of SDC problems over "
+          "partitions of at most this many nodes, rather than one problem over "
+          "the whole function. Reduces scheduling time and memory for very "
+          "large functions at some cost in register count. Requires "
+          "`--clock_period_ps`. If zero, functions are never partitioned.");
 ABSL_FLAG(bool, minimize_worst_case_throughput, false,
           "If true, when `--worst_case_throughput` is not given, search for & "
           "report the best possible worst-case throughput of the circuit "
@@ -145,11 +165,20 @@ ABSL_FLAG(
 ABSL_FLAG(std::string, fdo_path_evaluate_strategy, "window",
           "Path evaluation strategy for FDO. Supports path, cone, and window.");
 ABSL_FLAG(std::string, fdo_synthesizer_name, "yosys",
-          "Name of synthesis backend for FDO. Only supports yosys.");
+          "Name of synthesis backend for FDO. Supports yosys, and fake, which "
+          "times subgraphs with the delay model instead of running external "
+          "tools.");
 ABSL_FLAG(std::string, fdo_yosys_path, "", "Absolute path of yosys.");
 ABSL_FLAG(std::string, fdo_sta_path, "", "Absolute path of OpenSTA.");
 ABSL_FLAG(std::string, fdo_synthesis_libraries, "",
           "Synthesis and STA libraries.");
+ABSL_FLAG(int64_t, fdo_synthesis_threads, 0,
+          "Maximum number of subgraphs synthesized concurrently in each FDO "
+          "iteration. If zero, uses one thread per available CPU.");
+ABSL_FLAG(std::string, fdo_synthesis_cache_path, "",
+          "File in which the delays of synthesized subgraphs are cached, so "
+          "that identical subgraphs are not synthesized again by later runs. "
+          "If empty, delays are only reused within a run.");
 // TODO: google/xls#869 - Remove when proc-scoped channels supplant old-style
 // procs.
 ABSL_FLAG(bool, multi_proc, false,
@@ -188,6 +217,8 @@ static absl::StatusOr<bool> SetOptionsFromFlags(
   POPULATE_FLAG(clock_margin_percent);
   POPULATE_FLAG(period_relaxation_percent);
   POPULATE_FLAG(minimize_clock_on_failure);
+  POPULATE_FLAG(scheduling_threads);
+  POPULATE_FLAG(sdc_partition_size);
   POPULATE_FLAG(minimize_worst_case_throughput);
   {
     any_flags_set |= FLAGS_worst_case_throughput.IsSpecifiedOnCommandLine();
@@ -211,6 +242,8 @@ static absl::StatusOr<bool> SetOptionsFromFlags(
   POPULATE_FLAG(fdo_yosys_path);
   POPULATE_FLAG(fdo_sta_path);
   POPULATE_FLAG(fdo_synthesis_libraries);
+  POPULATE_FLAG(fdo_synthesis_threads);
+  POPULATE_FLAG(fdo_synthesis_cache_path);
   POPULATE_FLAG(multi_proc);
 #undef POPULATE_FLAG
 #undef POPULATE_REPEATED_FLAG
@@ -277,6 +310,24 @@ static absl::StatusOr<SchedulingOptions> OptionsFromFlagProto(
   }
   scheduling_options.minimize_clock_on_failure(
       proto.minimize_clock_on_failure());
+  if (proto.has_scheduling_threads()) {
+    if (proto.scheduling_threads() < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("scheduling_threads must be non-negative, got %d",
+                          proto.scheduling_threads()));
+    }
+    scheduling_options.scheduling_threads(proto.scheduling_threads() == 0
+                                              ? AvailableCPUs()
+                                              : proto.scheduling_threads());
+  }
+  if (proto.has_sdc_partition_size()) {
+    if (proto.sdc_partition_size() < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("sdc_partition_size must be non-negative, got %d",
+                          proto.sdc_partition_size()));
+    }
+    scheduling_options.sdc_partition_size(proto.sdc_partition_size());
+  }
   if (proto.worst_case_throughput() != 1) {
     scheduling_options.worst_case_throughput(proto.worst_case_throughput());
   }
@@ -440,6 +491,16 @@ static absl::StatusOr<SchedulingOptions> OptionsFromFlagProto(
   scheduling_options.fdo_yosys_path(proto.fdo_yosys_path());
   scheduling_options.fdo_sta_path(proto.fdo_sta_path());
   scheduling_options.fdo_synthesis_libraries(proto.fdo_synthesis_libraries());
+  scheduling_options.fdo_synthesis_cache_path(proto.fdo_synthesis_cache_path());
+
+  if (proto.has_fdo_synthesis_threads()) {
+    if (proto.fdo_synthesis_threads() < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("fdo_synthesis_threads must be non-negative, got %d",
+                          proto.fdo_synthesis_threads()));
+    }
+    scheduling_options.fdo_synthesis_threads(proto.fdo_synthesis_threads());
+  }
 
   scheduling_options.schedule_all_procs(proto.multi_proc());
 
@@ -463,21 +524,39 @@ absl::StatusOr<SchedulingOptions> SetUpSchedulingOptions(
 
 absl::StatusOr<synthesis::Synthesizer*> SetUpSynthesizer(
     const SchedulingOptions& flags) {
+  std::unique_ptr<synthesis::Synthesizer> synthesizer;
   if (flags.fdo_synthesizer_name() == "yosys") {
     if (flags.fdo_yosys_path().empty() || flags.fdo_sta_path().empty() ||
         flags.fdo_synthesis_libraries().empty()) {
       return absl::InternalError(
           "yosys_path, sta_path, and synthesis_libraries must not be empty");
     }
-    synthesis::YosysSynthesizer* yosys_synthesizer =
-        new synthesis::YosysSynthesizer(flags.fdo_yosys_path(),
-                                        flags.fdo_sta_path(),
-                                        flags.fdo_synthesis_libraries());
-    return yosys_synthesizer;
+    synthesizer = std::make_unique<synthesis::YosysSynthesizer>(
+        flags.fdo_yosys_path(), flags.fdo_sta_path(),
+        flags.fdo_synthesis_libraries(), flags.fdo_synthesis_threads());
+  } else if (flags.fdo_synthesizer_name() == "fake") {
+    if (!flags.delay_model().has_value()) {
+      return absl::InvalidArgumentError(
+          "The fake synthesizer requires a delay model");
+    }
+    XLS_ASSIGN_OR_RETURN(DelayEstimator * delay_estimator,
+                         GetDelayEstimator(*flags.delay_model()));
+    synthesizer = std::make_unique<synthesis::FakeSynthesizer>(
+        *delay_estimator, absl::ZeroDuration(), flags.fdo_synthesis_threads());
+  } else {
+    return absl::InternalError("Synthesis service is invalid: " +
+                               flags.fdo_synthesizer_name());
   }
 
-  return absl::InternalError("Synthesis service is invalid: " +
-                             flags.fdo_synthesizer_name());
+  std::optional<std::filesystem::path> cache_path;
+  if (!flags.fdo_synthesis_cache_path().empty()) {
+    cache_path = flags.fdo_synthesis_cache_path();
+  }
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<synthesis::CachingSynthesizer> caching_synthesizer,
+      synthesis::CachingSynthesizer::Create(std::move(synthesizer),
+                                            std::move(cache_path)));
+  return caching_synthesizer.release();
 }
 
 }  // namespace xls
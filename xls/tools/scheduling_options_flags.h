@@ -42,6 +42,8 @@ absl::StatusOr<DelayEstimator*> SetUpDelayEstimator(
     const SchedulingOptionsFlagsProto& flags);
 absl::StatusOr<bool> IsDelayModelSpecifiedViaFlag(
     const SchedulingOptionsFlagsProto& flags);
+// The caller takes ownership of the returned synthesizer and must destroy it
+// for any synthesis cache to be written back.
 absl::StatusOr<synthesis::Synthesizer*> SetUpSynthesizer(
     const SchedulingOptions& flags);
 
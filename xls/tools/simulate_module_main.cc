@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <filesystem>  // NOLINT
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -34,9 +36,12 @@
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/ir/block.h"
 #include "xls/ir/format_preference.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/jit/block_jit.h"
 #include "xls/simulation/module_simulator.h"
 #include "xls/simulation/verilog_simulators.h"
 #include "xls/tools/eval_utils.h"
@@ -54,6 +59,11 @@ Simulate a module with a batch of arguments, one argument set per line in
 ARGS_FILE:
   simulate_module_main  --signature_file=SIG_FILE \
       --args_file=ARGS_FILE VERILOG_FILE
+
+Simulate the block IR written by codegen_main --output_block_ir_path with the
+block JIT instead of a Verilog simulator:
+  simulate_module_main  --signature_file=SIG_FILE \
+      --args_file=ARGS_FILE --block_ir_file=BLOCK_IR_FILE
 )";
 
 ABSL_FLAG(
@@ -89,6 +99,11 @@ ABSL_FLAG(std::vector<std::string>, output_channel_counts, {},
 ABSL_FLAG(std::string, verilog_simulator, "",
           "The Verilog simulator to use. If not specified, the default "
           "simulator is used.");
+ABSL_FLAG(std::string, block_ir_file, "",
+          "Path to the block IR the module was generated from, as written by "
+          "codegen_main --output_block_ir_path. If specified, the block is "
+          "simulated in process with the block JIT and no Verilog file or "
+          "simulator is used.");
 ABSL_FLAG(std::string, file_type, "",
           "The type of input file, may be either 'verilog' or "
           "'system_verilog'. If not specified the file type is determined by "
@@ -144,6 +159,15 @@ absl::Status RunFunction(const verilog::ModuleSimulator& simulator,
   return absl::OkStatus();
 }
 
+absl::Status RunInputs(const verilog::ModuleSimulator& simulator,
+                       const verilog::ModuleSignature& signature,
+                       InputType inputs) {
+  if (std::holds_alternative<FunctionInput>(inputs)) {
+    return RunFunction(simulator, signature, std::get<FunctionInput>(inputs));
+  }
+  return RunProc(simulator, signature, std::get<ProcInput>(inputs));
+}
+
 absl::Status RealMain(std::string_view verilog_text,
                       verilog::FileType file_type,
                       const verilog::ModuleSignature& signature,
@@ -151,11 +175,20 @@ absl::Status RealMain(std::string_view verilog_text,
                       const verilog::VerilogSimulator* verilog_simulator) {
   verilog::ModuleSimulator simulator(signature, verilog_text, file_type,
                                      verilog_simulator);
+  return RunInputs(simulator, signature, std::move(inputs));
+}
 
-  if (std::holds_alternative<FunctionInput>(inputs)) {
-    return RunFunction(simulator, signature, std::get<FunctionInput>(inputs));
-  }
-  return RunProc(simulator, signature, std::get<ProcInput>(inputs));
+absl::Status RealMainWithBlockJit(std::string_view block_ir_path,
+                                  const verilog::ModuleSignature& signature,
+                                  InputType inputs) {
+  XLS_ASSIGN_OR_RETURN(std::string block_ir, GetFileContents(block_ir_path));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(block_ir, block_ir_path));
+  XLS_ASSIGN_OR_RETURN(Block * block,
+                       package->GetBlock(signature.module_name()));
+  verilog::ModuleSimulator simulator(signature, block,
+                                     &kStreamingJitBlockEvaluator);
+  return RunInputs(simulator, signature, std::move(inputs));
 }
 
 }  // namespace
@@ -165,49 +198,6 @@ int main(int argc, char** argv) {
   std::vector<std::string_view> positional_arguments =
       xls::InitXls(kUsage, argc, argv);
 
-  const xls::verilog::VerilogSimulator* verilog_simulator;
-  if (absl::GetFlag(FLAGS_verilog_simulator).empty()) {
-    verilog_simulator = &xls::verilog::GetDefaultVerilogSimulator();
-  } else {
-    absl::StatusOr<const xls::verilog::VerilogSimulator*>
-        verilog_simulator_status = xls::verilog::GetVerilogSimulator(
-            absl::GetFlag(FLAGS_verilog_simulator));
-    std::string verilog_simulator_names = absl::StrJoin(
-        xls::verilog::GetVerilogSimulatorManagerSingleton().simulator_names(),
-        ", ");
-    QCHECK_OK(verilog_simulator_status.status())
-        << "Available simulators: " << verilog_simulator_names;
-    verilog_simulator = verilog_simulator_status.value();
-  }
-  QCHECK_EQ(positional_arguments.size(), 1)
-      << "Expected single Verilog file argument.";
-  std::filesystem::path verilog_path(positional_arguments.at(0));
-  absl::StatusOr<std::string> verilog_text = xls::GetFileContents(verilog_path);
-  QCHECK_OK(verilog_text.status());
-
-  xls::verilog::FileType file_type;
-  if (absl::GetFlag(FLAGS_file_type).empty()) {
-    if (verilog_path.extension() == ".v") {
-      file_type = xls::verilog::FileType::kVerilog;
-    } else if (verilog_path.extension() == ".sv") {
-      file_type = xls::verilog::FileType::kSystemVerilog;
-    } else {
-      XLS_LOG(QFATAL) << absl::StreamFormat(
-          "Unable to determine file type from filename `%s`. Expected `.v` or "
-          "`.sv` file extension.",
-          verilog_path);
-    }
-  } else {
-    if (absl::GetFlag(FLAGS_file_type) == "verilog") {
-      file_type = xls::verilog::FileType::kVerilog;
-    } else if (absl::GetFlag(FLAGS_file_type) == "system_verilog") {
-      file_type = xls::verilog::FileType::kSystemVerilog;
-    } else {
-      XLS_LOG(QFATAL) << "Invalid value for --file_type. Expected `verilog` or "
-                         "`system_verilog`.";
-    }
-  }
-
   int64_t arg_count = absl::GetFlag(FLAGS_args).empty() ? 0 : 1;
   arg_count += absl::GetFlag(FLAGS_args_file).empty() ? 0 : 1;
   arg_count += absl::GetFlag(FLAGS_channel_values_file).empty() ? 0 : 1;
@@ -264,6 +254,56 @@ int main(int argc, char** argv) {
       xls::verilog::ModuleSignature::FromProto(signature_proto);
   QCHECK_OK(signature_status.status());
 
+  if (!absl::GetFlag(FLAGS_block_ir_file).empty()) {
+    QCHECK(positional_arguments.empty())
+        << "A Verilog file cannot be specified with --block_ir_file.";
+    return xls::ExitStatus(xls::RealMainWithBlockJit(
+        absl::GetFlag(FLAGS_block_ir_file), signature_status.value(), input));
+  }
+
+  const xls::verilog::VerilogSimulator* verilog_simulator;
+  if (absl::GetFlag(FLAGS_verilog_simulator).empty()) {
+    verilog_simulator = &xls::verilog::GetDefaultVerilogSimulator();
+  } else {
+    absl::StatusOr<const xls::verilog::VerilogSimulator*>
+        verilog_simulator_status = xls::verilog::GetVerilogSimulator(
+            absl::GetFlag(FLAGS_verilog_simulator));
+    std::string verilog_simulator_names = absl::StrJoin(
+        xls::verilog::GetVerilogSimulatorManagerSingleton().simulator_names(),
+        ", ");
+    QCHECK_OK(verilog_simulator_status.status())
+        << "Available simulators: " << verilog_simulator_names;
+    verilog_simulator = verilog_simulator_status.value();
+  }
+  QCHECK_EQ(positional_arguments.size(), 1)
+      << "Expected single Verilog file argument.";
+  std::filesystem::path verilog_path(positional_arguments.at(0));
+  absl::StatusOr<std::string> verilog_text = xls::GetFileContents(verilog_path);
+  QCHECK_OK(verilog_text.status());
+
+  xls::verilog::FileType file_type;
+  if (absl::GetFlag(FLAGS_file_type).empty()) {
+    if (verilog_path.extension() == ".v") {
+      file_type = xls::verilog::FileType::kVerilog;
+    } else if (verilog_path.extension() == ".sv") {
+      file_type = xls::verilog::FileType::kSystemVerilog;
+    } else {
+      XLS_LOG(QFATAL) << absl::StreamFormat(
+          "Unable to determine file type from filename `%s`. Expected `.v` or "
+          "`.sv` file extension.",
+          verilog_path);
+    }
+  } else {
+    if (absl::GetFlag(FLAGS_file_type) == "verilog") {
+      file_type = xls::verilog::FileType::kVerilog;
+    } else if (absl::GetFlag(FLAGS_file_type) == "system_verilog") {
+      file_type = xls::verilog::FileType::kSystemVerilog;
+    } else {
+      XLS_LOG(QFATAL) << "Invalid value for --file_type. Expected `verilog` or "
+                         "`system_verilog`.";
+    }
+  }
+
   return xls::ExitStatus(xls::RealMain(verilog_text.value(), file_type,
                                        signature_status.value(), input,
                                        verilog_simulator));
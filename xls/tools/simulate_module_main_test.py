@@ -119,6 +119,36 @@ class SimulateModuleMainTest(test_base.TestCase):
     self.assertMultiLineEqual('bits[32]:0xf01\nbits[32]:0x2a\n',
                               result.decode('utf-8'))
 
+  def test_multi_arg_from_file_function_block_jit(self):
+    ir_file = self.create_tempfile(content=ADD_IR_FUNCTION)
+    block_ir_file = self.create_tempfile()
+    signature_file = self.create_tempfile()
+    subprocess.check_call([
+        CODEGEN_MAIN_PATH,
+        '--generator=pipeline',
+        '--delay_model=unit',
+        '--pipeline_stages=2',
+        '--reset=rst',
+        '--output_block_ir_path=' + block_ir_file.full_path,
+        '--output_signature_path=' + signature_file.full_path,
+        '--alsologtostderr',
+        ir_file.full_path,
+    ])
+    args_file = self.create_tempfile(content="""
+      bits[32]:0xf00; bits[32]:1
+
+      bits[32]:2; bits[32]:40
+
+    """)
+    result = subprocess.check_output([
+        SIMULATE_MODULE_MAIN_PATH, '--alsologtostderr', '--v=1',
+        '--signature_file=' + signature_file.full_path,
+        '--args_file=' + args_file.full_path,
+        '--block_ir_file=' + block_ir_file.full_path
+    ])
+    self.assertMultiLineEqual('bits[32]:0xf01\nbits[32]:0x2a\n',
+                              result.decode('utf-8'))
+
   def test_multi_arg_from_file_proc(self):
     ir_file = self.create_tempfile(content=ADD_IR_PROC)
     verilog_file = self.create_tempfile()